@@ -18,12 +18,14 @@
 */
 
 #include <android/bitmap.h>
+#include <dlfcn.h>
+#include <GLES2/gl2.h>
 #include <jni.h>
 #include <string>
 
 #include "../../core.h"
 #include "../../settings.h"
-#include "../../common/nds_icon.h"
+#include "../../common/rom_index.h"
 #include "../../common/screen_layout.h"
 
 int screenFilter = 1;
@@ -31,8 +33,76 @@ int showFpsCounter = 0;
 
 std::string ndsPath, gbaPath;
 Core *core = nullptr;
+RomIndex *romIndex = nullptr;
 ScreenLayout layout;
 
+// AAudio is loaded at runtime, since it's only on Android 8.0 and up and older versions use AudioTrack instead
+// Only the parts that are used are declared here, with values from the NDK's AAudio.h
+struct AAudioStream;
+struct AAudioStreamBuilder;
+typedef int32_t (*AAudioCallback)(AAudioStream *stream, void *userData, void *audioData, int32_t numFrames);
+
+struct AAudioFuncs
+{
+    int32_t (*createStreamBuilder)(AAudioStreamBuilder **builder);
+    void (*setFormat)(AAudioStreamBuilder *builder, int32_t format);
+    void (*setChannelCount)(AAudioStreamBuilder *builder, int32_t channelCount);
+    void (*setPerformanceMode)(AAudioStreamBuilder *builder, int32_t mode);
+    void (*setDataCallback)(AAudioStreamBuilder *builder, AAudioCallback callback, void *userData);
+    int32_t (*openStream)(AAudioStreamBuilder *builder, AAudioStream **stream);
+    int32_t (*deleteBuilder)(AAudioStreamBuilder *builder);
+    int32_t (*getSampleRate)(AAudioStream *stream);
+    int32_t (*requestStart)(AAudioStream *stream);
+    int32_t (*requestStop)(AAudioStream *stream);
+    int32_t (*close)(AAudioStream *stream);
+};
+
+AAudioFuncs aaudio = {};
+AAudioStream *audioStream = nullptr;
+int audioRate = 0;
+
+bool loadAAudio()
+{
+    // Load the AAudio functions if they haven't been loaded yet
+    if (aaudio.close) return true;
+    void *lib = dlopen("libaaudio.so", RTLD_NOW);
+    if (!lib) return false;
+
+    AAudioFuncs funcs;
+    funcs.createStreamBuilder = (int32_t(*)(AAudioStreamBuilder**))dlsym(lib, "AAudio_createStreamBuilder");
+    funcs.setFormat = (void(*)(AAudioStreamBuilder*, int32_t))dlsym(lib, "AAudioStreamBuilder_setFormat");
+    funcs.setChannelCount = (void(*)(AAudioStreamBuilder*, int32_t))dlsym(lib, "AAudioStreamBuilder_setChannelCount");
+    funcs.setPerformanceMode = (void(*)(AAudioStreamBuilder*, int32_t))dlsym(lib, "AAudioStreamBuilder_setPerformanceMode");
+    funcs.setDataCallback = (void(*)(AAudioStreamBuilder*, AAudioCallback, void*))dlsym(lib, "AAudioStreamBuilder_setDataCallback");
+    funcs.openStream = (int32_t(*)(AAudioStreamBuilder*, AAudioStream**))dlsym(lib, "AAudioStreamBuilder_openStream");
+    funcs.deleteBuilder = (int32_t(*)(AAudioStreamBuilder*))dlsym(lib, "AAudioStreamBuilder_delete");
+    funcs.getSampleRate = (int32_t(*)(AAudioStream*))dlsym(lib, "AAudioStream_getSampleRate");
+    funcs.requestStart = (int32_t(*)(AAudioStream*))dlsym(lib, "AAudioStream_requestStart");
+    funcs.requestStop = (int32_t(*)(AAudioStream*))dlsym(lib, "AAudioStream_requestStop");
+    funcs.close = (int32_t(*)(AAudioStream*))dlsym(lib, "AAudioStream_close");
+
+    // Give up if anything is missing
+    void **ptrs = (void**)&funcs;
+    for (unsigned int i = 0; i < sizeof(funcs) / sizeof(void*); i++)
+    {
+        if (!ptrs[i])
+        {
+            dlclose(lib);
+            return false;
+        }
+    }
+
+    aaudio = funcs;
+    return true;
+}
+
+int32_t audioCallback(AAudioStream *stream, void *userData, void *audioData, int32_t numFrames)
+{
+    // Resample straight from the SPU's ring buffer into the stream, at the rate the device chose
+    core->spu.getSamples((int16_t*)audioData, numFrames, audioRate);
+    return 0; // AAUDIO_CALLBACK_RESULT_CONTINUE
+}
+
 extern "C" JNIEXPORT void JNICALL Java_com_hydra_noods_FileBrowser_loadSettings(JNIEnv* env, jobject obj, jstring rootPath)
 {
     // Convert the Java string to a C++ string
@@ -62,22 +132,35 @@ extern "C" JNIEXPORT void JNICALL Java_com_hydra_noods_FileBrowser_loadSettings(
         Settings::setSdImagePath(path + "/noods/sd.img");
         Settings::save();
     }
+
+    // Open the index of decoded NDS icons
+    if (!romIndex) romIndex = new RomIndex(path + "/noods/roms.idx");
 }
 
 extern "C" JNIEXPORT void JNICALL Java_com_hydra_noods_FileBrowser_getNdsIcon(JNIEnv *env, jobject obj, jstring romName, jobject bitmap)
 {
-    // Get the NDS icon
+    // Get the NDS icon, from the index if the ROM hasn't changed since it was last decoded
     const char *str = env->GetStringUTFChars(romName, nullptr);
-    NdsIcon icon(str);
+    RomInfo info;
+    romIndex->get(str, &info);
     env->ReleaseStringUTFChars(romName, str);
 
     // Copy the data to the bitmap
     uint32_t *data;
     AndroidBitmap_lockPixels(env, bitmap, (void**)&data);
-    memcpy(data, icon.getIcon(), 32 * 32 * sizeof(uint32_t));
+    memcpy(data, info.icon, 32 * 32 * sizeof(uint32_t));
     AndroidBitmap_unlockPixels(env, bitmap);
 }
 
+extern "C" JNIEXPORT void JNICALL Java_com_hydra_noods_FileBrowser_scanDirectory(JNIEnv *env, jobject obj, jstring dirPath)
+{
+    // Index the folders inside a directory in the background, and save any icons decoded while listing it
+    const char *str = env->GetStringUTFChars(dirPath, nullptr);
+    romIndex->save();
+    romIndex->scan(str);
+    env->ReleaseStringUTFChars(dirPath, str);
+}
+
 extern "C" JNIEXPORT jint JNICALL Java_com_hydra_noods_FileBrowser_startCore(JNIEnv* env, jobject obj)
 {
     // Start the core, or return an error code on failure
@@ -117,37 +200,67 @@ extern "C" JNIEXPORT void JNICALL Java_com_hydra_noods_FileBrowser_setGbaPath(JN
     env->ReleaseStringUTFChars(value, str);
 }
 
-extern "C" JNIEXPORT void JNICALL Java_com_hydra_noods_NooActivity_fillAudioBuffer(JNIEnv *env, jobject obj, jshortArray buffer)
+extern "C" JNIEXPORT jboolean JNICALL Java_com_hydra_noods_NooActivity_startAudio(JNIEnv *env, jobject obj)
 {
-    // Get the buffer and sample data
-    jshort *data = env->GetShortArrayElements(buffer, nullptr);
-    int count = env->GetArrayLength(buffer) / 2;
-    uint32_t *samples = core->spu.getSamples(count);
+    // Open a low latency AAudio stream that pulls samples from the core, or return false to fall back to AudioTrack
+    if (audioStream) return true;
+    if (!loadAAudio()) return false;
+
+    AAudioStreamBuilder *builder;
+    if (aaudio.createStreamBuilder(&builder) != 0) return false;
+    aaudio.setFormat(builder, 1); // AAUDIO_FORMAT_PCM_I16
+    aaudio.setChannelCount(builder, 2);
+    aaudio.setPerformanceMode(builder, 12); // AAUDIO_PERFORMANCE_MODE_LOW_LATENCY
+    aaudio.setDataCallback(builder, audioCallback, nullptr);
+    int32_t result = aaudio.openStream(builder, &audioStream);
+    aaudio.deleteBuilder(builder);
 
-    // Fill the audio buffer
-    for (int i = 0; i < count; i++)
+    if (result != 0)
     {
-        data[i * 2 + 0] = samples[i] >>  0;
-        data[i * 2 + 1] = samples[i] >> 16;
+        audioStream = nullptr;
+        return false;
     }
 
+    // Start the stream at whatever sample rate the device uses, since the SPU resamples anyway
+    audioRate = aaudio.getSampleRate(audioStream);
+    if (audioRate <= 0 || aaudio.requestStart(audioStream) != 0)
+    {
+        aaudio.close(audioStream);
+        audioStream = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_hydra_noods_NooActivity_stopAudio(JNIEnv *env, jobject obj)
+{
+    // Stop and close the AAudio stream, so it doesn't pull from the core while it's paused or replaced
+    if (!audioStream) return;
+    aaudio.requestStop(audioStream);
+    aaudio.close(audioStream);
+    audioStream = nullptr;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_com_hydra_noods_NooActivity_fillAudioBuffer(JNIEnv *env, jobject obj, jshortArray buffer)
+{
+    // Fill the audio buffer directly, at the NDS sample rate that the audio track uses
+    jshort *data = env->GetShortArrayElements(buffer, nullptr);
+    int count = env->GetArrayLength(buffer) / 2;
+    core->spu.getSamples(data, count, 32768);
     env->ReleaseShortArrayElements(buffer, data, 0);
-    delete[] samples;
 }
 
-extern "C" JNIEXPORT jboolean JNICALL Java_com_hydra_noods_NooRenderer_copyFramebuffer(JNIEnv *env, jobject obj, jobject bitmap, jboolean gbaCrop)
+extern "C" JNIEXPORT jboolean JNICALL Java_com_hydra_noods_NooRenderer_uploadFramebuffer(JNIEnv *env, jobject obj, jboolean gbaCrop)
 {
     // Get a new frame if one is ready
-    uint32_t *framebuffer = core->gpu.getFrame(gbaCrop);
+    const uint32_t *framebuffer = core->gpu.getFrame(gbaCrop);
     if (!framebuffer) return false;
 
-    // Copy the frame to the bitmap
-    uint32_t *data;
-    AndroidBitmap_lockPixels(env, bitmap, (void**)&data);
-    memcpy(data, framebuffer, (gbaCrop ? (240 * 160) : (256 * 192 * 2)) * sizeof(uint32_t));
-    AndroidBitmap_unlockPixels(env, bitmap);
-
-    delete[] framebuffer;
+    // Upload the frame to the bound texture straight from the core, instead of going through a Java bitmap
+    // The frame's RGBA8 layout matches what GL expects, so nothing needs to be converted
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, gbaCrop ? 240 : 256, gbaCrop ? 160 : (192 * 2), 0,
+        GL_RGBA, GL_UNSIGNED_BYTE, framebuffer);
     return true;
 }
 
@@ -275,7 +388,9 @@ extern "C" JNIEXPORT void JNICALL Java_com_hydra_noods_SettingsMenu_setShowFpsCo
 
 extern "C" JNIEXPORT void JNICALL Java_com_hydra_noods_SettingsMenu_saveSettings(JNIEnv* env, jobject obj)
 {
+    // Save the settings, passing the changes to the core if one is running
     Settings::save();
+    if (core) core->setConfig(Settings::getConfig());
 }
 
 extern "C" JNIEXPORT jint JNICALL Java_com_hydra_noods_NooActivity_getShowFpsCounter(JNIEnv* env, jobject obj)
@@ -295,7 +410,7 @@ extern "C" JNIEXPORT jboolean JNICALL Java_com_hydra_noods_NooActivity_isGbaMode
 
 extern "C" JNIEXPORT void JNICALL Java_com_hydra_noods_NooActivity_runFrame(JNIEnv *env, jobject obj)
 {
-    core->runFrame();
+    core->runAhead.runFrame();
 }
 
 extern "C" JNIEXPORT void JNICALL Java_com_hydra_noods_NooActivity_writeSave(JNIEnv *env, jobject obj)
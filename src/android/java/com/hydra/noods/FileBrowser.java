@@ -308,10 +308,14 @@ public class FileBrowser extends AppCompatActivity
         }
 
         fileView.setAdapter(new FileAdapter(this, fileNames, fileIcons));
+
+        // Index the folders inside this one in the background, so they open quickly
+        scanDirectory(path);
     }
 
     public native void loadSettings(String rootPath);
     public native void getNdsIcon(String romPath, Bitmap bitmap);
+    public native void scanDirectory(String dirPath);
     public native int startCore();
     public native String getNdsPath();
     public native String getGbaPath();
@@ -129,11 +129,6 @@ public class NooActivity extends AppCompatActivity
             layout.addView(fpsCounter);
 
         setContentView(layout);
-
-        // Set up audio playback
-        track = new AudioTrack(AudioManager.STREAM_MUSIC, 32768, AudioFormat.CHANNEL_OUT_STEREO,
-                AudioFormat.ENCODING_PCM_16BIT, 1024 * 2 * 2, AudioTrack.MODE_STREAM);
-        track.play();
     }
 
     @Override
@@ -277,12 +272,14 @@ public class NooActivity extends AppCompatActivity
     private void pauseCore()
     {
         running = false;
+        stopAudio();
 
         // Wait for the emulator to stop
         try
         {
             core.join();
-            audio.join();
+            if (audio != null)
+                audio.join();
             if (getShowFpsCounter() != 0)
                 fps.join();
         }
@@ -314,23 +311,40 @@ public class NooActivity extends AppCompatActivity
         core.setPriority(Thread.MAX_PRIORITY);
         core.start();
 
-        // Prepare the audio thread
-        audio = new Thread()
+        // Play audio through AAudio if it's available, which pulls samples from the core without going through Java
+        // Otherwise, fall back to filling an AudioTrack from a thread
+        if (startAudio())
         {
-            @Override
-            public void run()
-            {             
-                while (running)
+            audio = null;
+        }
+        else
+        {
+            // Set up audio playback
+            if (track == null)
+            {
+                track = new AudioTrack(AudioManager.STREAM_MUSIC, 32768, AudioFormat.CHANNEL_OUT_STEREO,
+                        AudioFormat.ENCODING_PCM_16BIT, 1024 * 2 * 2, AudioTrack.MODE_STREAM);
+                track.play();
+            }
+
+            // Prepare the audio thread, reusing one buffer so nothing is allocated while it runs
+            audio = new Thread()
+            {
+                @Override
+                public void run()
                 {
                     short[] buffer = new short[1024 * 2];
-                    fillAudioBuffer(buffer);
-                    track.write(buffer, 0, 1024 * 2);
+                    while (running)
+                    {
+                        fillAudioBuffer(buffer);
+                        track.write(buffer, 0, 1024 * 2);
+                    }
                 }
-            }
-        };
+            };
 
-        audio.setPriority(Thread.NORM_PRIORITY);
-        audio.start();
+            audio.setPriority(Thread.NORM_PRIORITY);
+            audio.start();
+        }
 
         if (getShowFpsCounter() != 0)
         {
@@ -388,6 +402,8 @@ public class NooActivity extends AppCompatActivity
 
     public boolean isRunning() { return running; }
 
+    public native boolean startAudio();
+    public native void stopAudio();
     public native void fillAudioBuffer(short[] buffer);
     public native int getShowFpsCounter();
     public native int getFps();
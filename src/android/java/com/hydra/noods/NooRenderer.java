@@ -19,10 +19,8 @@
 
 package com.hydra.noods;
 
-import android.graphics.Bitmap;
 import android.opengl.GLES20;
 import android.opengl.GLSurfaceView;
-import android.opengl.GLUtils;
 
 import javax.microedition.khronos.egl.EGLConfig;
 import javax.microedition.khronos.opengles.GL10;
@@ -37,7 +35,6 @@ public class NooRenderer implements GLSurfaceView.Renderer
 
     private int program;
     private int textures[];
-    private Bitmap bitmap;
     private boolean gbaMode;
     private int width, height;
 
@@ -100,7 +97,6 @@ public class NooRenderer implements GLSurfaceView.Renderer
         GLES20.glTexParameteri(GLES20.GL_TEXTURE_2D, GLES20.GL_TEXTURE_MIN_FILTER, (getScreenFilter() == 1) ? GLES20.GL_LINEAR : GLES20.GL_NEAREST);
         GLES20.glTexParameteri(GLES20.GL_TEXTURE_2D, GLES20.GL_TEXTURE_MAG_FILTER, (getScreenFilter() == 1) ? GLES20.GL_LINEAR : GLES20.GL_NEAREST);
 
-        bitmap = Bitmap.createBitmap(256, 192 * 2, Bitmap.Config.ARGB_8888);
         gbaMode = false;
     }
 
@@ -137,17 +133,15 @@ public class NooRenderer implements GLSurfaceView.Renderer
         {
             gbaMode = !gbaMode;
             updateLayout(width, height);
-            bitmap = Bitmap.createBitmap((gbaMode ? 240 : 256), (gbaMode ? 160 : (192 * 2)), Bitmap.Config.ARGB_8888);
         }
 
         // Clear the display
         GLES20.glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         GLES20.glClear(GLES20.GL_COLOR_BUFFER_BIT);
 
-        // Wait until a new frame is ready to prevent stuttering
+        // Wait until a new frame is ready to prevent stuttering, and upload it to the texture
         // This sucks, but buffers are automatically swapped, so returning would cause even worse stutter
-        while (!copyFramebuffer(bitmap, gbaMode) && activity.isRunning());
-        GLUtils.texImage2D(GLES20.GL_TEXTURE_2D, 0, bitmap, 0);
+        while (!uploadFramebuffer(gbaMode) && activity.isRunning());
 
         if (gbaMode)
         {
@@ -191,7 +185,7 @@ public class NooRenderer implements GLSurfaceView.Renderer
         GLES20.glDrawArrays(GLES20.GL_TRIANGLE_STRIP, 0, 4);
     }
 
-    public native boolean copyFramebuffer(Bitmap bitmap, boolean gbaCrop);
+    public native boolean uploadFramebuffer(boolean gbaCrop);
     public native int getScreenRotation();
     public native int getGbaCrop();
     public native int getScreenFilter();
@@ -0,0 +1,198 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../core.h"
+#include "../settings.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+// A headless frontend that runs a ROM as fast as possible and reports timing as JSON
+// Settings are loaded from noods.ini like the other frontends, so BIOS paths and core options carry over
+// The FPS limiter is always disabled, and no video or audio is output
+
+long getResidentSize()
+{
+#ifdef __linux__
+    // Read the resident page count of the process, and convert it to KB
+    long pages = 0, resident = 0;
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (!file) return -1;
+    int count = fscanf(file, "%ld %ld", &pages, &resident);
+    fclose(file);
+    return (count == 2) ? resident * (sysconf(_SC_PAGESIZE) / 1024) : -1;
+#else
+    // Resident size isn't reported on other platforms
+    return -1;
+#endif
+}
+
+void printUsage()
+{
+    fprintf(stderr, "Usage: noods-bench [options] rom\n");
+    fprintf(stderr, "  -f <frames>  Number of frames to measure (default 600)\n");
+    fprintf(stderr, "  -w <frames>  Number of frames to run before measuring (default 60)\n");
+    fprintf(stderr, "  -i <file>    Settings file to load (default noods.ini)\n");
+    fprintf(stderr, "  -r <file>    Record the input of the run to a movie file\n");
+    fprintf(stderr, "  -p <file>    Replay the input of a movie file, and report if the output differs\n");
+}
+
+int main(int argc, char **argv)
+{
+    std::string romPath, iniPath = "noods.ini", recordPath, playPath;
+    int frames = 600, warmup = 60;
+
+    // Parse the command line arguments
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+            frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+            warmup = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+            iniPath = argv[++i];
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+            playPath = argv[++i];
+        else if (argv[i][0] != '-' && romPath == "")
+            romPath = argv[i];
+        else
+            romPath = "";
+    }
+
+    if (romPath == "" || frames <= 0 || warmup < 0)
+    {
+        printUsage();
+        return 1;
+    }
+
+    // Load the settings, and make sure nothing throttles the emulator
+    Settings::load(iniPath);
+    Settings::setFpsLimiter(0);
+
+    // Boot the ROM, treating any file ending in .gba as a GBA ROM
+    Core *core;
+    bool gba = (romPath.size() >= 4 && romPath.substr(romPath.size() - 4) == ".gba");
+    try
+    {
+        core = gba ? new Core("", romPath) : new Core(romPath);
+    }
+    catch (int e)
+    {
+        switch (e)
+        {
+            case 1: fprintf(stderr, "Error: Make sure the path settings point to valid BIOS and firmware files\n"); break;
+            case 2: fprintf(stderr, "Error: Make sure the ROM file is accessible\n"); break;
+        }
+        return 1;
+    }
+
+    // Start a movie from boot if requested, so the same run can be measured again on another build
+    if ((recordPath != "" && !core->movie.startRecording(recordPath)) || (playPath != "" && !core->movie.startPlayback(playPath)))
+    {
+        fprintf(stderr, "Error: Make sure the movie file is accessible\n");
+        delete core;
+        return 1;
+    }
+    bool playing = core->movie.isPlaying();
+
+    // Run some frames first so startup doesn't skew the results
+    for (int i = 0; i < warmup; i++)
+        core->runFrame();
+
+    // Run the measured frames with the profiler enabled, timing each one
+    std::vector<double> frameTimes;
+    core->profiler.setEnabled(true);
+    core->profiler.reset();
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++)
+    {
+        std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+        core->runFrame();
+        std::chrono::duration<double, std::milli> frameTime = std::chrono::steady_clock::now() - frameStart;
+        frameTimes.push_back(frameTime.count());
+    }
+    std::chrono::duration<double> total = std::chrono::steady_clock::now() - start;
+    ProfileFrame profile = core->profiler.getTotal();
+
+    // Sort the frame times to find the percentiles
+    std::sort(frameTimes.begin(), frameTimes.end());
+    const int percentiles[] = { 50, 90, 95, 99 };
+
+    // Escape the ROM path so it's valid in a JSON string
+    std::string romName;
+    for (unsigned int i = 0; i < romPath.size(); i++)
+    {
+        if (romPath[i] == '\\' || romPath[i] == '"')
+            romName += '\\';
+        romName += romPath[i];
+    }
+
+    // Report the results
+    // These are written with fprintf, since printf is disabled for debug output in release builds
+    fprintf(stdout, "{\n");
+    fprintf(stdout, "  \"rom\": \"%s\",\n", romName.c_str());
+    fprintf(stdout, "  \"frames\": %d,\n", frames);
+    fprintf(stdout, "  \"seconds\": %.6f,\n", total.count());
+    fprintf(stdout, "  \"fps\": %.3f,\n", frames / total.count());
+    fprintf(stdout, "  \"cpus\": \"%s\",\n", ThreadPlacement::describe().c_str());
+    if (playing)
+        fprintf(stdout, "  \"desync_frame\": %d,\n", core->movie.getDesyncFrame());
+    fprintf(stdout, "  \"memory_kb\": {\n");
+    fprintf(stdout, "    \"core\": %lu,\n", (unsigned long)(core->getFootprint() / 1024));
+    fprintf(stdout, "    \"resident\": %ld\n", getResidentSize());
+    fprintf(stdout, "  },\n");
+    fprintf(stdout, "  \"frame_ms\": {\n");
+    fprintf(stdout, "    \"min\": %.4f,\n", frameTimes[0]);
+    for (int i = 0; i < 4; i++)
+        fprintf(stdout, "    \"p%d\": %.4f,\n", percentiles[i], frameTimes[(frameTimes.size() - 1) * percentiles[i] / 100]);
+    fprintf(stdout, "    \"max\": %.4f\n", frameTimes[frameTimes.size() - 1]);
+    fprintf(stdout, "  },\n");
+    fprintf(stdout, "  \"subsystem_ms\": {\n");
+    for (int i = 0; i < PROFILE_COUNT; i++)
+    {
+        ProfileSection section = (ProfileSection)i;
+        fprintf(stdout, "    \"%s\": %.4f%s\n", Profiler::getName(section), profile.times[i] / 1000000.0,
+            (i < PROFILE_COUNT - 1) ? "," : "");
+    }
+    fprintf(stdout, "  },\n");
+    fprintf(stdout, "  \"per_frame\": {\n");
+    for (int i = 0; i < COUNTER_COUNT; i++)
+    {
+        ProfileCounter counter = (ProfileCounter)i;
+        fprintf(stdout, "    \"%s\": %.1f%s\n", Profiler::getName(counter), (double)profile.counts[i] / frames,
+            (i < COUNTER_COUNT - 1) ? "," : "");
+    }
+    fprintf(stdout, "  }\n");
+    fprintf(stdout, "}\n");
+
+    delete core;
+    return 0;
+}
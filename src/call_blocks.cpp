@@ -0,0 +1,83 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "call_blocks.h"
+
+#define BUFFER_SIZE 0x800000 // 8MB of blocks per CPU
+
+bool CallBlocks::init()
+{
+    // Allocate a buffer for blocks, if it hasn't been already
+    if (!calls) calls = new ThreadedCall[BUFFER_SIZE / sizeof(ThreadedCall)];
+    return true;
+}
+
+CallBlocks::~CallBlocks()
+{
+    // Free the block memory
+    if (calls) delete[] calls;
+}
+
+void CallBlocks::beginBlock()
+{
+    // Start a new block at the current position in the buffer
+    start = offset;
+    count = 0;
+}
+
+bool CallBlocks::addCall(Call call, const Operands &ops)
+{
+    // Stop adding calls if the block or the buffer is full, leaving room for the terminator
+    if (count >= 64 || (offset + 2) * sizeof(ThreadedCall) > BUFFER_SIZE)
+        return false;
+
+    // Add an entry with the operands to the call list
+    calls[offset].call = call;
+    calls[offset++].ops = ops;
+    count++;
+    return true;
+}
+
+void *CallBlocks::endBlock()
+{
+    // Fail if nothing was added, which happens when the buffer ran out of space
+    if (count == 0)
+    {
+        offset = start;
+        return nullptr;
+    }
+
+    // Terminate the call list
+    calls[offset++].call = nullptr;
+    return &calls[start];
+}
+
+int CallBlocks::runBlock(void *block, void *arg)
+{
+    // Run the calls in a block until one returns false or the list ends
+    ThreadedCall *call = (ThreadedCall*)block;
+    int count = 0;
+    while (call->call)
+    {
+        count++;
+        if (!call->call(arg, &call->ops)) break;
+        call++;
+    }
+    return count;
+}
@@ -0,0 +1,67 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CALL_BLOCKS_H
+#define CALL_BLOCKS_H
+
+#include <cstdint>
+
+// Call blocks run a sequence of opcodes as a list of pre-decoded calls to the interpreter's handlers
+// This is call threading rather than recompilation; the handlers still do all the work, and blocks only save the
+// fetch and decode of each opcode and the trip through the scheduler between them
+// The calls are kept in regular memory, so this works anywhere, including hosts that don't allow executable memory
+class CallBlocks
+{
+    public:
+        // The fields of an opcode, decoded when the block is built so the calls don't have to extract them each time
+        struct Operands
+        {
+            uint32_t opcode;
+            uint32_t imm;
+            uint8_t rd, rs, rn;
+        };
+
+        // Each call in a block takes the block argument and its operands, and returns false to exit the block
+        typedef bool (*Call)(void *arg, const Operands *ops);
+
+        ~CallBlocks();
+
+        bool init();
+
+        void beginBlock();
+        bool addCall(Call call, const Operands &ops);
+        void *endBlock();
+
+        int runBlock(void *block, void *arg);
+
+        void reset() { offset = 0; }
+
+    private:
+        struct ThreadedCall
+        {
+            Call call;
+            Operands ops;
+        };
+
+        ThreadedCall *calls = nullptr;
+        uint32_t offset = 0;
+        uint32_t start = 0, count = 0;
+};
+
+#endif // CALL_BLOCKS_H
@@ -17,11 +17,28 @@
     along with NooDS. If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <cstring>
 
+#if !defined(_WIN32) && !defined(__SWITCH__)
+#include <sys/mman.h>
+#define ROM_MMAP
+#endif
+
+// The size of the blocks an NDS ROM is read in when it can't be mapped
+#define ROM_BLOCK 0x10000
+
 #include "cartridge.h"
 #include "core.h"
 #include "settings.h"
+#include "ziso.h"
+
+Cartridge::Cartridge(Core *core): core(core)
+{
+    // Prepare tasks to be used with the scheduler
+    for (int i = 0; i < 2; i++)
+        blockTask[i] = std::bind(&Cartridge::resumeBlock, this, i);
+}
 
 Cartridge::~Cartridge()
 {
@@ -29,24 +46,88 @@ Cartridge::~Cartridge()
     writeSave();
 
     // Free the ROM and save memory
-    if (ndsRom)  delete[] ndsRom;
+    freeRom(ndsRom, ndsRomSize, ndsRomMapped);
     if (ndsSave) delete[] ndsSave;
-    if (gbaRom)  delete[] gbaRom;
+    freeRom(gbaRom, gbaRomSize, gbaRomMapped);
     if (gbaSave) delete[] gbaSave;
+
+    // Close compressed ROM files, and the NDS ROM file if it's read on demand
+    if (ndsZiso) delete ndsZiso;
+    if (gbaZiso) delete gbaZiso;
+    if (ndsRomFile) fclose(ndsRomFile);
+}
+
+void Cartridge::syncState(Savestate *state)
+{
+    // Register the tasks so they can be referenced by ID
+    for (int i = 0; i < 2; i++)
+        state->addTask(&blockTask[i]);
+
+    // Sync the GBA save protocol state
+    // Save memory is kept in its own file, so it isn't part of the state
+    state->sync(gbaEepromCount);
+    state->sync(gbaEepromCmd);
+    state->sync(gbaEepromData);
+    state->sync(gbaEepromDone);
+    state->sync(gbaFlashCmd);
+    state->sync(gbaBankSwap);
+    state->sync(gbaFlashErase);
+
+    // Sync the NDS cartridge protocol state
+    state->sync(encTable);
+    state->sync(encCode);
+    state->sync(command);
+    state->sync(blockSize);
+    state->sync(readCount);
+    state->sync(blockPending);
+    state->sync(encrypted);
+    state->sync(auxCommand);
+    state->sync(auxAddress);
+    state->sync(auxWriteCount);
+
+    // Sync the registers
+    state->sync(auxSpiCnt);
+    state->sync(auxSpiData);
+    state->sync(romCtrl);
+    state->sync(romCmdOut);
 }
 
 void Cartridge::loadNdsRom(std::string path)
 {
     // Attempt to load an NDS ROM
     ndsRomName = path;
-    FILE *ndsRomFile = fopen(ndsRomName.c_str(), "rb");
-    if (!ndsRomFile) throw 2;
-    fseek(ndsRomFile, 0, SEEK_END);
-    ndsRomSize = ftell(ndsRomFile);
-    fseek(ndsRomFile, 0, SEEK_SET);
-    ndsRom = new uint8_t[ndsRomSize];
-    fread(ndsRom, sizeof(uint8_t), ndsRomSize, ndsRomFile);
-    fclose(ndsRomFile);
+    FILE *romFile = fopen(ndsRomName.c_str(), "rb");
+    if (!romFile) throw 2;
+
+    if (Ziso::detect(romFile))
+    {
+        // Decompress blocks of a compressed ROM as they're needed, starting with the header and secure area
+        // The buffer is left uninitialized, so the OS only commits memory for the parts that get decompressed
+        ndsZiso = new Ziso(romFile);
+        ndsRomSize = ndsZiso->getSize();
+        ndsRom = new uint8_t[ndsRomSize];
+        fetchNdsRom(0, 0x8000);
+    }
+    else
+    {
+        fseek(romFile, 0, SEEK_END);
+        ndsRomSize = ftell(romFile);
+        fseek(romFile, 0, SEEK_SET);
+        ndsRom = loadRom(romFile, ndsRomSize, &ndsRomMapped, true);
+
+        if (ndsRomMapped)
+        {
+            fclose(romFile);
+        }
+        else
+        {
+            // If the ROM can't be mapped, keep the file open and read blocks as they're needed, like a compressed ROM
+            // This way startup only reads the header, secure area, and initial code, no matter how big the ROM is
+            ndsRomFile = romFile;
+            ndsRomLoaded.assign((ndsRomSize + ROM_BLOCK - 1) / ROM_BLOCK, false);
+            fetchNdsRom(0, 0x8000);
+        }
+    }
 
     if (ndsRomSize > 0x8000) // ROM has secure area
     {
@@ -80,6 +161,7 @@ void Cartridge::loadNdsRom(std::string path)
 
     // Attempt to load the ROM's save file
     ndsSaveName = path.substr(0, path.rfind(".")) + ".sav";
+    ndsSaveWriter.setName(ndsSaveName);
     FILE *ndsSaveFile = fopen(ndsSaveName.c_str(), "rb");
     if (ndsSaveFile)
     {
@@ -105,15 +187,27 @@ void Cartridge::loadGbaRom(std::string path)
     gbaRomName = path;
     FILE *gbaRomFile = fopen(gbaRomName.c_str(), "rb");
     if (!gbaRomFile) throw 2;
-    fseek(gbaRomFile, 0, SEEK_END);
-    gbaRomSize = ftell(gbaRomFile);
-    fseek(gbaRomFile, 0, SEEK_SET);
-    gbaRom = new uint8_t[gbaRomSize];
-    fread(gbaRom, sizeof(uint8_t), gbaRomSize, gbaRomFile);
-    fclose(gbaRomFile);
+
+    if (Ziso::detect(gbaRomFile))
+    {
+        // Decompress a compressed ROM all at once, since the memory map accesses it directly
+        gbaZiso = new Ziso(gbaRomFile);
+        gbaRomSize = gbaZiso->getSize();
+        gbaRom = new uint8_t[gbaRomSize];
+        gbaZiso->fetch(gbaRom, 0, gbaRomSize);
+    }
+    else
+    {
+        fseek(gbaRomFile, 0, SEEK_END);
+        gbaRomSize = ftell(gbaRomFile);
+        fseek(gbaRomFile, 0, SEEK_SET);
+        gbaRom = loadRom(gbaRomFile, gbaRomSize, &gbaRomMapped);
+        fclose(gbaRomFile);
+    }
 
     // Attempt to load the ROM's save file
     gbaSaveName = path.substr(0, path.rfind(".")) + ".sav";
+    gbaSaveWriter.setName(gbaSaveName);
     FILE *gbaSaveFile = fopen(gbaSaveName.c_str(), "rb");
     if (gbaSaveFile)
     {
@@ -215,6 +309,10 @@ void Cartridge::directBoot()
     for (uint32_t i = 0; i < 0x170; i++)
         core->memory.write<uint8_t>(0, 0x27FFE00 + i, ndsRom[i]);
 
+    // Make sure the initial code is available if the ROM is compressed
+    fetchNdsRom(offset9, size9);
+    fetchNdsRom(offset7, size7);
+
     // Load the initial ARM9 code into memory
     for (uint32_t i = 0; i < size9; i++)
         core->memory.write<uint8_t>(0, ramAddr9 + i, ndsRom[offset9 + i]);
@@ -236,34 +334,148 @@ void Cartridge::directBoot()
 
 void Cartridge::writeSave()
 {
-    // Update the NDS save file if necessary
-    if (ndsSaveDirty)
+    // Write any changes to the save files and wait for them to finish
+    ndsSaveWriter.flush(ndsSave, ndsSaveSize);
+    gbaSaveWriter.flush(gbaSave, gbaSaveSize);
+}
+
+void Cartridge::updateSave()
+{
+    // Let the save writers queue changes in the background once they've settled
+    ndsSaveWriter.update(ndsSave, ndsSaveSize);
+    gbaSaveWriter.update(gbaSave, gbaSaveSize);
+}
+
+void Cartridge::backupSave()
+{
+    // Back up both saves before running frames that will be rolled back
+    backupSave(ndsSave, ndsSaveSize, &ndsSaveWriter, &ndsSaveBackup, &ndsBackupMarks);
+    backupSave(gbaSave, gbaSaveSize, &gbaSaveWriter, &gbaSaveBackup, &gbaBackupMarks);
+}
+
+void Cartridge::restoreSave()
+{
+    // Undo any writes to the saves since they were backed up
+    restoreSave(ndsSave, ndsSaveSize, &ndsSaveWriter, &ndsSaveBackup, &ndsBackupMarks);
+    restoreSave(gbaSave, gbaSaveSize, &gbaSaveWriter, &gbaSaveBackup, &gbaBackupMarks);
+}
+
+void Cartridge::backupSave(const uint8_t *save, int saveSize, SaveWriter *saveWriter, std::vector<uint8_t> *backup, uint32_t *marks)
+{
+    // Copy the save, unless the last backup is still current
+    if (!save || saveSize <= 0)
     {
-        FILE *ndsSaveFile = fopen(ndsSaveName.c_str(), "wb");
-        if (ndsSaveFile)
-        {
-            if (ndsSaveSize > 0)
-                fwrite(ndsSave, sizeof(uint8_t), ndsSaveSize, ndsSaveFile);
-            fclose(ndsSaveFile);
-            ndsSaveDirty = false;
-        }
+        backup->clear();
+        return;
     }
+    if (backup->size() == (uint32_t)saveSize && *marks == saveWriter->getMarks())
+        return;
+    backup->assign(save, save + saveSize);
+    *marks = saveWriter->getMarks();
+}
 
-    // Update the GBA save file if necessary
-    if (gbaSaveDirty)
+void Cartridge::restoreSave(uint8_t *save, int saveSize, SaveWriter *saveWriter, std::vector<uint8_t> *backup, uint32_t *marks)
+{
+    // Copy the backup over the save if it was written since, leaving it alone if it was resized or removed
+    // The pages marked by those writes are left dirty, which only makes the save writer rewrite the same data
+    if (*marks == saveWriter->getMarks() || !save || backup->size() != (uint32_t)saveSize)
+        return;
+    memcpy(save, &(*backup)[0], saveSize);
+    *marks = saveWriter->getMarks();
+}
+
+void Cartridge::trimNdsRom()
+{
+    // Compressed ROMs aren't trimmed, since that would overwrite them with uncompressed data
+    if (ndsZiso) return;
+
+    // Finish reading a ROM that's read on demand, and close it so the file can be rewritten
+    if (ndsRomFile)
     {
-        FILE *gbaSaveFile = fopen(gbaSaveName.c_str(), "wb");
-        if (gbaSaveFile)
+        fetchNdsRom(0, ndsRomSize);
+        fclose(ndsRomFile);
+        ndsRomFile = nullptr;
+    }
+
+    trimRom(&ndsRom, &ndsRomSize, &ndsRomName, &ndsRomMapped);
+}
+
+void Cartridge::trimGbaRom()
+{
+    // Trim the GBA ROM and remap it in case it moved
+    // Compressed ROMs aren't trimmed, since that would overwrite them with uncompressed data
+    if (gbaZiso) return;
+    trimRom(&gbaRom, &gbaRomSize, &gbaRomName, &gbaRomMapped);
+    if (core->isGbaMode())
+        core->memory.updateMap(1, 0x08000000, 0x0D000000);
+}
+
+uint8_t *Cartridge::loadRom(FILE *romFile, int romSize, bool *mapped, bool lazy)
+{
+#ifdef ROM_MMAP
+    // Map the ROM file into memory so pages are only read from disk once they're accessed
+    // The mapping is private, so changes like secure area decryption stay in memory and aren't written to the file
+    if (romSize > 0)
+    {
+        void *rom = mmap(nullptr, romSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(romFile), 0);
+        if (rom != MAP_FAILED)
         {
-            if (gbaSaveSize > 0)
-                fwrite(gbaSave, sizeof(uint8_t), gbaSaveSize, gbaSaveFile);
-            fclose(gbaSaveFile);
-            gbaSaveDirty = false;
+            *mapped = true;
+            return (uint8_t*)rom;
         }
     }
+#endif
+
+    // Fall back to reading the entire ROM into memory, unless the caller will read it on demand
+    // The buffer is left uninitialized in that case, so the OS only commits memory for the parts that get read
+    uint8_t *rom = new uint8_t[romSize];
+    if (!lazy) fread(rom, sizeof(uint8_t), romSize, romFile);
+    *mapped = false;
+    return rom;
 }
 
-void Cartridge::trimRom(uint8_t **rom, int *romSize, std::string *romName)
+void Cartridge::freeRom(uint8_t *rom, int romSize, bool mapped)
+{
+    if (!rom) return;
+
+#ifdef ROM_MMAP
+    // Unmap the ROM if it was mapped from its file
+    if (mapped)
+    {
+        munmap(rom, romSize);
+        return;
+    }
+#endif
+
+    delete[] rom;
+}
+
+void Cartridge::fetchNdsRom(uint32_t address, uint32_t size)
+{
+    // Decompress a range of the NDS ROM if it's compressed and hasn't been loaded yet
+    if (ndsZiso)
+    {
+        ndsZiso->fetch(ndsRom, address, size);
+        return;
+    }
+
+    // Read a range of the NDS ROM if it's read on demand and hasn't been loaded yet
+    uint32_t romSize = ndsRomSize;
+    if (!ndsRomFile || address >= romSize || size == 0) return;
+    uint32_t end = (size > romSize - address) ? romSize : (address + size);
+    for (uint32_t i = address / ROM_BLOCK; i <= (end - 1) / ROM_BLOCK; i++)
+    {
+        if (ndsRomLoaded[i]) continue;
+        uint32_t start = i * ROM_BLOCK;
+        uint32_t length = std::min<uint32_t>(romSize - start, ROM_BLOCK);
+        memset(&ndsRom[start], 0xFF, length);
+        fseek(ndsRomFile, start, SEEK_SET);
+        fread(&ndsRom[start], sizeof(uint8_t), length, ndsRomFile);
+        ndsRomLoaded[i] = true;
+    }
+}
+
+void Cartridge::trimRom(uint8_t **rom, int *romSize, std::string *romName, bool *mapped)
 {
     // Starting from the end, reduce the ROM size until a non-filler word is found
     int newSize;
@@ -276,11 +488,13 @@ void Cartridge::trimRom(uint8_t **rom, int *romSize, std::string *romName)
     if (newSize < *romSize)
     {
         // Update the ROM in memory
-        *romSize = newSize;
+        // A mapped ROM is copied out and unmapped first, since its pages can't be accessed once the file is truncated
         uint8_t *newRom = new uint8_t[newSize];
         memcpy(newRom, *rom, newSize * sizeof(uint8_t));
-        delete[] *rom;
+        freeRom(*rom, *romSize, *mapped);
+        *romSize = newSize;
         *rom = newRom;
+        *mapped = false;
 
         // Update the ROM file
         FILE *romFile = fopen(romName->c_str(), "wb");
@@ -293,7 +507,7 @@ void Cartridge::trimRom(uint8_t **rom, int *romSize, std::string *romName)
     }
 }
 
-void Cartridge::resizeSave(int newSize, uint8_t **save, int *saveSize, bool *saveDirty)
+void Cartridge::resizeSave(int newSize, uint8_t **save, int *saveSize, SaveWriter *saveWriter)
 {
     // Resize the save
     if (newSize > 0)
@@ -318,7 +532,7 @@ void Cartridge::resizeSave(int newSize, uint8_t **save, int *saveSize, bool *sav
     }
 
     *saveSize = newSize;
-    *saveDirty = true;
+    saveWriter->markAll();
 }
 
 uint8_t Cartridge::gbaEepromRead()
@@ -415,7 +629,7 @@ void Cartridge::gbaEepromWrite(uint8_t value)
             uint16_t addr = (gbaSaveSize == 0x200) ? ((gbaEepromCmd & 0x3F00) >> 8) : (gbaEepromCmd & 0x03FF);
             for (unsigned int i = 0; i < 8; i++)
                 gbaSave[addr * 8 + i] = gbaEepromData >> (i * 8);
-            gbaSaveDirty = true;
+            gbaSaveWriter.mark(addr * 8, 8);
 
             // Reset the transfer
             gbaEepromCount = 0;
@@ -463,7 +677,7 @@ void Cartridge::gbaSramWrite(uint32_t address, uint8_t value)
     {
         // Write a single byte because the data bus is only 8 bits
         gbaSave[address - 0xE000000] = value;
-        gbaSaveDirty = true;
+        gbaSaveWriter.mark(address - 0xE000000);
     }
     else if ((gbaSaveSize == 0x10000 || gbaSaveSize == 0x20000) && address < 0xE010000) // FLASH
     {
@@ -473,7 +687,7 @@ void Cartridge::gbaSramWrite(uint32_t address, uint8_t value)
             // Write a single byte
             if (gbaBankSwap) address += 0x10000;
             gbaSave[address - 0xE000000] = value;
-            gbaSaveDirty = true;
+            gbaSaveWriter.mark(address - 0xE000000);
             gbaFlashCmd = 0xF0;
         }
         else if (gbaFlashErase && (address & ~0x000F000) == 0xE000000 && (value & 0xFF) == 0x30)
@@ -481,7 +695,7 @@ void Cartridge::gbaSramWrite(uint32_t address, uint8_t value)
             // Erase a sector
             if (gbaBankSwap) address += 0x10000;
             memset(&gbaSave[address - 0xE000000], 0xFF, 0x1000 * sizeof(uint8_t));
-            gbaSaveDirty = true;
+            gbaSaveWriter.mark(address - 0xE000000, 0x1000);
             gbaFlashErase = false;
         }
         else if (gbaSaveSize == 0x20000 && gbaFlashCmd == 0xB0 && address == 0xE000000)
@@ -507,7 +721,7 @@ void Cartridge::gbaSramWrite(uint32_t address, uint8_t value)
             else if (gbaFlashErase && gbaFlashCmd == 0x10)
             {
                 memset(gbaSave, 0xFF, gbaSaveSize * sizeof(uint8_t));
-                gbaSaveDirty = true;
+                gbaSaveWriter.mark(0, gbaSaveSize);
             }
         }
     }
@@ -559,6 +773,15 @@ uint64_t Cartridge::decrypt64(uint64_t value)
 
 void Cartridge::initKeycode(int level)
 {
+    // Reuse the table from the last time this level was initialized, since it only depends on the BIOS and game code
+    // KEY1 commands initialize it for every command during a firmware boot, which otherwise adds up
+    if (!keyCache[level].empty())
+    {
+        memcpy(encTable, &keyCache[level][0], sizeof(encTable));
+        memcpy(encCode, &keyCache[level][0x412], sizeof(encCode));
+        return;
+    }
+
     // Initialize the Blowfish encryption table
     // This is a translation of the pseudocode from GBATEK to C++
 
@@ -578,6 +801,10 @@ void Cartridge::initKeycode(int level)
     encCode[2] /= 2;
 
     if (level >= 3) applyKeycode();
+
+    // Cache the result for the next time
+    keyCache[level].assign(encTable, encTable + 0x412);
+    keyCache[level].insert(keyCache[level].end(), encCode, encCode + 3);
 }
 
 void Cartridge::applyKeycode()
@@ -700,7 +927,7 @@ void Cartridge::writeAuxSpiData(bool cpu, uint8_t value)
                             if (auxAddress[cpu] < 0x200)
                             {
                                 ndsSave[auxAddress[cpu]] = value;
-                                ndsSaveDirty = true;
+                                ndsSaveWriter.mark(auxAddress[cpu]);
                             }
 
                             auxAddress[cpu]++;
@@ -723,7 +950,7 @@ void Cartridge::writeAuxSpiData(bool cpu, uint8_t value)
                             if (auxAddress[cpu] < 0x200)
                             {
                                 ndsSave[auxAddress[cpu]] = value;
-                                ndsSaveDirty = true;
+                                ndsSaveWriter.mark(auxAddress[cpu]);
                             }
 
                             auxAddress[cpu]++;
@@ -779,7 +1006,7 @@ void Cartridge::writeAuxSpiData(bool cpu, uint8_t value)
                             if (auxAddress[cpu] < ndsSaveSize)
                             {
                                 ndsSave[auxAddress[cpu]] = value;
-                                ndsSaveDirty = true;
+                                ndsSaveWriter.mark(auxAddress[cpu]);
                             }
 
                             auxAddress[cpu]++;
@@ -833,7 +1060,7 @@ void Cartridge::writeAuxSpiData(bool cpu, uint8_t value)
                             if (auxAddress[cpu] < ndsSaveSize)
                             {
                                 ndsSave[auxAddress[cpu]] = value;
-                                ndsSaveDirty = true;
+                                ndsSaveWriter.mark(auxAddress[cpu]);
                             }
 
                             auxAddress[cpu]++;
@@ -893,6 +1120,9 @@ void Cartridge::writeRomCtrl(bool cpu, uint32_t mask, uint32_t value)
 
     if (!transfer) return;
 
+    // Cancel any words still pending from a bulk read of the last block
+    blockPending[cpu] = false;
+
     // Determine the size of the block to transfer
     uint8_t size = (romCtrl[cpu] & 0x07000000) >> 24;
     switch (size)
@@ -928,6 +1158,11 @@ void Cartridge::writeRomCtrl(bool cpu, uint32_t mask, uint32_t value)
             // On hardware, this is where KEY2 encryption would start
             encrypted[cpu] = false;
         }
+        else if ((command[cpu] & 0xFF00000000FFFFFF) == 0xB700000000000000) // Get data
+        {
+            // Decompress the data for the transfer ahead of time if the ROM is compressed
+            fetchNdsRom((command[cpu] & 0x00FFFFFFFF000000) >> 24, blockSize[cpu]);
+        }
     }
 
     if (blockSize[cpu] == 0)
@@ -958,6 +1193,69 @@ uint32_t Cartridge::readRomDataIn(bool cpu)
     if (!(romCtrl[cpu] & BIT(23)))
         return 0;
 
+    // Read a word, and either end the transfer or trigger DMA for the next one
+    uint32_t value = readRomWord(cpu);
+    finishWords(cpu);
+    return value;
+}
+
+unsigned int Cartridge::readRomBlock(bool cpu, uint32_t *data, unsigned int count)
+{
+    // Don't transfer if the word ready bit isn't set
+    if (!(romCtrl[cpu] & BIT(23)))
+        return 0;
+
+    // Read up to the given number of words that are left in the block at once
+    count = std::min(count, (unsigned int)(blockSize[cpu] - readCount[cpu]) >> 2);
+    for (unsigned int i = 0; i < count; i++)
+        data[i] = readRomWord(cpu);
+
+    // Words read one at a time by DMA arrive a cycle apart
+    // Hold the next word or the end of the block until the last of these words would have arrived, so games see the same timing
+    if (count > 1)
+    {
+        romCtrl[cpu] &= ~BIT(23); // Word not ready
+        blockPending[cpu] = true;
+        core->schedule(Task(&blockTask[cpu], count - 1));
+    }
+    else
+    {
+        finishWords(cpu);
+    }
+
+    return count;
+}
+
+void Cartridge::resumeBlock(bool cpu)
+{
+    // Continue once the words from a bulk read would have arrived, unless a new transfer was started in the meantime
+    if (!blockPending[cpu]) return;
+    blockPending[cpu] = false;
+    finishWords(cpu);
+}
+
+void Cartridge::finishWords(bool cpu)
+{
+    if (readCount[cpu] == blockSize[cpu])
+    {
+        // End the transfer when the block size has been reached
+        romCtrl[cpu] &= ~BIT(23); // Word not ready
+        romCtrl[cpu] &= ~BIT(31); // Block ready
+
+        // Trigger a block ready IRQ if enabled
+        if (auxSpiCnt[cpu] & BIT(14))
+            core->interpreter[cpu].sendInterrupt(19);
+    }
+    else
+    {
+        // Indicate that a word is ready and trigger DS cartridge DMA transfers until the block size is reached
+        romCtrl[cpu] |= BIT(23);
+        core->dma[cpu].trigger((cpu == 0) ? 5 : 2);
+    }
+}
+
+uint32_t Cartridge::readRomWord(bool cpu)
+{
     // Endless 0xFFs are returned on a dummy command or when no cart is inserted
     uint32_t value = 0xFFFFFFFF;
 
@@ -1032,22 +1330,5 @@ uint32_t Cartridge::readRomDataIn(bool cpu)
     }
 
     readCount[cpu] += 4;
-
-    if (readCount[cpu] == blockSize[cpu])
-    {
-        // End the transfer when the block size has been reached
-        romCtrl[cpu] &= ~BIT(23); // Word not ready
-        romCtrl[cpu] &= ~BIT(31); // Block ready
-
-        // Trigger a block ready IRQ if enabled
-        if (auxSpiCnt[cpu] & BIT(14))
-            core->interpreter[cpu].sendInterrupt(19);
-    }
-    else
-    {
-        // Trigger DS cartridge DMA transfers until the block size is reached
-        core->dma[cpu].trigger((cpu == 0) ? 5 : 2);
-    }
-
     return value;
 }
@@ -21,26 +21,38 @@
 #define CARTRIDGE_H
 
 #include <cstdint>
+#include <cstdio>
+#include <functional>
 #include <string>
+#include <vector>
+
+#include "save_writer.h"
 
 class Core;
+class Ziso;
+class Savestate;
 
 class Cartridge
 {
     public:
-        Cartridge(Core *core): core(core) {}
+        Cartridge(Core *core);
         ~Cartridge();
 
+        void syncState(Savestate *state);
+
         void loadNdsRom(std::string path);
         void loadGbaRom(std::string path);
         void directBoot();
         void writeSave();
+        void updateSave();
+        void backupSave();
+        void restoreSave();
 
-        void trimNdsRom() { trimRom(&ndsRom, &ndsRomSize, &ndsRomName); }
-        void trimGbaRom() { trimRom(&gbaRom, &gbaRomSize, &gbaRomName); }
+        void trimNdsRom();
+        void trimGbaRom();
 
-        void resizeNdsSave(int newSize) { resizeSave(newSize, &ndsSave, &ndsSaveSize, &ndsSaveDirty); }
-        void resizeGbaSave(int newSize) { resizeSave(newSize, &gbaSave, &gbaSaveSize, &gbaSaveDirty); }
+        void resizeNdsSave(int newSize) { resizeSave(newSize, &ndsSave, &ndsSaveSize, &ndsSaveWriter); }
+        void resizeGbaSave(int newSize) { resizeSave(newSize, &gbaSave, &gbaSaveSize, &gbaSaveWriter); }
 
         int getNdsRomSize()  { return ndsRomSize;  }
         int getNdsSaveSize() { return ndsSaveSize; }
@@ -64,6 +76,7 @@ class Cartridge
         uint8_t  readAuxSpiData(bool cpu) { return auxSpiData[cpu]; }
         uint32_t readRomCtrl(bool cpu)    { return romCtrl[cpu];    }
         uint32_t readRomDataIn(bool cpu);
+        unsigned int readRomBlock(bool cpu, uint32_t *data, unsigned int count);
 
         void writeAuxSpiCnt(bool cpu, uint16_t mask, uint16_t value);
         void writeAuxSpiData(bool cpu, uint8_t value);
@@ -77,12 +90,18 @@ class Cartridge
         std::string gbaRomName, gbaSaveName;
         uint8_t *gbaRom = nullptr, *gbaSave = nullptr;
         int gbaRomSize = 0, gbaSaveSize = 0;
-        bool gbaSaveDirty = false;
+        bool gbaRomMapped = false;
+        Ziso *gbaZiso = nullptr;
+        SaveWriter gbaSaveWriter;
 
         std::string ndsRomName, ndsSaveName;
         uint8_t *ndsRom = nullptr, *ndsSave = nullptr;
         int ndsRomSize = 0, ndsSaveSize = 0;
-        bool ndsSaveDirty = false;
+        bool ndsRomMapped = false;
+        Ziso *ndsZiso = nullptr;
+        FILE *ndsRomFile = nullptr;
+        std::vector<bool> ndsRomLoaded;
+        SaveWriter ndsSaveWriter;
 
         int gbaEepromCount = 0;
         uint16_t gbaEepromCmd = 0;
@@ -95,6 +114,12 @@ class Cartridge
 
         uint32_t encTable[0x412] = {};
         uint32_t encCode[3] = {};
+        std::vector<uint32_t> keyCache[4];
+
+        // Save memory isn't part of savestates, so it's backed up separately before frames that will be rolled back
+        // Each backup is only copied again once the save has been written, since it usually stays the same for a while
+        std::vector<uint8_t> ndsSaveBackup, gbaSaveBackup;
+        uint32_t ndsBackupMarks = 0, gbaBackupMarks = 0;
 
         uint64_t command[2] = {};
         int blockSize[2] = {}, readCount[2] = {};
@@ -109,8 +134,21 @@ class Cartridge
         uint32_t romCtrl[2] = {};
         uint64_t romCmdOut[2] = {};
 
-        static void trimRom(uint8_t **rom, int *romSize, std::string *romName);
-        static void resizeSave(int newSize, uint8_t **save, int *saveSize, bool *saveDirty);
+        bool blockPending[2] = {};
+        std::function<void()> blockTask[2];
+
+        static uint8_t *loadRom(FILE *romFile, int romSize, bool *mapped, bool lazy = false);
+        static void freeRom(uint8_t *rom, int romSize, bool mapped);
+        static void trimRom(uint8_t **rom, int *romSize, std::string *romName, bool *mapped);
+        static void resizeSave(int newSize, uint8_t **save, int *saveSize, SaveWriter *saveWriter);
+        static void backupSave(const uint8_t *save, int saveSize, SaveWriter *saveWriter, std::vector<uint8_t> *backup, uint32_t *marks);
+        static void restoreSave(uint8_t *save, int saveSize, SaveWriter *saveWriter, std::vector<uint8_t> *backup, uint32_t *marks);
+
+        void fetchNdsRom(uint32_t address, uint32_t size);
+
+        uint32_t readRomWord(bool cpu);
+        void resumeBlock(bool cpu);
+        void finishWords(bool cpu);
 
         uint64_t encrypt64(uint64_t value);
         uint64_t decrypt64(uint64_t value);
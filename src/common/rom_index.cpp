@@ -0,0 +1,297 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "rom_index.h"
+#include "nds_icon.h"
+
+#define INDEX_MAGIC 0x5844494E // NIDX
+#define INDEX_VERSION 1
+
+static void writeString(FILE *file, const std::string &str)
+{
+    uint16_t length = str.size();
+    fwrite(&length, sizeof(uint16_t), 1, file);
+    fwrite(str.data(), sizeof(char), length, file);
+}
+
+static bool readString(FILE *file, std::string *str)
+{
+    uint16_t length;
+    if (fread(&length, sizeof(uint16_t), 1, file) != 1) return false;
+    str->resize(length);
+    return length == 0 || fread(&(*str)[0], sizeof(char), length, file) == length;
+}
+
+RomIndex::RomIndex(std::string path): path(path)
+{
+    load();
+}
+
+RomIndex::~RomIndex()
+{
+    // Stop the scan thread, dropping any directories that haven't been scanned yet
+    if (thread)
+    {
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            running = false;
+            dirs.clear();
+        }
+        cond.notify_one();
+        thread->join();
+        delete thread;
+    }
+
+    save();
+}
+
+bool RomIndex::isNdsRom(const std::string &name)
+{
+    return name.length() >= 4 && name.find(".nds", name.length() - 4) != std::string::npos;
+}
+
+bool RomIndex::getStats(std::string filePath, int64_t *modified, uint64_t *size, bool *isDir)
+{
+    // Get the modification time and size of a file, which decide if its entry is still valid
+    struct stat st;
+    if (::stat(filePath.c_str(), &st) != 0) return false;
+    *modified = st.st_mtime;
+    *size = st.st_size;
+    if (isDir) *isDir = S_ISDIR(st.st_mode);
+    return true;
+}
+
+void RomIndex::decode(std::string romPath, RomInfo *info)
+{
+    // Decode the icon
+    NdsIcon icon(romPath);
+    memcpy(info->icon, icon.getIcon(), sizeof(info->icon));
+
+    FILE *rom = fopen(romPath.c_str(), "rb");
+    if (!rom) return;
+
+    // Get the game title and code from the header
+    char header[0x10] = {};
+    uint32_t offset = 0;
+    fread(header, sizeof(char), 0x10, rom);
+    fseek(rom, 0x68, SEEK_SET);
+    fread(&offset, sizeof(uint32_t), 1, rom);
+    info->gameTitle = std::string(header, 12).c_str();
+    info->gameCode = std::string(&header[12], 4).c_str();
+
+    // Get the English title from the banner, converting it from UTF-16 to UTF-8
+    uint16_t title[128] = {};
+    if (offset)
+    {
+        fseek(rom, offset + 0x340, SEEK_SET);
+        fread(title, sizeof(uint16_t), 128, rom);
+    }
+    fclose(rom);
+
+    info->title = "";
+    for (int i = 0; i < 128 && title[i]; i++)
+    {
+        uint16_t c = title[i];
+        if (c < 0x80)
+        {
+            info->title += (char)c;
+        }
+        else if (c < 0x800)
+        {
+            info->title += (char)(0xC0 | (c >> 6));
+            info->title += (char)(0x80 | (c & 0x3F));
+        }
+        else
+        {
+            info->title += (char)(0xE0 | (c >> 12));
+            info->title += (char)(0x80 | ((c >> 6) & 0x3F));
+            info->title += (char)(0x80 | (c & 0x3F));
+        }
+    }
+}
+
+bool RomIndex::get(std::string romPath, RomInfo *info)
+{
+    // Get the current size and modification time of the ROM
+    int64_t modified;
+    uint64_t size;
+    if (!getStats(romPath, &modified, &size))
+        return false;
+
+    {
+        // Use the indexed entry if the file hasn't changed since it was decoded
+        std::lock_guard<std::mutex> guard(mutex);
+        std::unordered_map<std::string, RomInfo>::iterator entry = entries.find(romPath);
+        if (entry != entries.end() && entry->second.modified == modified && entry->second.size == size)
+        {
+            *info = entry->second;
+            return true;
+        }
+    }
+
+    // Decode the ROM and add it to the index
+    decode(romPath, info);
+    info->modified = modified;
+    info->size = size;
+    std::lock_guard<std::mutex> guard(mutex);
+    entries[romPath] = *info;
+    dirty = true;
+    return true;
+}
+
+void RomIndex::scan(std::string dirPath)
+{
+    // Queue a directory to be indexed in the background, starting the thread if it isn't running
+    std::lock_guard<std::mutex> guard(mutex);
+    dirs.push_back(dirPath);
+    if (!thread)
+    {
+        running = true;
+        thread = new std::thread(&RomIndex::runScans, this);
+    }
+    cond.notify_one();
+}
+
+void RomIndex::runScans()
+{
+    while (true)
+    {
+        // Wait for a directory to be queued
+        std::string dirPath;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [&] { return !running || !dirs.empty(); });
+            if (!running) return;
+            dirPath = dirs.front();
+            dirs.pop_front();
+        }
+
+        // Index the ROMs in the directory and the directories inside it, since those are the ones that can be opened next
+        std::deque<std::string> pending(1, dirPath);
+        for (int depth = 0; depth < 2 && !pending.empty(); depth++)
+        {
+            std::deque<std::string> subdirs;
+            while (!pending.empty())
+            {
+                DIR *dir = opendir(pending.front().c_str());
+                std::string base = pending.front();
+                pending.pop_front();
+                if (!dir) continue;
+
+                while (dirent *entry = readdir(dir))
+                {
+                    // Stop early if the index is being closed
+                    {
+                        std::lock_guard<std::mutex> guard(mutex);
+                        if (!running) break;
+                    }
+
+                    std::string name = entry->d_name;
+                    if (name == "." || name == "..") continue;
+                    std::string filePath = base + "/" + name;
+
+                    int64_t modified;
+                    uint64_t size;
+                    bool isDir;
+                    if (!getStats(filePath, &modified, &size, &isDir))
+                        continue;
+
+                    if (isDir)
+                    {
+                        subdirs.push_back(filePath);
+                    }
+                    else if (isNdsRom(name))
+                    {
+                        RomInfo info;
+                        get(filePath, &info);
+                    }
+                }
+
+                closedir(dir);
+            }
+            pending = subdirs;
+        }
+
+        // Write the new entries once a scan is done, so they're kept even if the frontend doesn't exit cleanly
+        save();
+    }
+}
+
+void RomIndex::load()
+{
+    // Read the index file if it exists
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) return;
+
+    // Ignore files that are invalid or from a different version
+    uint32_t header[3] = {};
+    if (fread(header, sizeof(uint32_t), 3, file) != 3 || header[0] != INDEX_MAGIC || header[1] != INDEX_VERSION)
+    {
+        fclose(file);
+        return;
+    }
+
+    // Read the entries, stopping at the first incomplete one
+    for (uint32_t i = 0; i < header[2]; i++)
+    {
+        std::string romPath;
+        RomInfo info;
+        if (!readString(file, &romPath) ||
+            fread(&info.modified, sizeof(int64_t), 1, file) != 1 ||
+            fread(&info.size, sizeof(uint64_t), 1, file) != 1 ||
+            fread(info.icon, sizeof(uint32_t), 32 * 32, file) != 32 * 32 ||
+            !readString(file, &info.title) || !readString(file, &info.gameTitle) || !readString(file, &info.gameCode))
+            break;
+        entries[romPath] = info;
+    }
+
+    fclose(file);
+}
+
+void RomIndex::save()
+{
+    // Write the index file if anything changed since it was last written
+    std::lock_guard<std::mutex> guard(mutex);
+    if (!dirty) return;
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) return;
+
+    uint32_t header[3] = { INDEX_MAGIC, INDEX_VERSION, (uint32_t)entries.size() };
+    fwrite(header, sizeof(uint32_t), 3, file);
+
+    for (std::unordered_map<std::string, RomInfo>::iterator entry = entries.begin(); entry != entries.end(); entry++)
+    {
+        writeString(file, entry->first);
+        fwrite(&entry->second.modified, sizeof(int64_t), 1, file);
+        fwrite(&entry->second.size, sizeof(uint64_t), 1, file);
+        fwrite(entry->second.icon, sizeof(uint32_t), 32 * 32, file);
+        writeString(file, entry->second.title);
+        writeString(file, entry->second.gameTitle);
+        writeString(file, entry->second.gameCode);
+    }
+
+    fclose(file);
+    dirty = false;
+}
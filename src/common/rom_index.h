@@ -0,0 +1,75 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef ROM_INDEX_H
+#define ROM_INDEX_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+struct RomInfo
+{
+    int64_t modified = 0;
+    uint64_t size = 0;
+
+    uint32_t icon[32 * 32] = {};
+    std::string title;
+    std::string gameTitle;
+    std::string gameCode;
+};
+
+// A persistent index of NDS ROM icons and header fields, so file browsers don't have to reopen every ROM
+// Entries are keyed by path, and are decoded again if a file's size or modification time changes
+// Directories can be indexed in the background, so they're ready by the time they're opened
+class RomIndex
+{
+    public:
+        RomIndex(std::string path);
+        ~RomIndex();
+
+        bool get(std::string romPath, RomInfo *info);
+        void scan(std::string dirPath);
+        void save();
+
+    private:
+        std::string path;
+        std::unordered_map<std::string, RomInfo> entries;
+        bool dirty = false;
+
+        std::thread *thread = nullptr;
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::deque<std::string> dirs;
+        bool running = false;
+
+        static bool isNdsRom(const std::string &name);
+        static bool getStats(std::string filePath, int64_t *modified, uint64_t *size, bool *isDir = nullptr);
+        static void decode(std::string romPath, RomInfo *info);
+
+        void load();
+        void runScans();
+};
+
+#endif // ROM_INDEX_H
@@ -18,25 +18,41 @@
 */
 
 #include <algorithm>
+#include <cstdio>
 #include <cstring>
 #include <thread>
 
 #include "core.h"
-#include "settings.h"
 
-Core::Core(std::string ndsPath, std::string gbaPath):
+Core::Core(std::string ndsPath, std::string gbaPath, const Config &config): config(config),
     cartridge(this), cp15(this), divSqrt(this), dldi(this), dma { Dma(this, 0), Dma(this, 1) }, gpu(this), gpu2D { Gpu2D(this, 0),
-    Gpu2D(this, 1) }, gpu3D(this), gpu3DRenderer(this), input(this), interpreter { Interpreter(this, 0), Interpreter(this, 1) },
-    ipc(this), memory(this), rtc(this), spi(this), spu(this), timers { Timers(this, 0), Timers(this, 1) }, wifi(this)
+    Gpu2D(this, 1) }, gpu3D(this), gpu3DRenderer(this), hleBios { HleBios(this, 0), HleBios(this, 1) }, input(this),
+    interpreter { { this, false }, { this, true } }, ipc(this), memory(this), movie(this), rewind(this), rtc(this),
+    runAhead(this), spi(this), spu(this), telemetry(this), timers { Timers(this, 0), Timers(this, 1) }, wifi(this)
 {
+    // Run the CPUs in blocks of pre-decoded calls to the interpreter's handlers if enabled
+    if (config.callBlocks)
+        callBlocks = interpreter[0].initCallBlocks() && interpreter[1].initCallBlocks();
+
+    // Run the CPUs in slices between tasks if enabled, rather than interleaving every cycle
+    batchCpus = config.batchCpus;
+
+    arm7Slice = arm7Done = sliceEnd = 0;
+    arm7Running = arm7Sleeping = false;
+
+    // Build the initial memory maps
+    memory.updateMap(0, 0x00000000, 0x10000000);
+    memory.updateMap(1, 0x00000000, 0x10000000);
+
     // Schedule initial tasks for NDS mode
     resetCyclesTask = std::bind(&Core::resetCycles, this);
     schedule(Task(&resetCyclesTask, 0x7FFFFFFF));
     gpu.scheduleInit();
     spu.scheduleInit();
+    wifi.schedulePoll();
 
     // Load the NDS BIOS and firmware unless directly booting a GBA ROM
-    if (ndsPath != "" || gbaPath == "" || !Settings::getDirectBoot())
+    if (ndsPath != "" || gbaPath == "" || !config.directBoot)
     {
         memory.loadBios();
         spi.loadFirmware();
@@ -48,7 +64,7 @@ Core::Core(std::string ndsPath, std::string gbaPath):
         cartridge.loadNdsRom(ndsPath);
 
         // Prepare to boot the NDS ROM directly if direct boot is enabled
-        if (Settings::getDirectBoot())
+        if (config.directBoot)
         {
             // Set some registers as the BIOS/firmware would
             cp15.write(1, 0, 0, 0x0005707D); // CP15 Control
@@ -81,19 +97,150 @@ Core::Core(std::string ndsPath, std::string gbaPath):
     if (gbaPath != "")
     {
         // Load the GBA BIOS unless directly booting an NDS ROM
-        if (ndsPath == "" || !Settings::getDirectBoot())
+        if (ndsPath == "" || !config.directBoot)
             memory.loadGbaBios();
 
         // Load a GBA ROM
         cartridge.loadGbaRom(gbaPath);
 
         // Enable GBA mode right away if direct boot is enabled
-        if (ndsPath == "" && Settings::getDirectBoot())
+        if (ndsPath == "" && config.directBoot)
         {
             memory.write<uint16_t>(0, 0x4000304, 0x8003); // POWCNT1
             enterGbaMode();
         }
     }
+
+    // Run the ARM7 slices on a separate thread if enabled, which only works in batched mode
+    // This is done last, since loading files can throw and the destructor wouldn't be there to stop the thread
+    if (batchCpus && !callBlocks && config.threadedArm7)
+    {
+        arm7Window = std::max(config.arm7Window, 1);
+        arm7Running = true;
+        arm7Thread = new std::thread(&Core::runArm7Thread, this, config.pinThreads);
+    }
+}
+
+Core::~Core()
+{
+    // Stop the ARM7 thread if it's running
+    if (arm7Thread)
+    {
+        arm7Running = false;
+        arm7Slice++;
+        {
+            std::lock_guard<std::mutex> guard(sliceMutex);
+            sliceCond.notify_one();
+        }
+        arm7Thread->join();
+        delete arm7Thread;
+    }
+}
+
+void Core::setConfig(const Config &config)
+{
+    // Hold the new settings until the core takes them, since the thread running it could be reading the current ones
+    std::lock_guard<std::mutex> guard(configMutex);
+    pendingConfig = config;
+    configPending.store(true);
+}
+
+void Core::applyConfig()
+{
+    // Take the settings a frontend passed in since the last frame, if any
+    if (!configPending.load()) return;
+    std::lock_guard<std::mutex> guard(configMutex);
+    config = pendingConfig;
+    configPending.store(false);
+
+    // Pass along the settings that the audio thread uses, since it can't read these directly
+    spu.updateConfig();
+}
+
+void Core::runFrame()
+{
+    // Apply any new settings before the frame starts
+    applyConfig();
+
+    // Place the thread running the core whenever it changes, like when a frontend restarts its emulation thread
+    if (config.pinThreads && std::this_thread::get_id() != placedThread)
+    {
+        placedThread = std::this_thread::get_id();
+        ThreadPlacement::place(THREAD_CORE);
+    }
+
+    // Run a frame in the current mode, letting an active movie handle its input and output
+    // The frontend's input is sampled again once the game first reads it
+    // Telemetry times the frame from here, so its interval covers everything the frontend does between frames
+    telemetry.startFrame();
+    input.startFrame();
+    if (movie.isActive()) movie.startFrame();
+    (this->*runFunc)();
+    if (movie.isActive()) movie.finishFrame();
+    telemetry.finishFrame();
+}
+
+size_t Core::getFootprint()
+{
+    // Estimate the memory used by the core, including buffers that are only allocated once they're needed
+    size_t size = sizeof(Core) + gpu3DRenderer.getFootprint();
+    if (gpu2D[0].getEffects3D())
+        size += 256 * 192 * sizeof(uint64_t);
+    return size;
+}
+
+std::unique_lock<std::recursive_mutex> Core::syncCpus(int cpu)
+{
+    // Lock access to state shared between the CPUs if they're running on separate threads
+    if (!arm7Thread)
+        return std::unique_lock<std::recursive_mutex>();
+    std::unique_lock<std::recursive_mutex> lock(sharedMutex, std::try_to_lock);
+
+    if (cpu == 1)
+    {
+        // Let the ARM7 be paused while it waits, since the ARM9 might hold the lock when it asks for a pause
+        while (!lock.owns_lock())
+        {
+            holdArm7();
+            std::this_thread::yield();
+            lock.try_lock();
+        }
+    }
+    else if (!lock.owns_lock())
+    {
+        lock.lock();
+    }
+    return lock;
+}
+
+void Core::pauseArm7()
+{
+    // Stop the ARM7 between opcodes so the ARM9 can change how it sees memory
+    // Nothing needs to wait if the ARM7 isn't on its own thread, has already finished its slice, or is the one asking
+    if (!arm7Thread || std::this_thread::get_id() == arm7Thread->get_id()) return;
+    arm7Pause.store(true);
+    while (arm7Done.load(std::memory_order_acquire) != arm7Slice.load(std::memory_order_relaxed) &&
+        !arm7Paused.load(std::memory_order_acquire))
+        std::this_thread::yield();
+}
+
+void Core::resumeArm7()
+{
+    // Let the ARM7 continue, and wait for it to leave the pause so a new one isn't mistaken for the old one
+    if (!arm7Thread || std::this_thread::get_id() == arm7Thread->get_id()) return;
+    arm7Pause.store(false, std::memory_order_release);
+    while (arm7Paused.load(std::memory_order_acquire))
+        std::this_thread::yield();
+}
+
+void Core::holdArm7()
+{
+    // Wait in place on the ARM7 thread while the ARM9 has it paused
+    if (!arm7Pause.load(std::memory_order_acquire)) return;
+    arm7Paused.store(true, std::memory_order_release);
+    while (arm7Pause.load(std::memory_order_acquire))
+        std::this_thread::yield();
+    arm7Paused.store(false, std::memory_order_release);
 }
 
 void Core::resetCycles()
@@ -103,35 +250,93 @@ void Core::resetCycles()
         tasks[i].cycles -= globalCycles;
     timers[0].resetCycles();
     timers[1].resetCycles();
+    divSqrt.resetCycles();
+    gpu3D.resetCycles();
+    spu.resetCycles();
+    wifi.resetCycles();
+    for (int i = 0; i < 2; i++)
+        cpuCycles[i] = (cpuCycles[i] > globalCycles) ? (cpuCycles[i] - globalCycles) : 0;
     globalCycles -= globalCycles;
     schedule(Task(&resetCyclesTask, 0x7FFFFFFF));
 }
 
 void Core::runGbaFrame()
 {
+    // Start counting for the profiler, if enabled
+    profiler.startFrame();
+
     // Run a frame in GBA mode
     while (frameCycles < 228 * 308 * 4) // 228 scanlines, 308 dots, 4 ARM7 cycles
     {
-        // Run the ARM7
-        if ((frameCycles & 1) && interpreter[1].shouldRun())
-            interpreter[1].runOpcode();
+        uint32_t i;
+
+        if (callBlocks)
+        {
+            // Run a block on the ARM7 once it has caught up to the current cycle
+            // Each ARM7 cycle counts for 2 cycles, matching the interpreter timing, and blocks stop at the next task
+            if (interpreter[1].shouldRun() && cpuCycles[1] <= globalCycles)
+            {
+                uint32_t opcodes;
+                cpuCycles[1] = globalCycles + interpreter[1].runBlock((tasks[0].cycles - globalCycles + 1) / 2, &opcodes) * 2;
+                profiler.add(COUNTER_ARM7_OPCODES, opcodes);
+            }
+
+            // Jump to the end of the block or to the next task, whichever comes first
+            uint32_t next = (interpreter[1].shouldRun() && cpuCycles[1] < tasks[0].cycles) ? cpuCycles[1] : tasks[0].cycles;
+            i = (next > globalCycles) ? (next - globalCycles) : 1;
+        }
+        else if (batchCpus)
+        {
+            // Run the ARM7 in a slice up to the next task, with each ARM7 cycle counting for 2 cycles
+            // The slice ends early if the ARM7 halts or schedules a task that comes sooner
+            if (cpuCycles[1] < globalCycles) cpuCycles[1] = globalCycles;
+            uint32_t opcodes = 0;
+            while (interpreter[1].shouldRun() && cpuCycles[1] < tasks[0].cycles)
+            {
+                cpuCycles[1] += interpreter[1].runOpcode() * 2;
+                opcodes++;
+            }
+            profiler.add(COUNTER_ARM7_OPCODES, opcodes);
+
+            // Jump to the next task
+            i = tasks[0].cycles - globalCycles;
+        }
+        else
+        {
+            // Run the ARM7 once it has caught up to the current cycle, with each ARM7 cycle counting for 2 cycles
+            if (interpreter[1].shouldRun() && cpuCycles[1] <= globalCycles)
+            {
+                cpuCycles[1] = globalCycles + interpreter[1].runOpcode() * 2;
+                profiler.add(COUNTER_ARM7_OPCODES);
+            }
+
+            // Jump to the ARM7's next opcode or to the next task, whichever comes first
+            uint32_t next = (interpreter[1].shouldRun() && cpuCycles[1] < tasks[0].cycles) ? cpuCycles[1] : tasks[0].cycles;
+            i = (next > globalCycles) ? (next - globalCycles) : 1;
+        }
 
-        // Count a cycle if a CPU is running, otherwise jump to the next task
-        uint32_t i = interpreter[1].shouldRun() ? 1 : (tasks[0].cycles - globalCycles);
         frameCycles += i;
         globalCycles += i;
 
         // Run any tasks that are scheduled now
-        while (tasks[0].cycles <= globalCycles)
-        {
-            (*tasks[0].task)();
-            tasks.erase(tasks.begin());
-        }
+        runTasks();
     }
 
-    // Count a frame
+    // Count a frame, unless it was run ahead and will be rolled back
     frameCycles -= 228 * 308 * 4;
-    fpsCount++;
+    if (!runAhead.isSpeculative())
+        fpsCount++;
+
+    // Let changes to save memory be written in the background, waiting for the real frame when running ahead
+    if (!runAhead.isSpeculative())
+        cartridge.updateSave();
+
+    // Count the idle loops that each CPU halted in, and finish counting time for the profiler
+    // The counts are taken every frame, so they don't pile up while the profiler is off
+    profiler.add(COUNTER_ARM9_IDLE_LOOPS, interpreter[0].takeIdleCount());
+    profiler.add(COUNTER_ARM7_IDLE_LOOPS, interpreter[1].takeIdleCount());
+    if (profiler.isEnabled())
+        profiler.endFrame();
 
     // Update the FPS and reset the counter every second
     std::chrono::duration<double> fpsTime = std::chrono::steady_clock::now() - lastFpsTime;
@@ -145,33 +350,117 @@ void Core::runGbaFrame()
 
 void Core::runNdsFrame()
 {
+    // Start counting for the profiler, if enabled
+    profiler.startFrame();
+
     // Run a frame in NDS mode
     while (frameCycles < 263 * 355 * 6) // 263 scanlines, 355 dots, 6 ARM9 cycles
     {
-        // Run the ARM9
-        if (interpreter[0].shouldRun())
-            interpreter[0].runOpcode();
+        uint32_t i;
 
-        // Run the ARM7 at half the speed of the ARM9
-        if ((frameCycles & 1) && interpreter[1].shouldRun())
-            interpreter[1].runOpcode();
+        if (callBlocks)
+        {
+            // Run a block on each CPU once it has caught up to the current cycle, stopping at the next task
+            // ARM7 cycles count for 2 cycles, since it runs at half the speed of the ARM9
+            uint32_t opcodes;
+            if (interpreter[0].shouldRun() && cpuCycles[0] <= globalCycles)
+            {
+                cpuCycles[0] = globalCycles + interpreter[0].runBlock(tasks[0].cycles - globalCycles, &opcodes);
+                profiler.add(COUNTER_ARM9_OPCODES, opcodes);
+            }
+            if (interpreter[1].shouldRun() && cpuCycles[1] <= globalCycles)
+            {
+                cpuCycles[1] = globalCycles + interpreter[1].runBlock((tasks[0].cycles - globalCycles + 1) / 2, &opcodes) * 2;
+                profiler.add(COUNTER_ARM7_OPCODES, opcodes);
+            }
+
+            // Jump to the end of the first block or to the next task, whichever comes first
+            uint32_t next = tasks[0].cycles;
+            for (int j = 0; j < 2; j++)
+            {
+                if (interpreter[j].shouldRun() && cpuCycles[j] < next)
+                    next = cpuCycles[j];
+            }
+            i = (next > globalCycles) ? (next - globalCycles) : 1;
+        }
+        else if (batchCpus)
+        {
+            // Run each CPU in a slice up to the next task, so the scheduler is only checked between slices
+            // The ARM9 runs first, and a slice ends early if the CPU halts or schedules a task that comes sooner
+            uint32_t end = tasks[0].cycles;
+            if (arm7Thread) end = std::min(end, globalCycles + arm7Window);
+            sliceEnd.store(end, std::memory_order_relaxed);
+
+            if (arm7Thread && (interpreter[1].shouldRun() || !arm7Tasks.empty()))
+            {
+                // Hand the ARM7 slice to its thread, and run the ARM9 slice alongside it
+                // Release and acquire at the handoffs make each CPU's writes to shared RAM visible to the other between slices
+                uint32_t slice = arm7Slice.fetch_add(1, std::memory_order_release) + 1;
+                if (arm7Sleeping)
+                {
+                    std::lock_guard<std::mutex> guard(sliceMutex);
+                    sliceCond.notify_one();
+                }
+                runSlice(0);
+                while (arm7Done.load(std::memory_order_acquire) != slice)
+                    std::this_thread::yield();
+            }
+            else
+            {
+                runSlice(0);
+                runSlice(1);
+            }
+
+            profiler.add(COUNTER_ARM9_OPCODES, sliceOpcodes[0]);
+            profiler.add(COUNTER_ARM7_OPCODES, sliceOpcodes[1]);
+
+            // Jump to the next task, or to the end of the window
+            i = std::min(tasks[0].cycles, end) - globalCycles;
+        }
+        else
+        {
+            // Run each CPU once it has caught up to the current cycle
+            // The ARM7 runs at half the speed of the ARM9, so each of its cycles counts for 2
+            if (interpreter[0].shouldRun() && cpuCycles[0] <= globalCycles)
+            {
+                cpuCycles[0] = globalCycles + interpreter[0].runOpcode();
+                profiler.add(COUNTER_ARM9_OPCODES);
+            }
+            if (interpreter[1].shouldRun() && cpuCycles[1] <= globalCycles)
+            {
+                cpuCycles[1] = globalCycles + interpreter[1].runOpcode() * 2;
+                profiler.add(COUNTER_ARM7_OPCODES);
+            }
+
+            // Count a cycle if a CPU is running, otherwise jump to the next task
+            i = (interpreter[0].shouldRun() || interpreter[1].shouldRun()) ? 1 : (tasks[0].cycles - globalCycles);
+        }
 
-        // Count a cycle if a CPU is running, otherwise jump to the next task
-        uint32_t i = (interpreter[0].shouldRun() || interpreter[1].shouldRun()) ? 1 : (tasks[0].cycles - globalCycles);
         frameCycles += i;
         globalCycles += i;
 
         // Run any tasks that are scheduled now
-        while (tasks[0].cycles <= globalCycles)
-        {
-            (*tasks[0].task)();
-            tasks.erase(tasks.begin());
-        }
+        runTasks();
     }
 
-    // Count a frame
+    // Run any ARM7 tasks that are still waiting for a slice, so they're back in the scheduler between frames
+    runArm7Tasks();
+
+    // Count a frame, unless it was run ahead and will be rolled back
     frameCycles -= 263 * 355 * 6;
-    fpsCount++;
+    if (!runAhead.isSpeculative())
+        fpsCount++;
+
+    // Let changes to save memory be written in the background, waiting for the real frame when running ahead
+    if (!runAhead.isSpeculative())
+        cartridge.updateSave();
+
+    // Count the idle loops that each CPU halted in, and finish counting time for the profiler
+    // The counts are taken every frame, so they don't pile up while the profiler is off
+    profiler.add(COUNTER_ARM9_IDLE_LOOPS, interpreter[0].takeIdleCount());
+    profiler.add(COUNTER_ARM7_IDLE_LOOPS, interpreter[1].takeIdleCount());
+    if (profiler.isEnabled())
+        profiler.endFrame();
 
     // Update the FPS and reset the counter every second
     std::chrono::duration<double> fpsTime = std::chrono::steady_clock::now() - lastFpsTime;
@@ -183,24 +472,163 @@ void Core::runNdsFrame()
     }
 }
 
+void Core::runTasks()
+{
+    // Run tasks from the top of the heap until the next one is in the future
+    // Each task is removed before it runs, so it's free to schedule more tasks
+    while (tasks[0].cycles <= globalCycles)
+    {
+        std::function<void()> *task = tasks[0].task;
+        bool arm7 = tasks[0].arm7;
+        std::pop_heap(tasks.begin(), tasks.end(), std::greater<Task>());
+        tasks.pop_back();
+
+        // Leave ARM7 tasks for its thread, which runs them at this cycle before its next slice
+        if (arm7 && arm7Thread && !gbaMode)
+        {
+            arm7Tasks.push_back(task);
+            continue;
+        }
+
+        (*task)();
+        profiler.add(COUNTER_TASKS);
+
+        // Wake the CPUs from idle loops, since they could be waiting on what the task changed
+        interpreter[0].wakeIdle();
+        interpreter[1].wakeIdle();
+    }
+}
+
+void Core::runArm7Tasks()
+{
+    // Run the ARM7 tasks that were left by the scheduler, while still at the cycle they were due
+    // They can schedule more tasks alongside the ARM9 slice, so they hold the shared lock
+    if (arm7Tasks.empty()) return;
+    auto lock = syncCpus(1);
+    for (size_t i = 0; i < arm7Tasks.size(); i++)
+    {
+        (*arm7Tasks[i])();
+        interpreter[0].wakeIdle();
+        interpreter[1].wakeIdle();
+    }
+    arm7Tasks.clear();
+}
+
 void Core::schedule(Task task)
 {
-    // Add a task to the scheduler, sorted by least to most cycles until execution
+    // Add a task to the scheduler, which is kept as a heap with the soonest task on top
     task.cycles += globalCycles;
-    auto it = std::upper_bound(tasks.cbegin(), tasks.cend(), task);
-    tasks.insert(it, task);
+    task.order = taskOrder++;
+    tasks.push_back(task);
+    std::push_heap(tasks.begin(), tasks.end(), std::greater<Task>());
+
+    // End the current CPU slices early if the task comes sooner
+    if (task.cycles < sliceEnd.load(std::memory_order_relaxed))
+        sliceEnd.store(task.cycles, std::memory_order_relaxed);
+}
+
+void Core::runSlice(int cpu)
+{
+    // Run a CPU until it halts or reaches the end of the slice
+    // ARM7 cycles count for 2 cycles, since it runs at half the speed of the ARM9
+    const uint32_t clockShift = cpu ? 1 : 0;
+    if (cpuCycles[cpu] < globalCycles) cpuCycles[cpu] = globalCycles;
+    uint32_t opcodes = 0;
+    while (interpreter[cpu].shouldRun() && cpuCycles[cpu] < sliceEnd.load(std::memory_order_relaxed))
+    {
+        // Check for a pause from the ARM9 before each ARM7 opcode, and recheck the slice after one
+        if (cpu && arm7Pause.load(std::memory_order_relaxed))
+        {
+            holdArm7();
+            continue;
+        }
+        cpuCycles[cpu] += interpreter[cpu].runOpcode() << clockShift;
+        opcodes++;
+    }
+    sliceOpcodes[cpu] = opcodes;
+}
+
+void Core::runArm7Thread(bool pin)
+{
+    if (pin) ThreadPlacement::place(THREAD_ARM7);
+    uint32_t slice = 0;
+
+    while (true)
+    {
+        // Wait for the next slice, spinning for a bit first since they usually come in quick succession
+        // The thread goes to sleep if nothing comes, like when the frontend is waiting between frames
+        for (int spins = 0; arm7Slice.load(std::memory_order_acquire) == slice; spins++)
+        {
+            if (spins < 1000)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sliceMutex);
+            arm7Sleeping = true;
+            sliceCond.wait(lock, [&] { return arm7Slice != slice; });
+            arm7Sleeping = false;
+        }
+
+        // Run the ARM7 slice and signal that it's done
+        slice = arm7Slice.load(std::memory_order_acquire);
+        if (!arm7Running) break;
+        runArm7Tasks();
+        runSlice(1);
+        arm7Done.store(slice, std::memory_order_release);
+    }
+}
+
+void Core::reschedule(Task task)
+{
+    // Replace any pending runs of a task with a new one
+    cancel(task.task);
+    schedule(task);
+}
+
+void Core::cancel(std::function<void()> *task)
+{
+    // Remove any pending runs of a task from the scheduler
+    // Only a handful of tasks are ever pending, so a scan and rebuild of the heap is cheap
+    size_t count = tasks.size();
+    for (size_t i = 0; i < tasks.size();)
+    {
+        if (tasks[i].task == task)
+        {
+            tasks[i] = tasks.back();
+            tasks.pop_back();
+        }
+        else
+        {
+            i++;
+        }
+    }
+    if (tasks.size() != count)
+        std::make_heap(tasks.begin(), tasks.end(), std::greater<Task>());
+
+    // Drop the task if it was also left for the ARM7 thread
+    arm7Tasks.erase(std::remove(arm7Tasks.begin(), arm7Tasks.end(), task), arm7Tasks.end());
 }
 
 void Core::enterGbaMode()
 {
+    // Let the 2D threads finish any DS scanlines before switching
+    gpu.sync2D();
+
     // Switch to GBA mode
     interpreter[1].enterGbaMode();
     runFunc = &Core::runGbaFrame;
     gbaMode = true;
 
+    // Remap the ARM7 memory with the GBA layout
+    memory.updateMap(1, 0x00000000, 0x10000000);
+
     // Reset the scheduler and schedule initial tasks for GBA mode
     frameCycles = globalCycles = 0;
+    cpuCycles[0] = cpuCycles[1] = 0;
     tasks.clear();
+    arm7Tasks.clear();
     schedule(Task(&resetCyclesTask, 0x7FFFFFFF));
     gpu.gbaScheduleInit();
     spu.gbaScheduleInit();
@@ -210,3 +638,122 @@ void Core::enterGbaMode()
     memory.write<uint8_t>(0, 0x4000240, 0x80); // VRAMCNT_A
     memory.write<uint8_t>(0, 0x4000241, 0x80); // VRAMCNT_B
 }
+
+void Core::syncState(Savestate *state)
+{
+    // Register the core's task so it can be referenced by ID
+    state->addTask(&resetCyclesTask);
+
+    // Sync the core state, and pick the frame function for the loaded mode
+    state->sync(gbaMode);
+    state->sync(frameCycles);
+    state->sync(globalCycles);
+    state->sync(cpuCycles);
+    state->sync(taskOrder);
+    if (state->isLoading())
+        runFunc = gbaMode ? &Core::runGbaFrame : &Core::runNdsFrame;
+
+    // Sync the components in a fixed order, which also keeps the task IDs stable
+    cartridge.syncState(state);
+    cp15.syncState(state);
+    divSqrt.syncState(state);
+    dldi.syncState(state);
+    dma[0].syncState(state);
+    dma[1].syncState(state);
+    gpu.syncState(state);
+    gpu2D[0].syncState(state);
+    gpu2D[1].syncState(state);
+    gpu3D.syncState(state);
+    gpu3DRenderer.syncState(state);
+    hleBios[0].syncState(state);
+    hleBios[1].syncState(state);
+    input.syncState(state);
+    interpreter[0].syncState(state);
+    interpreter[1].syncState(state);
+    ipc.syncState(state);
+    memory.syncState(state);
+    rtc.syncState(state);
+    spi.syncState(state);
+    spu.syncState(state);
+    timers[0].syncState(state);
+    timers[1].syncState(state);
+    wifi.syncState(state);
+
+    // Sync the scheduled tasks, with the task pointers stored as IDs
+    // The tasks are kept in heap order, so they can be restored as they are
+    uint32_t count = tasks.size();
+    state->sync(count);
+    if (state->isLoading())
+        tasks.clear();
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        Task task = state->isLoading() ? Task(nullptr, 0) : tasks[i];
+        uint32_t id = state->getTaskId(task.task);
+        state->sync(id);
+        state->sync(task.cycles);
+        state->sync(task.order);
+
+        if (state->isLoading() && (task.task = state->getTask(id)))
+            tasks.push_back(task);
+    }
+
+    // Restart checking for wireless packets, based on whether this core is connected rather than the state
+    if (state->isLoading())
+        wifi.schedulePoll();
+}
+
+void Core::saveState(std::vector<uint8_t> *data)
+{
+    // Write a savestate to memory, reusing the vector's capacity so that frequent saves don't allocate
+    uint32_t header[3] = { STATE_MAGIC, STATE_VERSION, 0 };
+    data->clear();
+    Savestate state(data, false);
+    state.sync(header);
+    syncState(&state);
+
+    // Fill in the total size of the state
+    header[2] = data->size();
+    memcpy(&(*data)[8], &header[2], sizeof(uint32_t));
+}
+
+bool Core::loadState(std::vector<uint8_t> *data)
+{
+    // Check the header before changing anything, so an incompatible state leaves the core as it was
+    uint32_t header[3];
+    if (data->size() < sizeof(header)) return false;
+    memcpy(header, &(*data)[0], sizeof(header));
+    if (header[0] != STATE_MAGIC || header[1] != STATE_VERSION || header[2] != data->size())
+        return false;
+
+    // Read a savestate from memory
+    Savestate state(data, true);
+    state.sync(header);
+    syncState(&state);
+    return state.isValid();
+}
+
+bool Core::saveState(std::string path)
+{
+    // Write a savestate to a file
+    std::vector<uint8_t> data;
+    saveState(&data);
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+    fwrite(&data[0], sizeof(uint8_t), data.size(), file);
+    fclose(file);
+    return true;
+}
+
+bool Core::loadState(std::string path)
+{
+    // Read a savestate from a file
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+    fseek(file, 0, SEEK_END);
+    std::vector<uint8_t> data(ftell(file));
+    fseek(file, 0, SEEK_SET);
+    size_t size = fread(&data[0], sizeof(uint8_t), data.size(), file);
+    fclose(file);
+    return size == data.size() && loadState(&data);
+}
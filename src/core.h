@@ -20,10 +20,15 @@
 #ifndef CORE_H
 #define CORE_H
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "cartridge.h"
@@ -36,41 +41,81 @@
 #include "gpu_2d.h"
 #include "gpu_3d.h"
 #include "gpu_3d_renderer.h"
+#include "hle_bios.h"
 #include "input.h"
 #include "interpreter.h"
 #include "ipc.h"
 #include "memory.h"
+#include "movie.h"
+#include "profiler.h"
+#include "rewind.h"
 #include "rtc.h"
+#include "run_ahead.h"
+#include "savestate.h"
+#include "settings.h"
 #include "spi.h"
 #include "spu.h"
+#include "telemetry.h"
+#include "thread_placement.h"
 #include "timers.h"
 #include "wifi.h"
 
 struct Task
 {
-    Task(std::function<void()> *task, uint32_t cycles): task(task), cycles(cycles) {}
+    Task(std::function<void()> *task, uint32_t cycles, bool arm7 = false): task(task), cycles(cycles), arm7(arm7) {}
 
     std::function<void()> *task;
     uint32_t cycles;
+    uint64_t order = 0;
 
-    bool operator<(const Task &task) const { return cycles < task.cycles; }
+    // Tasks that only touch ARM7 state can run on the ARM7 thread, at the start of its next slice
+    // This isn't saved in states, since it only decides which thread runs the task
+    bool arm7;
+
+    // Tasks scheduled for the same cycle run in the order they were scheduled
+    bool operator<(const Task &task) const { return cycles < task.cycles || (cycles == task.cycles && order < task.order); }
+    bool operator>(const Task &task) const { return task < *this; }
 };
 
 class Core
 {
     public:
-        Core(std::string ndsPath = "", std::string gbaPath = "");
+        Core(std::string ndsPath = "", std::string gbaPath = "", const Config &config = Settings::getConfig());
+        ~Core();
 
-        void runFrame() { (this->*runFunc)(); }
+        void runFrame();
 
         bool isGbaMode() { return gbaMode; }
         int  getFps()    { return fps;     }
 
+        size_t getFootprint();
+
         uint32_t getGlobalCycles() { return globalCycles; }
+        // A CPU's count includes the cycles it has run so far in the current block, so reads within a block see the right time
+        // ARM7 cycles count for 2 cycles, since it runs at half the speed of the ARM9
+        uint32_t getCpuCycles(int cpu) { return std::max(globalCycles, cpuCycles[cpu]) + (interpreter[cpu].getBlockCycles() << cpu); }
 
         void schedule(Task task);
+        void reschedule(Task task);
+        void cancel(std::function<void()> *task);
         void enterGbaMode();
 
+        std::unique_lock<std::recursive_mutex> syncCpus(int cpu);
+        void pauseArm7();
+        void resumeArm7();
+
+        void setConfig(const Config &config);
+
+        void saveState(std::vector<uint8_t> *data);
+        bool loadState(std::vector<uint8_t> *data);
+        bool saveState(std::string path);
+        bool loadState(std::string path);
+
+        // Each core has its own copy of the settings, declared first so the components can use it when they're created
+        // Frontends change the ones that apply while running, like the FPS limiter or 3D threads, through setConfig
+        // This is only written by the thread running the core, so the core can read it without locking
+        Config config;
+
         Cartridge cartridge;
         Cp15 cp15;
         DivSqrt divSqrt;
@@ -80,29 +125,70 @@ class Core
         Gpu2D gpu2D[2];
         Gpu3D gpu3D;
         Gpu3DRenderer gpu3DRenderer;
+        HleBios hleBios[2];
         Input input;
         Interpreter interpreter[2];
         Ipc ipc;
         Memory memory;
+        Movie movie;
+        Profiler profiler;
+        Rewind rewind;
         Rtc rtc;
+        RunAhead runAhead;
         Spi spi;
         Spu spu;
+        Telemetry telemetry;
         Timers timers[2];
         Wifi wifi;
 
     private:
         bool gbaMode = false;
+        bool callBlocks = false;
+        bool batchCpus = false;
         void (Core::*runFunc)() = &Core::runNdsFrame;
 
+        // In batched mode, the ARM7 can run its slices on a separate thread alongside the ARM9
+        // The CPUs only sync at I/O accesses, which covers IPC, WRAMCNT, and interrupts, and otherwise drift within a slice
+        // Slices are capped at a window of cycles in this mode, to bound how far the CPUs can drift apart
+        // The ARM9 pauses the ARM7 between opcodes when it remaps memory that the ARM7 can see
+        std::thread *arm7Thread = nullptr;
+        std::recursive_mutex sharedMutex;
+        std::mutex sliceMutex;
+        std::condition_variable sliceCond;
+        std::atomic<uint32_t> arm7Slice, arm7Done;
+        std::atomic<bool> arm7Running, arm7Sleeping;
+        std::atomic<bool> arm7Pause { false }, arm7Paused { false };
+        std::vector<std::function<void()>*> arm7Tasks;
+        uint32_t arm7Window = 0;
+
+        std::atomic<uint32_t> sliceEnd;
+        uint32_t sliceOpcodes[2] = {};
+
+        // New settings from a frontend wait here until the core takes them at the start of a frame
+        std::mutex configMutex;
+        Config pendingConfig;
+        std::atomic<bool> configPending { false };
+
         std::vector<Task> tasks;
+        uint64_t taskOrder = 0;
         uint32_t frameCycles = 0, globalCycles = 0;
+        uint32_t cpuCycles[2] = {};
 
         int fps = 0, fpsCount = 0;
         std::chrono::steady_clock::time_point lastFpsTime;
 
+        std::thread::id placedThread;
+
         std::function<void()> resetCyclesTask;
 
+        void applyConfig();
         void resetCycles();
+        void runTasks();
+        void runArm7Tasks();
+        void runSlice(int cpu);
+        void runArm7Thread(bool pin);
+        void holdArm7();
+        void syncState(Savestate *state);
 
         void runNdsFrame();
         void runGbaFrame();
@@ -17,19 +17,151 @@
     along with NooDS. If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <cstring>
+
 #include "cp15.h"
 #include "core.h"
 
+Cp15::Cp15(Core *core): core(core)
+{
+    // Model memory timing if enabled, with 1 using the region tables and 2 also simulating the caches
+    timing = core->config.memTiming;
+}
+
+void Cp15::syncState(Savestate *state)
+{
+    // Sync the registers and the values derived from them
+    state->sync(ctrlReg);
+    state->sync(dtcmReg);
+    state->sync(itcmReg);
+    state->sync(exceptionAddr);
+    state->sync(dtcmEnabled);
+    state->sync(itcmEnabled);
+    state->sync(dtcmAddr);
+    state->sync(dtcmSize);
+    state->sync(itcmSize);
+    state->sync(dataCacheBits);
+    state->sync(instrCacheBits);
+    state->sync(writeBufferBits);
+    state->sync(regions);
+
+    // Rebuild the page attributes after loading, and start with empty caches
+    if (state->isLoading())
+    {
+        updateAttrs();
+        memset(instrTags, 0, sizeof(instrTags));
+        memset(dataTags, 0, sizeof(dataTags));
+    }
+}
+
+uint8_t Cp15::regionAttrs(uint32_t address)
+{
+    // Get the attributes of the highest enabled protection region that contains an address
+    for (int i = 7; i >= 0; i--)
+    {
+        uint64_t size = 2ULL << ((regions[i] & 0x0000003E) >> 1);
+        if ((regions[i] & BIT(0)) && address - (regions[i] & 0xFFFFF000) < size)
+            return ((instrCacheBits >> i) & 1) | (((dataCacheBits >> i) & 1) << 1) | (((writeBufferBits >> i) & 1) << 2);
+    }
+    return 0;
+}
+
+void Cp15::updateAttrs()
+{
+    // Look up the attributes of every page below 0x10000000 when the regions change, if timing is modeled
+    if (!timing) return;
+    for (uint32_t i = 0; i < 0x10000; i++)
+        pageAttrs[i] = regionAttrs(i << 12);
+}
+
+bool Cp15::lookupLine(uint32_t *tags, uint8_t *next, int sets, uint32_t address)
+{
+    // Check if the line containing an address is cached, and replace the next way in its set if not
+    uint32_t line = (address & ~0x1F) | BIT(0);
+    int set = (address >> 5) & (sets - 1);
+    for (int i = 0; i < 4; i++)
+    {
+        if (tags[set * 4 + i] == line)
+            return true;
+    }
+    tags[set * 4 + next[set]] = line;
+    next[set] = (next[set] + 1) & 3;
+    return false;
+}
+
+void Cp15::invalidateLine(uint32_t *tags, int sets, uint32_t address)
+{
+    // Remove the line containing an address from a cache
+    uint32_t line = (address & ~0x1F) | BIT(0);
+    int set = (address >> 5) & (sets - 1);
+    for (int i = 0; i < 4; i++)
+    {
+        if (tags[set * 4 + i] == line)
+            tags[set * 4 + i] = 0;
+    }
+}
+
+int Cp15::fillCycles(uint32_t address)
+{
+    // Filling a cache line reads 8 words in a burst
+    return core->memory.getWaitstates(0, address, ACCESS_N32) + core->memory.getWaitstates(0, address, ACCESS_S32) * 7;
+}
+
+int Cp15::fetchCycles(uint32_t address, int size, bool seq)
+{
+    // Fetch from the instruction TCM without waiting
+    if (itcmEnabled && address < itcmSize)
+        return 1;
+
+    // Fetch from the instruction cache if enabled for the region, only missing when caches are simulated
+    if ((ctrlReg & (BIT(12) | BIT(0))) == (BIT(12) | BIT(0)) && (getAttrs(address) & BIT(0)))
+        return (timing < 2 || lookupLine(instrTags, instrNext, 64, address)) ? 1 : fillCycles(address);
+
+    // Fetch from the bus
+    return core->memory.getWaitstates(0, address, (AccessType)(((size == 4) ? ACCESS_N32 : ACCESS_N16) + seq));
+}
+
+int Cp15::dataCycles(uint32_t address, int size, bool seq, bool write)
+{
+    // Access the TCMs without waiting
+    if ((itcmEnabled && address < itcmSize) || (dtcmEnabled && address - dtcmAddr < dtcmSize))
+        return 1;
+
+    uint8_t attrs = getAttrs(address);
+    if (write)
+    {
+        // Let the write buffer take writes to buffered regions, and write through to the bus otherwise
+        // Writes never allocate cache lines, so they don't change the cache state
+        if ((ctrlReg & BIT(0)) && (attrs & BIT(2)))
+            return 1;
+    }
+    else if ((ctrlReg & (BIT(2) | BIT(0))) == (BIT(2) | BIT(0)) && (attrs & BIT(1)))
+    {
+        // Read from the data cache if enabled for the region, only missing when caches are simulated
+        return (timing < 2 || lookupLine(dataTags, dataNext, 32, address)) ? 1 : fillCycles(address);
+    }
+
+    // Access the bus
+    return core->memory.getWaitstates(0, address, (AccessType)(((size == 4) ? ACCESS_N32 : ACCESS_N16) + seq));
+}
+
 uint32_t Cp15::read(int cn, int cm, int cp)
 {
     // Read a value from a CP15 register
     switch ((cn << 16) | (cm << 8) | (cp << 0))
     {
-        case 0x000000: return 0x41059461; // Main ID
-        case 0x000001: return 0x0F0D2112; // Cache type
-        case 0x010000: return ctrlReg;    // Control
-        case 0x090100: return dtcmReg;    // Data TCM base/size
-        case 0x090101: return itcmReg;    // Instruction TCM size
+        case 0x000000: return 0x41059461;      // Main ID
+        case 0x000001: return 0x0F0D2112;      // Cache type
+        case 0x010000: return ctrlReg;         // Control
+        case 0x020000: return dataCacheBits;   // Data cachable bits
+        case 0x020001: return instrCacheBits;  // Instruction cachable bits
+        case 0x030000: return writeBufferBits; // Write buffer bits
+        case 0x090100: return dtcmReg;         // Data TCM base/size
+        case 0x090101: return itcmReg;         // Instruction TCM size
+
+        case 0x060000: case 0x060100: case 0x060200: case 0x060300:
+        case 0x060400: case 0x060500: case 0x060600: case 0x060700: // Protection region base/size
+            return regions[cm];
 
         default:
         {
@@ -51,6 +183,9 @@ void Cp15::write(int cn, int cm, int cp, uint32_t value)
             exceptionAddr = (ctrlReg & BIT(13)) ? 0xFFFF0000 : 0x00000000;
             dtcmEnabled = (ctrlReg & BIT(16));
             itcmEnabled = (ctrlReg & BIT(18));
+
+            // Remap the ARM9 memory in case the TCM was toggled
+            core->memory.updateMap(0, 0x00000000, 0x10000000);
             return;
         }
 
@@ -61,11 +196,81 @@ void Cp15::write(int cn, int cm, int cp, uint32_t value)
             dtcmAddr = dtcmReg & 0xFFFFF000;
             dtcmSize = 0x200 << ((dtcmReg & 0x0000003E) >> 1);
             if (dtcmSize < 0x1000) dtcmSize = 0x1000;
+
+            // Remap the ARM9 memory around the new DTCM location
+            core->memory.updateMap(0, 0x00000000, 0x10000000);
+            return;
+        }
+
+        case 0x020000: // Data cachable bits
+        {
+            dataCacheBits = value & 0xFF;
+            updateAttrs();
+            return;
+        }
+
+        case 0x020001: // Instruction cachable bits
+        {
+            instrCacheBits = value & 0xFF;
+            updateAttrs();
+            return;
+        }
+
+        case 0x030000: // Write buffer bits
+        {
+            writeBufferBits = value & 0xFF;
+            updateAttrs();
+            return;
+        }
+
+        case 0x060000: case 0x060100: case 0x060200: case 0x060300:
+        case 0x060400: case 0x060500: case 0x060600: case 0x060700: // Protection region base/size
+        {
+            regions[cm] = value;
+            updateAttrs();
+            return;
+        }
+
+        case 0x070500: // Invalidate instruction cache
+        {
+            memset(instrTags, 0, sizeof(instrTags));
+            return;
+        }
+
+        case 0x070501: // Invalidate instruction cache line
+        {
+            invalidateLine(instrTags, 64, value);
+            return;
+        }
+
+        case 0x070600: // Invalidate data cache
+        {
+            memset(dataTags, 0, sizeof(dataTags));
+            return;
+        }
+
+        case 0x070601: case 0x070E01: // Invalidate data cache line
+        {
+            invalidateLine(dataTags, 32, value);
+            return;
+        }
+
+        case 0x070E02: // Clean and invalidate data cache line by index
+        {
+            dataTags[((value >> 5) & 31) * 4 + (value >> 30)] = 0;
+            return;
+        }
+
+        case 0x070A01: case 0x070A02: case 0x070A04: case 0x070D01: // Clean data cache, drain write buffer, prefetch
+        {
+            // Caches only affect timing and are always coherent here, so these have no effect
             return;
         }
 
         case 0x070004: case 0x070802: // Wait for interrupt
         {
+            // Halting changes state that the other CPU can touch when it's on its own thread
+            auto lock = core->syncCpus(0);
             core->interpreter[0].halt(0);
             return;
         }
@@ -77,6 +282,9 @@ void Cp15::write(int cn, int cm, int cp, uint32_t value)
             itcmReg = value;
             itcmSize = 0x200 << ((itcmReg & 0x0000003E) >> 1);
             if (itcmSize < 0x1000) itcmSize = 0x1000;
+
+            // Remap the ARM9 memory for the new ITCM size
+            core->memory.updateMap(0, 0x00000000, 0x10000000);
             return;
         }
 
@@ -23,11 +23,14 @@
 #include <cstdint>
 
 class Core;
+class Savestate;
 
 class Cp15
 {
     public:
-        Cp15(Core *core): core(core) {}
+        Cp15(Core *core);
+
+        void syncState(Savestate *state);
 
         uint32_t read(int cn, int cm, int cp);
         void write(int cn, int cm, int cp, uint32_t value);
@@ -39,6 +42,9 @@ class Cp15
         uint32_t getDtcmSize()      { return dtcmSize;      }
         uint32_t getItcmSize()      { return itcmSize;      }
 
+        int fetchCycles(uint32_t address, int size, bool seq);
+        int dataCycles(uint32_t address, int size, bool seq, bool write);
+
     private:
         Core *core;
 
@@ -51,6 +57,28 @@ class Cp15
         bool itcmEnabled = false;
         uint32_t dtcmAddr = 0, dtcmSize = 0;
         uint32_t itcmSize = 0;
+
+        // The protection regions decide which memory is cached, and are only used for timing
+        // Attributes are looked up per 4KB page below 0x10000000, with bit 0 for instruction cache, 1 for data, and 2 for buffered writes
+        int timing = 0;
+        uint32_t dataCacheBits = 0, instrCacheBits = 0, writeBufferBits = 0;
+        uint32_t regions[8] = {};
+        uint8_t pageAttrs[0x10000] = {};
+
+        // The caches are modeled as tags only, with 4 ways of 32-byte lines and round-robin replacement
+        // The instruction cache is 8KB with 64 sets, and the data cache is 4KB with 32 sets
+        uint32_t instrTags[64 * 4] = {};
+        uint32_t dataTags[32 * 4] = {};
+        uint8_t instrNext[64] = {};
+        uint8_t dataNext[32] = {};
+
+        uint8_t regionAttrs(uint32_t address);
+        uint8_t getAttrs(uint32_t address) { return (address < 0x10000000) ? pageAttrs[address >> 12] : regionAttrs(address); }
+        void updateAttrs();
+
+        bool lookupLine(uint32_t *tags, uint8_t *next, int sets, uint32_t address);
+        void invalidateLine(uint32_t *tags, int sets, uint32_t address);
+        int fillCycles(uint32_t address);
 };
 
 #endif // CP15_H
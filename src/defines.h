@@ -34,6 +34,14 @@
 #define FORCE_INLINE inline __attribute__((always_inline))
 #endif
 
+// Macro to also build a hot loop for newer x86-64 levels, with the best one for the CPU picked at runtime
+// This relies on ifunc support, so it's only used with GCC 12 or newer on Linux, and when no level is set at build time
+#if defined(__x86_64__) && defined(__linux__) && !defined(__clang__) && __GNUC__ >= 12 && !defined(__AVX2__)
+#define TARGET_CLONES __attribute__((target_clones("arch=x86-64-v3", "arch=x86-64-v2", "default")))
+#else
+#define TARGET_CLONES
+#endif
+
 // Simple bit macro
 #define BIT(i) (1 << (i))
 
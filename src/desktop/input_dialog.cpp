@@ -36,7 +36,8 @@ enum Event
     REMAP_L,
     REMAP_R,
     REMAP_FAST_FORWARD,
-    REMAP_FULL_SCREEN
+    REMAP_FULL_SCREEN,
+    REMAP_REWIND
 };
 
 wxBEGIN_EVENT_TABLE(InputDialog, wxDialog)
@@ -54,6 +55,7 @@ EVT_BUTTON(REMAP_L,            InputDialog::remapL)
 EVT_BUTTON(REMAP_R,            InputDialog::remapR)
 EVT_BUTTON(REMAP_FAST_FORWARD, InputDialog::remapFastForward)
 EVT_BUTTON(REMAP_FULL_SCREEN,  InputDialog::remapFullScreen)
+EVT_BUTTON(REMAP_REWIND,       InputDialog::remapRewind)
 EVT_BUTTON(wxID_OK,            InputDialog::confirm)
 EVT_CHAR_HOOK(InputDialog::pressKey)
 EVT_JOYSTICK_EVENTS(InputDialog::joystickInput)
@@ -183,7 +185,7 @@ std::string InputDialog::keyToString(int key)
 InputDialog::InputDialog(wxJoystick *joystick): wxDialog(nullptr, wxID_ANY, "Input Bindings"), joystick(joystick)
 {
     // Load the key bindings
-    for (int i = 0; i < 14; i++)
+    for (int i = 0; i < 15; i++)
         keyBinds[i] = NooApp::getKeyBind(i);
 
     // Determine the height of a button
@@ -262,6 +264,11 @@ InputDialog::InputDialog(wxJoystick *joystick): wxDialog(nullptr, wxID_ANY, "Inp
     fullScreenSizer->Add(new wxStaticText(this, wxID_ANY, "Full Screen:"), 1, wxALIGN_CENTRE | wxRIGHT, size / 16);
     fullScreenSizer->Add(keyFullScreen = new wxButton(this, REMAP_FULL_SCREEN, keyToString(keyBinds[13]), wxDefaultPosition, wxSize(size * 4, size)), 0, wxLEFT, size / 16);
 
+    // Set up the rewind button setting
+    wxBoxSizer *rewindSizer = new wxBoxSizer(wxHORIZONTAL);
+    rewindSizer->Add(new wxStaticText(this, wxID_ANY, "Rewind:"), 1, wxALIGN_CENTRE | wxRIGHT, size / 16);
+    rewindSizer->Add(keyRewind = new wxButton(this, REMAP_REWIND, keyToString(keyBinds[14]), wxDefaultPosition, wxSize(size * 4, size)), 0, wxLEFT, size / 16);
+
     // Set up the cancel and confirm buttons
     wxBoxSizer *buttonSizer = new wxBoxSizer(wxHORIZONTAL);
     buttonSizer->Add(new wxStaticText(this, wxID_ANY, ""), 1);
@@ -277,7 +284,7 @@ InputDialog::InputDialog(wxJoystick *joystick): wxDialog(nullptr, wxID_ANY, "Inp
     leftContents->Add(startSizer,       1, wxEXPAND | wxALL, size / 8);
     leftContents->Add(selectSizer,      1, wxEXPAND | wxALL, size / 8);
     leftContents->Add(fastForwardSizer, 1, wxEXPAND | wxALL, size / 8);
-    leftContents->Add(new wxStaticText(this, wxID_ANY, ""), 1, wxEXPAND | wxALL, size / 8);
+    leftContents->Add(rewindSizer,      1, wxEXPAND | wxALL, size / 8);
 
     // Combine all of the right contents
     wxBoxSizer *rightContents = new wxBoxSizer(wxVERTICAL);
@@ -325,6 +332,9 @@ void InputDialog::resetLabels()
     keyRight->SetLabel(keyToString(keyBinds[4]));
     keyL->SetLabel(keyToString(keyBinds[9]));
     keyR->SetLabel(keyToString(keyBinds[8]));
+    keyFastForward->SetLabel(keyToString(keyBinds[12]));
+    keyFullScreen->SetLabel(keyToString(keyBinds[13]));
+    keyRewind->SetLabel(keyToString(keyBinds[14]));
     current = nullptr;
 }
 
@@ -454,10 +464,19 @@ void InputDialog::remapFullScreen(wxCommandEvent &event)
     keyIndex = 13;
 }
 
+void InputDialog::remapRewind(wxCommandEvent &event)
+{
+    // Prepare the rewind button for remapping
+    resetLabels();
+    keyRewind->SetLabel("Press a key");
+    current = keyRewind;
+    keyIndex = 14;
+}
+
 void InputDialog::confirm(wxCommandEvent &event)
 {
     // Save the key mappings
-    for (int i = 0; i < 14; i++)
+    for (int i = 0; i < 15; i++)
         NooApp::setKeyBind(i, keyBinds[i]);
     Settings::save();
 
@@ -46,8 +46,9 @@ class InputDialog: public wxDialog
         wxButton *keyR;
         wxButton *keyFastForward;
         wxButton *keyFullScreen;
+        wxButton *keyRewind;
 
-        int keyBinds[14];
+        int keyBinds[15];
         std::vector<int> axisBases;
         wxButton *current = nullptr;
         int keyIndex = 0;
@@ -70,6 +71,7 @@ class InputDialog: public wxDialog
         void remapR(wxCommandEvent &event);
         void remapFastForward(wxCommandEvent &event);
         void remapFullScreen(wxCommandEvent &event);
+        void remapRewind(wxCommandEvent &event);
         void confirm(wxCommandEvent &event);
         void pressKey(wxKeyEvent &event);
         void joystickInput(wxJoystickEvent &event);
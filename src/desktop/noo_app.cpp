@@ -34,7 +34,9 @@ EVT_TIMER(UPDATE, NooApp::update)
 wxEND_EVENT_TABLE()
 
 int NooApp::screenFilter = 1;
-int NooApp::keyBinds[] = { 'L', 'K', 'G', 'H', 'D', 'A', 'W', 'S', 'P', 'Q', 'O', 'I', WXK_TAB, WXK_ESCAPE };
+int NooApp::profiler = 0;
+int NooApp::shaderDisplay = 0;
+int NooApp::keyBinds[] = { 'L', 'K', 'G', 'H', 'D', 'A', 'W', 'S', 'P', 'Q', 'O', 'I', WXK_TAB, WXK_ESCAPE, WXK_BACK };
 
 bool NooApp::OnInit()
 {
@@ -44,6 +46,8 @@ bool NooApp::OnInit()
     std::vector<Setting> platformSettings =
     {
         Setting("screenFilter",   &screenFilter, false),
+        Setting("profiler",       &profiler,     false),
+        Setting("shaderDisplay",  &shaderDisplay, false),
         Setting("keyA",           &keyBinds[0],  false),
         Setting("keyB",           &keyBinds[1],  false),
         Setting("keySelect",      &keyBinds[2],  false),
@@ -57,7 +61,8 @@ bool NooApp::OnInit()
         Setting("keyX",           &keyBinds[10], false),
         Setting("keyY",           &keyBinds[11], false),
         Setting("keyFastForward", &keyBinds[12], false),
-        Setting("keyFullScreen",  &keyBinds[13], false)
+        Setting("keyFullScreen",  &keyBinds[13], false),
+        Setting("keyRewind",      &keyBinds[14], false)
     };
 
     // Add the platform settings
@@ -120,7 +125,21 @@ void NooApp::update(wxTimerEvent &event)
 {
     // Refresh the display and update the FPS counter
     canvas->Refresh();
-    frame->SetLabel(emulator.running ? wxString::Format("NooDS - %d FPS", emulator.core->getFps()) : "NooDS");
+    wxString label = emulator.running ? wxString::Format("NooDS - %d FPS", emulator.core->getFps()) : "NooDS";
+
+    // Add the profiler counters from the last frame if enabled, to go along with the overlay
+    if (emulator.running && profiler)
+    {
+        ProfileFrame profile = emulator.core->profiler.getLastFrame();
+        label += wxString::Format(" | ARM9 %lluK, ARM7 %lluK opcodes | ARM9 %llu, ARM7 %llu idle loops | %llu tasks | %llu GX, %llu polygons",
+            (unsigned long long)profile.counts[COUNTER_ARM9_OPCODES] / 1000, (unsigned long long)profile.counts[COUNTER_ARM7_OPCODES] / 1000,
+            (unsigned long long)profile.counts[COUNTER_ARM9_IDLE_LOOPS], (unsigned long long)profile.counts[COUNTER_ARM7_IDLE_LOOPS],
+            (unsigned long long)profile.counts[COUNTER_TASKS], (unsigned long long)profile.counts[COUNTER_GX_COMMANDS],
+            (unsigned long long)profile.counts[COUNTER_POLYGONS]);
+        label += " | " + ThreadPlacement::describe();
+    }
+
+    frame->SetLabel(label);
 }
 
 int NooApp::audioCallback(const void *in, void *out, unsigned long frames,
@@ -133,18 +152,8 @@ int NooApp::audioCallback(const void *in, void *out, unsigned long frames,
     {
         // The NDS sample rate is 32768Hz, and PortAudio supports this frequency directly
         // It causes issues on some systems though, so a more standard frequency of 48000Hz is used instead
-        // Get 699 samples at 32768Hz, which is equal to approximately 1024 samples at 48000Hz
-        uint32_t *original = emulator->core->spu.getSamples(699);
-
-        // Stretch the 699 samples out to 1024 samples in the audio buffer
-        for (int i = 0; i < frames; i++)
-        {
-            uint32_t sample = original[i * 699 / 1024];
-            buffer[i * 2 + 0] = sample >>  0;
-            buffer[i * 2 + 1] = sample >> 16;
-        }
-
-        delete[] original;
+        // The SPU resamples directly into the audio buffer
+        emulator->core->spu.getSamples(buffer, frames, 48000);
     }
     else
     {
@@ -30,9 +30,13 @@ class NooApp: public wxApp
 {
     public:
         static int getScreenFilter()     { return screenFilter;    }
+        static int getProfiler()         { return profiler;        }
+        static int getShaderDisplay()    { return shaderDisplay;   }
         static int getKeyBind(int index) { return keyBinds[index]; }
 
         static void setScreenFilter(int value)       { screenFilter    = value; }
+        static void setProfiler(int value)           { profiler        = value; }
+        static void setShaderDisplay(int value)      { shaderDisplay   = value; }
         static void setKeyBind(int index, int value) { keyBinds[index] = value; }
 
     private:
@@ -42,7 +46,9 @@ class NooApp: public wxApp
         Emulator emulator;
 
         static int screenFilter;
-        static int keyBinds[14];
+        static int profiler;
+        static int shaderDisplay;
+        static int keyBinds[15];
 
         bool OnInit();
 
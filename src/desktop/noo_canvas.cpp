@@ -17,15 +17,78 @@
     along with NooDS. If not, see <https://www.gnu.org/licenses/>.
 */
 
+// Shader display needs OpenGL 3.0 functions, which can only be linked directly on Linux
+#if !defined(_WIN32) && !defined(MACOS)
+#define SHADER_DISPLAY
+#define GL_GLEXT_PROTOTYPES
+#endif
+
+#include <algorithm>
+#include <cstdio>
+
 #include "noo_canvas.h"
 #include "noo_app.h"
 #include "../settings.h"
 
-#ifdef _WIN32
+#if defined(_WIN32) || defined(SHADER_DISPLAY)
 #include <GL/gl.h>
 #include <GL/glext.h>
 #endif
 
+#ifdef SHADER_DISPLAY
+
+static const char *vertexShader =
+R"(#version 130
+
+out vec2 texCoord;
+
+void main()
+{
+    gl_Position = ftransform();
+    texCoord = gl_MultiTexCoord0.xy;
+}
+)";
+
+// Frames are uploaded as raw RGB6 values, and converted to RGB8 here
+// Integer textures can't be filtered by the hardware, so linear filtering is done by hand within the screen's region
+static const char *fragmentShader =
+R"(#version 130
+
+uniform usampler2D frame;
+uniform ivec4 region;
+uniform bool smoothing;
+
+in vec2 texCoord;
+out vec4 fragColor;
+
+vec3 fetch(ivec2 pos)
+{
+    uint color = texelFetch(frame, region.xy + clamp(pos, ivec2(0), region.zw - 1), 0).r;
+    return floor(vec3(uvec3(color, color >> 6u, color >> 12u) & 0x3Fu) * 255.0 / 63.0) / 255.0;
+}
+
+void main()
+{
+    vec2 pos = texCoord * vec2(region.zw);
+
+    if (smoothing)
+    {
+        pos -= 0.5;
+        ivec2 base = ivec2(floor(pos));
+        vec2 f = fract(pos);
+        vec3 top = mix(fetch(base), fetch(base + ivec2(1, 0)), f.x);
+        vec3 bot = mix(fetch(base + ivec2(0, 1)), fetch(base + ivec2(1, 1)), f.x);
+        fragColor = vec4(mix(top, bot, f.y), 1.0);
+    }
+    else
+    {
+        fragColor = vec4(fetch(ivec2(pos)), 1.0);
+    }
+}
+)";
+
+#endif // SHADER_DISPLAY
+
 wxBEGIN_EVENT_TABLE(NooCanvas, wxGLCanvas)
 EVT_PAINT(NooCanvas::draw)
 EVT_SIZE(NooCanvas::resize)
@@ -42,13 +105,19 @@ NooCanvas::NooCanvas(NooFrame *frame, Emulator *emulator): wxGLCanvas(frame, wxI
     context = new wxGLContext(this);
     SetCurrent(*context);
 
-    // Prepare a texture for the framebuffer
-    GLuint texture;
+    // Prepare textures for the top and bottom screens
+    // Their storage is allocated once for a given size, and only updated after that
     glEnable(GL_TEXTURE_2D);
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glGenTextures(2, textures);
+    for (int i = 0; i < 2; i++)
+    {
+        glBindTexture(GL_TEXTURE_2D, textures[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+
+    // Prepare the shader for converting raw frames, if possible
+    initShader();
 
     // Set focus so that key presses will be registered
     SetFocus();
@@ -56,12 +125,6 @@ NooCanvas::NooCanvas(NooFrame *frame, Emulator *emulator): wxGLCanvas(frame, wxI
     frame->SendSizeEvent();
 }
 
-NooCanvas::~NooCanvas()
-{
-    // Free the framebuffer
-    if (framebuffer) delete[] framebuffer;
-}
-
 void NooCanvas::draw(wxPaintEvent &event)
 {
     // Continuous rendering can prevent the canvas from closing, so only render when needed
@@ -75,23 +138,33 @@ void NooCanvas::draw(wxPaintEvent &event)
 
     if (emulator->core)
     {
-        // Request a new frame
+        // Request a new frame, at a higher resolution if 3D is being upscaled
+        // Native resolution frames can be taken raw and converted by a shader instead, if enabled and supported
         bool gba = (emulator->core->isGbaMode() && ScreenLayout::getGbaCrop());
-        uint32_t *fb = emulator->core->gpu.getFrame(gba);
+        // The settings are read from the frontend's copy, since the core's copy belongs to the emulation thread
+        bool hardware = (Settings::getHardware3D() && !emulator->core->gpu3DRenderer.hasHardwareFailed());
+        int scale = (!gba && hardware) ? std::min(std::max(Settings::getScale3D(), 1), 4) : 1;
+        bool raw = (program && scale == 1 && NooApp::getShaderDisplay());
+        const uint32_t *fb = raw ? emulator->core->gpu.getRawFrame() : emulator->core->gpu.getFrame(gba, scale);
 
         if (fb)
         {
-            // Update the frame if a new one was ready
-            // If not, the old frame will be drawn so the screen layout can still update
-            if (framebuffer) delete[] framebuffer;
-            framebuffer = fb;
-
             // Update GBA mode status to match the new frame
             if (gbaMode != gba)
             {
                 gbaMode = gba;
                 frame->SendSizeEvent();
             }
+
+            // Update the textures if a new frame was ready
+            // If not, the old frame will be drawn so the screen layout can still update
+            rawFrame = raw;
+            if (rawFrame)
+                uploadFrame(fb, 256, 192 * 2);
+            else if (gba)
+                uploadFrame(fb, 240, 160);
+            else
+                uploadFrame(fb, 256 * scale, 192 * scale);
         }
 
         // Rotate the texture coordinates
@@ -103,50 +176,53 @@ void NooCanvas::draw(wxPaintEvent &event)
             case 2: texCoords = 0xD2; break; // Counter-clockwise
         }
 
+#ifdef SHADER_DISPLAY
+        if (rawFrame)
+        {
+            // Draw from the raw frame, selecting the region of each screen in the shader
+            glUseProgram(program);
+            glBindTexture(GL_TEXTURE_2D, rawTexture);
+            glUniform1i(filterLoc, NooApp::getScreenFilter());
+
+            if (gbaMode)
+            {
+                // Draw the GBA screen, cropped from whichever DS screen it's on
+                int y = (emulator->core->gpu.readPowCnt1() & BIT(15)) ? 16 : (192 + 16);
+                glUniform4i(regionLoc, 8, y, 240, 160);
+                drawScreen(layout.getTopX(), layout.getTopY(), layout.getTopWidth(), layout.getTopHeight(), texCoords);
+            }
+            else // NDS mode
+            {
+                // Draw the DS top and bottom screens
+                glUniform4i(regionLoc, 0, 0, 256, 192);
+                drawScreen(layout.getTopX(), layout.getTopY(), layout.getTopWidth(), layout.getTopHeight(), texCoords);
+                glUniform4i(regionLoc, 0, 192, 256, 192);
+                drawScreen(layout.getBotX(), layout.getBotY(), layout.getBotWidth(), layout.getBotHeight(), texCoords);
+            }
+
+            glUseProgram(0);
+        }
+        else
+#endif
         if (gbaMode)
         {
             // Draw the GBA screen
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 240, 160, 0, GL_RGBA, GL_UNSIGNED_BYTE, &framebuffer[0]);
-            glBegin(GL_QUADS);
-            glTexCoord2i((texCoords >> 0) & 1, (texCoords >> 1) & 1);
-            glVertex2i(layout.getTopX() + layout.getTopWidth(), layout.getTopY() + layout.getTopHeight());
-            glTexCoord2i((texCoords >> 2) & 1, (texCoords >> 3) & 1);
-            glVertex2i(layout.getTopX(), layout.getTopY() + layout.getTopHeight());
-            glTexCoord2i((texCoords >> 4) & 1, (texCoords >> 5) & 1);
-            glVertex2i(layout.getTopX(), layout.getTopY());
-            glTexCoord2i((texCoords >> 6) & 1, (texCoords >> 7) & 1);
-            glVertex2i(layout.getTopX() + layout.getTopWidth(), layout.getTopY());
-            glEnd();
+            glBindTexture(GL_TEXTURE_2D, textures[0]);
+            drawScreen(layout.getTopX(), layout.getTopY(), layout.getTopWidth(), layout.getTopHeight(), texCoords);
         }
         else // NDS mode
         {
-            // Draw the DS top screen
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 256, 192, 0, GL_RGBA, GL_UNSIGNED_BYTE, &framebuffer[0]);
-            glBegin(GL_QUADS);
-            glTexCoord2i((texCoords >> 0) & 1, (texCoords >> 1) & 1);
-            glVertex2i(layout.getTopX() + layout.getTopWidth(), layout.getTopY() + layout.getTopHeight());
-            glTexCoord2i((texCoords >> 2) & 1, (texCoords >> 3) & 1);
-            glVertex2i(layout.getTopX(), layout.getTopY() + layout.getTopHeight());
-            glTexCoord2i((texCoords >> 4) & 1, (texCoords >> 5) & 1);
-            glVertex2i(layout.getTopX(), layout.getTopY());
-            glTexCoord2i((texCoords >> 6) & 1, (texCoords >> 7) & 1);
-            glVertex2i(layout.getTopX() + layout.getTopWidth(), layout.getTopY());
-            glEnd();
-
-            // Draw the DS bottom screen
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 256, 192, 0, GL_RGBA, GL_UNSIGNED_BYTE, &framebuffer[256 * 192]);
-            glBegin(GL_QUADS);
-            glTexCoord2i((texCoords >> 0) & 1, (texCoords >> 1) & 1);
-            glVertex2i(layout.getBotX() + layout.getBotWidth(), layout.getBotY() + layout.getBotHeight());
-            glTexCoord2i((texCoords >> 2) & 1, (texCoords >> 3) & 1);
-            glVertex2i(layout.getBotX(), layout.getBotY() + layout.getBotHeight());
-            glTexCoord2i((texCoords >> 4) & 1, (texCoords >> 5) & 1);
-            glVertex2i(layout.getBotX(), layout.getBotY());
-            glTexCoord2i((texCoords >> 6) & 1, (texCoords >> 7) & 1);
-            glVertex2i(layout.getBotX() + layout.getBotWidth(), layout.getBotY());
-            glEnd();
+            // Draw the DS top and bottom screens
+            glBindTexture(GL_TEXTURE_2D, textures[0]);
+            drawScreen(layout.getTopX(), layout.getTopY(), layout.getTopWidth(), layout.getTopHeight(), texCoords);
+            glBindTexture(GL_TEXTURE_2D, textures[1]);
+            drawScreen(layout.getBotX(), layout.getBotY(), layout.getBotWidth(), layout.getBotHeight(), texCoords);
         }
 
+        // Draw the profiler overlay on top of the screens if enabled
+        if (NooApp::getProfiler())
+            drawProfiler();
+
         display = true;
     }
     else
@@ -160,6 +236,166 @@ void NooCanvas::draw(wxPaintEvent &event)
     SwapBuffers();
 }
 
+void NooCanvas::initShader()
+{
+#ifdef SHADER_DISPLAY
+    // Compile the shaders, giving up if the context doesn't support them
+    GLuint shaders[2] = { glCreateShader(GL_VERTEX_SHADER), glCreateShader(GL_FRAGMENT_SHADER) };
+    const char *sources[2] = { vertexShader, fragmentShader };
+    GLint success = 0;
+
+    for (int i = 0; i < 2; i++)
+    {
+        glShaderSource(shaders[i], 1, &sources[i], nullptr);
+        glCompileShader(shaders[i]);
+        glGetShaderiv(shaders[i], GL_COMPILE_STATUS, &success);
+        if (!success) break;
+    }
+
+    if (success)
+    {
+        // Link the shaders into a program
+        program = glCreateProgram();
+        glAttachShader(program, shaders[0]);
+        glAttachShader(program, shaders[1]);
+        glLinkProgram(program);
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+    }
+
+    glDeleteShader(shaders[0]);
+    glDeleteShader(shaders[1]);
+
+    if (!success)
+    {
+        // Fall back to converting frames on the CPU
+        printf("Shader display is unavailable; falling back to CPU conversion\n");
+        if (program) glDeleteProgram(program);
+        program = 0;
+        return;
+    }
+
+    // Get the uniform locations, and point the shader at the first texture unit
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "frame"), 0);
+    regionLoc = glGetUniformLocation(program, "region");
+    filterLoc = glGetUniformLocation(program, "smoothing");
+    glUseProgram(0);
+
+    // Prepare an integer texture that holds raw frames with both screens, which is never filtered by the hardware
+    glGenTextures(1, &rawTexture);
+    glBindTexture(GL_TEXTURE_2D, rawTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, 256, 192 * 2, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+#endif
+}
+
+void NooCanvas::uploadFrame(const uint32_t *fb, int width, int height)
+{
+#ifdef SHADER_DISPLAY
+    if (rawFrame)
+    {
+        // Update the raw frame texture in place
+        glBindTexture(GL_TEXTURE_2D, rawTexture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RED_INTEGER, GL_UNSIGNED_INT, fb);
+        return;
+    }
+#endif
+
+    // Reallocate the screen textures only when the frame size changes
+    if (texWidth != width || texHeight != height)
+    {
+        texWidth = width;
+        texHeight = height;
+        for (int i = 0; i < 2; i++)
+        {
+            glBindTexture(GL_TEXTURE_2D, textures[i]);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+    }
+
+    // Update the screen textures in place, with only the top one used in GBA mode
+    for (int i = 0; i < (gbaMode ? 1 : 2); i++)
+    {
+        glBindTexture(GL_TEXTURE_2D, textures[i]);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, &fb[i * width * height]);
+    }
+}
+
+void NooCanvas::drawScreen(int x, int y, int width, int height, uint8_t texCoords)
+{
+    // Draw a screen as a textured quad, with texture coordinates rotated as given
+    glBegin(GL_QUADS);
+    glTexCoord2i((texCoords >> 0) & 1, (texCoords >> 1) & 1);
+    glVertex2i(x + width, y + height);
+    glTexCoord2i((texCoords >> 2) & 1, (texCoords >> 3) & 1);
+    glVertex2i(x, y + height);
+    glTexCoord2i((texCoords >> 4) & 1, (texCoords >> 5) & 1);
+    glVertex2i(x, y);
+    glTexCoord2i((texCoords >> 6) & 1, (texCoords >> 7) & 1);
+    glVertex2i(x + width, y);
+    glEnd();
+}
+
+void NooCanvas::drawProfiler()
+{
+    // Colors for each section: CPU, 2D, 3D, SPU, and DMA
+    static const uint8_t colors[][3] =
+    {
+        { 0x40, 0x80, 0xFF }, { 0x40, 0xFF, 0x40 }, { 0xFF, 0x80, 0x40 }, { 0xFF, 0xFF, 0x40 }, { 0xFF, 0x40, 0xFF }
+    };
+
+    // Get the results from the last frame
+    ProfileFrame profile = emulator->core->profiler.getLastFrame();
+
+    // Place the bars along the top of the top screen, where a full bar represents a frame at 60 FPS
+    int x = layout.getTopX(), y = layout.getTopY();
+    int width = layout.getTopWidth();
+    int height = std::max(layout.getTopHeight() / 32, 3);
+    const float frameTime = 1000000000.0f / 60;
+
+    glDisable(GL_TEXTURE_2D);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBegin(GL_QUADS);
+
+    // Darken the area behind the bars
+    glColor4ub(0x00, 0x00, 0x00, 0xA0);
+    glVertex2i(x,         y);
+    glVertex2i(x + width, y);
+    glVertex2i(x + width, y + height * (PROFILE_COUNT + 2));
+    glVertex2i(x,         y + height * (PROFILE_COUNT + 2));
+
+    // Draw the first row as every section stacked together, and then each section on its own row
+    int stack = x;
+    for (int i = 0; i < PROFILE_COUNT; i++)
+    {
+        int size = std::min<int>(profile.times[i] / frameTime * width, width);
+        int rows[] = { 0, i + 2 };
+        glColor4ub(colors[i][0], colors[i][1], colors[i][2], 0xFF);
+
+        for (int j = 0; j < 2; j++)
+        {
+            int left = (j == 0) ? stack : x;
+            int right = std::min(left + size, x + width);
+            int top = y + height * rows[j], bottom = top + height - 1;
+            glVertex2i(left,  top);
+            glVertex2i(right, top);
+            glVertex2i(right, bottom);
+            glVertex2i(left,  bottom);
+        }
+
+        stack = std::min(stack + size, x + width);
+    }
+
+    glEnd();
+
+    // Restore the state for drawing textures
+    glColor4ub(0xFF, 0xFF, 0xFF, 0xFF);
+    glDisable(GL_BLEND);
+    glEnable(GL_TEXTURE_2D);
+}
+
 void NooCanvas::resize(wxSizeEvent &event)
 {
     // Update the screen layout
@@ -185,15 +421,20 @@ void NooCanvas::resize(wxSizeEvent &event)
     glOrtho(0, size.x, size.y, 0, -1, 1);
     glViewport(0, 0, size.x, size.y);
 
-    // Set filtering
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, NooApp::getScreenFilter() ? GL_LINEAR : GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, NooApp::getScreenFilter() ? GL_LINEAR : GL_NEAREST);
+    // Set filtering on the screen textures
+    // Raw frames are filtered in the shader instead
+    for (int i = 0; i < 2; i++)
+    {
+        glBindTexture(GL_TEXTURE_2D, textures[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, NooApp::getScreenFilter() ? GL_LINEAR : GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, NooApp::getScreenFilter() ? GL_LINEAR : GL_NEAREST);
+    }
 }
 
 void NooCanvas::pressKey(wxKeyEvent &event)
 {
     // Trigger a key press if a mapped key was pressed
-    for (int i = 0; i < 14; i++)
+    for (int i = 0; i < 15; i++)
     {
         if (event.GetKeyCode() == NooApp::getKeyBind(i))
             frame->pressKey(i);
@@ -203,7 +444,7 @@ void NooCanvas::pressKey(wxKeyEvent &event)
 void NooCanvas::releaseKey(wxKeyEvent &event)
 {
     // Trigger a key release if a mapped key was released
-    for (int i = 0; i < 14; i++)
+    for (int i = 0; i < 15; i++)
     {
         if (event.GetKeyCode() == NooApp::getKeyBind(i))
             frame->releaseKey(i);
@@ -30,7 +30,6 @@ class NooCanvas: public wxGLCanvas
 {
     public:
         NooCanvas(NooFrame *frame, Emulator *emulator);
-        ~NooCanvas();
 
     private:
         NooFrame *frame;
@@ -38,11 +37,22 @@ class NooCanvas: public wxGLCanvas
         wxGLContext *context;
 
         ScreenLayout layout;
-        uint32_t *framebuffer = nullptr;
+        GLuint textures[2] = {};
+        int texWidth = 0, texHeight = 0;
         bool gbaMode = false;
         bool display = true;
 
+        GLuint rawTexture = 0;
+        GLuint program = 0;
+        GLint regionLoc = 0, filterLoc = 0;
+        bool rawFrame = false;
+
+        void initShader();
+        void uploadFrame(const uint32_t *fb, int width, int height);
+        void drawScreen(int x, int y, int width, int height, uint8_t texCoords);
+
         void resize();
+        void drawProfiler();
 
         void draw(wxPaintEvent &event);
         void resize(wxSizeEvent &event);
@@ -44,11 +44,29 @@ enum Event
     FPS_DISABLED,
     FPS_LIGHT,
     FPS_ACCURATE,
+    FPS_PACED,
+    SKIP_0,
+    SKIP_AUTO,
+    SKIP_1,
+    SKIP_2,
+    SKIP_3,
+    RESAMPLE_0,
+    RESAMPLE_1,
+    RESAMPLE_2,
     THREADED_2D,
     THREADED_3D_0,
     THREADED_3D_1,
     THREADED_3D_2,
     THREADED_3D_3,
+    THREADED_GEO,
+    HARDWARE_3D,
+    SCALE_3D_1,
+    SCALE_3D_2,
+    SCALE_3D_3,
+    SCALE_3D_4,
+    DUAL_SCREEN_3D,
+    PROFILER,
+    SHADER_DISPLAY,
     UPDATE_FPS
 };
 
@@ -68,11 +86,29 @@ EVT_MENU(DIRECT_BOOT,    NooFrame::directBootToggle)
 EVT_MENU(FPS_DISABLED,   NooFrame::fpsDisabled)
 EVT_MENU(FPS_LIGHT,      NooFrame::fpsLight)
 EVT_MENU(FPS_ACCURATE,   NooFrame::fpsAccurate)
+EVT_MENU(FPS_PACED,      NooFrame::fpsPaced)
+EVT_MENU(SKIP_0,         NooFrame::frameSkip0)
+EVT_MENU(SKIP_AUTO,      NooFrame::frameSkipAuto)
+EVT_MENU(SKIP_1,         NooFrame::frameSkip1)
+EVT_MENU(SKIP_2,         NooFrame::frameSkip2)
+EVT_MENU(SKIP_3,         NooFrame::frameSkip3)
+EVT_MENU(RESAMPLE_0,     NooFrame::resampler0)
+EVT_MENU(RESAMPLE_1,     NooFrame::resampler1)
+EVT_MENU(RESAMPLE_2,     NooFrame::resampler2)
 EVT_MENU(THREADED_2D,    NooFrame::threaded2D)
 EVT_MENU(THREADED_3D_0,  NooFrame::threaded3D0)
 EVT_MENU(THREADED_3D_1,  NooFrame::threaded3D1)
 EVT_MENU(THREADED_3D_2,  NooFrame::threaded3D2)
 EVT_MENU(THREADED_3D_3,  NooFrame::threaded3D3)
+EVT_MENU(THREADED_GEO,   NooFrame::threadedGeo)
+EVT_MENU(HARDWARE_3D,    NooFrame::hardware3D)
+EVT_MENU(SCALE_3D_1,     NooFrame::scale3D1)
+EVT_MENU(SCALE_3D_2,     NooFrame::scale3D2)
+EVT_MENU(SCALE_3D_3,     NooFrame::scale3D3)
+EVT_MENU(SCALE_3D_4,     NooFrame::scale3D4)
+EVT_MENU(DUAL_SCREEN_3D, NooFrame::dualScreen3D)
+EVT_MENU(PROFILER,       NooFrame::profilerToggle)
+EVT_MENU(SHADER_DISPLAY, NooFrame::shaderDisplayToggle)
 EVT_DROP_FILES(NooFrame::dropFiles)
 EVT_JOYSTICK_EVENTS(NooFrame::joystickInput)
 EVT_CLOSE(NooFrame::close)
@@ -112,13 +148,47 @@ NooFrame::NooFrame(wxJoystick *joystick, Emulator *emulator, std::string path):
     fpsLimiter->AppendRadioItem(FPS_DISABLED, "&Disabled");
     fpsLimiter->AppendRadioItem(FPS_LIGHT,    "&Light");
     fpsLimiter->AppendRadioItem(FPS_ACCURATE, "&Accurate");
+    fpsLimiter->AppendRadioItem(FPS_PACED,    "&Paced");
 
     // Set the current value of the FPS limiter setting
     switch (Settings::getFpsLimiter())
     {
         case 0:  fpsLimiter->Check(FPS_DISABLED, true); break;
         case 1:  fpsLimiter->Check(FPS_LIGHT,    true); break;
-        default: fpsLimiter->Check(FPS_ACCURATE, true); break;
+        case 2:  fpsLimiter->Check(FPS_ACCURATE, true); break;
+        default: fpsLimiter->Check(FPS_PACED,    true); break;
+    }
+
+    // Set up the Frame Skip submenu
+    wxMenu *frameSkip = new wxMenu();
+    frameSkip->AppendRadioItem(SKIP_0,    "&Disabled");
+    frameSkip->AppendRadioItem(SKIP_AUTO, "&Automatic");
+    frameSkip->AppendRadioItem(SKIP_1,    "&1 Frame");
+    frameSkip->AppendRadioItem(SKIP_2,    "&2 Frames");
+    frameSkip->AppendRadioItem(SKIP_3,    "&3 Frames");
+
+    // Set the current value of the frame skip setting
+    switch (Settings::getFrameSkip())
+    {
+        case 0:  frameSkip->Check(SKIP_0,    true); break;
+        case 1:  frameSkip->Check(SKIP_AUTO, true); break;
+        case 2:  frameSkip->Check(SKIP_1,    true); break;
+        case 3:  frameSkip->Check(SKIP_2,    true); break;
+        default: frameSkip->Check(SKIP_3,    true); break;
+    }
+
+    // Set up the Audio Resampling submenu
+    wxMenu *resampler = new wxMenu();
+    resampler->AppendRadioItem(RESAMPLE_0, "&Nearest");
+    resampler->AppendRadioItem(RESAMPLE_1, "&Linear");
+    resampler->AppendRadioItem(RESAMPLE_2, "&Cubic");
+
+    // Set the current value of the audio resampling setting
+    switch (Settings::getResampler())
+    {
+        case 0:  resampler->Check(RESAMPLE_0, true); break;
+        case 1:  resampler->Check(RESAMPLE_1, true); break;
+        default: resampler->Check(RESAMPLE_2, true); break;
     }
 
     // Set up the Threaded 3D submenu
@@ -137,6 +207,22 @@ NooFrame::NooFrame(wxJoystick *joystick, Emulator *emulator, std::string path):
         default: threaded3D->Check(THREADED_3D_3, true); break;
     }
 
+    // Set up the 3D Resolution submenu
+    wxMenu *scale3D = new wxMenu();
+    scale3D->AppendRadioItem(SCALE_3D_1, "&1x Native");
+    scale3D->AppendRadioItem(SCALE_3D_2, "&2x Native");
+    scale3D->AppendRadioItem(SCALE_3D_3, "&3x Native");
+    scale3D->AppendRadioItem(SCALE_3D_4, "&4x Native");
+
+    // Set the current value of the 3D scale setting
+    switch (Settings::getScale3D())
+    {
+        case 2:  scale3D->Check(SCALE_3D_2, true); break;
+        case 3:  scale3D->Check(SCALE_3D_3, true); break;
+        case 4:  scale3D->Check(SCALE_3D_4, true); break;
+        default: scale3D->Check(SCALE_3D_1, true); break;
+    }
+
     // Set up the Settings menu
     wxMenu *settingsMenu = new wxMenu();
     settingsMenu->Append(PATH_SETTINGS,  "&Path Settings");
@@ -145,13 +231,27 @@ NooFrame::NooFrame(wxJoystick *joystick, Emulator *emulator, std::string path):
     settingsMenu->AppendSeparator();
     settingsMenu->AppendCheckItem(DIRECT_BOOT, "&Direct Boot");
     settingsMenu->AppendSubMenu(fpsLimiter, "&FPS Limiter");
+    settingsMenu->AppendSubMenu(frameSkip, "Frame S&kip");
+    settingsMenu->AppendSubMenu(resampler, "&Audio Resampling");
     settingsMenu->AppendSeparator();
     settingsMenu->AppendCheckItem(THREADED_2D, "&Threaded 2D");
     settingsMenu->AppendSubMenu(threaded3D, "&Threaded 3D");
+    settingsMenu->AppendCheckItem(THREADED_GEO, "Threaded &Geometry");
+    settingsMenu->AppendCheckItem(HARDWARE_3D, "&Hardware 3D");
+    settingsMenu->AppendSubMenu(scale3D, "3D &Resolution");
+    settingsMenu->AppendCheckItem(DUAL_SCREEN_3D, "D&ual-Screen 3D");
+    settingsMenu->AppendSeparator();
+    settingsMenu->AppendCheckItem(PROFILER, "&Profiler Overlay");
+    settingsMenu->AppendCheckItem(SHADER_DISPLAY, "Sha&der Display");
 
     // Set the current values of the checkboxes
     settingsMenu->Check(DIRECT_BOOT, Settings::getDirectBoot());
     settingsMenu->Check(THREADED_2D, Settings::getThreaded2D());
+    settingsMenu->Check(THREADED_GEO, Settings::getThreadedGeo());
+    settingsMenu->Check(HARDWARE_3D, Settings::getHardware3D());
+    settingsMenu->Check(DUAL_SCREEN_3D, Settings::getDualScreen3D());
+    settingsMenu->Check(PROFILER,    NooApp::getProfiler());
+    settingsMenu->Check(SHADER_DISPLAY, NooApp::getShaderDisplay());
 
     // Set up the menu bar
     wxMenuBar *menuBar = new wxMenuBar();
@@ -191,7 +291,14 @@ void NooFrame::runCore()
 {
     // Run the emulator
     while (emulator->running)
-        emulator->core->runFrame();
+    {
+        // Step back through the rewind history while rewind is held, or run and record a new frame
+        if (!emulator->rewinding || !emulator->core->rewind.rewindFrame())
+        {
+            emulator->core->runAhead.runFrame();
+            emulator->core->rewind.recordFrame();
+        }
+    }
 }
 
 void NooFrame::startCore(bool full)
@@ -205,6 +312,7 @@ void NooFrame::startCore(bool full)
         {
             // Attempt to boot the core
             emulator->core = new Core(ndsPath, gbaPath);
+            emulator->core->profiler.setEnabled(NooApp::getProfiler());
         }
         catch (int e)
         {
@@ -295,6 +403,7 @@ void NooFrame::pressKey(int key)
             {
                 fpsLimiterBackup = Settings::getFpsLimiter();
                 Settings::setFpsLimiter(0);
+                updateConfig();
             }
             break;
         }
@@ -307,6 +416,13 @@ void NooFrame::pressKey(int key)
             break;
         }
 
+        case 14: // Rewind
+        {
+            // Start stepping back through the rewind history
+            emulator->rewinding = true;
+            break;
+        }
+
         default: // Core input
         {
             // Send a key press to the core
@@ -329,10 +445,18 @@ void NooFrame::releaseKey(int key)
             {
                 Settings::setFpsLimiter(fpsLimiterBackup);
                 fpsLimiterBackup = 0;
+                updateConfig();
             }
             break;
         }
 
+        case 14: // Rewind
+        {
+            // Stop rewinding and continue from the current frame
+            emulator->rewinding = false;
+            break;
+        }
+
         default: // Core input
         {
             // Send a key release to the core
@@ -343,6 +467,12 @@ void NooFrame::releaseKey(int key)
     }
 }
 
+void NooFrame::updateConfig()
+{
+    // Pass the settings to the running core, so changes to the ones that apply while running take effect
+    if (emulator->core) emulator->core->setConfig(Settings::getConfig());
+}
+
 void NooFrame::loadRomPath(std::string path)
 {
     // Set the NDS or GBA ROM path depending on the extension of the given file
@@ -487,6 +617,7 @@ void NooFrame::directBootToggle(wxCommandEvent &event)
     // Toggle the direct boot setting
     Settings::setDirectBoot(!Settings::getDirectBoot());
     Settings::save();
+    updateConfig();
 }
 
 void NooFrame::fpsDisabled(wxCommandEvent &event)
@@ -494,6 +625,7 @@ void NooFrame::fpsDisabled(wxCommandEvent &event)
     // Set the FPS limiter setting to disabled
     Settings::setFpsLimiter(0);
     Settings::save();
+    updateConfig();
 }
 
 void NooFrame::fpsLight(wxCommandEvent &event)
@@ -501,6 +633,7 @@ void NooFrame::fpsLight(wxCommandEvent &event)
     // Set the FPS limiter setting to light
     Settings::setFpsLimiter(1);
     Settings::save();
+    updateConfig();
 }
 
 void NooFrame::fpsAccurate(wxCommandEvent &event)
@@ -508,6 +641,79 @@ void NooFrame::fpsAccurate(wxCommandEvent &event)
     // Set the FPS limiter setting to accurate
     Settings::setFpsLimiter(2);
     Settings::save();
+    updateConfig();
+}
+
+void NooFrame::fpsPaced(wxCommandEvent &event)
+{
+    // Set the FPS limiter setting to paced
+    Settings::setFpsLimiter(3);
+    Settings::save();
+    updateConfig();
+}
+
+void NooFrame::frameSkip0(wxCommandEvent &event)
+{
+    // Set the frame skip setting to disabled
+    Settings::setFrameSkip(0);
+    Settings::save();
+    updateConfig();
+}
+
+void NooFrame::frameSkipAuto(wxCommandEvent &event)
+{
+    // Set the frame skip setting to automatic
+    Settings::setFrameSkip(1);
+    Settings::save();
+    updateConfig();
+}
+
+void NooFrame::frameSkip1(wxCommandEvent &event)
+{
+    // Set the frame skip setting to skip 1 frame between drawn ones
+    Settings::setFrameSkip(2);
+    Settings::save();
+    updateConfig();
+}
+
+void NooFrame::frameSkip2(wxCommandEvent &event)
+{
+    // Set the frame skip setting to skip 2 frames between drawn ones
+    Settings::setFrameSkip(3);
+    Settings::save();
+    updateConfig();
+}
+
+void NooFrame::frameSkip3(wxCommandEvent &event)
+{
+    // Set the frame skip setting to skip 3 frames between drawn ones
+    Settings::setFrameSkip(4);
+    Settings::save();
+    updateConfig();
+}
+
+void NooFrame::resampler0(wxCommandEvent &event)
+{
+    // Set the audio resampling setting to nearest
+    Settings::setResampler(0);
+    Settings::save();
+    updateConfig();
+}
+
+void NooFrame::resampler1(wxCommandEvent &event)
+{
+    // Set the audio resampling setting to linear
+    Settings::setResampler(1);
+    Settings::save();
+    updateConfig();
+}
+
+void NooFrame::resampler2(wxCommandEvent &event)
+{
+    // Set the audio resampling setting to cubic
+    Settings::setResampler(2);
+    Settings::save();
+    updateConfig();
 }
 
 void NooFrame::threaded2D(wxCommandEvent &event)
@@ -515,6 +721,7 @@ void NooFrame::threaded2D(wxCommandEvent &event)
     // Toggle the threaded 2D setting
     Settings::setThreaded2D(!Settings::getThreaded2D());
     Settings::save();
+    updateConfig();
 }
 
 void NooFrame::threaded3D0(wxCommandEvent &event)
@@ -522,6 +729,7 @@ void NooFrame::threaded3D0(wxCommandEvent &event)
     // Set the threaded 3D setting to disabled
     Settings::setThreaded3D(0);
     Settings::save();
+    updateConfig();
 }
 
 void NooFrame::threaded3D1(wxCommandEvent &event)
@@ -529,6 +737,7 @@ void NooFrame::threaded3D1(wxCommandEvent &event)
     // Set the threaded 3D setting to 1 thread
     Settings::setThreaded3D(1);
     Settings::save();
+    updateConfig();
 }
 
 void NooFrame::threaded3D2(wxCommandEvent &event)
@@ -536,6 +745,7 @@ void NooFrame::threaded3D2(wxCommandEvent &event)
     // Set the threaded 3D setting to 2 threads
     Settings::setThreaded3D(2);
     Settings::save();
+    updateConfig();
 }
 
 void NooFrame::threaded3D3(wxCommandEvent &event)
@@ -543,6 +753,78 @@ void NooFrame::threaded3D3(wxCommandEvent &event)
     // Set the threaded 3D setting to 3 threads
     Settings::setThreaded3D(3);
     Settings::save();
+    updateConfig();
+}
+
+void NooFrame::threadedGeo(wxCommandEvent &event)
+{
+    // Toggle the threaded geometry setting
+    Settings::setThreadedGeo(!Settings::getThreadedGeo());
+    Settings::save();
+    updateConfig();
+}
+
+void NooFrame::hardware3D(wxCommandEvent &event)
+{
+    // Toggle the hardware 3D setting
+    Settings::setHardware3D(!Settings::getHardware3D());
+    Settings::save();
+    updateConfig();
+}
+
+void NooFrame::scale3D1(wxCommandEvent &event)
+{
+    // Set the 3D scale setting to native resolution
+    Settings::setScale3D(1);
+    Settings::save();
+    updateConfig();
+}
+
+void NooFrame::scale3D2(wxCommandEvent &event)
+{
+    // Set the 3D scale setting to 2x native resolution
+    Settings::setScale3D(2);
+    Settings::save();
+    updateConfig();
+}
+
+void NooFrame::scale3D3(wxCommandEvent &event)
+{
+    // Set the 3D scale setting to 3x native resolution
+    Settings::setScale3D(3);
+    Settings::save();
+    updateConfig();
+}
+
+void NooFrame::scale3D4(wxCommandEvent &event)
+{
+    // Set the 3D scale setting to 4x native resolution
+    Settings::setScale3D(4);
+    Settings::save();
+    updateConfig();
+}
+
+void NooFrame::dualScreen3D(wxCommandEvent &event)
+{
+    // Toggle the dual-screen 3D enhancement
+    Settings::setDualScreen3D(!Settings::getDualScreen3D());
+    Settings::save();
+    updateConfig();
+}
+
+void NooFrame::profilerToggle(wxCommandEvent &event)
+{
+    // Toggle the profiler overlay, along with the profiler itself
+    NooApp::setProfiler(!NooApp::getProfiler());
+    if (emulator->core) emulator->core->profiler.setEnabled(NooApp::getProfiler());
+    Settings::save();
+}
+
+void NooFrame::shaderDisplayToggle(wxCommandEvent &event)
+{
+    // Toggle converting frames on the GPU instead of the CPU
+    NooApp::setShaderDisplay(!NooApp::getShaderDisplay());
+    Settings::save();
 }
 
 void NooFrame::dropFiles(wxDropFilesEvent &event)
@@ -557,7 +839,7 @@ void NooFrame::dropFiles(wxDropFilesEvent &event)
 void NooFrame::joystickInput(wxJoystickEvent &event)
 {
     // Check the status of mapped joystick inputs and trigger key presses and releases accordingly
-    for (int i = 0; i < 14; i++)
+    for (int i = 0; i < 15; i++)
     {
         if (NooApp::getKeyBind(i) >= 3000 && joystick->GetNumberAxes() > NooApp::getKeyBind(i) - 3000) // Axis -
         {
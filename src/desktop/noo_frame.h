@@ -30,6 +30,7 @@ struct Emulator
 {
     Core *core = nullptr;
     bool running = false;
+    bool rewinding = false;
     bool frameReset = false;
 };
 
@@ -57,6 +58,7 @@ class NooFrame: public wxFrame
         bool fullScreen = false;
 
         void runCore();
+        void updateConfig();
         void loadRomPath(std::string path);
 
         void loadRom(wxCommandEvent &event);
@@ -74,11 +76,29 @@ class NooFrame: public wxFrame
         void fpsDisabled(wxCommandEvent &event);
         void fpsLight(wxCommandEvent &event);
         void fpsAccurate(wxCommandEvent &event);
+        void fpsPaced(wxCommandEvent &event);
+        void frameSkip0(wxCommandEvent &event);
+        void frameSkipAuto(wxCommandEvent &event);
+        void frameSkip1(wxCommandEvent &event);
+        void frameSkip2(wxCommandEvent &event);
+        void frameSkip3(wxCommandEvent &event);
+        void resampler0(wxCommandEvent &event);
+        void resampler1(wxCommandEvent &event);
+        void resampler2(wxCommandEvent &event);
         void threaded2D(wxCommandEvent &event);
         void threaded3D0(wxCommandEvent &event);
         void threaded3D1(wxCommandEvent &event);
         void threaded3D2(wxCommandEvent &event);
         void threaded3D3(wxCommandEvent &event);
+        void threadedGeo(wxCommandEvent &event);
+        void hardware3D(wxCommandEvent &event);
+        void scale3D1(wxCommandEvent &event);
+        void scale3D2(wxCommandEvent &event);
+        void scale3D3(wxCommandEvent &event);
+        void scale3D4(wxCommandEvent &event);
+        void dualScreen3D(wxCommandEvent &event);
+        void profilerToggle(wxCommandEvent &event);
+        void shaderDisplayToggle(wxCommandEvent &event);
         void dropFiles(wxDropFilesEvent &event);
         void joystickInput(wxJoystickEvent &event);
         void close(wxCloseEvent &event);
@@ -22,8 +22,49 @@
 #include "div_sqrt.h"
 #include "core.h"
 
+void DivSqrt::syncState(Savestate *state)
+{
+    // Sync the registers
+    state->sync(divCnt);
+    state->sync(divNumer);
+    state->sync(divDenom);
+    state->sync(divResult);
+    state->sync(divRemResult);
+    state->sync(sqrtCnt);
+    state->sync(sqrtResult);
+    state->sync(sqrtParam);
+    state->sync(divDirty);
+    state->sync(sqrtDirty);
+    state->sync(divEndCycles);
+    state->sync(sqrtEndCycles);
+}
+
+void DivSqrt::resetCycles()
+{
+    // Adjust the end cycles for a global cycle reset, clamping ones that have already passed
+    uint32_t cycles = core->getGlobalCycles();
+    divEndCycles = (divEndCycles > cycles) ? (divEndCycles - cycles) : 0;
+    sqrtEndCycles = (sqrtEndCycles > cycles) ? (sqrtEndCycles - cycles) : 0;
+}
+
+void DivSqrt::startDivide()
+{
+    // Restart the division, which takes 18 cycles in 32-bit mode and 34 otherwise at the ARM9 bus speed
+    divDirty = true;
+    divEndCycles = core->getCpuCycles(0) + (((divCnt & 0x0003) == 0) ? 36 : 68);
+}
+
+void DivSqrt::startSquareRoot()
+{
+    // Restart the square root, which takes 13 cycles at the ARM9 bus speed
+    sqrtDirty = true;
+    sqrtEndCycles = core->getCpuCycles(0) + 26;
+}
+
 void DivSqrt::divide()
 {
+    divDirty = false;
+
     // Set the division by zero error bit
     // The bit only gets set if the full 64-bit denominator is zero, even in 32-bit mode
     if (divDenom == 0) divCnt |= BIT(14); else divCnt &= ~BIT(14);
@@ -95,6 +136,8 @@ void DivSqrt::divide()
 
 void DivSqrt::squareRoot()
 {
+    sqrtDirty = false;
+
     // Calculate the square root result
     switch (sqrtCnt & 0x0001) // Square root mode
     {
@@ -108,13 +151,32 @@ void DivSqrt::squareRoot()
     }
 }
 
+uint16_t DivSqrt::readDivCnt()
+{
+    // Read the DIVCNT register, with the division by zero bit brought up to date and the busy bit set if unfinished
+    // The busy bit clears without a task to wake the CPU, so a loop polling it shouldn't be treated as idle
+    if (divDirty) divide();
+    bool busy = (int32_t)(divEndCycles - core->getCpuCycles(0)) > 0;
+    if (busy) core->interpreter[0].wakeIdle();
+    return divCnt | (busy << 15);
+}
+
+uint16_t DivSqrt::readSqrtCnt()
+{
+    // Read the SQRTCNT register, with the busy bit set if unfinished
+    // The busy bit clears without a task to wake the CPU, so a loop polling it shouldn't be treated as idle
+    bool busy = (int32_t)(sqrtEndCycles - core->getCpuCycles(0)) > 0;
+    if (busy) core->interpreter[0].wakeIdle();
+    return sqrtCnt | (busy << 15);
+}
+
 void DivSqrt::writeDivCnt(uint16_t mask, uint16_t value)
 {
     // Write to the DIVCNT register
     mask &= 0x0003;
     divCnt = (divCnt & ~mask) | (value & mask);
 
-    divide();
+    startDivide();
 }
 
 void DivSqrt::writeDivNumerL(uint32_t mask, uint32_t value)
@@ -122,7 +184,7 @@ void DivSqrt::writeDivNumerL(uint32_t mask, uint32_t value)
     // Write to the DIVNUMER register
     divNumer = (divNumer & ~((uint64_t)mask)) | (value & mask);
 
-    divide();
+    startDivide();
 }
 
 void DivSqrt::writeDivNumerH(uint32_t mask, uint32_t value)
@@ -130,7 +192,7 @@ void DivSqrt::writeDivNumerH(uint32_t mask, uint32_t value)
     // Write to the DIVNUMER register
     divNumer = (divNumer & ~((uint64_t)mask << 32)) | ((uint64_t)(value & mask) << 32);
 
-    divide();
+    startDivide();
 }
 
 void DivSqrt::writeDivDenomL(uint32_t mask, uint32_t value)
@@ -138,7 +200,7 @@ void DivSqrt::writeDivDenomL(uint32_t mask, uint32_t value)
     // Write to the DIVDENOM register
     divDenom = (divDenom & ~((uint64_t)mask)) | (value & mask);
 
-    divide();
+    startDivide();
 }
 
 void DivSqrt::writeDivDenomH(uint32_t mask, uint32_t value)
@@ -146,7 +208,7 @@ void DivSqrt::writeDivDenomH(uint32_t mask, uint32_t value)
     // Write to the DIVDENOM register
     divDenom = (divDenom & ~((uint64_t)mask << 32)) | ((uint64_t)(value & mask) << 32);
 
-    divide();
+    startDivide();
 }
 
 void DivSqrt::writeSqrtCnt(uint16_t mask, uint16_t value)
@@ -155,7 +217,7 @@ void DivSqrt::writeSqrtCnt(uint16_t mask, uint16_t value)
     mask &= 0x0001;
     sqrtCnt = (sqrtCnt & ~mask) | (value & mask);
 
-    squareRoot();
+    startSquareRoot();
 }
 
 void DivSqrt::writeSqrtParamL(uint32_t mask, uint32_t value)
@@ -163,7 +225,7 @@ void DivSqrt::writeSqrtParamL(uint32_t mask, uint32_t value)
     // Write to the DIVDENOM register
     sqrtParam = (sqrtParam & ~((uint64_t)mask)) | (value & mask);
 
-    squareRoot();
+    startSquareRoot();
 }
 
 void DivSqrt::writeSqrtParamH(uint32_t mask, uint32_t value)
@@ -171,5 +233,5 @@ void DivSqrt::writeSqrtParamH(uint32_t mask, uint32_t value)
     // Write to the SQRTPARAM register
     sqrtParam = (sqrtParam & ~((uint64_t)mask << 32)) | ((uint64_t)(value & mask) << 32);
 
-    squareRoot();
+    startSquareRoot();
 }
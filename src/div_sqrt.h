@@ -23,25 +23,29 @@
 #include <cstdint>
 
 class Core;
+class Savestate;
 
 class DivSqrt
 {
     public:
         DivSqrt(Core *core): core(core) {}
 
-        uint16_t readDivCnt()        { return divCnt;             }
-        uint32_t readDivNumerL()     { return divNumer;           }
-        uint32_t readDivNumerH()     { return divNumer     >> 32; }
-        uint32_t readDivDenomL()     { return divDenom;           }
-        uint32_t readDivDenomH()     { return divDenom     >> 32; }
-        uint32_t readDivResultL()    { return divResult;          }
-        uint32_t readDivResultH()    { return divResult    >> 32; }
-        uint32_t readDivRemResultL() { return divRemResult;       }
-        uint32_t readDivRemResultH() { return divRemResult >> 32; }
-        uint16_t readSqrtCnt()       { return sqrtCnt;            }
-        uint32_t readSqrtResult()    { return sqrtResult;         }
-        uint32_t readSqrtParamL()    { return sqrtParam;          }
-        uint32_t readSqrtParamH()    { return sqrtParam    >> 32; }
+        void syncState(Savestate *state);
+        void resetCycles();
+
+        uint16_t readDivCnt();
+        uint32_t readDivNumerL()     { return divNumer;                                   }
+        uint32_t readDivNumerH()     { return divNumer     >> 32;                         }
+        uint32_t readDivDenomL()     { return divDenom;                                   }
+        uint32_t readDivDenomH()     { return divDenom     >> 32;                         }
+        uint32_t readDivResultL()    { if (divDirty) divide(); return divResult;          }
+        uint32_t readDivResultH()    { if (divDirty) divide(); return divResult    >> 32; }
+        uint32_t readDivRemResultL() { if (divDirty) divide(); return divRemResult;       }
+        uint32_t readDivRemResultH() { if (divDirty) divide(); return divRemResult >> 32; }
+        uint16_t readSqrtCnt();
+        uint32_t readSqrtResult()    { if (sqrtDirty) squareRoot(); return sqrtResult;    }
+        uint32_t readSqrtParamL()    { return sqrtParam;                                  }
+        uint32_t readSqrtParamH()    { return sqrtParam    >> 32;                         }
 
         void writeDivCnt(uint16_t mask, uint16_t value);
         void writeDivNumerL(uint32_t mask, uint32_t value);
@@ -65,6 +69,14 @@ class DivSqrt
         uint32_t sqrtResult = 0;
         uint64_t sqrtParam = 0;
 
+        // Results are only calculated when they're read, so a parameter written in parts is only processed once
+        // The busy bits are based on the cycle each calculation finishes, instead of scheduling the end
+        // Reading a busy bit keeps the ARM9 out of idle loop halts, since no task comes along to wake it
+        bool divDirty = false, sqrtDirty = false;
+        uint32_t divEndCycles = 0, sqrtEndCycles = 0;
+
+        void startDivide();
+        void startSquareRoot();
         void divide();
         void squareRoot();
 };
@@ -17,15 +17,29 @@
     along with NooDS. If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <cstring>
+
+#if !defined(_WIN32) && !defined(__SWITCH__)
+#include <sys/mman.h>
+#define SD_MMAP
+#endif
+
 #include "dldi.h"
 #include "core.h"
-#include "settings.h"
 
 Dldi::~Dldi()
 {
-    // Ensure the SD image is closed
+    // Ensure the SD image is written back and closed
     if (sdImage)
-        fclose(sdImage);
+        closeImage();
+}
+
+void Dldi::syncState(Savestate *state)
+{
+    // Sync the address of the patched driver functions
+    // The SD image is a file on the host, so it isn't part of the state
+    state->sync(funcAddress);
 }
 
 void Dldi::patchDriver(uint32_t address)
@@ -60,8 +74,27 @@ bool Dldi::isFunction(uint32_t address)
 int Dldi::startup()
 {
     // Try to open the SD image
-    sdImage = fopen(Settings::getSdImagePath().c_str(), "rb+");
-    return (sdImage ? 1 : 0);
+    sdImage = fopen(core->config.sdImagePath.c_str(), "rb+");
+    if (!sdImage) return 0;
+    fseek(sdImage, 0, SEEK_END);
+    sdSize = ftell(sdImage);
+
+#ifdef SD_MMAP
+    // Map the SD image into memory if possible, with changes shared back to the file
+    if (sdSize > 0)
+    {
+        void *map = mmap(nullptr, sdSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileno(sdImage), 0);
+        if (map != MAP_FAILED)
+        {
+            sdMap = (uint8_t*)map;
+            return 1;
+        }
+    }
+#endif
+
+    // Fall back to accessing the SD image through the block cache
+    sdCache.resize(64);
+    return 1;
 }
 
 int Dldi::isInserted()
@@ -74,19 +107,29 @@ int Dldi::readSectors(int sector, int numSectors, uint32_t buf)
 {
     if (!sdImage) return 0;
 
-    const int offset = sector * 0x200;
-    const int size = numSectors * 0x200;
+    int64_t offset = (int64_t)sector * 0x200;
+    int size = numSectors * 0x200;
 
-    // Read data from the SD image
-    uint8_t *data = new uint8_t[size];
-    fseek(sdImage, offset, SEEK_SET);
-    fread(data, sizeof(uint8_t), size, sdImage);
+    if (sdMap)
+    {
+        // Write the data to memory directly from the mapped SD image
+        if (offset + size > sdSize) return 0;
+        copyToMemory(buf, &sdMap[offset], size);
+        return 1;
+    }
 
-    // Write the data to memory
-    for (int i = 0; i < size; i++)
-        core->memory.write<uint8_t>(0, buf + i, data[i]);
+    // Write the data to memory from cached blocks, loading any that are missing
+    while (size > 0)
+    {
+        SdBlock *block = getBlock(offset >> 16, true);
+        int start = offset & 0xFFFF;
+        int length = std::min(size, 0x10000 - start);
+        copyToMemory(buf, &block->data[start], length);
+        offset += length;
+        buf += length;
+        size -= length;
+    }
 
-    delete[] data;
     return 1;
 }
 
@@ -94,19 +137,32 @@ int Dldi::writeSectors(int sector, int numSectors, uint32_t buf)
 {
     if (!sdImage) return 0;
 
-    const int offset = sector * 0x200;
-    const int size = numSectors * 0x200;
+    int64_t offset = (int64_t)sector * 0x200;
+    int size = numSectors * 0x200;
 
-    // Read data from memory
-    uint8_t *data = new uint8_t[size];
-    for (int i = 0; i < size; i++)
-        data[i] = core->memory.read<uint8_t>(0, buf + i);
+    if (sdMap)
+    {
+        // Read the data from memory directly into the mapped SD image
+        if (offset + size > sdSize) return 0;
+        copyFromMemory(buf, &sdMap[offset], size);
+        return 1;
+    }
 
-    // Write the data to the SD image
-    fseek(sdImage, offset, SEEK_SET);
-    fwrite(data, sizeof(uint8_t), size, sdImage);
+    // Read the data from memory into cached blocks, which are written back to the SD image later
+    // Blocks that are completely overwritten don't need to be loaded first
+    while (size > 0)
+    {
+        int start = offset & 0xFFFF;
+        int length = std::min(size, 0x10000 - start);
+        SdBlock *block = getBlock(offset >> 16, length < 0x10000);
+        copyFromMemory(buf, &block->data[start], length);
+        block->dirty = true;
+        sdSize = std::max(sdSize, offset + length);
+        offset += length;
+        buf += length;
+        size -= length;
+    }
 
-    delete[] data;
     return 1;
 }
 
@@ -121,7 +177,103 @@ int Dldi::shutdown()
     if (!sdImage) return 0;
 
     // Close the SD image
+    closeImage();
+    return 1;
+}
+
+void Dldi::closeImage()
+{
+#ifdef SD_MMAP
+    // Unmap the SD image, which leaves the OS to finish writing it back
+    if (sdMap)
+        munmap(sdMap, sdSize);
+#endif
+
+    // Write back any changed blocks before closing the SD image
+    for (size_t i = 0; i < sdCache.size(); i++)
+        flushBlock(&sdCache[i]);
+
     fclose(sdImage);
     sdImage = nullptr;
-    return 1;
+    sdMap = nullptr;
+    sdCache.clear();
+}
+
+SdBlock *Dldi::getBlock(int64_t index, bool load)
+{
+    // Look for the block in the cache, keeping track of the least recently used one
+    SdBlock *block = &sdCache[0];
+    for (size_t i = 0; i < sdCache.size(); i++)
+    {
+        if (sdCache[i].index == index)
+        {
+            sdCache[i].lastUse = ++sdUseCount;
+            return &sdCache[i];
+        }
+        if (sdCache[i].lastUse < block->lastUse)
+            block = &sdCache[i];
+    }
+
+    // Replace the least recently used block, writing it back first if it changed
+    flushBlock(block);
+    block->index = index;
+    block->lastUse = ++sdUseCount;
+
+    // Read the whole block at once, so sequential reads of the following sectors don't need to touch the file
+    // Anything past the end of the SD image reads as zero
+    int size = 0;
+    if (load && (index << 16) < sdSize)
+    {
+        fseek(sdImage, index << 16, SEEK_SET);
+        size = fread(block->data, sizeof(uint8_t), std::min<int64_t>(0x10000, sdSize - (index << 16)), sdImage);
+    }
+    memset(&block->data[size], 0, 0x10000 - size);
+    return block;
+}
+
+void Dldi::flushBlock(SdBlock *block)
+{
+    // Write a changed block back to the SD image in one go, without going past the data that exists
+    if (!block->dirty) return;
+    fseek(sdImage, block->index << 16, SEEK_SET);
+    fwrite(block->data, sizeof(uint8_t), std::min<int64_t>(0x10000, sdSize - (block->index << 16)), sdImage);
+    block->dirty = false;
+}
+
+void Dldi::copyToMemory(uint32_t address, const uint8_t *data, int size)
+{
+    // Write data to memory a page at a time, falling back to single bytes for pages that aren't plain memory
+    while (size > 0)
+    {
+        int length = std::min(size, 0x1000 - (int)(address & 0xFFF));
+        if (!core->memory.writeBlock(0, address, data, length))
+        {
+            for (int i = 0; i < length; i++)
+                core->memory.write<uint8_t>(0, address + i, data[i]);
+        }
+        address += length;
+        data += length;
+        size -= length;
+    }
+}
+
+void Dldi::copyFromMemory(uint32_t address, uint8_t *data, int size)
+{
+    // Read data from memory a page at a time, falling back to single bytes for pages that aren't plain memory
+    while (size > 0)
+    {
+        int length = std::min(size, 0x1000 - (int)(address & 0xFFF));
+        if (uint8_t *from = core->memory.getReadPointer(0, address))
+        {
+            memcpy(data, from, length);
+        }
+        else
+        {
+            for (int i = 0; i < length; i++)
+                data[i] = core->memory.read<uint8_t>(0, address + i);
+        }
+        address += length;
+        data += length;
+        size -= length;
+    }
 }
@@ -22,8 +22,10 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <vector>
 
 class Core;
+class Savestate;
 
 enum DldiFunc
 {
@@ -35,12 +37,22 @@ enum DldiFunc
     DLDI_STOP
 };
 
+struct SdBlock
+{
+    int64_t index = -1;
+    bool dirty = false;
+    uint32_t lastUse = 0;
+    uint8_t data[0x10000];
+};
+
 class Dldi
 {
     public:
         Dldi(Core *core): core(core) {}
         ~Dldi();
 
+        void syncState(Savestate *state);
+
         void patchDriver(uint32_t address);
         bool isFunction(uint32_t address);
 
@@ -56,6 +68,20 @@ class Dldi
 
         uint32_t funcAddress = 0;
         FILE *sdImage = nullptr;
+
+        // The SD image is mapped into memory when possible, so the OS handles caching and writing it back
+        // Otherwise, it's accessed through a cache of 64KB blocks, which reads ahead and coalesces writes
+        uint8_t *sdMap = nullptr;
+        int64_t sdSize = 0;
+        std::vector<SdBlock> sdCache;
+        uint32_t sdUseCount = 0;
+
+        void closeImage();
+        SdBlock *getBlock(int64_t index, bool load);
+        void flushBlock(SdBlock *block);
+
+        void copyToMemory(uint32_t address, const uint8_t *data, int size);
+        void copyFromMemory(uint32_t address, uint8_t *data, int size);
 };
 
 #endif // DLDI_H
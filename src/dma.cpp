@@ -17,6 +17,8 @@
     along with NooDS. If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+
 #include "dma.h"
 #include "core.h"
 
@@ -27,13 +29,42 @@ Dma::Dma(Core *core, bool cpu): core(core), cpu(cpu)
         transferTask[i] = std::bind(&Dma::transfer, this, i);
 }
 
+void Dma::syncState(Savestate *state)
+{
+    // Register the tasks so they can be referenced by ID
+    for (int i = 0; i < 4; i++)
+        state->addTask(&transferTask[i]);
+
+    // Sync the transfer state and registers
+    state->sync(srcAddrs);
+    state->sync(dstAddrs);
+    state->sync(wordCounts);
+    state->sync(dmaSad);
+    state->sync(dmaDad);
+    state->sync(dmaCnt);
+}
+
 void Dma::transfer(int channel)
 {
+    ProfileScope scope(&core->profiler, PROFILE_DMA);
+
     int dstAddrCnt = (dmaCnt[channel] & 0x00600000) >> 21;
     int srcAddrCnt = (dmaCnt[channel] & 0x01800000) >> 23;
     int mode       = (dmaCnt[channel] & 0x38000000) >> 27;
     int gxFifoCount = 0;
 
+    // Plain memory copies and fills go in bulk a page at a time, when the destination increments and the source doesn't decrement
+    // GXFIFO transfers are left out, since their destination is an I/O port
+    bool bulk = (mode != 7 && (dstAddrCnt == 0 || dstAddrCnt == 3) && srcAddrCnt != 1);
+
+    // GXFIFO transfers from incrementing memory to the fixed GXFIFO port can hand their words to the geometry engine directly
+    bool gxBulk = (mode == 7 && cpu == 0 && srcAddrCnt == 0 && dstAddrCnt == 2 && (dstAddrs[channel] & ~0x3F) == 0x4000400);
+
+    // DS cart transfers that repeat a word at a time from the fixed data port into incrementing memory can take the rest of the block at once
+    // This is left out if the transfer has an IRQ, since it would only fire once instead of for every word
+    bool cartBulk = (mode == (cpu ? 4 : 5) && !core->isGbaMode() && srcAddrCnt == 2 && dstAddrCnt == 0 && srcAddrs[channel] == 0x4100010 &&
+        wordCounts[channel] == 1 && (dmaCnt[channel] & BIT(25)) && !(dmaCnt[channel] & BIT(30)));
+
     // Perform the transfer
     if (core->isGbaMode() && mode == 6 && (channel == 1 || channel == 2)) // GBA sound DMA
     {
@@ -54,6 +85,38 @@ void Dma::transfer(int channel)
     {
         for (unsigned int i = 0; i < wordCounts[channel]; i++)
         {
+            // Transfer up to the end of the page in bulk if possible, or fall back to single words if not
+            if (bulk)
+            {
+                unsigned int count = bulkTransfer(channel, 4, wordCounts[channel] - i);
+                if (count > 0)
+                {
+                    i += count - 1;
+                    continue;
+                }
+            }
+            else if (gxBulk)
+            {
+                // GXFIFO transfers still stop after 112 words
+                unsigned int count = gxFifoTransfer(channel, std::min(wordCounts[channel] - i, 112u - gxFifoCount));
+                if (count > 0)
+                {
+                    i += count - 1;
+                    if ((gxFifoCount += count) == 112)
+                        break;
+                    continue;
+                }
+            }
+            else if (cartBulk)
+            {
+                unsigned int count = cartTransfer(channel);
+                if (count > 0)
+                {
+                    i += count - 1;
+                    continue;
+                }
+            }
+
             // Transfer a word
             core->memory.write<uint32_t>(cpu, dstAddrs[channel], core->memory.read<uint32_t>(cpu, srcAddrs[channel]));
 
@@ -78,6 +141,17 @@ void Dma::transfer(int channel)
     {
         for (unsigned int i = 0; i < wordCounts[channel]; i++)
         {
+            // Transfer up to the end of the page in bulk if possible, or fall back to single half-words if not
+            if (bulk)
+            {
+                unsigned int count = bulkTransfer(channel, 2, wordCounts[channel] - i);
+                if (count > 0)
+                {
+                    i += count - 1;
+                    continue;
+                }
+            }
+
             // Transfer a half-word
             core->memory.write<uint16_t>(cpu, dstAddrs[channel], core->memory.read<uint16_t>(cpu, srcAddrs[channel]));
 
@@ -106,7 +180,7 @@ void Dma::transfer(int channel)
         if (wordCounts[channel] > 0)
         {
             // Schedule another transfer immediately if the FIFO is still half empty
-            if (core->gpu3D.readGxStat() & BIT(25))
+            if (core->gpu3D.isFifoHalfEmpty())
                 core->schedule(Task(&transferTask[channel], 1));
             return;
         }
@@ -120,7 +194,7 @@ void Dma::transfer(int channel)
             dstAddrs[channel] = dmaDad[channel];
 
         // In GXFIFO mode, schedule another transfer immediately if the FIFO is still half empty
-        if (mode == 7 && core->gpu3D.readGxStat() & BIT(25))
+        if (mode == 7 && core->gpu3D.isFifoHalfEmpty())
             core->schedule(Task(&transferTask[channel], 1));
     }
     else
@@ -134,6 +208,59 @@ void Dma::transfer(int channel)
         core->interpreter[cpu].sendInterrupt(8 + channel);
 }
 
+unsigned int Dma::gxFifoTransfer(int channel, unsigned int count)
+{
+    // Limit the span to the end of the source page, and get it from memory directly if possible
+    uint32_t src = srcAddrs[channel] & ~3;
+    uint8_t *data = core->memory.getReadPointer(cpu, src);
+    if (!data) return 0;
+    count = std::min(count, (0x1000 - (src & 0xFFF)) >> 2);
+
+    // Wake the CPUs from idle loops like a normal write would, and feed the words to the geometry engine
+    core->interpreter[0].wakeIdle();
+    core->interpreter[1].wakeIdle();
+    core->gpu3D.writeGxFifo(data, count);
+
+    srcAddrs[channel] += count << 2;
+    return count;
+}
+
+unsigned int Dma::cartTransfer(int channel)
+{
+    // Make sure the destination is plain memory before reading, since reading from the cart can't be undone
+    uint32_t dst = dstAddrs[channel] & ~3;
+    if (!core->memory.getWritePointer(cpu, dst))
+        return 0;
+
+    // Read the words left in the cart block up to the end of the destination page, and write them all at once
+    uint32_t data[0x400];
+    unsigned int count = core->cartridge.readRomBlock(cpu, data, (0x1000 - (dst & 0xFFF)) >> 2);
+    if (count > 0)
+        core->memory.writeBlock(cpu, dst, (uint8_t*)data, count << 2);
+
+    dstAddrs[channel] += count << 2;
+    return count;
+}
+
+unsigned int Dma::bulkTransfer(int channel, uint32_t size, unsigned int count)
+{
+    // Limit the block to the end of the current page on each side that increments
+    uint32_t dst = dstAddrs[channel] & ~(size - 1);
+    uint32_t src = srcAddrs[channel] & ~(size - 1);
+    bool fixed = (((dmaCnt[channel] & 0x01800000) >> 23) >= 2);
+    uint32_t bytes = std::min(count * size, 0x1000 - (dst & 0xFFF));
+    if (!fixed) bytes = std::min(bytes, 0x1000 - (src & 0xFFF));
+
+    // Copy or fill the block using host pointers, unless one of the sides isn't plain memory
+    if (fixed ? !core->memory.fillBlock(cpu, dst, src, bytes, size) : !core->memory.copyBlock(cpu, dst, src, bytes))
+        return 0;
+
+    // Adjust the addresses past the block
+    if (!fixed) srcAddrs[channel] += bytes;
+    dstAddrs[channel] += bytes;
+    return bytes / size;
+}
+
 void Dma::trigger(int mode, uint8_t channels)
 {
     // ARM7 DMAs don't use the lowest mode bit, so adjust accordingly
@@ -172,7 +299,7 @@ void Dma::writeDmaCnt(int channel, uint32_t mask, uint32_t value)
     // In GXFIFO mode, schedule a transfer on the channel immediately if the FIFO is already half empty
     // All other modes are only triggered at the moment when the event happens
     // For example, if a word from the DS cart is ready before starting a DMA, the DMA will not be triggered
-    if ((dmaCnt[channel] & BIT(31)) && ((dmaCnt[channel] & 0x38000000) >> 27) == 7 && (core->gpu3D.readGxStat() & BIT(25)))
+    if ((dmaCnt[channel] & BIT(31)) && ((dmaCnt[channel] & 0x38000000) >> 27) == 7 && core->gpu3D.isFifoHalfEmpty())
         core->schedule(Task(&transferTask[channel], 1));
 
     // Don't reload the internal registers unless the enable bit changed from 0 to 1
@@ -24,12 +24,15 @@
 #include <functional>
 
 class Core;
+class Savestate;
 
 class Dma
 {
     public:
         Dma(Core *core, bool cpu);
 
+        void syncState(Savestate *state);
+
         void trigger(int mode, uint8_t channels = 0x0F);
 
         uint32_t readDmaSad(int channel) { return dmaSad[channel]; }
@@ -55,6 +58,9 @@ class Dma
         std::function<void()> transferTask[4];
 
         void transfer(int channel);
+        unsigned int bulkTransfer(int channel, uint32_t size, unsigned int count);
+        unsigned int gxFifoTransfer(int channel, unsigned int count);
+        unsigned int cartTransfer(int channel);
 };
 
 #endif // DMA_H
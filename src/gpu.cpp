@@ -17,16 +17,21 @@
     along with NooDS. If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <cstring>
 
 #include "gpu.h"
 #include "core.h"
-#include "settings.h"
 
 Gpu::Gpu(Core *core): core(core)
 {
-    // Mark the thread as not drawing to start
-    drawing.store(false);
+    // Start with an empty scanline queue
+    lineHead.store(0);
+    lineTail[0].store(0);
+    lineTail[1].store(0);
+
+    // Start with a blank frame ready, so frontends have something to show right away
+    readyFrame.store(BIT(2) | 1);
 
     // Prepare tasks to be used with the scheduler
     gbaScanline240Task = std::bind(&Gpu::gbaScanline240, this);
@@ -37,12 +42,39 @@ Gpu::Gpu(Core *core): core(core)
 
 Gpu::~Gpu()
 {
-    // Clean up the thread
-    if (thread)
+    // Clean up the threads
+    stopThread();
+}
+
+void Gpu::syncState(Savestate *state)
+{
+    // Register the tasks so they can be referenced by ID
+    state->addTask(&gbaScanline240Task);
+    state->addTask(&gbaScanline308Task);
+    state->addTask(&scanline256Task);
+    state->addTask(&scanline355Task);
+
+    // Let the 2D and 3D threads finish what they're drawing before anything changes
+    sync2D();
+    for (int i = 0; i < 192; i++)
+        core->gpu3DRenderer.getLine(i);
+
+    // Sync the registers
+    state->sync(displayCapture);
+    state->sync(dirty3D);
+    state->sync(dispStat);
+    state->sync(vCount);
+    state->sync(dispCapCnt);
+    state->sync(powCnt1);
+
+    // Redraw the 3D after loading, since the last frame came from a different state
+    // Dual-screen 3D has to be detected again for the same reason, and the next frame shouldn't be skipped
+    // The exception is when run-ahead goes back to the real frame, which is never shown
+    if (state->isLoading())
     {
-        running = false;
-        thread->join();
-        delete thread;
+        invalidate3D();
+        dualFrames = 0;
+        skipFrame = skip3D = core->runAhead.isHidden();
     }
 }
 
@@ -78,49 +110,150 @@ uint16_t Gpu::rgb6ToRgb5(uint32_t color)
     return BIT(15) | (b << 10) | (g << 5) | r;
 }
 
-uint32_t *Gpu::getFrame(bool gbaCrop)
+TARGET_CLONES const uint32_t *Gpu::getFrame(bool gbaCrop, int scale)
 {
-    mutex.lock();
-    uint32_t *out = nullptr;
-
-    // If a new frame is ready, get it, convert it to RGB8 format, and crop it if needed
+    // If a new frame is ready, take it, convert it to RGB8 format, and crop it if needed
     // If a new frame isn't ready yet, nothing will be returned
     // In that case, frontends should reuse the previous frame (or skip redrawing) to avoid repeated conversion
-    if (ready)
+    // The returned buffer belongs to the GPU, and stays valid until the next frame is returned
+    // The frame is scaled by the given factor, using nearest neighbour for everything but high resolution 3D
+    if (!takeFrame())
+        return nullptr;
+
+    Frame &frame = frames[frontFrame];
+
+    if (gbaCrop)
     {
-        if (gbaCrop)
-        {
-            int offset = (powCnt1 & BIT(15)) ? 0 : (256 * 192); // Display swap
-            out = new uint32_t[240 * 160];
-            for (int y = 0; y < 160; y++)
-                for (int x = 0; x < 240; x++)
-                    out[y * 240 + x] = rgb6ToRgb8(framebuffer[offset + (y + 16) * 256 + (x + 8)]);
-        }
-        else
+        int offset = (powCnt1 & BIT(15)) ? 0 : (256 * 192); // Display swap
+        output.resize(240 * 160 * scale * scale);
+        for (int y = 0; y < 160 * scale; y++)
+            for (int x = 0; x < 240 * scale; x++)
+                output[y * 240 * scale + x] = rgb6ToRgb8(frame.framebuffer[offset + (y / scale + 16) * 256 + (x / scale + 8)]);
+    }
+    else if (scale == 1)
+    {
+        output.resize(256 * 192 * 2);
+        for (int i = 0; i < 256 * 192 * 2; i++)
+            output[i] = rgb6ToRgb8(frame.framebuffer[i]);
+    }
+    else
+    {
+        int width = 256 * scale;
+        output.resize(256 * 192 * 2 * scale * scale);
+
+        for (int i = 0; i < 256 * 192 * 2; i++)
         {
-            out = new uint32_t[256 * 192 * 2];
-            for (int i = 0; i < 256 * 192 * 2; i++)
-                out[i] = rgb6ToRgb8(framebuffer[i]);
+            int screen = i / (256 * 192);
+            int x = (i % 256) * scale;
+            int y = (i / 256) * scale;
+            uint32_t *dst = &output[y * width + x];
+
+            if (frame.highResScale == scale && !frame.effects3D[screen].empty() && (frame.effects3D[screen][i % (256 * 192)] & (1ULL << 32)))
+            {
+                // Blend the high resolution 3D pixels the same way the native resolution pixel was blended
+                int offset = (y - screen * 192 * scale) * width + x;
+                uint64_t effect = frame.effects3D[screen][i % (256 * 192)];
+                for (int j = 0; j < scale; j++)
+                    for (int k = 0; k < scale; k++)
+                        dst[j * width + k] = rgb6ToRgb8(Gpu2D::blend3D(frame.highRes3D[screen][offset + j * width + k], effect));
+            }
+            else
+            {
+                // Scale other pixels with nearest neighbour
+                uint32_t color = rgb6ToRgb8(frame.framebuffer[i]);
+                for (int j = 0; j < scale; j++)
+                    for (int k = 0; k < scale; k++)
+                        dst[j * width + k] = color;
+            }
         }
     }
 
-    ready = false;
-    mutex.unlock();
-    return out;
+    return &output[0];
+}
+
+const uint32_t *Gpu::getRawFrame()
+{
+    // If a new frame is ready, return it as-is, in RGB6 format at native resolution with both screens
+    // This skips conversion entirely, for frontends that can do it on their own (such as in a shader)
+    // The returned buffer stays valid until the next frame is returned
+    return takeFrame() ? frames[frontFrame].framebuffer : nullptr;
+}
+
+bool Gpu::takeFrame()
+{
+    // Swap the ready frame with the front one if it hasn't been taken yet
+    // The old front frame goes back to the core to be filled again
+    if (!(readyFrame.load() & BIT(2)))
+        return false;
+
+    frontFrame = readyFrame.exchange(frontFrame) & 0x3;
+    return true;
+}
+
+void Gpu::publishFrame()
+{
+    // Swap the completed back frame with the ready one, marking it as new for the frontend
+    // The frame that comes back is either one the frontend skipped or one it's done with, so it can be reused
+    backFrame = readyFrame.exchange(backFrame | BIT(2)) & 0x3;
+}
+
+void Gpu::paceFrame()
+{
+    // When pacing by a timer, wait until the frame's time is up instead of letting the audio throttle the emulator
+    // A DS frame lasts about 16715 microseconds (59.8261Hz), and a GBA frame about 16743 microseconds (59.7275Hz)
+    // If the emulator falls more than a frame behind, the timer restarts instead of rushing to catch up
+    // Frames run ahead are extra work within the real frame's time, so they aren't paced
+    if (core->config.fpsLimiter != 3 || core->runAhead.isSpeculative()) return;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    nextFrame += std::chrono::microseconds(core->isGbaMode() ? 16743 : 16715);
+    if (nextFrame + std::chrono::microseconds(16743) < now)
+        nextFrame = now;
+    else if (nextFrame > now)
+        std::this_thread::sleep_until(nextFrame);
+}
+
+void Gpu::updateFrameSkip()
+{
+    // Keep a running average of the time between V-blanks, ignoring long pauses
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    int elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - lastVBlank).count();
+    averageTime += (std::min(elapsed, 100000) - averageTime) / 8;
+    lastVBlank = now;
+
+    // Decide whether to skip the next frame
+    // Automatic skipping only happens with the FPS limiter on, since there's no target speed otherwise
+    // It skips while frames take longer than real time, but still draws at least every 5th frame
+    // Fixed skipping draws one frame out of every setting value, starting at 2 for every other frame
+    int setting = core->config.frameSkip;
+    bool skip;
+    // Automatic skipping depends on timing, so it's disabled while a movie is active to keep the output the same
+    if (setting == 1)
+        skip = core->config.fpsLimiter && averageTime > 1000000 / 60 + 500 && skippedFrames < 4 && !core->movie.isActive();
+    else
+        skip = skippedFrames < setting - 1;
+
+    // Don't skip after a frame with a display capture, since games that capture usually do it every frame
+    // Skipping the 3D or 2D output would then show up in the captured VRAM that game logic relies on
+    bool capturing = frameCapturing;
+    if (capturing)
+        skip = false;
+    frameCapturing = false;
+
+    // Also skip frames that run-ahead won't show, without counting them toward the skip limit
+    skippedFrames = skip ? (skippedFrames + 1) : 0;
+    if (core->runAhead.isNextHidden() && !capturing)
+        skip = true;
+    skipFrame = skip3D = skip;
 }
 
 void Gpu::gbaScanline240()
 {
     if (vCount < 160)
     {
-        if (thread)
-        {
-            // Wait for the scanline to finish drawing
-            while (drawing.load()) std::this_thread::yield();
-        }
-        else
+        // Draw visible scanlines, unless the 2D threads are handling them or the frame is skipped
+        if (!threads[0] && !skipFrame)
         {
-            // Draw visible scanlines
+            ProfileScope scope(&core->profiler, PROFILE_2D);
             core->gpu2D[0].drawGbaScanline(vCount);
         }
 
@@ -149,13 +282,11 @@ void Gpu::gbaScanline308()
     {
         case 160: // End of visible scanlines
         {
-            // Stop the thread now that the frame has been drawn
-            if (thread)
+            // Wait for the 2D threads to finish the frame, counting the wait as 2D time
+            if (threads[0])
             {
-                running = false;
-                thread->join();
-                delete thread;
-                thread = nullptr;
+                ProfileScope scope(&core->profiler, PROFILE_2D);
+                sync2D();
             }
 
             // Set the V-blank flag
@@ -168,9 +299,17 @@ void Gpu::gbaScanline308()
             // Trigger V-blank DMA transfers
             core->dma[1].trigger(1);
 
-            mutex.lock();
+            // Wait for the frame timer if frames are paced by it
+            paceFrame();
+
+            // Decide whether to skip the next frame, and leave the last frame up if this one was skipped or hidden
+            bool skipped = skipFrame || core->runAhead.isHidden();
+            updateFrameSkip();
+            if (skipped) break;
 
-            // Copy the completed sub-framebuffers to the main framebuffer
+            // Copy the completed sub-framebuffer to the back frame
+            uint32_t *framebuffer = frames[backFrame].framebuffer;
+            frames[backFrame].highResScale = 1;
             if (powCnt1 & BIT(15)) // Display swap
             {
                 memcpy(&framebuffer[0],         core->gpu2D[0].getFramebuffer(), 256 * 192 * sizeof(uint32_t));
@@ -182,8 +321,8 @@ void Gpu::gbaScanline308()
                 memcpy(&framebuffer[256 * 192], core->gpu2D[0].getFramebuffer(), 256 * 192 * sizeof(uint32_t));
             }
 
-            ready = true;
-            mutex.unlock();
+            if (core->movie.isActive()) core->movie.hashVideo(framebuffer, 256 * 192 * 2);
+            publishFrame();
             break;
         }
 
@@ -199,20 +338,19 @@ void Gpu::gbaScanline308()
             // Start the next frame
             vCount = 0;
 
-            // Start the 2D thread if enabled
-            if (Settings::getThreaded2D() && !thread)
-            {
-                running = true;
-                thread = new std::thread(&Gpu::drawGbaThreaded, this);
-            }
+            // Start or stop the 2D threads based on the setting
+            if (core->config.threaded2D)
+                startThread();
+            else
+                stopThread();
 
             break;
         }
     }
 
-    // Signal that the next scanline has started
-    if (vCount < 160 && thread)
-        drawing.store(true);
+    // Queue the next scanline for the 2D threads
+    if (vCount < 160 && threads[0] && !skipFrame)
+        queueLine(vCount);
 
     // Check if the current scanline matches the V-counter
     if (vCount == (dispStat[1] >> 8))
@@ -238,12 +376,24 @@ void Gpu::scanline256()
 {
     if (vCount < 192)
     {
-        if (thread)
+        // Count drawing or waiting for the 2D threads as 2D time, along with display capture
+        ProfileScope scope(&core->profiler, PROFILE_2D);
+
+        // Draw a skipped frame anyway if a display capture starts, since the captured VRAM can affect game logic
+        // The 3D has already been skipped by this point, so a capture of it will have the last drawn 3D frame
+        if (vCount == 0 && skipFrame && (dispCapCnt & BIT(31)))
+        {
+            skipFrame = false;
+            if (threads[0]) queueLine(0);
+        }
+
+        if (threads[0])
         {
-            // Wait for the scanlines to finish drawing
-            while (drawing.load()) std::this_thread::yield();
+            // Display capture reads the drawn scanline, so only wait for the 2D threads when capturing
+            if (displayCapture || (dispCapCnt & BIT(31)))
+                sync2D();
         }
-        else
+        else if (!skipFrame)
         {
             // Draw visible scanlines
             core->gpu2D[0].drawScanline(vCount);
@@ -255,7 +405,7 @@ void Gpu::scanline256()
 
         // Start a display capture at the beginning of the frame if one was requested
         if (vCount == 0 && (dispCapCnt & BIT(31)))
-            displayCapture = true;
+            displayCapture = frameCapturing = true;
 
         // Perform a display capture
         if (displayCapture)
@@ -270,11 +420,21 @@ void Gpu::scanline256()
                 case 3: width = 256; height = 192; break;
             }
 
-            // Get the VRAM destination address for the current scanline
-            uint32_t base = 0x6800000 + ((dispCapCnt & 0x00030000) >> 16) * 0x20000;
-            uint32_t writeOffset = ((dispCapCnt & 0x000C0000) >> 3) + vCount * width * 2;
+            // Resolve the LCDC VRAM that the current scanline is captured to, and read from for source B
+            // Lines never cross a 16KB boundary, so each line can be accessed directly through a single pointer
+            uint8_t **lcdc = core->memory.getLcdc();
+            uint32_t block = ((dispCapCnt & 0x00030000) >> 16) * 0x20000;
+            uint32_t writeOffset = (((dispCapCnt & 0x000C0000) >> 3) + vCount * width * 2) % 0x20000;
+            uint32_t readOffset = (((dispCapCnt & 0x0C000000) >> 11) + vCount * width * 2) % 0x20000;
+            uint8_t *dst = lcdc[(block + writeOffset) >> 14];
+            uint8_t *src = lcdc[(block + readOffset) >> 14];
+            if (dst) dst += (writeOffset & 0x3FFF);
+            if (src) src += (readOffset & 0x3FFF);
+
+            // Build the scanline as a 15-bit bitmap
+            uint16_t line[256];
+            bool captured = true;
 
-            // Copy the source contents to memory as a 15-bit bitmap
             switch ((dispCapCnt & 0x60000000) >> 29) // Capture source
             {
                 case 0: // Source A
@@ -282,9 +442,8 @@ void Gpu::scanline256()
                     // Choose from 2D engine A or the 3D engine
                     uint32_t *source = (dispCapCnt & BIT(24)) ? core->gpu3DRenderer.getLine(vCount) : core->gpu2D[0].getRawLine();
 
-                    // Copy a scanline to memory
                     for (int i = 0; i < width; i++)
-                        core->memory.write<uint16_t>(0, base + (writeOffset + i * 2) % 0x20000, rgb6ToRgb5(source[i]));
+                        line[i] = rgb6ToRgb5(source[i]);
 
                     break;
                 }
@@ -294,18 +453,12 @@ void Gpu::scanline256()
                     if (dispCapCnt & BIT(25))
                     {
                         printf("Unimplemented display capture source: display FIFO\n");
+                        captured = false;
                         break;
                     }
 
-                    // Get the VRAM source address for the current scanline
-                    uint32_t readOffset = ((dispCapCnt & 0x0C000000) >> 11) + vCount * width * 2;
-
-                    // Copy a scanline to memory
                     for (int i = 0; i < width; i++)
-                    {
-                        uint16_t color = core->memory.read<uint16_t>(0, base + (readOffset + i * 2) % 0x20000);
-                        core->memory.write<uint16_t>(0, base + (writeOffset + i * 2) % 0x20000, color);
-                    }
+                        line[i] = src ? U8TO16(src, i * 2) : 0;
 
                     break;
                 }
@@ -315,42 +468,52 @@ void Gpu::scanline256()
                     if (dispCapCnt & BIT(25))
                     {
                         printf("Unimplemented display capture source: display FIFO\n");
+                        captured = false;
                         break;
                     }
 
                     // Choose from 2D engine A or the 3D engine
                     uint32_t *source = (dispCapCnt & BIT(24)) ? core->gpu3DRenderer.getLine(vCount) : core->gpu2D[0].getRawLine();
 
-                    // Get the VRAM source address for the current scanline
-                    uint32_t readOffset = ((dispCapCnt & 0x0C000000) >> 11) + vCount * width * 2;
+                    // Get the blending factors for the two sources
+                    int eva = (dispCapCnt & 0x0000001F) >> 0; if (eva > 16) eva = 16;
+                    int evb = (dispCapCnt & 0x00001F00) >> 8; if (evb > 16) evb = 16;
 
-                    // Copy a scanline to memory
+                    // Blend the two sources
+                    // There are no branches, so the compiler can vectorize this across many pixels at once
                     for (int i = 0; i < width; i++)
                     {
-                        // Get colors from the two sources
                         uint16_t c1 = rgb6ToRgb5(source[i]);
-                        uint16_t c2 = core->memory.read<uint16_t>(0, base + (readOffset + i * 2) % 0x20000);
-
-                        // Get the blending factors for the two sources
-                        int eva = (dispCapCnt & 0x0000001F) >> 0; if (eva > 16) eva = 16;
-                        int evb = (dispCapCnt & 0x00001F00) >> 8; if (evb > 16) evb = 16;
-
-                        // Blend the color values
+                        uint16_t c2 = src ? U8TO16(src, i * 2) : 0;
                         uint8_t r = (((c1 >>  0) & 0x1F) * eva + ((c2 >>  0) & 0x1F) * evb) / 16;
                         uint8_t g = (((c1 >>  5) & 0x1F) * eva + ((c2 >>  5) & 0x1F) * evb) / 16;
                         uint8_t b = (((c1 >> 10) & 0x1F) * eva + ((c2 >> 10) & 0x1F) * evb) / 16;
-
-                        uint16_t color = BIT(15) | (b << 10) | (g << 5) | r;
-                        core->memory.write<uint16_t>(0, base + (writeOffset + i * 2) % 0x20000, color);
+                        line[i] = BIT(15) | (b << 10) | (g << 5) | r;
                     }
 
                     break;
                 }
             }
 
+            // Write the scanline to VRAM and track the change, waking the CPUs in case they're waiting on it
+            if (captured && dst)
+            {
+                for (int i = 0; i < width; i++)
+                {
+                    dst[i * 2 + 0] = line[i] >> 0;
+                    dst[i * 2 + 1] = line[i] >> 8;
+                }
+
+                core->memory.vramWritten(dst, width * 2);
+                core->interpreter[0].wakeIdle();
+                core->interpreter[1].wakeIdle();
+            }
+
             // End the display capture
             if (vCount + 1 == height)
             {
+                // Remember if a full-screen capture of source A was made this frame, for detecting dual-screen 3D
+                frameCaptured = (height == 192 && ((dispCapCnt & 0x60000000) >> 29) == 0);
                 displayCapture = false;
                 dispCapCnt &= ~BIT(31);
             }
@@ -360,7 +523,8 @@ void Gpu::scanline256()
     // Draw 3D scanlines 48 lines in advance, if the current 3D is dirty
     // If the 3D parameters haven't changed since the last frame, there's no need to draw it again
     // Bit 0 of the dirty variable represents invalidation, and bit 1 represents a frame currently drawing
-    if (dirty3D && (core->gpu2D[0].readDispCnt() & BIT(3)) && ((vCount + 48) % 263) < 192)
+    // Skipped frames are left out, but stay dirty so the next drawn frame is up to date
+    if (dirty3D && !skip3D && (core->gpu2D[0].readDispCnt() & BIT(3)) && ((vCount + 48) % 263) < 192)
     {
         if (vCount == 215) dirty3D = BIT(1);
         core->gpu3DRenderer.drawScanline((vCount + 48) % 263);
@@ -388,13 +552,11 @@ void Gpu::scanline355()
     {
         case 192: // End of visible scanlines
         {
-            // Stop the thread now that the frame has been drawn
-            if (thread)
+            // Wait for the 2D threads to finish the frame, counting the wait as 2D time
+            if (threads[0])
             {
-                running = false;
-                thread->join();
-                delete thread;
-                thread = nullptr;
+                ProfileScope scope(&core->profiler, PROFILE_2D);
+                sync2D();
             }
 
             for (int i = 0; i < 2; i++)
@@ -414,9 +576,17 @@ void Gpu::scanline355()
             if (core->gpu3D.shouldSwap())
                 core->gpu3D.swapBuffers();
 
-            mutex.lock();
+            // Wait for the frame timer if frames are paced by it
+            paceFrame();
 
-            // Copy the completed sub-framebuffers to the main framebuffer
+            // Decide whether to skip the next frame, and leave the last frame up if this one was skipped or hidden
+            bool skipped = skipFrame || core->runAhead.isHidden();
+            updateFrameSkip();
+            if (skipped) break;
+
+            // Copy the completed sub-framebuffers to the back frame
+            Frame &frame = frames[backFrame];
+            uint32_t *framebuffer = frame.framebuffer;
             if (powCnt1 & BIT(0)) // LCDs enabled
             {
                 if (powCnt1 & BIT(15)) // Display swap
@@ -435,8 +605,50 @@ void Gpu::scanline355()
                 memset(framebuffer, 0, 256 * 192 * 2 * sizeof(uint32_t));
             }
 
-            ready = true;
-            mutex.unlock();
+            // Keep a copy of the high resolution 3D frame if there is one, along with how engine A blended its pixels
+            // Mixing in the high resolution pixels is left for when the frame is requested, so it stays off the core thread
+            int screenA = (powCnt1 & BIT(15)) ? 0 : 1;
+            frame.highResScale = (powCnt1 & BIT(0)) ? core->gpu3DRenderer.getHighResScale() : 1;
+            frame.highRes3D[0].clear();
+            frame.highRes3D[1].clear();
+            frame.effects3D[0].clear();
+            frame.effects3D[1].clear();
+            if (frame.highResScale > 1)
+            {
+                uint32_t *highRes = core->gpu3DRenderer.getHighResFrame();
+                uint64_t *effects = core->gpu2D[0].getEffects3D();
+                frame.highRes3D[screenA].assign(highRes, highRes + 256 * 192 * frame.highResScale * frame.highResScale);
+                if (effects) frame.effects3D[screenA].assign(effects, effects + 256 * 192);
+            }
+
+            // Detect dual-screen 3D, which needs a full-screen capture and a display swap for a couple of frames in a row
+            bool swap = (powCnt1 & BIT(15));
+            dualFrames = (frameCaptured && swap != lastSwap) ? std::min(dualFrames + 1, 2) : 0;
+            frameCaptured = false;
+            lastSwap = swap;
+
+            if (core->config.dualScreen3D && dualFrames == 2 && (powCnt1 & BIT(0)))
+            {
+                // Show engine A's output from the previous frame on the other screen, instead of engine B's copy of it
+                // This skips the round trip through 15-bit VRAM, and keeps the high resolution 3D of both screens
+                memcpy(&framebuffer[(1 - screenA) * 256 * 192], dualFramebuffer, 256 * 192 * sizeof(uint32_t));
+                if (frame.highResScale > 1 && dualHighRes3D.size() == frame.highRes3D[screenA].size())
+                {
+                    frame.highRes3D[1 - screenA] = dualHighRes3D;
+                    frame.effects3D[1 - screenA] = dualEffects3D;
+                }
+            }
+
+            // Keep engine A's output in case the next frame is dual-screen 3D
+            if (core->config.dualScreen3D)
+            {
+                memcpy(dualFramebuffer, core->gpu2D[0].getFramebuffer(), 256 * 192 * sizeof(uint32_t));
+                dualHighRes3D = frame.highRes3D[screenA];
+                dualEffects3D = frame.effects3D[screenA];
+            }
+
+            if (core->movie.isActive()) core->movie.hashVideo(framebuffer, 256 * 192 * 2);
+            publishFrame();
             break;
         }
 
@@ -453,20 +665,19 @@ void Gpu::scanline355()
             // Start the next frame
             vCount = 0;
 
-            // Start the 2D thread if enabled
-            if (Settings::getThreaded2D() && !thread)
-            {
-                running = true;
-                thread = new std::thread(&Gpu::drawThreaded, this);
-            }
+            // Start or stop the 2D threads based on the setting
+            if (core->config.threaded2D)
+                startThread();
+            else
+                stopThread();
 
             break;
         }
     }
 
-    // Signal that the next scanline has started
-    if (vCount < 192 && thread)
-        drawing.store(true);
+    // Queue the next scanline for the 2D threads
+    if (vCount < 192 && threads[0] && !skipFrame)
+        queueLine(vCount);
 
     for (int i = 0; i < 2; i++)
     {
@@ -494,42 +705,81 @@ void Gpu::scanline355()
     core->schedule(Task(&scanline355Task, 355 * 6));
 }
 
-void Gpu::drawGbaThreaded()
+void Gpu::startThread()
 {
-    while (running)
-    {
-        // Wait until the next scanline starts
-        while (!drawing.load())
-        {
-            if (!running) return;
-            std::this_thread::yield();
-        }
+    // Start the 2D threads if they aren't running
+    if (threads[0]) return;
+    running = true;
+    for (int i = 0; i < 2; i++)
+        threads[i] = new std::thread(&Gpu::drawThreaded, this, i, core->config.pinThreads);
+}
 
-        // Draw the scanline
-        core->gpu2D[0].drawGbaScanline(vCount);
+void Gpu::stopThread()
+{
+    // Stop the 2D threads if they're running, letting them finish any queued scanlines first
+    if (!threads[0]) return;
+    sync2D();
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        running = false;
+    }
+    queueCond.notify_all();
+    for (int i = 0; i < 2; i++)
+    {
+        threads[i]->join();
+        delete threads[i];
+        threads[i] = nullptr;
+    }
+}
 
-        // Signal that the scanline is finished
-        drawing.store(false);
+void Gpu::queueLine(int line)
+{
+    // Add a scanline to the queue and wake the 2D threads if they're waiting
+    // The queue is emptied every V-blank, so it never holds more than a frame of scanlines
+    lineQueue[lineHead.load() & 0xFF] = line;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        lineHead.store(lineHead.load() + 1);
     }
+    queueCond.notify_all();
+}
+
+void Gpu::sync2D()
+{
+    // Wait for both 2D threads to draw every queued scanline
+    if (!threads[0]) return;
+    uint32_t head = lineHead.load();
+    if (lineTail[0].load() == head && lineTail[1].load() == head) return;
+    TelemetryWait wait(&core->telemetry, false);
+    while (lineTail[0].load() != head || lineTail[1].load() != head)
+        std::this_thread::yield();
 }
 
-void Gpu::drawThreaded()
+void Gpu::drawThreaded(int engine, bool pin)
 {
-    while (running)
+    if (pin) ThreadPlacement::place(THREAD_WORKER);
+    std::atomic<uint32_t> &tail = lineTail[engine];
+
+    while (true)
     {
-        // Wait until the next scanline starts
-        while (!drawing.load())
+        // Sleep until a scanline is queued or the threads are stopped
+        if (tail.load() == lineHead.load())
         {
-            if (!running) return;
-            std::this_thread::yield();
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCond.wait(lock, [&] { return tail.load() != lineHead.load() || !running; });
+            if (tail.load() == lineHead.load()) return;
         }
 
-        // Draw the scanlines
-        core->gpu2D[0].drawScanline(vCount);
-        core->gpu2D[1].drawScanline(vCount);
+        // Draw the next scanline for this thread's engine; engine B has nothing to draw in GBA mode
+        uint32_t index = tail.load();
+        int line = lineQueue[index & 0xFF];
+        if (!core->isGbaMode())
+            core->gpu2D[engine].drawScanline(line);
+        else if (engine == 0)
+            core->gpu2D[0].drawGbaScanline(line);
 
         // Signal that the scanline is finished
-        drawing.store(false);
+        tail.store(index + 1);
     }
 }
 
@@ -543,8 +793,12 @@ void Gpu::writeDispStat(bool cpu, uint16_t mask, uint16_t value)
 void Gpu::writeDispCapCnt(uint32_t mask, uint32_t value)
 {
     // Write to the DISPCAPCNT register
+    // Engine A checks this while drawing, so let queued scanlines finish before it changes
     mask &= 0xEF3F1F1F;
-    dispCapCnt = (dispCapCnt & ~mask) | (value & mask);
+    value = (dispCapCnt & ~mask) | (value & mask);
+    if (value == dispCapCnt) return;
+    sync2D();
+    dispCapCnt = value;
 }
 
 void Gpu::writePowCnt1(uint16_t mask, uint16_t value)
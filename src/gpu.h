@@ -21,14 +21,18 @@
 #define GPU_H
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
-#include <thread>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #include "defines.h"
 
 class Core;
+class Savestate;
 
 class Gpu
 {
@@ -36,12 +40,16 @@ class Gpu
         Gpu(Core *core);
         ~Gpu();
 
+        void syncState(Savestate *state);
+
         void scheduleInit();
         void gbaScheduleInit();
 
-        uint32_t *getFrame(bool gbaCrop);
+        const uint32_t *getFrame(bool gbaCrop, int scale = 1);
+        const uint32_t *getRawFrame();
 
         void invalidate3D() { dirty3D |= BIT(0); }
+        void sync2D();
 
         uint16_t readDispStat(bool cpu) { return dispStat[cpu]; }
         uint16_t readVCount()           { return vCount;        }
@@ -55,17 +63,56 @@ class Gpu
     private:
         Core *core;
 
-        uint32_t framebuffer[256 * 192 * 2] = {};
-        bool ready = true;
-        std::mutex mutex;
-
+        struct Frame
+        {
+            uint32_t framebuffer[256 * 192 * 2] = {};
+            std::vector<uint32_t> highRes3D[2];
+            std::vector<uint64_t> effects3D[2];
+            int highResScale = 1;
+        };
+
+        // Completed frames are triple-buffered, so the core and frontend never wait on each other
+        // The core fills the back frame and swaps it with the ready one, and the frontend swaps that with the front one
+        // The ready index has bit 2 set when it holds a frame that the frontend hasn't taken yet
+        Frame frames[3];
+        std::atomic<int> readyFrame;
+        int backFrame = 0;
+        int frontFrame = 2;
+        std::vector<uint32_t> output;
+
+        // Scanlines are queued for the 2D threads as they start, and they draw them whenever they catch up
+        // Each engine has its own thread and tail, since they draw to separate framebuffers from separate registers
+        // The CPU only waits for both tails to reach the head when drawing state changes or the output is needed
         bool running = false;
-        std::atomic<bool> drawing;
-        std::thread *thread = nullptr;
+        std::thread *threads[2] = {};
+        std::mutex queueMutex;
+        std::condition_variable queueCond;
+        int lineQueue[256] = {};
+        std::atomic<uint32_t> lineHead;
+        std::atomic<uint32_t> lineTail[2];
 
         bool displayCapture = false;
         uint8_t dirty3D = 0;
 
+        // Frames can be skipped to keep the emulator at full speed, leaving out their 2D and 3D drawing
+        // The decision is made at V-blank, since the 3D for the next frame starts drawing before it begins
+        bool skipFrame = false;
+        bool skip3D = false;
+        bool frameCapturing = false;
+        int skippedFrames = 0;
+        int averageTime = 0;
+        std::chrono::steady_clock::time_point lastVBlank;
+        std::chrono::steady_clock::time_point nextFrame;
+
+        // Dual-screen 3D is detected by a full-screen capture every frame, with the screens swapped each time
+        // Once detected, the screen showing the capture can be replaced with engine A's output from the previous frame
+        bool frameCaptured = false;
+        bool lastSwap = false;
+        int dualFrames = 0;
+        uint32_t dualFramebuffer[256 * 192] = {};
+        std::vector<uint32_t> dualHighRes3D;
+        std::vector<uint64_t> dualEffects3D;
+
         uint16_t dispStat[2] = {};
         uint16_t vCount = 0;
         uint32_t dispCapCnt = 0;
@@ -84,8 +131,15 @@ class Gpu
         void scanline256();
         void scanline355();
 
-        void drawGbaThreaded();
-        void drawThreaded();
+        void publishFrame();
+        void paceFrame();
+        void updateFrameSkip();
+        bool takeFrame();
+
+        void startThread();
+        void stopThread();
+        void queueLine(int line);
+        void drawThreaded(int engine, bool pin);
 };
 
 #endif // GPU_H
@@ -17,6 +17,7 @@
     along with NooDS. If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <cstring>
 
 #include "gpu_2d.h"
@@ -32,6 +33,10 @@ Gpu2D::Gpu2D(Core *core, bool engine): core(core), engine(engine)
         palette = core->memory.getPalette();
         oam = core->memory.getOam();
         extPalettes = core->memory.getEngAExtPal();
+        bgVram = core->memory.getEngABg();
+        objVram = core->memory.getEngAObj();
+        bgVramMask = 0x7FFFF;
+        objVramMask = 0x3FFFF;
     }
     else
     {
@@ -41,9 +46,58 @@ Gpu2D::Gpu2D(Core *core, bool engine): core(core), engine(engine)
         palette = core->memory.getPalette() + 0x400;
         oam = core->memory.getOam() + 0x400;
         extPalettes = core->memory.getEngBExtPal();
+        bgVram = core->memory.getEngBBg();
+        objVram = core->memory.getEngBObj();
+        bgVramMask = 0x1FFFF;
+        objVramMask = 0x1FFFF;
     }
 }
 
+void Gpu2D::syncState(Savestate *state)
+{
+    // Sync the internal state
+    state->sync(gbaBlock);
+    state->sync(internalX);
+    state->sync(internalY);
+
+    // Redraw the GBA border after loading, since the framebuffer isn't part of the state
+    if (state->isLoading())
+        stableBorders = 0;
+
+    // Sync the registers
+    state->sync(dispCnt);
+    state->sync(bgCnt);
+    state->sync(bgHOfs);
+    state->sync(bgVOfs);
+    state->sync(bgPA);
+    state->sync(bgPB);
+    state->sync(bgPC);
+    state->sync(bgPD);
+    state->sync(bgX);
+    state->sync(bgY);
+    state->sync(winX1);
+    state->sync(winX2);
+    state->sync(winY1);
+    state->sync(winY2);
+    state->sync(winIn);
+    state->sync(winOut);
+    state->sync(bldCnt);
+    state->sync(bldAlpha);
+    state->sync(bldY);
+    state->sync(masterBright);
+
+    // Draw every line again, since anything could have changed
+    invalidate();
+    invalidateObjects();
+}
+
+void Gpu2D::invalidate()
+{
+    // Let queued scanlines finish with the old state before anything changes, then mark the lines as dirty
+    core->gpu.sync2D();
+    changes++;
+}
+
 uint32_t Gpu2D::rgb5ToRgb6(uint32_t color)
 {
     // Convert an RGB5 value to an RGB6 value (the way the 2D engine does it)
@@ -54,6 +108,119 @@ uint32_t Gpu2D::rgb5ToRgb6(uint32_t color)
     return (color & 0xFFFC0000) | (b << 12) | (g << 6) | r;
 }
 
+uint32_t Gpu2D::blend3D(uint32_t color, uint64_t effect)
+{
+    // Apply the blending that was used for a 3D pixel to another 3D color
+    // This lets a higher resolution 3D frame be placed over the 2D layers after the fact
+    uint32_t pixel2 = effect & 0x3FFFF;
+    int bldY = (effect >> 20) & 0x1F;
+
+    // Show the second pixel through 3D samples that are fully transparent, without blending
+    int mode = (effect >> 18) & 0x3;
+    if (!(color & 0xFC0000))
+    {
+        color = pixel2;
+        mode = 0;
+    }
+
+    switch (mode) // Blend effect
+    {
+        case 1: // Alpha blending
+        {
+            int eva = ((color >> 18) & 0x3F) + 1;
+            int evb = 64 - eva;
+            int r = ((color >>  0) & 0x3F) * eva / 64 + ((pixel2 >>  0) & 0x3F) * evb / 64; if (r > 63) r = 63;
+            int g = ((color >>  6) & 0x3F) * eva / 64 + ((pixel2 >>  6) & 0x3F) * evb / 64; if (g > 63) g = 63;
+            int b = ((color >> 12) & 0x3F) * eva / 64 + ((pixel2 >> 12) & 0x3F) * evb / 64; if (b > 63) b = 63;
+            color = (b << 12) | (g << 6) | r;
+            break;
+        }
+
+        case 2: // Brightness increase
+        {
+            int r = (color >>  0) & 0x3F; r += (63 - r) * bldY / 16;
+            int g = (color >>  6) & 0x3F; g += (63 - g) * bldY / 16;
+            int b = (color >> 12) & 0x3F; b += (63 - b) * bldY / 16;
+            color = (b << 12) | (g << 6) | r;
+            break;
+        }
+
+        case 3: // Brightness decrease
+        {
+            int r = (color >>  0) & 0x3F; r -= r * bldY / 16;
+            int g = (color >>  6) & 0x3F; g -= g * bldY / 16;
+            int b = (color >> 12) & 0x3F; b -= b * bldY / 16;
+            color = (b << 12) | (g << 6) | r;
+            break;
+        }
+    }
+
+    // Apply the master brightness
+    uint16_t masterBright = effect >> 40;
+    int factor = (masterBright & 0x001F);
+    if (factor > 16) factor = 16;
+
+    switch ((masterBright & 0xC000) >> 14) // Mode
+    {
+        case 1: // Up
+        {
+            int r = (color >>  0) & 0x3F; r += (63 - r) * factor / 16;
+            int g = (color >>  6) & 0x3F; g += (63 - g) * factor / 16;
+            int b = (color >> 12) & 0x3F; b += (63 - b) * factor / 16;
+            return (b << 12) | (g << 6) | r;
+        }
+
+        case 2: // Down
+        {
+            int r = (color >>  0) & 0x3F; r -= r * factor / 16;
+            int g = (color >>  6) & 0x3F; g -= g * factor / 16;
+            int b = (color >> 12) & 0x3F; b -= b * factor / 16;
+            return (b << 12) | (g << 6) | r;
+        }
+    }
+
+    return color & 0x3FFFF;
+}
+
+template <typename T> T Gpu2D::readBg(uint32_t address)
+{
+    // GBA VRAM is laid out differently, so let the memory handle it
+    if (core->isGbaMode())
+        return core->memory.read<T>(1, address);
+
+    // Read a value directly from the VRAM mapped to the engine's background space
+    // The mapping table is kept up to date by VRAMCNT writes, which avoids a full memory lookup for every read
+    address &= ~(sizeof(T) - 1);
+    uint8_t *data = bgVram[(address & bgVramMask) >> 14];
+    if (!data) return 0;
+    data += (address & 0x3FFF);
+
+    // Form an LSB-first value from the data at the pointer
+    T value = 0;
+    for (unsigned int i = 0; i < sizeof(T); i++)
+        value |= data[i] << (i * 8);
+    return value;
+}
+
+template <typename T> T Gpu2D::readObj(uint32_t address)
+{
+    // GBA VRAM is laid out differently, so let the memory handle it
+    if (core->isGbaMode())
+        return core->memory.read<T>(1, address);
+
+    // Read a value directly from the VRAM mapped to the engine's object space
+    address &= ~(sizeof(T) - 1);
+    uint8_t *data = objVram[(address & objVramMask) >> 14];
+    if (!data) return 0;
+    data += (address & 0x3FFF);
+
+    // Form an LSB-first value from the data at the pointer
+    T value = 0;
+    for (unsigned int i = 0; i < sizeof(T); i++)
+        value |= data[i] << (i * 8);
+    return value;
+}
+
 void Gpu2D::drawGbaScanline(int line)
 {
     // Reload the internal registers at the start of the frame
@@ -63,6 +230,10 @@ void Gpu2D::drawGbaScanline(int line)
         internalX[1] = bgX[1];
         internalY[0] = bgY[0];
         internalY[1] = bgY[1];
+
+        // Only track 3D blending once there's a high resolution 3D frame for it to be used with
+        if (engine == 0 && effects3D.empty() && core->gpu3DRenderer.getHighResScale() > 1)
+            effects3D.resize(256 * 192);
     }
 
     // Clear the layers
@@ -115,23 +286,14 @@ void Gpu2D::drawGbaScanline(int line)
     // Draw the objects
     if (dispCnt & BIT(12)) drawObjects(line);
 
+    // Find which layers are enabled for each pixel, based on the windows
+    uint8_t windows[240];
+    calculateWindows(windows, line, 240);
+
     // Blend the layers to form the final image
     for (int i = 0; i < 240; i++)
     {
-        uint8_t enabled = BIT(5) | (dispCnt >> 8);
-
-        // If the current pixel is in the bounds of a window, disable layers that are disabled in that window
-        if (dispCnt & 0xE000) // Windows enabled
-        {
-            if ((dispCnt & BIT(13)) && i >= winX1[0] && i < winX2[0] && line >= winY1[0] && line < winY2[0])
-                enabled &= winIn >> 0; // Window 0
-            else if ((dispCnt & BIT(14)) && i >= winX1[1] && i < winX2[1] && line >= winY1[1] && line < winY2[1])
-                enabled &= winIn >> 8; // Window 1
-            else if ((dispCnt & BIT(15)) && (framebuffer[line * 256 + i] & BIT(24)))
-                enabled &= winOut >> 8; // Object window
-            else
-                enabled &= winOut >> 0; // Outside of windows
-        }
+        uint8_t enabled = windows[i];
 
         // Set the topmost two pixels to the backdrop color (first palette index)
         uint32_t pixel = U8TO16(palette, 0), pixel2 = pixel;
@@ -219,14 +381,31 @@ void Gpu2D::drawGbaScanline(int line)
         uint32_t base = 0x6800000 + gbaBlock * 0x20000;
         gbaBlock = !gbaBlock;
 
+        // The ARM9 is off in GBA mode, so the border usually never changes after boot
+        // Once both blocks have been drawn without changing the output, skip redrawing until VRAM A or B is written
+        if (core->memory.bankChanged(BANK_A, borderGeneration) || core->memory.bankChanged(BANK_B, borderGeneration))
+            stableBorders = 0;
+        if (stableBorders >= 2) return;
+        borderGeneration = core->memory.nextVramGeneration();
+
+        bool changed = false;
         for (int y = 0; y < 192; y++)
         {
+            // Read each row through a direct pointer if possible, since a row never crosses a page
+            uint32_t address = base + y * 256 * 2;
+            uint8_t *row = core->memory.getReadPointer(0, address);
+
             for (int x = 0; x < 256; x++)
             {
                 if (x == 8 && y >= 16 && y < 192 - 16) x += 240;
-                framebuffer[y * 256 + x] = rgb5ToRgb6(core->memory.read<uint16_t>(0, base + (y * 256 + x) * 2));
+                uint16_t color = row ? U8TO16(row, x * 2) : core->memory.read<uint16_t>(0, address + x * 2);
+                uint32_t pixel = rgb5ToRgb6(color);
+                changed |= (framebuffer[y * 256 + x] != pixel);
+                framebuffer[y * 256 + x] = pixel;
             }
         }
+
+        stableBorders = changed ? 0 : (stableBorders + 1);
     }
 }
 
@@ -241,6 +420,38 @@ void Gpu2D::drawScanline(int line)
         internalY[1] = bgY[1];
     }
 
+    // Count the lines drawn since something that affects the output last changed
+    // Once every line has been drawn since then, each line would look the same as it did last frame
+    if (drawnChanges != changes)
+    {
+        drawnChanges = changes;
+        cleanLines = 0;
+    }
+    else if (cleanLines < 192)
+    {
+        cleanLines++;
+    }
+
+    // Reuse the previous frame's output for the line if it would look the same
+    // Lines with 3D, display capture, or VRAM display depend on more than what's tracked, so they're always drawn
+    if (cleanLines == 192 && (dispCnt & 0x00020000) == 0 && !((dispCnt & BIT(3)) && (dispCnt & BIT(8))) &&
+        !(engine == 0 && (core->gpu.readDispCapCnt() & BIT(31))))
+    {
+        // Increment the internal registers of affine backgrounds as if the line was drawn
+        int mode = dispCnt & 0x00000007;
+        if ((dispCnt & BIT(10)) && (mode == 2 || (mode >= 4 && mode <= 6)))
+        {
+            internalX[0] += bgPB[0];
+            internalY[0] += bgPD[0];
+        }
+        if ((dispCnt & BIT(11)) && mode >= 1 && mode <= 5)
+        {
+            internalX[1] += bgPB[1];
+            internalY[1] += bgPD[1];
+        }
+        return;
+    }
+
     // Clear the layers
     for (int i = 0; i < 5; i++)
         memset(layers[i], 0, 256 * sizeof(uint32_t));
@@ -322,24 +533,19 @@ void Gpu2D::drawScanline(int line)
 
     // Blend the layers to form the final image
     // This is done in a separate buffer so display capture can always access the raw 2D output
+    // Layer selection needs per-pixel priority checks, but blending is done in a separate pass that can be vectorized
+    uint8_t enabled[256];
+    uint32_t pixels2[256];
+    uint8_t effects[256];
+    uint64_t *lineEffects3D = effects3D.empty() ? nullptr : &effects3D[line * 256];
+
+    // Find which layers are enabled for each pixel, based on the windows
+    calculateWindows(enabled, line, 256);
+
     for (int i = 0; i < 256; i++)
     {
-        uint8_t enabled = BIT(5) | (dispCnt >> 8);
         uint32_t *pixel = &layers[5][i];
 
-        // If the current pixel is in the bounds of a window, disable layers that are disabled in that window
-        if (dispCnt & 0x0000E000) // Windows enabled
-        {
-            if ((dispCnt & BIT(13)) && i >= winX1[0] && i < winX2[0] && line >= winY1[0] && line < winY2[0])
-                enabled &= winIn >> 0; // Window 0
-            else if ((dispCnt & BIT(14)) && i >= winX1[1] && i < winX2[1] && line >= winY1[1] && line < winY2[1])
-                enabled &= winIn >> 8; // Window 1
-            else if ((dispCnt & BIT(15)) && (framebuffer[line * 256 + i] & BIT(24)))
-                enabled &= winOut >> 8; // Object window
-            else
-                enabled &= winOut >> 0; // Outside of windows
-        }
-
         // Set the topmost two pixels to the backdrop color (first palette index)
         uint32_t pixel2 = *pixel = U8TO16(palette, 0);
         int blendBit = 5, blendBit2 = 5;
@@ -347,7 +553,7 @@ void Gpu2D::drawScanline(int line)
 
         // If an object pixel exists, set it to the topmost pixel
         // Objects are higher priority than background layers, so the priority is given a little boost
-        if ((enabled & BIT(4)) && (layers[4][i] & BIT(15)))
+        if ((enabled[i] & BIT(4)) && (layers[4][i] & BIT(15)))
         {
             *pixel = layers[4][i];
             blendBit = 4;
@@ -359,7 +565,7 @@ void Gpu2D::drawScanline(int line)
         {
             // Update the topmost pixels if a higher priority pixel is found
             // 3D pixels (marked by bit 26) are special cases that have higher-precision alpha values
-            if ((enabled & BIT(j)) && (layers[j][i] & ((layers[j][i] & BIT(26)) ? 0xFC0000 : BIT(15))))
+            if ((enabled[i] & BIT(j)) && (layers[j][i] & ((layers[j][i] & BIT(26)) ? 0xFC0000 : BIT(15))))
             {
                 if ((bgCnt[j] & 0x0003) <= priority) // Higher than topmost
                 {
@@ -383,54 +589,34 @@ void Gpu2D::drawScanline(int line)
             }
         }
 
-        // Convert the pixels to 18-bit if they aren't 3D pixels that were already 18-bit
-        if (!(*pixel & BIT(26))) *pixel = rgb5ToRgb6(*pixel);
-        if (!(pixel2 & BIT(26))) pixel2 = rgb5ToRgb6(pixel2);
+        pixels2[i] = pixel2;
+
+        // Remember how topmost 3D pixels are blended, so a higher resolution 3D frame can be blended the same way later
+        // This holds the second pixel (0-17), blend effect (18-19), brightness factor (20-24), 3D bit (32), and master brightness (40-55)
+        uint64_t effect = (blendBit == 0 && (*pixel & BIT(26))) ? ((1ULL << 32) | ((uint64_t)(masterBright & 0xC01F) << 40) |
+            (((pixel2 & BIT(26)) ? pixel2 : rgb5ToRgb6(pixel2)) & 0x3FFFF)) : 0;
 
         int mode = (bldCnt & 0x00C0) >> 6;
-        bool blend = ((enabled & BIT(5)) && (bldCnt & BIT(blendBit)));
+        bool blend = ((enabled[i] & BIT(5)) && (bldCnt & BIT(blendBit)));
 
-        // Blend the pixel if enabled
+        // Decide which blend effect to apply to the pixel
         // Semi-transparent objects and 3D are special cases that force alpha blending (marked by bits 25 and 26)
         // If special cases don't have a second target to blend with, they can fall back to brightness effects
-        // Blending is done with 18-bit colors on the DS
         if (((blend && mode == 1) || (*pixel & (BIT(25) | BIT(26)))) && (bldCnt & BIT(8 + blendBit2))) // Alpha blending
-        {
-            if (*pixel & BIT(26)) // 3D
-            {
-                int eva = ((*pixel >> 18) & 0x3F) + 1;
-                int evb = 64 - eva;
-                int r = ((*pixel >>  0) & 0x3F) * eva / 64 + ((pixel2 >>  0) & 0x3F) * evb / 64; if (r > 63) r = 63;
-                int g = ((*pixel >>  6) & 0x3F) * eva / 64 + ((pixel2 >>  6) & 0x3F) * evb / 64; if (g > 63) g = 63;
-                int b = ((*pixel >> 12) & 0x3F) * eva / 64 + ((pixel2 >> 12) & 0x3F) * evb / 64; if (b > 63) b = 63;
-                *pixel = (b << 12) | (g << 6) | r;
-            }
-            else
-            {
-                int eva = (bldAlpha & 0x001F) >> 0; if (eva > 16) eva = 16;
-                int evb = (bldAlpha & 0x1F00) >> 8; if (evb > 16) evb = 16;
-                int r = ((*pixel >>  0) & 0x3F) * eva / 16 + ((pixel2 >>  0) & 0x3F) * evb / 16; if (r > 63) r = 63;
-                int g = ((*pixel >>  6) & 0x3F) * eva / 16 + ((pixel2 >>  6) & 0x3F) * evb / 16; if (g > 63) g = 63;
-                int b = ((*pixel >> 12) & 0x3F) * eva / 16 + ((pixel2 >> 12) & 0x3F) * evb / 16; if (b > 63) b = 63;
-                *pixel = (b << 12) | (g << 6) | r;
-            }
-        }
-        else if (blend && mode == 2) // Brightness increase
-        {
-            int r = (*pixel >>  0) & 0x3F; r += (63 - r) * bldY / 16;
-            int g = (*pixel >>  6) & 0x3F; g += (63 - g) * bldY / 16;
-            int b = (*pixel >> 12) & 0x3F; b += (63 - b) * bldY / 16;
-            *pixel = (b << 12) | (g << 6) | r;
-        }
-        else if (blend && mode == 3) // Brightness decrease
-        {
-            int r = (*pixel >>  0) & 0x3F; r -= r * bldY / 16;
-            int g = (*pixel >>  6) & 0x3F; g -= g * bldY / 16;
-            int b = (*pixel >> 12) & 0x3F; b -= b * bldY / 16;
-            *pixel = (b << 12) | (g << 6) | r;
-        }
+            effects[i] = 1;
+        else if (blend && (mode == 2 || mode == 3)) // Brightness increase or decrease
+            effects[i] = mode;
+        else
+            effects[i] = 0;
+
+        if (effect && effects[i])
+            effect |= (effects[i] << 18) | ((effects[i] > 1) ? (bldY << 20) : 0);
+        if (lineEffects3D)
+            lineEffects3D[i] = effect;
     }
 
+    blendPixels(layers[5], pixels2, effects);
+
     // Copy the final image to the framebuffer
     switch ((dispCnt & 0x00030000) >> 16) // Display mode
     {
@@ -438,6 +624,7 @@ void Gpu2D::drawScanline(int line)
         {
             // Fill the display with white
             memset(&framebuffer[line * 256], 0xFF, 256 * sizeof(uint32_t));
+            if (lineEffects3D) memset(lineEffects3D, 0, 256 * sizeof(uint64_t));
             break;
         }
 
@@ -450,6 +637,7 @@ void Gpu2D::drawScanline(int line)
         case 2: // VRAM display
         {
             // Draw raw bitmap data from a VRAM block
+            if (lineEffects3D) memset(lineEffects3D, 0, 256 * sizeof(uint64_t));
             uint32_t address = 0x6800000 + ((dispCnt & 0x000C0000) >> 18) * 0x20000 + line * 256 * 2;
             for (int i = 0; i < 256; i++)
                 framebuffer[line * 256 + i] = rgb5ToRgb6(core->memory.read<uint16_t>(0, address + i * 2));
@@ -458,6 +646,7 @@ void Gpu2D::drawScanline(int line)
 
         case 3: // Main memory display
         {
+            if (lineEffects3D) memset(lineEffects3D, 0, 256 * sizeof(uint64_t));
             printf("Unimplemented engine %c display mode: display FIFO\n", ((engine == 0) ? 'A' : 'B'));
             break;
         }
@@ -517,6 +706,88 @@ void Gpu2D::drawScanline(int line)
     }
 }
 
+void Gpu2D::calculateWindows(uint8_t *enabled, int line, int width)
+{
+    uint8_t mask = BIT(5) | (dispCnt >> 8);
+
+    // Enable every layer if windows are disabled
+    if (!(dispCnt & 0xE000))
+    {
+        memset(enabled, mask, width);
+        return;
+    }
+
+    // Disable layers that are disabled outside of windows, and then fill in each window from lowest to highest priority
+    // This gives the same result as checking each window in order of priority for every pixel
+    memset(enabled, mask & (winOut >> 0), width);
+
+    // Object window
+    if (dispCnt & BIT(15))
+    {
+        for (int i = 0; i < width; i++)
+        {
+            if (framebuffer[line * 256 + i] & BIT(24))
+                enabled[i] = mask & (winOut >> 8);
+        }
+    }
+
+    // Window 1 and window 0
+    for (int i = 1; i >= 0; i--)
+    {
+        if ((dispCnt & BIT(13 + i)) && line >= winY1[i] && line < winY2[i] && winX1[i] < width)
+            memset(&enabled[winX1[i]], mask & (winIn >> (i * 8)), std::min<int>(winX2[i], width) - winX1[i]);
+    }
+}
+
+TARGET_CLONES void Gpu2D::blendPixels(uint32_t *pixels, uint32_t *pixels2, uint8_t *effects)
+{
+    // Get the blending factors that are the same for every pixel
+    // Regular alpha blending uses 4-bit factors, which are scaled to match the 6-bit factors of 3D pixels
+    int eva = (bldAlpha & 0x001F) >> 0; if (eva > 16) eva = 16;
+    int evb = (bldAlpha & 0x1F00) >> 8; if (evb > 16) evb = 16;
+    int brightness = bldY;
+
+    // Blend the pixels with 18-bit colors, as done on the DS
+    // Every effect is calculated for every pixel, and then the one each pixel uses is selected
+    // There are no branches, so the compiler can vectorize this across many pixels at once
+    for (int i = 0; i < 256; i++)
+    {
+        // Convert the pixels to 18-bit if they aren't 3D pixels that were already 18-bit
+        uint32_t pixel = pixels[i], pixel2 = pixels2[i];
+        bool is3D = (pixel & BIT(26));
+        uint32_t r1 = is3D ? ((pixel >>  0) & 0x3F) : (((pixel >>  0) & 0x1F) * 2);
+        uint32_t g1 = is3D ? ((pixel >>  6) & 0x3F) : (((pixel >>  5) & 0x1F) * 2);
+        uint32_t b1 = is3D ? ((pixel >> 12) & 0x3F) : (((pixel >> 10) & 0x1F) * 2);
+        uint32_t r2 = (pixel2 & BIT(26)) ? ((pixel2 >>  0) & 0x3F) : (((pixel2 >>  0) & 0x1F) * 2);
+        uint32_t g2 = (pixel2 & BIT(26)) ? ((pixel2 >>  6) & 0x3F) : (((pixel2 >>  5) & 0x1F) * 2);
+        uint32_t b2 = (pixel2 & BIT(26)) ? ((pixel2 >> 12) & 0x3F) : (((pixel2 >> 10) & 0x1F) * 2);
+
+        // Alpha blending
+        uint32_t eva1 = is3D ? (((pixel >> 18) & 0x3F) + 1) : (eva * 4);
+        uint32_t evb1 = is3D ? (64 - eva1) : (evb * 4);
+        uint32_t ra = std::min<uint32_t>((r1 * eva1) / 64 + (r2 * evb1) / 64, 63);
+        uint32_t ga = std::min<uint32_t>((g1 * eva1) / 64 + (g2 * evb1) / 64, 63);
+        uint32_t ba = std::min<uint32_t>((b1 * eva1) / 64 + (b2 * evb1) / 64, 63);
+
+        // Brightness increase
+        uint32_t ru = r1 + (63 - r1) * brightness / 16;
+        uint32_t gu = g1 + (63 - g1) * brightness / 16;
+        uint32_t bu = b1 + (63 - b1) * brightness / 16;
+
+        // Brightness decrease
+        uint32_t rd = r1 - r1 * brightness / 16;
+        uint32_t gd = g1 - g1 * brightness / 16;
+        uint32_t bd = b1 - b1 * brightness / 16;
+
+        // Select the result of the pixel's effect, keeping the extra bits of unblended pixels
+        uint8_t effect = effects[i];
+        pixels[i] = (effect == 1) ? ((ba << 12) | (ga << 6) | ra) :
+                    (effect == 2) ? ((bu << 12) | (gu << 6) | ru) :
+                    (effect == 3) ? ((bd << 12) | (gd << 6) | rd) :
+                    ((pixel & 0xFFFC0000) | (b1 << 12) | (g1 << 6) | r1);
+    }
+}
+
 void Gpu2D::drawText(int bg, int line)
 {
     // If 3D is enabled, render it to BG0 in text mode
@@ -542,6 +813,17 @@ void Gpu2D::drawText(int bg, int line)
     // Draw a line
     if (bgCnt[bg] & BIT(7)) // 8-bit
     {
+        // Get the extended palette once for the whole line
+        uint8_t *extPal = nullptr;
+        if (dispCnt & BIT(30))
+        {
+            // Determine the extended palette slot
+            // Backgrounds 0 and 1 can alternatively use slots 2 and 3
+            int slot = (bg < 2 && (bgCnt[bg] & BIT(13))) ? (bg + 2) : bg;
+            extPal = extPalettes[slot];
+            if (!extPal) return;
+        }
+
         for (int i = 0; i <= 256; i += 8)
         {
             // Move the tile address to the current tile
@@ -553,29 +835,16 @@ void Gpu2D::drawText(int bg, int line)
                 tileAddr += 0x800;
 
             // Get the current tile
-            uint16_t tile = core->memory.read<uint16_t>(core->isGbaMode(), tileAddr);
+            uint16_t tile = readBg<uint16_t>(tileAddr);
 
             // Get the tile's palette
-            uint8_t *pal;
-            if (dispCnt & BIT(30)) // Extended palette
-            {
-                // Determine the extended palette slot
-                // Backgrounds 0 and 1 can alternatively use slots 2 and 3
-                int slot = (bg < 2 && (bgCnt[bg] & BIT(13))) ? (bg + 2) : bg;
-
-                // In extended palette mode, the tile can select from multiple 256-color palettes
-                if (!extPalettes[slot]) return;
-                pal = &extPalettes[slot][(tile & 0xF000) >> 3];
-            }
-            else // Standard palette
-            {
-                pal = palette;
-            }
+            // In extended palette mode, the tile can select from multiple 256-color palettes
+            uint8_t *pal = extPal ? &extPal[(tile & 0xF000) >> 3] : palette;
 
             // Get the palette indices for the current line of the tile, flipped vertically if enabled
             uint32_t indexAddr = indexBase + (tile & 0x03FF) * 64 + ((tile & BIT(11)) ? ((7 - yOffset % 8) * 8) : ((yOffset % 8) * 8));
-            uint64_t indices = core->memory.read<uint32_t>(core->isGbaMode(), indexAddr) |
-                ((uint64_t)core->memory.read<uint32_t>(core->isGbaMode(), indexAddr + 4) << 32);
+            uint64_t indices = readBg<uint32_t>(indexAddr) |
+                ((uint64_t)readBg<uint32_t>(indexAddr + 4) << 32);
 
             // Draw the current line of the tile
             for (int j = 0; j < 8; j++)
@@ -605,7 +874,7 @@ void Gpu2D::drawText(int bg, int line)
                 tileAddr += 0x800;
 
             // Get the current tile
-            uint16_t tile = core->memory.read<uint16_t>(core->isGbaMode(), tileAddr);
+            uint16_t tile = readBg<uint16_t>(tileAddr);
 
             // Get the tile's palette
             // In 4-bit mode, the tile can select from multiple 16-color palettes
@@ -613,7 +882,7 @@ void Gpu2D::drawText(int bg, int line)
 
             // Get the palette indices for the current line of the tile, flipped vertically if enabled
             uint32_t indexAddr = indexBase + (tile & 0x03FF) * 32 + ((tile & BIT(11)) ? ((7 - yOffset % 8) * 4) : ((yOffset % 8) * 4));
-            uint32_t indices = core->memory.read<uint32_t>(core->isGbaMode(), indexAddr);
+            uint32_t indices = readBg<uint32_t>(indexAddr);
 
             // Draw the current line of the tile
             for (int j = 0; j < 8; j++)
@@ -660,11 +929,11 @@ void Gpu2D::drawAffine(int bg, int line)
         }
 
         // Get the current tile
-        uint8_t tile = core->memory.read<uint8_t>(core->isGbaMode(), tileBase + (rotscaleY / 8) * (size / 8) + (rotscaleX / 8));
+        uint8_t tile = readBg<uint8_t>(tileBase + (rotscaleY / 8) * (size / 8) + (rotscaleX / 8));
 
         // Get the palette index for the current pixel of the tile
         uint32_t indexAddr = indexBase + tile * 64 + (rotscaleY % 8) * 8 + (rotscaleX % 8);
-        uint8_t index = core->memory.read<uint8_t>(core->isGbaMode(), indexAddr);
+        uint8_t index = readBg<uint8_t>(indexAddr);
 
         // Draw a pixel
         if (index)
@@ -737,7 +1006,7 @@ void Gpu2D::drawExtended(int bg, int line)
                 }
 
                 // Draw a pixel
-                layers[bg][i] = core->memory.read<uint16_t>(core->isGbaMode(), dataBase + (rotscaleY * sizeX + rotscaleX) * 2);
+                layers[bg][i] = readBg<uint16_t>(dataBase + (rotscaleY * sizeX + rotscaleX) * 2);
 
                 // Ignore transparency in GBA mode
                 if (core->isGbaMode())
@@ -765,7 +1034,7 @@ void Gpu2D::drawExtended(int bg, int line)
                 }
 
                 // Get the palette index for the current pixel
-                uint8_t index = core->memory.read<uint8_t>(core->isGbaMode(), dataBase + rotscaleY * sizeX + rotscaleX);
+                uint8_t index = readBg<uint8_t>(dataBase + rotscaleY * sizeX + rotscaleX);
 
                 // Draw a pixel
                 if (index)
@@ -802,7 +1071,7 @@ void Gpu2D::drawExtended(int bg, int line)
 
             // Get the current tile
             uint32_t tileAddr = tileBase + ((rotscaleY / 8) * (size / 8) + (rotscaleX / 8)) * 2;
-            uint16_t tile = core->memory.read<uint16_t>(core->isGbaMode(), tileAddr);
+            uint16_t tile = readBg<uint16_t>(tileAddr);
 
             // Get the tile's palette
             uint8_t *pal;
@@ -821,7 +1090,7 @@ void Gpu2D::drawExtended(int bg, int line)
             uint32_t indexAddr = indexBase + (tile & 0x03FF) * 64;
             indexAddr += ((tile & BIT(11)) ? (7 - rotscaleY % 8) : (rotscaleY % 8)) * 8;
             indexAddr += ((tile & BIT(10)) ? (7 - rotscaleX % 8) : (rotscaleX % 8));
-            uint8_t index = core->memory.read<uint8_t>(core->isGbaMode(), indexAddr);
+            uint8_t index = readBg<uint8_t>(indexAddr);
 
             // Draw a pixel
             if (index)
@@ -873,7 +1142,7 @@ void Gpu2D::drawLarge(int bg, int line)
             rotscaleY %= sizeY / 4;
 
         // Get the palette index for the current pixel
-        uint8_t index = core->memory.read<uint8_t>(0, bgVramAddr + rotscaleY * sizeX + rotscaleX);
+        uint8_t index = readBg<uint8_t>(bgVramAddr + rotscaleY * sizeX + rotscaleX);
 
         // Draw a pixel
         if (index)
@@ -885,12 +1154,57 @@ void Gpu2D::drawLarge(int bg, int line)
     internalY[bg - 2] += bgPD[bg - 2];
 }
 
-void Gpu2D::drawObjects(int line)
+void Gpu2D::updateObjLists()
 {
-    // Loop through and draw the 128 sprites in OAM
+    // Object heights for each size and shape
+    static const int heights[4][4] =
+    {
+        {  8,  8, 16, 0 },
+        { 16,  8, 32, 0 },
+        { 32, 16, 32, 0 },
+        { 64, 32, 64, 0 }
+    };
+
+    // Sort the 128 sprites in OAM into lists of the scanlines they cover, keeping them in OAM order
+    memset(objCounts, 0, sizeof(objCounts));
     for (int i = 0; i < 128; i++)
+    {
+        uint16_t object0 = U8TO16(oam, i * 8);
+        uint16_t object1 = U8TO16(oam, i * 8 + 2);
+
+        // Skip sprites that are disabled
+        if (!(object0 & BIT(8)) && (object0 & BIT(9)))
+            continue;
+
+        // Get the height of the object's bounds, doubled for rotscale objects with the double size bit set
+        int height = heights[(object1 & 0xC000) >> 14][(object0 & 0xC000) >> 14];
+        if ((object0 & BIT(8)) && (object0 & BIT(9)))
+            height *= 2;
+
+        // Get the Y coordinate and wrap it around if it exceeds the screen bounds
+        int y = (object0 & 0x00FF);
+        if (y >= 192) y -= 256;
+
+        // Add the object to the list of every scanline it covers
+        for (int line = std::max(y, 0); line < std::min(y + height, 192); line++)
+            objLists[line][objCounts[line]++] = i;
+    }
+}
+
+void Gpu2D::drawObjects(int line)
+{
+    // Rebuild the scanline lists if OAM changed since they were made
+    if (listedChanges != objChanges)
+    {
+        listedChanges = objChanges;
+        updateObjLists();
+    }
+
+    // Loop through and draw the sprites that cover the current scanline
+    for (int n = 0; n < objCounts[line]; n++)
     {
         // Get the current object
+        int i = objLists[line][n];
         // Each object takes up 8 bytes in memory, but the last 2 bytes are reserved for rotscale
         uint16_t object[3];
         object[0] = U8TO16(oam, i * 8);
@@ -1016,7 +1330,7 @@ void Gpu2D::drawObjects(int line)
                     if (rotscaleY < 0 || rotscaleY >= height) continue;
 
                     // Draw a pixel if the old one is lower priority
-                    uint16_t pixel = core->memory.read<uint16_t>(0, dataBase + (rotscaleY * bitmapWidth + rotscaleX) * 2);
+                    uint16_t pixel = readObj<uint16_t>(dataBase + (rotscaleY * bitmapWidth + rotscaleX) * 2);
                     if ((pixel & BIT(15)) && prio < objPrio[offset])
                     {
                         layers[4][offset] = pixel;
@@ -1033,7 +1347,7 @@ void Gpu2D::drawObjects(int line)
                     if (offset < 0 || offset >= 256) continue;
 
                     // Draw a pixel if the old one is lower priority
-                    uint16_t pixel = core->memory.read<uint16_t>(0, dataBase + (spriteY * bitmapWidth + j) * 2);
+                    uint16_t pixel = readObj<uint16_t>(dataBase + (spriteY * bitmapWidth + j) * 2);
                     if ((pixel & BIT(15)) && prio < objPrio[offset])
                     {
                         layers[4][offset] = pixel;
@@ -1097,7 +1411,7 @@ void Gpu2D::drawObjects(int line)
                     if (rotscaleY < 0 || rotscaleY >= height) continue;
 
                     // Get the palette index for the current pixel
-                    uint8_t index = core->memory.read<uint8_t>(core->isGbaMode(), tileBase +
+                    uint8_t index = readObj<uint8_t>(tileBase +
                         ((rotscaleY / 8) * mapWidth + rotscaleY % 8) * 8 + (rotscaleX / 8) * 64 + rotscaleX % 8);
 
                     if (index && type == 2) // Object window
@@ -1145,7 +1459,7 @@ void Gpu2D::drawObjects(int line)
                     if (rotscaleY < 0 || rotscaleY >= height) continue;
 
                     // Get the palette index for the current pixel
-                    uint8_t index = core->memory.read<uint8_t>(core->isGbaMode(), tileBase +
+                    uint8_t index = readObj<uint8_t>(tileBase +
                         ((rotscaleY / 8) * mapWidth + rotscaleY % 8) * 4 + (rotscaleX / 8) * 32 + (rotscaleX % 8) / 2);
                     index = (rotscaleX % 2 == 1) ? ((index & 0xF0) >> 4) : (index & 0x0F);
 
@@ -1202,7 +1516,7 @@ void Gpu2D::drawObjects(int line)
                 if (offset < 0 || offset >= 256) continue;
 
                 // Get the palette index for the current pixel
-                uint8_t index = core->memory.read<uint8_t>(core->isGbaMode(), tileBase + (j / 8) * 64 + j % 8);
+                uint8_t index = readObj<uint8_t>(tileBase + (j / 8) * 64 + j % 8);
 
                 if (index && type == 2) // Object window
                 {
@@ -1247,7 +1561,7 @@ void Gpu2D::drawObjects(int line)
                 if (offset < 0 || offset >= 256) continue;
 
                 // Get the palette index for the current pixel
-                uint8_t index = core->memory.read<uint8_t>(core->isGbaMode(), tileBase + (j / 8) * 32 + (j % 8) / 2);
+                uint8_t index = readObj<uint8_t>(tileBase + (j / 8) * 32 + (j % 8) / 2);
                 index = (j & 1) ? ((index & 0xF0) >> 4) : (index & 0x0F);
 
                 if (index && type == 2) // Object window
@@ -1279,141 +1593,205 @@ void Gpu2D::writeDispCnt(uint32_t mask, uint32_t value)
 {
     // Write to the DISPCNT register
     mask &= ((engine == 0) ? 0xFFFFFFFF : 0xC0B1FFF7);
-    dispCnt = (dispCnt & ~mask) | (value & mask);
-    if (core->isGbaMode()) dispCnt &= 0xFFFF;
+    value = (dispCnt & ~mask) | (value & mask);
+    if (core->isGbaMode()) value &= 0xFFFF;
+    if (value == dispCnt) return;
+    invalidate();
+    dispCnt = value;
 }
 
 void Gpu2D::writeBgCnt(int bg, uint16_t mask, uint16_t value)
 {
     // Write to one of the BGCNT registers
-    bgCnt[bg] = (bgCnt[bg] & ~mask) | (value & mask);
+    value = (bgCnt[bg] & ~mask) | (value & mask);
+    if (value == bgCnt[bg]) return;
+    invalidate();
+    bgCnt[bg] = value;
 }
 
 void Gpu2D::writeBgHOfs(int bg, uint16_t mask, uint16_t value)
 {
     // Write to one of the BGHOFS registers
     mask &= 0x01FF;
-    bgHOfs[bg] = (bgHOfs[bg] & ~mask) | (value & mask);
+    value = (bgHOfs[bg] & ~mask) | (value & mask);
+    if (value == bgHOfs[bg]) return;
+    invalidate();
+    bgHOfs[bg] = value;
 }
 
 void Gpu2D::writeBgVOfs(int bg, uint16_t mask, uint16_t value)
 {
     // Write to one of the BGVOFS registers
     mask &= 0x01FF;
-    bgVOfs[bg] = (bgVOfs[bg] & ~mask) | (value & mask);
+    value = (bgVOfs[bg] & ~mask) | (value & mask);
+    if (value == bgVOfs[bg]) return;
+    invalidate();
+    bgVOfs[bg] = value;
 }
 
 void Gpu2D::writeBgPA(int bg, uint16_t mask, uint16_t value)
 {
     // Write to one of the BGPA registers
-    bgPA[bg - 2] = (bgPA[bg - 2] & ~mask) | (value & mask);
+    value = (bgPA[bg - 2] & ~mask) | (value & mask);
+    if ((int16_t)value == bgPA[bg - 2]) return;
+    invalidate();
+    bgPA[bg - 2] = value;
 }
 
 void Gpu2D::writeBgPB(int bg, uint16_t mask, uint16_t value)
 {
     // Write to one of the BGPB registers
-    bgPB[bg - 2] = (bgPB[bg - 2] & ~mask) | (value & mask);
+    value = (bgPB[bg - 2] & ~mask) | (value & mask);
+    if ((int16_t)value == bgPB[bg - 2]) return;
+    invalidate();
+    bgPB[bg - 2] = value;
 }
 
 void Gpu2D::writeBgPC(int bg, uint16_t mask, uint16_t value)
 {
     // Write to one of the BGPC registers
-    bgPC[bg - 2] = (bgPC[bg - 2] & ~mask) | (value & mask);
+    value = (bgPC[bg - 2] & ~mask) | (value & mask);
+    if ((int16_t)value == bgPC[bg - 2]) return;
+    invalidate();
+    bgPC[bg - 2] = value;
 }
 
 void Gpu2D::writeBgPD(int bg, uint16_t mask, uint16_t value)
 {
     // Write to one of the BGPD registers
-    bgPD[bg - 2] = (bgPD[bg - 2] & ~mask) | (value & mask);
+    value = (bgPD[bg - 2] & ~mask) | (value & mask);
+    if ((int16_t)value == bgPD[bg - 2]) return;
+    invalidate();
+    bgPD[bg - 2] = value;
 }
 
 void Gpu2D::writeBgX(int bg, uint32_t mask, uint32_t value)
 {
     // Write to one of the BGX registers
     mask &= 0x0FFFFFFF;
-    bgX[bg - 2] = (bgX[bg - 2] & ~mask) | (value & mask);
+    int32_t x = (bgX[bg - 2] & ~mask) | (value & mask);
 
     // Extend the sign to 32 bits
-    if (bgX[bg - 2] & BIT(27)) bgX[bg - 2] |= 0xF0000000; else bgX[bg - 2] &= ~0xF0000000;
+    if (x & BIT(27)) x |= 0xF0000000; else x &= ~0xF0000000;
 
     // Reload the internal register
-    internalX[bg - 2] = bgX[bg - 2];
+    // The internal register advances as lines are drawn, so queued scanlines have to finish before it's compared
+    // During V-blank this doesn't affect the output, since the internal registers are reloaded before drawing
+    bool visible = core->gpu.readVCount() < 192;
+    if (visible) core->gpu.sync2D();
+    if (x != bgX[bg - 2] || (x != internalX[bg - 2] && visible))
+        invalidate();
+    bgX[bg - 2] = internalX[bg - 2] = x;
 }
 
 void Gpu2D::writeBgY(int bg, uint32_t mask, uint32_t value)
 {
     // Write to one of the BGY registers
     mask &= 0x0FFFFFFF;
-    bgY[bg - 2] = (bgY[bg - 2] & ~mask) | (value & mask);
+    int32_t y = (bgY[bg - 2] & ~mask) | (value & mask);
 
     // Extend the sign to 32 bits
-    if (bgY[bg - 2] & BIT(27)) bgY[bg - 2] |= 0xF0000000; else bgY[bg - 2] &= ~0xF0000000;
+    if (y & BIT(27)) y |= 0xF0000000; else y &= ~0xF0000000;
 
     // Reload the internal register
-    internalY[bg - 2] = bgY[bg - 2];
+    // During V-blank this doesn't affect the output, since the internal registers are reloaded before drawing
+    bool visible = core->gpu.readVCount() < 192;
+    if (visible) core->gpu.sync2D();
+    if (y != bgY[bg - 2] || (y != internalY[bg - 2] && visible))
+        invalidate();
+    bgY[bg - 2] = internalY[bg - 2] = y;
 }
 
-
 void Gpu2D::writeWinH(int win, uint16_t mask, uint16_t value)
 {
     // Write to one of the WINH registers
-    if (mask & 0x00FF) winX2[win] = (value & 0x00FF) >> 0;
-    if (mask & 0xFF00) winX1[win] = (value & 0xFF00) >> 8;
+    uint16_t x1 = winX1[win], x2 = winX2[win];
+    if (mask & 0x00FF) x2 = (value & 0x00FF) >> 0;
+    if (mask & 0xFF00) x1 = (value & 0xFF00) >> 8;
 
     // Handle invalid values
-    if (winX1[win] > winX2[win])
-        winX2[win] = 256;
+    if (x1 > x2)
+        x2 = 256;
+
+    if (x1 == winX1[win] && x2 == winX2[win]) return;
+    invalidate();
+    winX1[win] = x1;
+    winX2[win] = x2;
 }
 
 void Gpu2D::writeWinV(int win, uint16_t mask, uint16_t value)
 {
     // Write to one of the WINV registers
-    if (mask & 0x00FF) winY2[win] = (value & 0x00FF) >> 0;
-    if (mask & 0xFF00) winY1[win] = (value & 0xFF00) >> 8;
+    uint16_t y1 = winY1[win], y2 = winY2[win];
+    if (mask & 0x00FF) y2 = (value & 0x00FF) >> 0;
+    if (mask & 0xFF00) y1 = (value & 0xFF00) >> 8;
 
     // Handle invalid values
-    if (winY1[win] > winY2[win])
-        winY2[win] = 192;
+    if (y1 > y2)
+        y2 = 192;
+
+    if (y1 == winY1[win] && y2 == winY2[win]) return;
+    invalidate();
+    winY1[win] = y1;
+    winY2[win] = y2;
 }
 
 void Gpu2D::writeWinIn(uint16_t mask, uint16_t value)
 {
     // Write to the WININ register
     mask &= 0x3F3F;
-    winIn = (winIn & ~mask) | (value & mask);
+    value = (winIn & ~mask) | (value & mask);
+    if (value == winIn) return;
+    invalidate();
+    winIn = value;
 }
 
 void Gpu2D::writeWinOut(uint16_t mask, uint16_t value)
 {
     // Write to the WINOUT register
     mask &= 0x3F3F;
-    winOut = (winOut & ~mask) | (value & mask);
+    value = (winOut & ~mask) | (value & mask);
+    if (value == winOut) return;
+    invalidate();
+    winOut = value;
 }
 
 void Gpu2D::writeBldCnt(uint16_t mask, uint16_t value)
 {
     // Write to the BLDCNT register
     mask &= 0x3FFF;
-    bldCnt = (bldCnt & ~mask) | (value & mask);
+    value = (bldCnt & ~mask) | (value & mask);
+    if (value == bldCnt) return;
+    invalidate();
+    bldCnt = value;
 }
 
 void Gpu2D::writeBldAlpha(uint16_t mask, uint16_t value)
 {
     // Write to the BLDALPHA register
     mask &= 0x1F1F;
-    bldAlpha = (bldAlpha & ~mask) | (value & mask);
+    value = (bldAlpha & ~mask) | (value & mask);
+    if (value == bldAlpha) return;
+    invalidate();
+    bldAlpha = value;
 }
 
 void Gpu2D::writeBldY(uint8_t value)
 {
     // Write to the BLDY register
-    bldY = value & 0x1F;
-    if (bldY > 16) bldY = 16;
+    value &= 0x1F;
+    if (value > 16) value = 16;
+    if (value == bldY) return;
+    invalidate();
+    bldY = value;
 }
 
 void Gpu2D::writeMasterBright(uint16_t mask, uint16_t value)
 {
     // Write to the MASTER_BRIGHT register
     mask &= 0xC01F;
-    masterBright = (masterBright & ~mask) | (value & mask);
+    value = (masterBright & ~mask) | (value & mask);
+    if (value == masterBright) return;
+    invalidate();
+    masterBright = value;
 }
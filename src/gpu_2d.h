@@ -21,19 +21,29 @@
 #define GPU_2D_H
 
 #include <cstdint>
+#include <vector>
 
 class Core;
+class Savestate;
 
 class Gpu2D
 {
     public:
         Gpu2D(Core *core, bool engine);
 
+        void syncState(Savestate *state);
+
         void drawGbaScanline(int line);
         void drawScanline(int line);
 
         uint32_t *getFramebuffer() { return framebuffer; }
         uint32_t *getRawLine()     { return layers[5];   }
+        uint64_t *getEffects3D()   { return effects3D.empty() ? nullptr : &effects3D[0]; }
+
+        static uint32_t blend3D(uint32_t color, uint64_t effect);
+
+        void invalidate();
+        void invalidateObjects() { objChanges++; }
 
         uint32_t readDispCnt()      { return dispCnt;      }
         uint16_t readBgCnt(int bg)  { return bgCnt[bg];    }
@@ -69,12 +79,26 @@ class Gpu2D
         uint32_t bgVramAddr, objVramAddr;
         uint8_t *palette, *oam;
         uint8_t **extPalettes;
+        uint8_t **bgVram, **objVram;
+        uint32_t bgVramMask, objVramMask;
 
         uint32_t framebuffer[256 * 192] = {};
+        std::vector<uint64_t> effects3D;
         uint32_t layers[6][256] = {};
         uint8_t objPrio[256] = {};
 
         int gbaBlock = 0;
+        uint32_t borderGeneration = 0;
+        int stableBorders = 0;
+
+        uint32_t changes = 0;
+        uint32_t drawnChanges = 0;
+        int cleanLines = 0;
+
+        uint8_t objLists[192][128] = {};
+        uint8_t objCounts[192] = {};
+        uint32_t objChanges = 1;
+        uint32_t listedChanges = 0;
 
         int internalX[2] = {};
         int internalY[2] = {};
@@ -102,10 +126,17 @@ class Gpu2D
 
         static uint32_t rgb5ToRgb6(uint32_t color);
 
+        template <typename T> T readBg(uint32_t address);
+        template <typename T> T readObj(uint32_t address);
+
+        void calculateWindows(uint8_t *enabled, int line, int width);
+        void blendPixels(uint32_t *pixels, uint32_t *pixels2, uint8_t *effects);
+
         void drawText(int bg, int line);
         void drawAffine(int bg, int line);
         void drawExtended(int bg, int line);
         void drawLarge(int bg, int line);
+        void updateObjLists();
         void drawObjects(int line);
 };
 
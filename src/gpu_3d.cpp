@@ -17,13 +17,24 @@
     along with NooDS. If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <cstring>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #include "gpu_3d.h"
 #include "core.h"
 
 Gpu3D::Gpu3D(Core *core): core(core)
 {
+    // Start with an empty command queue
+    queueHeadShared.store(0);
+    queueTail.store(0);
+
     // Set the parameter counts
     paramCounts[0x10] = 1;
     paramCounts[0x11] = 0;
@@ -64,7 +75,145 @@ Gpu3D::Gpu3D(Core *core): core(core)
     paramCounts[0x72] = 1;
 
     // Prepare tasks to be used with the scheduler
-    runCommandTask = std::bind(&Gpu3D::runCommand, this);
+    runCommandTask = std::bind(&Gpu3D::runBatch, this);
+}
+
+Gpu3D::~Gpu3D()
+{
+    // Clean up the thread
+    stopThread();
+}
+
+void Gpu3D::syncState(Savestate *state)
+{
+    // Register the task so it can be referenced by ID
+    state->addTask(&runCommandTask);
+
+    // Let the geometry thread finish its commands before anything changes
+    syncThread();
+
+    // Sync the geometry engine state
+    // The FIFO is synced from front to back, in the same format as a queue
+    state->sync(this->state);
+    state->sync(cmdCycles);
+    state->sync(fifoSize);
+    for (int i = 0; i < fifoSize; i++)
+        state->sync(fifo[(fifoHead + i) & 0x1FF]);
+    state->sync(pipeSize);
+
+    // Sync the matrices
+    state->sync(matrixMode);
+    state->sync(projectionPtr);
+    state->sync(coordinatePtr);
+    state->sync(clipDirty);
+    state->sync(projection);
+    state->sync(projectionStack);
+    state->sync(coordinate);
+    state->sync(coordinateStack);
+    state->sync(direction);
+    state->sync(directionStack);
+    state->sync(texture);
+    state->sync(textureStack);
+    state->sync(clip);
+    state->sync(temp);
+
+    // Sync which of the vertex and polygon buffers are in use for input
+    bool swapped = (verticesIn == vertices2);
+    state->sync(swapped);
+    if (state->isLoading())
+    {
+        verticesIn  = swapped ? vertices2 : vertices1;
+        verticesOut = swapped ? vertices1 : vertices2;
+        polygonsIn  = swapped ? polygons2 : polygons1;
+        polygonsOut = swapped ? polygons1 : polygons2;
+    }
+
+    // Sync the used parts of the vertex buffers
+    state->sync(vertexCountIn);
+    state->sync(vertexCountOut);
+    if (vertexCountIn  < 0 || vertexCountIn  > 6144) vertexCountIn  = 0;
+    if (vertexCountOut < 0 || vertexCountOut > 6144) vertexCountOut = 0;
+    state->syncData(verticesIn,  vertexCountIn  * sizeof(Vertex));
+    state->syncData(verticesOut, vertexCountOut * sizeof(Vertex));
+
+    // Sync the used parts of the polygon buffers
+    state->sync(polygonCountIn);
+    state->sync(polygonCountOut);
+    if (polygonCountIn  < 0 || polygonCountIn  > 2048) polygonCountIn  = 0;
+    if (polygonCountOut < 0 || polygonCountOut > 2048) polygonCountOut = 0;
+    for (int i = 0; i < polygonCountIn; i++)
+        syncPolygon(state, &polygonsIn[i]);
+    for (int i = 0; i < polygonCountOut; i++)
+        syncPolygon(state, &polygonsOut[i]);
+
+    // Sync the vertex and polygon being built
+    state->sync(savedVertex);
+    syncPolygon(state, &savedPolygon);
+    state->sync(s);
+    state->sync(t);
+
+    // Sync the rest of the geometry state
+    state->sync(vertexCount);
+    state->sync(clockwise);
+    state->sync(polygonType);
+    state->sync(textureCoordMode);
+    state->sync(polygonAttr);
+    state->sync(enabledLights);
+    state->sync(renderBack);
+    state->sync(renderFront);
+    state->sync(diffuseColor);
+    state->sync(ambientColor);
+    state->sync(specularColor);
+    state->sync(emissionColor);
+    state->sync(shininessEnabled);
+    state->sync(lightVector);
+    state->sync(halfVector);
+    state->sync(lightColor);
+    state->sync(shininess);
+    state->sync(viewportX);
+    state->sync(viewportY);
+    state->sync(viewportWidth);
+    state->sync(viewportHeight);
+    state->sync(boxTestCoords);
+
+    // Sync the registers, saving the separately kept geometry bits of GXSTAT together with the rest
+    state->sync(gxFifo);
+    uint32_t stat = gxStat | geometryStat;
+    state->sync(stat);
+    gxStat = stat & ~0x0000BF02;
+    geometryStat = stat & 0x0000BF02;
+    state->sync(posResult);
+    state->sync(vecResult);
+    state->sync(gxFifoCount);
+}
+
+void Gpu3D::syncPolygon(Savestate *state, _Polygon *polygon)
+{
+    // Convert the vertex pointer to an index across both vertex buffers, with -1 representing null
+    int32_t index = -1;
+    if (polygon->vertices >= vertices1 && polygon->vertices <= &vertices1[6144])
+        index = polygon->vertices - vertices1;
+    else if (polygon->vertices >= vertices2 && polygon->vertices <= &vertices2[6144])
+        index = 6145 + (polygon->vertices - vertices2);
+
+    // Sync the polygon and the index, leaving the host pointer out of the state
+    Vertex *vertices = polygon->vertices;
+    polygon->vertices = nullptr;
+    state->sync(*polygon);
+    state->sync(index);
+
+    if (state->isLoading())
+    {
+        // Convert the index back to a pointer
+        if (index >= 0 && index <= 6144)
+            polygon->vertices = &vertices1[index];
+        else if (index > 6144 && index <= 6145 + 6144)
+            polygon->vertices = &vertices2[index - 6145];
+    }
+    else
+    {
+        polygon->vertices = vertices;
+    }
 }
 
 uint32_t Gpu3D::rgb5ToRgb6(uint16_t color)
@@ -76,20 +225,57 @@ uint32_t Gpu3D::rgb5ToRgb6(uint16_t color)
     return (b << 12) | (g << 6) | r;
 }
 
+void Gpu3D::multiplyRow(const int32_t *row, const int32_t *mtx, int32_t *result)
+{
+    // Multiply a row of 4 fixed-point values with a matrix, giving another row
+    // Only bits 12 to 43 of each 64-bit sum end up in the result, so the sums can be done modulo 2^64
+#if defined(__x86_64__) || defined(_M_X64)
+    // SSE2 only has unsigned 32-bit multiplies, so do those and correct for the signs afterwards
+    // For the low 64 bits, a signed product is the unsigned one minus each operand shifted up 32 if the other is negative
+    __m128i even = _mm_setzero_si128(), odd = _mm_setzero_si128(), fix = _mm_setzero_si128();
+    for (int i = 0; i < 4; i++)
+    {
+        __m128i a = _mm_set1_epi32(row[i]);
+        __m128i b = _mm_loadu_si128((__m128i*)&mtx[i * 4]);
+        even = _mm_add_epi64(even, _mm_mul_epu32(a, b));
+        odd = _mm_add_epi64(odd, _mm_mul_epu32(a, _mm_srli_epi64(b, 32)));
+        fix = _mm_add_epi32(fix, _mm_add_epi32(_mm_and_si128(_mm_srai_epi32(a, 31), b), _mm_and_si128(_mm_srai_epi32(b, 31), a)));
+    }
+
+    // Apply the sign corrections, shift the sums, and put the even and odd columns back together
+    const __m128i low = _mm_set_epi32(0, -1, 0, -1);
+    even = _mm_srli_epi64(_mm_sub_epi64(even, _mm_slli_epi64(fix, 32)), 12);
+    odd = _mm_slli_epi64(_mm_srli_epi64(_mm_sub_epi64(odd, _mm_andnot_si128(low, fix)), 12), 32);
+    _mm_storeu_si128((__m128i*)result, _mm_or_si128(_mm_and_si128(even, low), odd));
+#elif defined(__aarch64__)
+    // Multiply and accumulate with NEON, narrowing the shifted sums back to 32 bits
+    int32x4_t b = vld1q_s32(&mtx[0]);
+    int64x2_t lo = vmull_n_s32(vget_low_s32(b), row[0]);
+    int64x2_t hi = vmull_high_n_s32(b, row[0]);
+    for (int i = 1; i < 4; i++)
+    {
+        b = vld1q_s32(&mtx[i * 4]);
+        lo = vmlal_n_s32(lo, vget_low_s32(b), row[i]);
+        hi = vmlal_high_n_s32(hi, b, row[i]);
+    }
+    vst1q_s32(result, vcombine_s32(vshrn_n_s64(lo, 12), vshrn_n_s64(hi, 12)));
+#else
+    for (int x = 0; x < 4; x++)
+    {
+        int64_t value = 0;
+        for (int i = 0; i < 4; i++) value += (int64_t)row[i] * mtx[i * 4 + x];
+        result[x] = value >> 12;
+    }
+#endif
+}
+
 Matrix Gpu3D::multiply(Matrix *mtx1, Matrix *mtx2)
 {
     Matrix matrix;
 
-    // Multiply 2 matrices
+    // Multiply 2 matrices, one row at a time
     for (int y = 0; y < 4; y++)
-    {
-        for (int x = 0; x < 4; x++)
-        {
-            int64_t value = 0;
-            for (int i = 0; i < 4; i++) value += (int64_t)mtx1->data[y * 4 + i] * mtx2->data[i * 4 + x];
-            matrix.data[y * 4 + x] = value >> 12;
-        }
-    }
+        multiplyRow(&mtx1->data[y * 4], mtx2->data, &matrix.data[y * 4]);
 
     return matrix;
 }
@@ -98,11 +284,14 @@ Vertex Gpu3D::multiply(Vertex *vtx, Matrix *mtx)
 {
     Vertex vertex = *vtx;
 
-    // Multiply a vertex with a matrix
-    vertex.x = ((int64_t)vtx->x * mtx->data[0] + (int64_t)vtx->y * mtx->data[4] + (int64_t)vtx->z * mtx->data[8]  + (int64_t)vtx->w * mtx->data[12]) >> 12;
-    vertex.y = ((int64_t)vtx->x * mtx->data[1] + (int64_t)vtx->y * mtx->data[5] + (int64_t)vtx->z * mtx->data[9]  + (int64_t)vtx->w * mtx->data[13]) >> 12;
-    vertex.z = ((int64_t)vtx->x * mtx->data[2] + (int64_t)vtx->y * mtx->data[6] + (int64_t)vtx->z * mtx->data[10] + (int64_t)vtx->w * mtx->data[14]) >> 12;
-    vertex.w = ((int64_t)vtx->x * mtx->data[3] + (int64_t)vtx->y * mtx->data[7] + (int64_t)vtx->z * mtx->data[11] + (int64_t)vtx->w * mtx->data[15]) >> 12;
+    // Multiply a vertex with a matrix, treating its coordinates as a row
+    int32_t row[4] = { vtx->x, vtx->y, vtx->z, vtx->w };
+    int32_t result[4];
+    multiplyRow(row, mtx->data, result);
+    vertex.x = result[0];
+    vertex.y = result[1];
+    vertex.z = result[2];
+    vertex.w = result[3];
 
     return vertex;
 }
@@ -199,30 +388,153 @@ bool Gpu3D::clipPolygon(Vertex *unclipped, Vertex *clipped, int *size)
     return clip;
 }
 
+void Gpu3D::resetCycles()
+{
+    // Adjust the next command cycle for a global cycle reset, catching up first so it can't go negative
+    runCommands();
+    cmdCycles -= core->getGlobalCycles();
+}
+
+void Gpu3D::runBatch()
+{
+    // Catch up to the end of the batch, and schedule the next one if more commands are ready
+    runCommands();
+    if (state == GX_RUNNING)
+        scheduleBatch();
+}
+
+void Gpu3D::runCommands()
+{
+    // Run every command that was due by the current cycle
+    if (state != GX_RUNNING || cmdCycles > core->getGlobalCycles())
+        return;
+
+    ProfileScope scope(&core->profiler, PROFILE_3D);
+    while (state == GX_RUNNING && cmdCycles <= core->getGlobalCycles())
+        runCommand();
+
+    // Hand the batch to the geometry thread
+    if (thread)
+        publishCommands();
+}
+
+void Gpu3D::scheduleBatch()
+{
+    // Step through the FIFO counts for the ready commands, without running them
+    // The batch ends at the last ready command, or the first one that halts the engine or affects more than registers
+    uint32_t cycles = cmdCycles;
+    int head = fifoHead, size = fifoSize, pipe = pipeSize;
+    while (true)
+    {
+        uint8_t command = fifo[head].command;
+        int count = std::max(paramCounts[command], 1);
+        head = (head + count) & 0x1FF;
+        size -= count;
+        pipe = 4 - ((pipe + count) & 1);
+        if (pipe > size) pipe = size;
+        int entries = size - pipe;
+
+        // Check for a swap, a GXFIFO DMA trigger, a GXFIFO IRQ, or an unhalt of a CPU waiting for space
+        if (command == 0x50 || (entries < 128 && !(gxStat & BIT(25))) || (entries <= 256 && fifoSize - pipeSize > 256))
+            break;
+        if ((((gxStat & 0xC0000000) >> 30) == 1 && (entries < 128 || (gxStat & BIT(25)))) ||
+            (((gxStat & 0xC0000000) >> 30) == 2 && entries == 0))
+            break;
+
+        // Check if the next command is ready
+        if (size == 0 || size < paramCounts[fifo[head].command])
+            break;
+        cycles += 2;
+    }
+
+    core->schedule(Task(&runCommandTask, cycles - core->getGlobalCycles()));
+}
+
 void Gpu3D::runCommand()
 {
+    core->profiler.add(COUNTER_GX_COMMANDS);
+
     // Fetch the next geometry command
-    Entry entry = fifo.front();
-    int count = paramCounts[entry.command];
-    std::vector<uint32_t> params;
+    uint8_t command = fifo[fifoHead].command;
+    int count = std::max(paramCounts[command], 1);
 
-    // If the command has multiple parameters, fetch them all
-    if (count > 1)
+    if (thread)
     {
-        params.reserve(count);
-        for (int i = 0; i < count; i++)
+        // Wait for space in the geometry thread's queue, making sure it can see everything before this
+        if (queueHead + count - queueTail.load() > 0x1000)
         {
-            params.push_back(fifo.front().param);
-            fifo.pop();
+            publishCommands();
+            while (queueHead + count - queueTail.load() > 0x1000)
+                std::this_thread::yield();
         }
+
+        // Copy the command and its parameters to the queue, to be published at the end of the batch
+        for (int i = 0; i < count; i++)
+            queue[(queueHead + i) & 0xFFF] = fifo[(fifoHead + i) & 0x1FF];
+        queueHead += count;
     }
     else
     {
-        count = 1;
-        fifo.pop();
+        // Execute the command, reading its parameters in place
+        paramRing = fifo;
+        paramHead = fifoHead;
+        paramMask = 0x1FF;
+        executeCommand();
     }
 
-    // Execute the geometry command
+    // Halt the geometry engine after a swap command
+    // The buffers will be swapped and the engine unhalted on next V-blank
+    if (command == 0x50)
+        state = GX_HALTED;
+
+    // Remove the command and its parameters from the FIFO
+    fifoHead = (fifoHead + count) & 0x1FF;
+    fifoSize -= count;
+
+    // On hardware, FIFO entries are moved into a pipe before being executed
+    // The pipe can hold 4 entries, and is refilled when it runs half empty (2 entries)
+    // As long as there are enough entries, set the pipe size to 3 or 4 depending on when it would refill
+    pipeSize = 4 - ((pipeSize + count) & 1);
+    if (pipeSize > fifoSize) pipeSize = fifoSize;
+
+    // Update the FIFO status
+    gxStat = (gxStat & ~0x01FF0000) | ((fifoSize - pipeSize) << 16); // FIFO entries
+    if (fifoSize - pipeSize == 0) gxStat |=  BIT(26); // FIFO empty
+    if (fifoSize == 0)            gxStat &= ~BIT(27); // Commands not executing
+
+    // If the FIFO becomes less than half full, trigger GXFIFO DMA transfers
+    // If the FIFO is already less than half full when a DMA starts, it will automatically activate
+    if (fifoSize - pipeSize < 128 && !(gxStat & BIT(25)))
+    {
+        gxStat |= BIT(25);
+        core->dma[0].trigger(7);
+    }
+
+    // Send a GXFIFO interrupt if enabled
+    switch ((gxStat & 0xC0000000) >> 30)
+    {
+        case 1: if (gxStat & BIT(25)) core->interpreter[0].sendInterrupt(21); break;
+        case 2: if (gxStat & BIT(26)) core->interpreter[0].sendInterrupt(21); break;
+    }
+
+    // Unhalt the CPU if the FIFO was full but now has space free
+    if (fifoSize - pipeSize <= 256)
+        core->interpreter[0].unhalt(1);
+
+    // Keep executing commands 2 cycles apart as long as they're ready
+    if (state != GX_HALTED)
+    {
+        if (fifoSize > 0 && fifoSize >= paramCounts[fifo[fifoHead].command])
+            cmdCycles += 2;
+        else
+            state = GX_IDLE;
+    }
+}
+
+void Gpu3D::executeCommand()
+{
+    // Execute the geometry command at the front of the parameter ring
+    Entry entry = paramRing[paramHead];
     switch (entry.command)
     {
         case 0x10: mtxModeCmd(entry.param);       break; // MTX_MODE
@@ -231,17 +543,17 @@ void Gpu3D::runCommand()
         case 0x13: mtxStoreCmd(entry.param);      break; // MTX_STORE
         case 0x14: mtxRestoreCmd(entry.param);    break; // MTX_RESTORE
         case 0x15: mtxIdentityCmd();              break; // MTX_IDENTITY
-        case 0x16: mtxLoad44Cmd(&params);         break; // MTX_LOAD_4x4
-        case 0x17: mtxLoad43Cmd(&params);         break; // MTX_LOAD_4x3
-        case 0x18: mtxMult44Cmd(&params);         break; // MTX_MULT_4x4
-        case 0x19: mtxMult43Cmd(&params);         break; // MTX_MULT_4x3
-        case 0x1A: mtxMult33Cmd(&params);         break; // MTX_MULT_3x3
-        case 0x1B: mtxScaleCmd(&params);          break; // MTX_SCALE
-        case 0x1C: mtxTransCmd(&params);          break; // MTX_TRANS
+        case 0x16: mtxLoad44Cmd();                break; // MTX_LOAD_4x4
+        case 0x17: mtxLoad43Cmd();                break; // MTX_LOAD_4x3
+        case 0x18: mtxMult44Cmd();                break; // MTX_MULT_4x4
+        case 0x19: mtxMult43Cmd();                break; // MTX_MULT_4x3
+        case 0x1A: mtxMult33Cmd();                break; // MTX_MULT_3x3
+        case 0x1B: mtxScaleCmd();                 break; // MTX_SCALE
+        case 0x1C: mtxTransCmd();                 break; // MTX_TRANS
         case 0x20: colorCmd(entry.param);         break; // COLOR
         case 0x21: normalCmd(entry.param);        break; // NORMAL
         case 0x22: texCoordCmd(entry.param);      break; // TEXCOORD
-        case 0x23: vtx16Cmd(&params);             break; // VTX_16
+        case 0x23: vtx16Cmd();                    break; // VTX_16
         case 0x24: vtx10Cmd(entry.param);         break; // VTX_10
         case 0x25: vtxXYCmd(entry.param);         break; // VTX_XY
         case 0x26: vtxXZCmd(entry.param);         break; // VTX_XZ
@@ -254,13 +566,13 @@ void Gpu3D::runCommand()
         case 0x31: speEmiCmd(entry.param);        break; // SPE_EMI
         case 0x32: lightVectorCmd(entry.param);   break; // LIGHT_VECTOR
         case 0x33: lightColorCmd(entry.param);    break; // LIGHT_COLOR
-        case 0x34: shininessCmd(&params);         break; // SHININESS
+        case 0x34: shininessCmd();                break; // SHININESS
         case 0x40: beginVtxsCmd(entry.param);     break; // BEGIN_VTXS
         case 0x41:                                break; // END_VTXS
         case 0x50: swapBuffersCmd(entry.param);   break; // SWAP_BUFFERS
         case 0x60: viewportCmd(entry.param);      break; // VIEWPORT
-        case 0x70: boxTestCmd(&params);           break; // BOX_TEST
-        case 0x71: posTestCmd(&params);           break; // POS_TEST
+        case 0x70: boxTestCmd();                  break; // BOX_TEST
+        case 0x71: posTestCmd();                  break; // POS_TEST
         case 0x72: vecTestCmd(entry.param);       break; // VEC_TEST
 
         default:
@@ -270,50 +582,95 @@ void Gpu3D::runCommand()
         }
     }
 
-    // On hardware, FIFO entries are moved into a pipe before being executed
-    // The pipe can hold 4 entries, and is refilled when it runs half empty (2 entries)
-    // As long as there are enough entries, set the pipe size to 3 or 4 depending on when it would refill
-    pipeSize = 4 - ((pipeSize + count) & 1);
-    if (pipeSize > fifo.size()) pipeSize = fifo.size();
+    // Update the matrix stack pointers
+    geometryStat = (geometryStat & ~0x00001F00) | (coordinatePtr << 8);
+    geometryStat = (geometryStat & ~0x00002000) | (projectionPtr << 13);
+}
 
-    // Update the FIFO status
-    gxStat = (gxStat & ~0x00001F00) | (coordinatePtr            <<  8); // Coordinate stack pointer
-    gxStat = (gxStat & ~0x00002000) | (projectionPtr            << 13); // Projection stack pointer
-    gxStat = (gxStat & ~0x01FF0000) | ((fifo.size() - pipeSize) << 16); // FIFO entries
-    if (fifo.size() - pipeSize == 0) gxStat |=  BIT(26); // FIFO empty
-    if (fifo.size() == 0)            gxStat &= ~BIT(27); // Commands not executing
+void Gpu3D::startThread()
+{
+    // Start the geometry thread if it isn't running
+    if (thread) return;
+    running = true;
+    thread = new std::thread(&Gpu3D::runThreaded, this, core->config.pinThreads);
+}
 
-    // If the FIFO becomes less than half full, trigger GXFIFO DMA transfers
-    // If the FIFO is already less than half full when a DMA starts, it will automatically activate
-    if (fifo.size() - pipeSize < 128 && !(gxStat & BIT(25)))
+void Gpu3D::stopThread()
+{
+    // Stop the geometry thread if it's running, letting it finish any queued commands first
+    if (!thread) return;
+    publishCommands();
+    while (queueTail.load() != queueHead)
+        std::this_thread::yield();
     {
-        gxStat |= BIT(25);
-        core->dma[0].trigger(7);
+        std::lock_guard<std::mutex> lock(queueMutex);
+        running = false;
     }
+    queueCond.notify_one();
+    thread->join();
+    delete thread;
+    thread = nullptr;
 
-    // Send a GXFIFO interrupt if enabled
-    switch ((gxStat & 0xC0000000) >> 30)
+    // Go back to executing commands in place
+    paramRing = fifo;
+    paramMask = 0x1FF;
+}
+
+void Gpu3D::publishCommands()
+{
+    // Make the queued commands visible to the geometry thread and wake it if it's waiting
+    if (queueHeadShared.load() == queueHead) return;
     {
-        case 1: if (gxStat & BIT(25)) core->interpreter[0].sendInterrupt(21); break;
-        case 2: if (gxStat & BIT(26)) core->interpreter[0].sendInterrupt(21); break;
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queueHeadShared.store(queueHead);
     }
+    queueCond.notify_one();
+}
 
-    // Unhalt the CPU if the FIFO was full but now has space free
-    if (fifo.size() - pipeSize <= 256)
-        core->interpreter[0].unhalt(1);
+void Gpu3D::syncThread()
+{
+    // Catch up on commands, and wait for the geometry thread to execute every queued one
+    runCommands();
+    if (!thread) return;
+    publishCommands();
+    while (queueTail.load() != queueHead)
+        std::this_thread::yield();
+}
 
-    // Keep executing commands as long as they're ready
-    if (state != GX_HALTED)
+void Gpu3D::runThreaded(bool pin)
+{
+    if (pin) ThreadPlacement::place(THREAD_WORKER);
+
+    while (true)
     {
-        if (!fifo.empty() && fifo.size() >= paramCounts[fifo.front().command])
-            core->schedule(Task(&runCommandTask, 2));
-        else
-            state = GX_IDLE;
+        // Sleep until a command is queued or the thread is stopped
+        if (queueTail.load() == queueHeadShared.load())
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCond.wait(lock, [this] { return queueTail.load() != queueHeadShared.load() || !running; });
+            if (queueTail.load() == queueHeadShared.load()) return;
+        }
+
+        // Execute the next command, reading its parameters in place from the queue
+        uint32_t tail = queueTail.load();
+        paramRing = queue;
+        paramHead = tail & 0xFFF;
+        paramMask = 0xFFF;
+        executeCommand();
+
+        // Signal that the command and its parameters are finished
+        queueTail.store(tail + std::max(paramCounts[queue[tail & 0xFFF].command], 1));
     }
 }
 
 void Gpu3D::swapBuffers()
 {
+    // Let the geometry thread finish the frame's commands
+    syncThread();
+
+    ProfileScope scope(&core->profiler, PROFILE_3D);
+    core->profiler.add(COUNTER_POLYGONS, polygonCountIn);
+
     // Process the vertices
     for (int i = 0; i < vertexCountIn; i++)
     {
@@ -377,11 +734,18 @@ void Gpu3D::swapBuffers()
     // Invalidate the 3D so a new frame is drawn
     core->gpu.invalidate3D();
 
+    // Start or stop the geometry thread based on the setting
+    if (core->config.threadedGeo)
+        startThread();
+    else
+        stopThread();
+
     // Unhalt the GXFIFO, and start executing commands if one is ready
-    if (!fifo.empty() && fifo.size() >= paramCounts[fifo.front().command])
+    if (fifoSize > 0 && fifoSize >= paramCounts[fifo[fifoHead].command])
     {
-        core->schedule(Task(&runCommandTask, 2));
+        cmdCycles = core->getGlobalCycles() + 2;
         state = GX_RUNNING;
+        scheduleBatch();
     }
     else
     {
@@ -650,7 +1014,7 @@ void Gpu3D::mtxPushCmd()
             else
             {
                 // Indicate a matrix stack overflow error
-                gxStat |= BIT(15);
+                geometryStat |= BIT(15);
             }
             break;
         }
@@ -659,7 +1023,7 @@ void Gpu3D::mtxPushCmd()
         {
             // Indicate a matrix stack overflow error
             // Even though the 31st slot exists, it still causes an overflow error
-            if (coordinatePtr >= 30) gxStat |= BIT(15);
+            if (coordinatePtr >= 30) geometryStat |= BIT(15);
 
             // Push to the current coordinate and directional stack slots and increment the pointer
             if (coordinatePtr < 31)
@@ -697,7 +1061,7 @@ void Gpu3D::mtxPopCmd(uint32_t param)
             else
             {
                 // Indicate a matrix stack underflow error
-                gxStat |= BIT(15);
+                geometryStat |= BIT(15);
             }
             break;
         }
@@ -709,7 +1073,7 @@ void Gpu3D::mtxPopCmd(uint32_t param)
 
             // Indicate a matrix stack underflow or overflow error
             // Even though the 31st slot exists, it still causes an overflow error
-            if (address < 0 || address >= 30) gxStat |= BIT(15);
+            if (address < 0 || address >= 30) geometryStat |= BIT(15);
 
             // Pop from the current coordinate and directional stack slots and update the pointer
             if (address >= 0 && address < 31)
@@ -750,7 +1114,7 @@ void Gpu3D::mtxStoreCmd(uint32_t param)
 
             // Indicate a matrix stack overflow error
             // Even though the 31st slot exists, it still causes an overflow error
-            if (address == 31) gxStat |= BIT(15);
+            if (address == 31) geometryStat |= BIT(15);
 
             // Store to the current coordinate and directional stack slots
             coordinateStack[address] = coordinate;
@@ -787,7 +1151,7 @@ void Gpu3D::mtxRestoreCmd(uint32_t param)
 
             // Indicate a matrix stack overflow error
             // Even though the 31st slot exists, it still causes an overflow error
-            if (address == 31) gxStat |= BIT(15);
+            if (address == 31) geometryStat |= BIT(15);
 
             // Restore from the current coordinate and directional stack slots
             coordinate = coordinateStack[address];
@@ -840,11 +1204,11 @@ void Gpu3D::mtxIdentityCmd()
     }
 }
 
-void Gpu3D::mtxLoad44Cmd(std::vector<uint32_t> *params)
+void Gpu3D::mtxLoad44Cmd()
 {
     // Store the paramaters to the temporary matrix
     for (int i = 0; i < 16; i++)
-        temp.data[i] = (int32_t)(*params)[i];
+        temp.data[i] = (int32_t)getParam(i);
 
     // Set a 4x4 matrix
     switch (matrixMode)
@@ -879,12 +1243,12 @@ void Gpu3D::mtxLoad44Cmd(std::vector<uint32_t> *params)
     }
 }
 
-void Gpu3D::mtxLoad43Cmd(std::vector<uint32_t> *params)
+void Gpu3D::mtxLoad43Cmd()
 {
     // Store the paramaters to the temporary matrix
     temp = Matrix();
     for (int i = 0; i < 12; i++)
-        temp.data[(i / 3) * 4 + i % 3] = (int32_t)(*params)[i];
+        temp.data[(i / 3) * 4 + i % 3] = (int32_t)getParam(i);
 
     // Set a 4x3 matrix
     switch (matrixMode)
@@ -919,11 +1283,11 @@ void Gpu3D::mtxLoad43Cmd(std::vector<uint32_t> *params)
     }
 }
 
-void Gpu3D::mtxMult44Cmd(std::vector<uint32_t> *params)
+void Gpu3D::mtxMult44Cmd()
 {
     // Store the paramaters to the temporary matrix
     for (int i = 0; i < 16; i++)
-        temp.data[i] = (int32_t)(*params)[i];
+        temp.data[i] = (int32_t)getParam(i);
 
     // Multiply a matrix by a 4x4 matrix
     switch (matrixMode)
@@ -958,12 +1322,12 @@ void Gpu3D::mtxMult44Cmd(std::vector<uint32_t> *params)
     }
 }
 
-void Gpu3D::mtxMult43Cmd(std::vector<uint32_t> *params)
+void Gpu3D::mtxMult43Cmd()
 {
     // Store the paramaters to the temporary matrix
     temp = Matrix();
     for (int i = 0; i < 12; i++)
-        temp.data[(i / 3) * 4 + i % 3] = (int32_t)(*params)[i];
+        temp.data[(i / 3) * 4 + i % 3] = (int32_t)getParam(i);
 
     // Multiply a matrix by a 4x3 matrix
     switch (matrixMode)
@@ -998,12 +1362,12 @@ void Gpu3D::mtxMult43Cmd(std::vector<uint32_t> *params)
     }
 }
 
-void Gpu3D::mtxMult33Cmd(std::vector<uint32_t> *params)
+void Gpu3D::mtxMult33Cmd()
 {
     // Store the paramaters to the temporary matrix
     temp = Matrix();
     for (int i = 0; i < 9; i++)
-        temp.data[(i / 3) * 4 + i % 3] = (int32_t)(*params)[i];
+        temp.data[(i / 3) * 4 + i % 3] = (int32_t)getParam(i);
 
     // Multiply a matrix by a 3x3 matrix
     switch (matrixMode)
@@ -1038,12 +1402,12 @@ void Gpu3D::mtxMult33Cmd(std::vector<uint32_t> *params)
     }
 }
 
-void Gpu3D::mtxScaleCmd(std::vector<uint32_t> *params)
+void Gpu3D::mtxScaleCmd()
 {
     // Store the paramaters to the temporary matrix
     temp = Matrix();
     for (int i = 0; i < 3; i++)
-        temp.data[i * 5] = (int32_t)(*params)[i];
+        temp.data[i * 5] = (int32_t)getParam(i);
 
     // Multiply a matrix by a scale matrix
     switch (matrixMode)
@@ -1070,12 +1434,12 @@ void Gpu3D::mtxScaleCmd(std::vector<uint32_t> *params)
     }
 }
 
-void Gpu3D::mtxTransCmd(std::vector<uint32_t> *params)
+void Gpu3D::mtxTransCmd()
 {
     // Store the paramaters to the temporary matrix
     temp = Matrix();
     for (int i = 0; i < 3; i++)
-        temp.data[12 + i] = (int32_t)(*params)[i];
+        temp.data[12 + i] = (int32_t)getParam(i);
 
     // Multiply a matrix by a translation matrix
     switch (matrixMode)
@@ -1222,12 +1586,12 @@ void Gpu3D::texCoordCmd(uint32_t param)
     }
 }
 
-void Gpu3D::vtx16Cmd(std::vector<uint32_t> *params)
+void Gpu3D::vtx16Cmd()
 {
     // Set the X, Y, and Z coordinates
-    savedVertex.x = (int16_t)((*params)[0] >>  0);
-    savedVertex.y = (int16_t)((*params)[0] >> 16);
-    savedVertex.z = (int16_t)((*params)[1]);
+    savedVertex.x = (int16_t)(getParam(0) >>  0);
+    savedVertex.y = (int16_t)(getParam(0) >> 16);
+    savedVertex.z = (int16_t)(getParam(1));
 
     addVertex();
 }
@@ -1352,15 +1716,15 @@ void Gpu3D::lightColorCmd(uint32_t param)
     lightColor[param >> 30] = rgb5ToRgb6(param);
 }
 
-void Gpu3D::shininessCmd(std::vector<uint32_t> *params)
+void Gpu3D::shininessCmd()
 {
     // Set the values of the specular reflection shininess table
     for (int i = 0; i < 32; i++)
     {
-        shininess[i * 4 + 0] = (*params)[i] >>  0;
-        shininess[i * 4 + 1] = (*params)[i] >>  8;
-        shininess[i * 4 + 2] = (*params)[i] >> 16;
-        shininess[i * 4 + 3] = (*params)[i] >> 24;
+        shininess[i * 4 + 0] = getParam(i) >>  0;
+        shininess[i * 4 + 1] = getParam(i) >>  8;
+        shininess[i * 4 + 2] = getParam(i) >> 16;
+        shininess[i * 4 + 3] = getParam(i) >> 24;
     }
 }
 
@@ -1393,10 +1757,6 @@ void Gpu3D::swapBuffersCmd(uint32_t param)
 {
     // Set the W-buffering toggle
     savedPolygon.wBuffer = param & BIT(1);
-
-    // Halt the geometry engine
-    // The buffers will be swapped and the engine unhalted on next V-blank
-    state = GX_HALTED;
 }
 
 void Gpu3D::viewportCmd(uint32_t param)
@@ -1408,13 +1768,13 @@ void Gpu3D::viewportCmd(uint32_t param)
     viewportHeight = ((191 - ((param & 0x0000FF00) >>  8)) - viewportY + 1) &  0xFF;
 }
 
-void Gpu3D::boxTestCmd(std::vector<uint32_t> *params)
+void Gpu3D::boxTestCmd()
 {
     // Store the parameters (X-pos, Y-pos, Z-pos, width, height, depth)
     for (int i = 0; i < 3; i++)
     {
-        boxTestCoords[i * 2 + 0] = (*params)[i] >>  0;
-        boxTestCoords[i * 2 + 1] = (*params)[i] >> 16;
+        boxTestCoords[i * 2 + 0] = getParam(i) >>  0;
+        boxTestCoords[i * 2 + 1] = getParam(i) >> 16;
     }
 
     // Get the vertices of the box
@@ -1479,21 +1839,21 @@ void Gpu3D::boxTestCmd(std::vector<uint32_t> *params)
 
         if (size > 0)
         {
-            gxStat |= BIT(1);
+            geometryStat |= BIT(1);
             return;
         }
     }
 
     // Clear the result bit if none of the faces were in view
-    gxStat &= ~BIT(1);
+    geometryStat &= ~BIT(1);
 }
 
-void Gpu3D::posTestCmd(std::vector<uint32_t> *params)
+void Gpu3D::posTestCmd()
 {
     // Set the X, Y, and Z coordinates, overwriting the saved vertex
-    savedVertex.x = (int16_t)((*params)[0] >>  0);
-    savedVertex.y = (int16_t)((*params)[0] >> 16);
-    savedVertex.z = (int16_t)((*params)[1]);
+    savedVertex.x = (int16_t)(getParam(0) >>  0);
+    savedVertex.y = (int16_t)(getParam(0) >> 16);
+    savedVertex.z = (int16_t)(getParam(1));
     savedVertex.w = 1 << 12;
 
     // Update the clip matrix if necessary
@@ -1529,10 +1889,13 @@ void Gpu3D::vecTestCmd(uint32_t param)
 
 void Gpu3D::addEntry(Entry entry)
 {
-    if (fifo.size() - pipeSize == 0 && pipeSize < 4)
+    // Catch up on commands before the FIFO changes
+    runCommands();
+
+    if (fifoSize - pipeSize == 0 && pipeSize < 4)
     {
         // Move data directly into the pipe if the FIFO is empty and the pipe isn't full
-        fifo.push(entry);
+        fifo[(fifoHead + fifoSize++) & 0x1FF] = entry;
         pipeSize++;
 
         // Update the FIFO status
@@ -1541,26 +1904,35 @@ void Gpu3D::addEntry(Entry entry)
     else
     {
         // If the FIFO is full, halt the CPU until space is free
-        if (fifo.size() - pipeSize >= 256)
+        // The current batch has to end at the next command then, since that will unhalt it
+        bool full = (fifoSize - pipeSize >= 256);
+        if (full)
             core->interpreter[0].halt(1);
 
         // Move data into the FIFO
-        fifo.push(entry);
+        fifo[(fifoHead + fifoSize++) & 0x1FF] = entry;
+
+        if (full && state == GX_RUNNING)
+        {
+            core->cancel(&runCommandTask);
+            scheduleBatch();
+        }
 
         // Update the FIFO status
-        gxStat = (gxStat & ~0x01FF0000) | ((fifo.size() - pipeSize) << 16); // FIFO entries
+        gxStat = (gxStat & ~0x01FF0000) | ((fifoSize - pipeSize) << 16); // FIFO entries
         gxStat &= ~BIT(26); // FIFO not empty
 
         // If the FIFO is half full or more, disable GXFIFO DMA transfers
-        if (fifo.size() - pipeSize >= 128 && (gxStat & BIT(25)))
+        if (fifoSize - pipeSize >= 128 && (gxStat & BIT(25)))
             gxStat &= ~BIT(25);
     }
 
     // Start executing commands if one is ready
-    if (state == GX_IDLE && fifo.size() >= paramCounts[fifo.front().command])
+    if (state == GX_IDLE && fifoSize >= paramCounts[fifo[fifoHead].command])
     {
-        core->schedule(Task(&runCommandTask, 2));
+        cmdCycles = core->getGlobalCycles() + 2;
         state = GX_RUNNING;
+        scheduleBatch();
     }
 }
 
@@ -1595,6 +1967,38 @@ void Gpu3D::writeGxFifo(uint32_t mask, uint32_t value)
     }
 }
 
+void Gpu3D::writeGxFifo(const uint8_t *data, int count)
+{
+    // Write a span of words to the GXFIFO register, as fed directly by a GXFIFO DMA
+    for (int i = 0; i < count; i++)
+    {
+        uint32_t value = U8TO32(data, i * 4);
+
+        if (gxFifo == 0)
+        {
+            // Read new packed commands
+            gxFifo = value;
+        }
+        else
+        {
+            // Add a command parameter, and move to the next command once all parameters have been sent
+            addEntry(Entry(gxFifo, value));
+            if (++gxFifoCount == paramCounts[gxFifo & 0xFF])
+            {
+                gxFifo >>= 8;
+                gxFifoCount = 0;
+            }
+        }
+
+        // Add entries for commands with no parameters
+        while (gxFifo != 0 && paramCounts[gxFifo & 0xFF] == 0)
+        {
+            addEntry(Entry(gxFifo, 0));
+            gxFifo >>= 8;
+        }
+    }
+}
+
 void Gpu3D::writeMtxMode(uint32_t mask, uint32_t value)
 {
     // Add an entry to the FIFO
@@ -1856,27 +2260,51 @@ void Gpu3D::writeVecTest(uint32_t mask, uint32_t value)
 
 void Gpu3D::writeGxStat(uint32_t mask, uint32_t value)
 {
+    // Catch up on commands before anything changes
+    syncThread();
+
     // Clear the error bit and reset the projection stack pointer
     if (value & BIT(15))
     {
-        gxStat &= ~0x0000A000;
+        geometryStat &= ~0x0000A000;
         projectionPtr = 0;
     }
 
     // Write to the GXSTAT register
     mask &= 0xC0000000;
+    uint32_t old = gxStat;
     gxStat = (gxStat & ~mask) | (value & mask);
+
+    // End the current batch sooner if a change to the IRQ mode makes an earlier command send one
+    if (gxStat != old && state == GX_RUNNING)
+    {
+        core->cancel(&runCommandTask);
+        scheduleBatch();
+    }
+}
+
+uint32_t Gpu3D::readGxStat()
+{
+    // Read from the GXSTAT register, after catching up on commands
+    // While commands are running, the FIFO count and busy bit change without a task to wake the ARM9,
+    // so a loop polling them shouldn't be treated as idle
+    syncThread();
+    if (state == GX_RUNNING)
+        core->interpreter[0].wakeIdle();
+    return gxStat | geometryStat;
 }
 
 uint32_t Gpu3D::readRamCount()
 {
-    // Read from the RAM_COUNT register
+    // Read from the RAM_COUNT register, after catching up on commands
+    syncThread();
     return (vertexCountIn << 16) | polygonCountIn;
 }
 
 uint32_t Gpu3D::readClipMtxResult(int index)
 {
-    // Update the clip matrix if necessary
+    // Catch up on commands, and update the clip matrix if necessary
+    syncThread();
     if (clipDirty)
     {
         clip = multiply(&coordinate, &projection);
@@ -1889,6 +2317,7 @@ uint32_t Gpu3D::readClipMtxResult(int index)
 
 uint32_t Gpu3D::readVecMtxResult(int index)
 {
-    // Read from one of the VECMTX_RESULT registers
+    // Read from one of the VECMTX_RESULT registers, after catching up on commands
+    syncThread();
     return direction.data[(index / 3) * 4 + index % 3];
 }
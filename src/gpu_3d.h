@@ -20,14 +20,18 @@
 #ifndef GPU_3D_H
 #define GPU_3D_H
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
-#include <queue>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "defines.h"
 
 class Core;
+class Savestate;
 
 enum GXState
 {
@@ -38,7 +42,7 @@ enum GXState
 
 struct Entry
 {
-    Entry(uint8_t command, uint32_t param): command(command), param(param) {}
+    Entry(uint8_t command = 0, uint32_t param = 0): command(command), param(param) {}
 
     uint8_t command;
     uint32_t param;
@@ -92,22 +96,30 @@ class Gpu3D
 {
     public:
         Gpu3D(Core *core);
+        ~Gpu3D();
 
+        void syncState(Savestate *state);
+        void resetCycles();
+
+        void runCommands();
         void swapBuffers();
+        void syncThread();
 
-        bool shouldSwap() { return state == GX_HALTED; }
+        bool shouldSwap()      { runCommands(); return state == GX_HALTED; }
+        bool isFifoHalfEmpty() { runCommands(); return gxStat & BIT(25);   }
 
         _Polygon *getPolygons()     { return polygonsOut;     }
         int       getPolygonCount() { return polygonCountOut; }
 
-        uint32_t readGxStat()             { return gxStat;           }
-        uint32_t readPosResult(int index) { return posResult[index]; }
-        uint32_t readVecResult(int index) { return vecResult[index]; }
+        uint32_t readGxStat();
+        uint32_t readPosResult(int index) { syncThread(); return posResult[index];      }
+        uint32_t readVecResult(int index) { syncThread(); return vecResult[index];      }
         uint32_t readRamCount();
         uint32_t readClipMtxResult(int index);
         uint32_t readVecMtxResult(int index);
 
         void writeGxFifo(uint32_t mask, uint32_t value);
+        void writeGxFifo(const uint8_t *data, int count);
         void writeMtxMode(uint32_t mask, uint32_t value);
         void writeMtxPush(uint32_t mask, uint32_t value);
         void writeMtxPop(uint32_t mask, uint32_t value);
@@ -150,13 +162,38 @@ class Gpu3D
     private:
         Core *core;
 
+        // Commands run lazily in batches, instead of each being scheduled 2 cycles after the last
+        // When anything accesses the geometry engine, it first catches up on the commands that are due
+        // Batches are scheduled to end at commands with effects that don't wait for an access, like DMA or IRQ triggers
         GXState state = GX_IDLE;
-
-        std::queue<Entry> fifo;
+        uint32_t cmdCycles = 0;
+
+        // The FIFO and the pipe share a ring buffer, with the pipe entries at the front
+        // Hardware holds 256 FIFO entries and 4 pipe entries, but the CPU only halts after the write that fills it
+        // The buffer is sized with room to spare for entries that arrive before the halt takes effect
+        Entry fifo[512];
+        int fifoHead = 0;
+        int fifoSize = 0;
         int pipeSize = 0;
 
         int paramCounts[0x100] = {};
 
+        // Commands can be executed on a separate geometry thread, with the FIFO and its events still handled here
+        // Each batch of commands is copied to a queue and published at the end, and only accesses to results wait for it
+        // Commands read their parameters in place from whichever ring they're executed from
+        bool running = false;
+        std::thread *thread = nullptr;
+        std::mutex queueMutex;
+        std::condition_variable queueCond;
+        Entry queue[0x1000];
+        uint32_t queueHead = 0;
+        std::atomic<uint32_t> queueHeadShared;
+        std::atomic<uint32_t> queueTail;
+
+        Entry *paramRing = fifo;
+        int paramHead = 0;
+        int paramMask = 0x1FF;
+
         int matrixMode = 0;
         int projectionPtr = 0, coordinatePtr = 0;
         bool clipDirty = false;
@@ -203,6 +240,7 @@ class Gpu3D
 
         uint32_t gxFifo = 0x00000000;
         uint32_t gxStat = 0x04000000;
+        uint32_t geometryStat = 0x00000000;
         int32_t posResult[4] = {};
         int16_t vecResult[3] = {};
 
@@ -212,6 +250,7 @@ class Gpu3D
 
         static uint32_t rgb5ToRgb6(uint16_t color);
 
+        static void multiplyRow(const int32_t *row, const int32_t *mtx, int32_t *result);
         static Matrix multiply(Matrix *mtx1, Matrix *mtx2);
         static Vertex multiply(Vertex *vtx, Matrix *mtx);
         static int32_t multiply(Vertex *vec1, Vertex *vec2);
@@ -219,7 +258,15 @@ class Gpu3D
         static Vertex intersection(Vertex *vtx1, Vertex *vtx2, int32_t val1, int32_t val2);
         static bool clipPolygon(Vertex *unclipped, Vertex *clipped, int *size);
 
+        void runBatch();
+        void scheduleBatch();
         void runCommand();
+        void executeCommand();
+
+        void startThread();
+        void stopThread();
+        void publishCommands();
+        void runThreaded(bool pin);
 
         void addVertex();
         void addPolygon();
@@ -230,17 +277,17 @@ class Gpu3D
         void mtxStoreCmd(uint32_t param);
         void mtxRestoreCmd(uint32_t param);
         void mtxIdentityCmd();
-        void mtxLoad44Cmd(std::vector<uint32_t> *params);
-        void mtxLoad43Cmd(std::vector<uint32_t> *params);
-        void mtxMult44Cmd(std::vector<uint32_t> *params);
-        void mtxMult43Cmd(std::vector<uint32_t> *params);
-        void mtxMult33Cmd(std::vector<uint32_t> *params);
-        void mtxScaleCmd(std::vector<uint32_t> *params);
-        void mtxTransCmd(std::vector<uint32_t> *params);
+        void mtxLoad44Cmd();
+        void mtxLoad43Cmd();
+        void mtxMult44Cmd();
+        void mtxMult43Cmd();
+        void mtxMult33Cmd();
+        void mtxScaleCmd();
+        void mtxTransCmd();
         void colorCmd(uint32_t param);
         void normalCmd(uint32_t param);
         void texCoordCmd(uint32_t param);
-        void vtx16Cmd(std::vector<uint32_t> *params);
+        void vtx16Cmd();
         void vtx10Cmd(uint32_t param);
         void vtxXYCmd(uint32_t param);
         void vtxXZCmd(uint32_t param);
@@ -253,15 +300,17 @@ class Gpu3D
         void speEmiCmd(uint32_t param);
         void lightVectorCmd(uint32_t param);
         void lightColorCmd(uint32_t param);
-        void shininessCmd(std::vector<uint32_t> *params);
+        void shininessCmd();
         void beginVtxsCmd(uint32_t param);
         void swapBuffersCmd(uint32_t param);
         void viewportCmd(uint32_t param);
-        void boxTestCmd(std::vector<uint32_t> *params);
-        void posTestCmd(std::vector<uint32_t> *params);
+        void boxTestCmd();
+        void posTestCmd();
         void vecTestCmd(uint32_t param);
 
+        uint32_t getParam(int index) { return paramRing[(paramHead + index) & paramMask].param; }
         void addEntry(Entry entry);
+        void syncPolygon(Savestate *state, _Polygon *polygon);
 };
 
 #endif // GPU_3D_H
@@ -17,12 +17,19 @@
     along with NooDS. If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <cstring>
 #include <vector>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #include "gpu_3d_renderer.h"
 #include "core.h"
-#include "settings.h"
+#include "gpu_3d_renderer_gl.h"
 
 Gpu3DRenderer::Gpu3DRenderer(Core *core): core(core)
 {
@@ -35,14 +42,39 @@ Gpu3DRenderer::Gpu3DRenderer(Core *core): core(core)
 Gpu3DRenderer::~Gpu3DRenderer()
 {
     // Clean up the threads
-    for (int i = 0; i < activeThreads; i++)
-    {
-        if (threads[i]) 
-        {
-            threads[i]->join();
-            delete threads[i];
-        }
-    }
+    stopThreads();
+
+    // Free the buffers
+    delete[] framebuffer;
+    delete[] depthBuffer;
+    delete[] attribBuffer;
+    delete[] stencilBuffer;
+
+#ifdef OPENGL_3D
+    // Clean up the hardware renderer
+    delete hardware;
+#endif
+}
+
+void Gpu3DRenderer::syncState(Savestate *state)
+{
+    // Let the threads finish drawing before the registers they read change
+    waitThreads();
+
+    // Sync the registers
+    // The buffers are redrawn from the geometry, so they aren't part of the state
+    state->sync(disp3DCnt);
+    state->sync(edgeColor);
+    state->sync(clearColor);
+    state->sync(clearDepth);
+    state->sync(fogColor);
+    state->sync(fogOffset);
+    state->sync(fogTable);
+    state->sync(toonTable);
+
+    // Decode textures again after loading, since texture memory is replaced
+    if (state->isLoading())
+        invalidateTextures();
 }
 
 uint32_t Gpu3DRenderer::rgba5ToRgba6(uint32_t color)
@@ -55,17 +87,113 @@ uint32_t Gpu3DRenderer::rgba5ToRgba6(uint32_t color)
     return (a << 18) | (b << 12) | (g << 6) | r;
 }
 
+void Gpu3DRenderer::allocateBuffers()
+{
+    // Allocate the buffers the first time they're needed
+    // This can happen on the core thread or the 2D thread, so it's only done once either way
+    std::call_once(buffersFlag, [this]
+    {
+        framebuffer = new uint32_t[2][256 * 192]();
+        depthBuffer = new uint32_t[2][256 * 192]();
+        attribBuffer = new uint32_t[2][256 * 192]();
+        stencilBuffer = new uint8_t[256 * 192]();
+    });
+}
+
+size_t Gpu3DRenderer::getFootprint()
+{
+    // Report the heap memory used by the renderer, which isn't part of the core's size
+    size_t size = highRes.capacity() * sizeof(uint32_t) + cacheSize;
+    if (framebuffer)
+        size += (3 * 2 * 256 * 192) * sizeof(uint32_t) + 256 * 192;
+    return size;
+}
+
 uint32_t *Gpu3DRenderer::getLine(int line)
 {
+    allocateBuffers();
+
     // Wait until a scanline is ready, and then return it
-    while (ready[line].load() < 2) std::this_thread::yield();
+    if (ready[line].load() < 2)
+    {
+        TelemetryWait wait(&core->telemetry, true);
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCond.wait(lock, [&] { return ready[line].load() == 2; });
+    }
+
     return &framebuffer[0][256 * line];
 }
 
 void Gpu3DRenderer::drawScanline(int line)
 {
+    ProfileScope scope(&core->profiler, PROFILE_3D);
+    allocateBuffers();
+
+#ifdef OPENGL_3D
+    if (core->config.hardware3D && !hardwareFailed)
+    {
+        // Draw the whole frame with the hardware renderer at the start of the frame
+        if (line > 0) return;
+
+        // Clean up any existing software threads
+        stopThreads();
+
+        // Create the hardware renderer if it doesn't exist yet
+        // If it can't be set up, fall back to the software renderer and don't try again
+        if (!hardware)
+        {
+            hardware = new Gpu3DRendererGl(core);
+            if (!hardware->isValid())
+            {
+                printf("Failed to set up the hardware 3D renderer; falling back to software\n");
+                hardwareFailed = true;
+            }
+        }
+
+        if (hardware->isValid())
+        {
+            // Draw the frame, at a higher resolution if requested
+            decodeTextures();
+            highResScale = std::min(std::max(core->config.scale3D, 1), 4);
+            highRes.resize(256 * 192 * highResScale * highResScale);
+            hardware->drawFrame(framebuffer[0], depthBuffer[0], attribBuffer[0], highResScale, &highRes[0]);
+
+            // Apply edge marking and fog on the CPU
+            if (highResScale > 1 && (disp3DCnt & (BIT(5) | BIT(7))))
+            {
+                // Keep the unmodified frame, so the changed pixels can be found afterwards
+                std::vector<uint32_t> original(framebuffer[0], framebuffer[0] + 256 * 192);
+                for (int i = 0; i < 192; i++)
+                    finishScanline(i);
+
+                // Copy changed pixels to the high resolution frame, so edges and fog still show up at a lower resolution
+                for (int i = 0; i < 256 * 192; i++)
+                {
+                    if (framebuffer[0][i] == original[i]) continue;
+                    for (int y = 0; y < highResScale; y++)
+                        for (int x = 0; x < highResScale; x++)
+                            highRes[((i / 256) * highResScale + y) * 256 * highResScale + (i % 256) * highResScale + x] = framebuffer[0][i];
+                }
+            }
+            else
+            {
+                for (int i = 0; i < 192; i++)
+                    finishScanline(i);
+            }
+
+            return;
+        }
+    }
+#endif
+
+    // The software renderer only draws at the native resolution
+    highResScale = 1;
+
     if (line == 0)
     {
+        // Let the threads finish the previous frame before anything changes
+        waitThreads();
+
         // Calculate the scanline bounds for each polygon
         for (int i = 0; i < core->gpu3D.getPolygonCount(); i++)
         {
@@ -84,35 +212,62 @@ void Gpu3DRenderer::drawScanline(int line)
             if (polygonTop[i] == polygonBot[i]) polygonBot[i]++;
         }
 
-        // Clean up any existing threads
-        for (int i = 0; i < activeThreads; i++)
+        // Sort the polygons into bands of scanlines, so each scanline only visits the polygons near it
+        // Solid and translucent polygons are kept apart, since the translucent ones are drawn last
+        for (int i = 0; i < BAND_COUNT; i++)
         {
-            if (threads[i]) 
-            {
-                threads[i]->join();
-                delete threads[i];
-            }
+            bandPolygons[i][0].clear();
+            bandPolygons[i][1].clear();
         }
+        for (int i = 0; i < core->gpu3D.getPolygonCount(); i++)
+        {
+            int top = std::max(polygonTop[i], 0);
+            int bot = std::min(polygonBot[i], 192);
+            if (top >= bot) continue;
 
-        // Update the thread count
-        activeThreads = Settings::getThreaded3D();
-        if (activeThreads > 3) activeThreads = 3;
+            _Polygon *polygon = &core->gpu3D.getPolygons()[i];
+            bool translucent = (polygon->alpha < 0x3F || polygon->textureFmt == 1 || polygon->textureFmt == 6);
+            for (int j = top / BAND_HEIGHT; j <= (bot - 1) / BAND_HEIGHT; j++)
+                bandPolygons[j][translucent].push_back(i);
+        }
+
+        // Decode any new textures before drawing starts
+        decodeTextures();
+
+        // Restart the threads if the thread count changed
+        int count = std::min(std::max(core->config.threaded3D, 0), 16);
+        if (count != (int)threads.size())
+        {
+            stopThreads();
+            running = true;
+            for (int i = 0; i < count; i++)
+                threads.push_back(new std::thread(&Gpu3DRenderer::drawThreaded, this, core->config.pinThreads));
+        }
 
-        // Set up threaded 3D rendering if enabled
-        if (activeThreads > 0)
+        // Start drawing the frame on the threads if enabled
+        if (!threads.empty())
         {
-            // Mark the scanlines as not ready
+            // Mark the scanlines and bands as not ready
             for (int i = 0; i < 192; i++)
                 ready[i].store(0);
+            for (int i = 0; i < BAND_COUNT; i++)
+            {
+                bandDrawn[i].store(false);
+                bandFinished[i].store(false);
+            }
 
-            // Create threads to draw the scanlines
-            for (int i = 0; i < activeThreads; i++)
-                threads[i] = new std::thread(&Gpu3DRenderer::drawThreaded, this, i);
+            // Wake the threads
+            // The band counter is reset under the lock so a thread that slept through a frame can't take bands early
+            std::lock_guard<std::mutex> guard(mutex);
+            nextBand.store(0);
+            bandsDone = 0;
+            frameCount++;
+            workCond.notify_all();
         }
     }
 
     // Draw one scanline at a time if threading is disabled
-    if (activeThreads == 0)
+    if (threads.empty())
     {
         drawScanline1(line);
         if (line > 0) finishScanline(line - 1);
@@ -120,39 +275,97 @@ void Gpu3DRenderer::drawScanline(int line)
     }
 }
 
-void Gpu3DRenderer::drawThreaded(int thread)
+void Gpu3DRenderer::waitThreads()
 {
-    // Draw the 3D scanlines in a threaded sequence
-    // The amount of scanlines skipped per thread depends on the number of active threads
-    // Together, they render the entire 3D image
-    int i;
-    for (i = thread; i < 192; i += activeThreads)
+    // Wait until every band of the current frame is finished and the threads are idle
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCond.wait(lock, [&] { return bandsDone == BAND_COUNT && busyThreads == 0; });
+}
+
+void Gpu3DRenderer::stopThreads()
+{
+    if (threads.empty()) return;
+
+    // Let the threads finish what they're drawing, and then signal them to stop
+    waitThreads();
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        running = false;
+        workCond.notify_all();
+    }
+
+    // Clean up the threads
+    for (unsigned int i = 0; i < threads.size(); i++)
+    {
+        threads[i]->join();
+        delete threads[i];
+    }
+    threads.clear();
+}
+
+void Gpu3DRenderer::drawThreaded(bool pin)
+{
+    if (pin) ThreadPlacement::place(THREAD_WORKER);
+    int frame = 0;
+
+    while (true)
     {
-        // Draw a scanline, save for the final pass
-        drawScanline1(i);
-        ready[i].store(1);
+        // Sleep until a new frame is started or the threads are stopped
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workCond.wait(lock, [&] { return !running || frameCount != frame; });
+            if (!running) return;
+            frame = frameCount;
+            busyThreads++;
+        }
 
-        if (i < activeThreads) continue;
-        int prev = i - activeThreads;
+        // Take bands of scanlines until there are none left, so threads that finish early pick up more of the work
+        // This keeps every thread busy even when the polygons are clustered in one part of the screen
+        int band;
+        while ((band = nextBand.fetch_add(1)) < BAND_COUNT)
+        {
+            // Draw the scanlines of the band, save for the final pass
+            for (int i = band * BAND_HEIGHT; i < (band + 1) * BAND_HEIGHT; i++)
+            {
+                drawScanline1(i);
+                ready[i].store(1);
+            }
+            bandDrawn[band].store(true);
 
-        // Wait for the scanlines surrounding this thread's previous scanline to be drawn
-        while ((prev > 0 && ready[prev - 1].load() < 1) || ready[prev + 1].load() < 1)
-            std::this_thread::yield();
+            // Finish this band and its neighbours, if they're no longer waiting on anything
+            for (int i = std::max(band - 1, 0); i <= std::min(band + 1, BAND_COUNT - 1); i++)
+                finishBand(i);
+        }
 
-        // Finish this thread's previous scanline
-        finishScanline(prev);
-        ready[prev].store(2);
+        // Signal that this thread is idle
+        std::lock_guard<std::mutex> guard(mutex);
+        busyThreads--;
+        doneCond.notify_all();
     }
+}
+
+void Gpu3DRenderer::finishBand(int band)
+{
+    // The final pass looks at the scanlines above and below, so a band needs its neighbours drawn first
+    if ((band > 0 && !bandDrawn[band - 1].load()) || !bandDrawn[band].load() ||
+        (band < BAND_COUNT - 1 && !bandDrawn[band + 1].load()))
+        return;
 
-    int prev = i - activeThreads;
+    // Make sure only one thread finishes each band
+    if (bandFinished[band].exchange(true))
+        return;
 
-    // Wait for the scanlines surrounding this thread's final scanline to be drawn
-    while (ready[prev - 1].load() < 1 || (prev < 191 && ready[prev + 1].load() < 1))
-        std::this_thread::yield();
+    // Finish the scanlines of the band
+    for (int i = band * BAND_HEIGHT; i < (band + 1) * BAND_HEIGHT; i++)
+    {
+        finishScanline(i);
+        ready[i].store(2);
+    }
 
-    // Finish this thread's final scanline
-    finishScanline(prev);
-    ready[prev].store(2);
+    // Wake anything waiting for the scanlines
+    std::lock_guard<std::mutex> guard(mutex);
+    bandsDone++;
+    doneCond.notify_all();
 }
 
 void Gpu3DRenderer::drawScanline1(int line)
@@ -174,26 +387,18 @@ void Gpu3DRenderer::drawScanline1(int line)
 
     stencilClear[line] = false;
 
-    std::vector<int> translucent;
-
-    // Draw the polygons
-    for (int i = 0; i < core->gpu3D.getPolygonCount(); i++)
+    // Draw the solid polygons in the scanline's band, followed by the translucent ones
+    std::vector<int> *polygons = bandPolygons[line / BAND_HEIGHT];
+    for (int i = 0; i < 2; i++)
     {
-        // Skip polygons that aren't on the current scanline
-        if (line < polygonTop[i] || line >= polygonBot[i])
-            continue;
-
-        // Draw solid polygons and save the translucent ones for later
-        _Polygon *polygon = &core->gpu3D.getPolygons()[i];
-        if (polygon->alpha < 0x3F || polygon->textureFmt == 1 || polygon->textureFmt == 6)
-            translucent.push_back(i);
-        else
-            drawPolygon(line, i);
+        for (unsigned int j = 0; j < polygons[i].size(); j++)
+        {
+            // Skip polygons that aren't on the current scanline
+            int index = polygons[i][j];
+            if (line >= polygonTop[index] && line < polygonBot[index])
+                drawPolygon(line, index);
+        }
     }
-
-    // Draw the translucent polygons
-    for (unsigned int i = 0; i < translucent.size(); i++)
-        drawPolygon(line, translucent[i]);
 }
 
 void Gpu3DRenderer::finishScanline(int line)
@@ -396,19 +601,89 @@ uint32_t Gpu3DRenderer::interpolateColor(uint32_t c1, uint32_t c2, uint32_t x1,
     return (a << 18) | (b << 12) | (g << 6) | r;
 }
 
-uint32_t Gpu3DRenderer::readTexture(_Polygon *polygon, int s, int t)
+TARGET_CLONES void Gpu3DRenderer::interpolateFactors(uint32_t *factors, uint32_t x1, uint32_t x2, uint32_t w1, uint32_t w2)
+{
+    // Calculate the perspective-correct interpolation factors for every pixel of a span, as done in interpolateFill
+    // The factor is the same for every value interpolated at a pixel, so this replaces a divide per value per pixel
+    uint32_t end = std::min<uint32_t>(x2, 256);
+    uint32_t x = x1 + 1;
+
+    // The first pixel always gets the first value, and could otherwise divide by zero
+    if (x1 < end) factors[x1] = 0;
+
+    // Divide several pixels at a time with double precision when the W values are 16-bit
+    // The numerator and denominator are exact integers well within the precision of a double, so the truncated quotient
+    // always matches integer division; wider W values would overflow the integer formula, so they're left to the scalar loop
+    if (w1 <= 0xFFFF && w2 <= 0xFFFF)
+    {
+#if defined(__x86_64__) || defined(_M_X64)
+        // Divide 4 pixels at a time with SSE2
+        __m128d vw1 = _mm_set1_pd(w1), vw2 = _mm_set1_pd(w2);
+        __m128d vx1 = _mm_set1_pd(x1), vx2 = _mm_set1_pd(x2);
+        for (; x + 4 <= end; x += 4)
+        {
+            __m128d vxa = _mm_setr_pd(x + 0, x + 1), vxb = _mm_setr_pd(x + 2, x + 3);
+            __m128d lefta = _mm_mul_pd(vw1, _mm_sub_pd(vxa, vx1)), leftb = _mm_mul_pd(vw1, _mm_sub_pd(vxb, vx1));
+            __m128d righta = _mm_mul_pd(vw2, _mm_sub_pd(vx2, vxa)), rightb = _mm_mul_pd(vw2, _mm_sub_pd(vx2, vxb));
+            __m128d fa = _mm_div_pd(_mm_mul_pd(lefta, _mm_set1_pd(256.0)), _mm_add_pd(lefta, righta));
+            __m128d fb = _mm_div_pd(_mm_mul_pd(leftb, _mm_set1_pd(256.0)), _mm_add_pd(leftb, rightb));
+            _mm_storeu_si128((__m128i*)&factors[x], _mm_unpacklo_epi64(_mm_cvttpd_epi32(fa), _mm_cvttpd_epi32(fb)));
+        }
+#elif defined(__aarch64__)
+        // Divide 4 pixels at a time with NEON
+        float64x2_t vw1 = vdupq_n_f64(w1), vw2 = vdupq_n_f64(w2);
+        float64x2_t vx1 = vdupq_n_f64(x1), vx2 = vdupq_n_f64(x2);
+        const double offsets[4] = { 0.0, 1.0, 2.0, 3.0 };
+        for (; x + 4 <= end; x += 4)
+        {
+            float64x2_t vxa = vaddq_f64(vdupq_n_f64(x), vld1q_f64(&offsets[0]));
+            float64x2_t vxb = vaddq_f64(vdupq_n_f64(x), vld1q_f64(&offsets[2]));
+            float64x2_t lefta = vmulq_f64(vw1, vsubq_f64(vxa, vx1)), leftb = vmulq_f64(vw1, vsubq_f64(vxb, vx1));
+            float64x2_t righta = vmulq_f64(vw2, vsubq_f64(vx2, vxa)), rightb = vmulq_f64(vw2, vsubq_f64(vx2, vxb));
+            float64x2_t fa = vdivq_f64(vmulq_n_f64(lefta, 256.0), vaddq_f64(lefta, righta));
+            float64x2_t fb = vdivq_f64(vmulq_n_f64(leftb, 256.0), vaddq_f64(leftb, rightb));
+            vst1q_u32(&factors[x], vcombine_u32(vmovn_u64(vcvtq_u64_f64(fa)), vmovn_u64(vcvtq_u64_f64(fb))));
+        }
+#endif
+    }
+
+    // Calculate the remaining factors one at a time
+    for (; x < end; x++)
+        factors[x] = ((w1 * (x - x1)) << 8) / (w2 * (x2 - x) + w1 * (x - x1));
+
+#ifdef SPAN_CHECK
+    // Compare against the scalar path when checking is enabled
+    // Interpolating from 0 to 0x100 gives the factor itself
+    for (x = x1; x < end; x++)
+    {
+        uint32_t scalar = interpolateFill(0, 0x100, x1, x, x2, w1, w2);
+        if (factors[x] != scalar)
+            fprintf(stderr, "Span factor mismatch at X %d: %d != %d (W %d, %d)\n", x, factors[x], scalar, w1, w2);
+    }
+#endif
+}
+
+uint32_t Gpu3DRenderer::interpolateSpan(uint32_t v1, uint32_t v2, uint32_t x1, uint32_t x, uint32_t x2, uint32_t *factors)
+{
+    // Fall back to linear interpolation if the span has no factors
+    if (!factors)
+        return interpolateLinear(v1, v2, x1, x, x2);
+
+    // Interpolate a new value between the min and max values using the factor of the pixel, as done in interpolateFill
+    if (v1 <= v2)
+        return v1 + (((v2 - v1) * factors[x]) >> 8);
+    else
+        return v2 + (((v1 - v2) * ((1 << 8) - factors[x])) >> 8);
+}
+
+uint32_t Gpu3DRenderer::readTexture(_Polygon *polygon, uint32_t *texels, int s, int t)
 {
     // Handle S-coordinate overflows
+    // Texture sizes are powers of 2, so the bit above the coordinate mask is set on every second repeat
     if (polygon->repeatS)
     {
-        // Wrap the S-coordinate
-        int count = 0;
-        while (s < 0)               { s += polygon->sizeS; count++; }
-        while (s >= polygon->sizeS) { s -= polygon->sizeS; count++; }
-
-        // Flip the S-coordinate every second repeat
-        if (polygon->flipS && count % 2 != 0)
-            s = polygon->sizeS - 1 - s;
+        // Wrap the S-coordinate, flipping it every second repeat
+        s = ((polygon->flipS && (s & polygon->sizeS)) ? ~s : s) & (polygon->sizeS - 1);
     }
     else if (s < 0)
     {
@@ -424,14 +699,8 @@ uint32_t Gpu3DRenderer::readTexture(_Polygon *polygon, int s, int t)
     // Handle T-coordinate overflows
     if (polygon->repeatT)
     {
-        // Wrap the T-coordinate
-        int count = 0;
-        while (t < 0)               { t += polygon->sizeT; count++; }
-        while (t >= polygon->sizeT) { t -= polygon->sizeT; count++; }
-
-        // Flip the T-coordinate every second repeat
-        if (polygon->flipT && count % 2 != 0)
-            t = polygon->sizeT - 1 - t;
+        // Wrap the T-coordinate, flipping it every second repeat
+        t = ((polygon->flipT && (t & polygon->sizeT)) ? ~t : t) & (polygon->sizeT - 1);
     }
     else if (t < 0)
     {
@@ -444,6 +713,117 @@ uint32_t Gpu3DRenderer::readTexture(_Polygon *polygon, int s, int t)
         t = polygon->sizeT - 1;
     }
 
+    // Read a texel from the decoded texture
+    return texels[t * polygon->sizeS + s];
+}
+
+void Gpu3DRenderer::decodeTextures()
+{
+    // Clear the texture cache if it was invalidated, or if it's grown too large
+    // Cached textures are only changed here, at the start of a frame, so other threads never see them change
+    if (texturesDirty || cacheSize > 0x1000000)
+    {
+        textureCache.clear();
+        cacheSize = 0;
+        texturesDirty = false;
+        textureGeneration++;
+    }
+
+    // Take a VRAM generation for this frame, so textures decoded now can tell if their data is written later
+    uint32_t generation = core->memory.nextVramGeneration();
+    bool redecoded = false;
+
+    for (int i = 0; i < core->gpu3D.getPolygonCount(); i++)
+    {
+        _Polygon *polygon = &core->gpu3D.getPolygons()[i];
+        if (polygon->textureFmt == 0) continue;
+
+        // Identify a texture by everything that affects how it decodes
+        uint64_t key = (uint64_t)(polygon->textureAddr & 0x7FFFF) | ((uint64_t)(polygon->paletteAddr & 0x1FFFF) << 19) |
+            ((uint64_t)polygon->textureFmt << 36) | ((uint64_t)polygon->transparent0 << 39) |
+            ((uint64_t)polygon->sizeS << 40) | ((uint64_t)polygon->sizeT << 51);
+
+        // Decode the whole texture into RGBA6 texels the first time it's used
+        // After that, it's checked once per frame and decoded again if its slots or data changed
+        CachedTexture &texture = textureCache[key];
+        if (texture.texels.empty())
+        {
+            texture.texels.resize(polygon->sizeS * polygon->sizeT);
+            cacheSize += texture.texels.size() * sizeof(uint32_t);
+            decodeTexture(polygon, &texture, generation);
+        }
+        else if (texture.checked != generation && textureChanged(polygon, &texture))
+        {
+            decodeTexture(polygon, &texture, generation);
+            redecoded = true;
+        }
+
+        texture.checked = generation;
+        polygonTextures[i] = &texture.texels[0];
+    }
+
+    // Make the hardware renderer upload its textures again if any were decoded in place
+    if (redecoded)
+        textureGeneration++;
+}
+
+void Gpu3DRenderer::decodeTexture(_Polygon *polygon, CachedTexture *texture, uint32_t generation)
+{
+    // Decode a texture, remembering the slot mappings and generation it was decoded with
+    memcpy(texture->tex3D, core->memory.getTex3D(), sizeof(texture->tex3D));
+    memcpy(texture->pal3D, core->memory.getPal3D(), sizeof(texture->pal3D));
+    texture->generation = generation;
+
+    for (int t = 0; t < polygon->sizeT; t++)
+        for (int s = 0; s < polygon->sizeS; s++)
+            texture->texels[t * polygon->sizeS + s] = decodeTexel(polygon, s, t);
+}
+
+bool Gpu3DRenderer::textureChanged(_Polygon *polygon, CachedTexture *texture)
+{
+    // A texture is out of date if any of its slots were remapped since it was decoded
+    if (memcmp(texture->tex3D, core->memory.getTex3D(), sizeof(texture->tex3D)) ||
+        memcmp(texture->pal3D, core->memory.getPal3D(), sizeof(texture->pal3D)))
+        return true;
+
+    // Otherwise, check the data it was decoded from for writes since then
+    // VRAM can only be written while it's mapped somewhere else, so this catches blocks that were mapped out and back
+    // 4x4 compressed textures can use palettes anywhere in the 64KB after their base, and have extra data in slot 1
+    static const uint8_t bits[] = { 0, 8, 2, 4, 8, 2, 8, 16 };
+    static const uint32_t colors[] = { 0, 32, 4, 16, 256, 0x8002, 8, 0 };
+    uint32_t texels = polygon->sizeS * polygon->sizeT;
+    if (rangeChanged(polygon->textureAddr, texels * bits[polygon->textureFmt] / 8, false, texture->generation))
+        return true;
+
+    if (polygon->textureFmt == 5)
+    {
+        uint32_t address = 0x20000 + (polygon->textureAddr % 0x20000) / 2 + ((polygon->textureAddr / 0x20000 == 2) ? 0x10000 : 0);
+        if (rangeChanged(address, texels / 8, false, texture->generation))
+            return true;
+    }
+
+    return rangeChanged(polygon->paletteAddr, colors[polygon->textureFmt] * 2, true, texture->generation);
+}
+
+bool Gpu3DRenderer::rangeChanged(uint32_t address, uint32_t size, bool palette, uint32_t generation)
+{
+    // Check a range of texture or palette memory for writes after the given generation
+    // The range is split at slot boundaries, since each slot can be mapped from a different VRAM block
+    uint32_t slotSize = palette ? 0x4000 : 0x20000;
+    uint32_t end = std::min(address + size, palette ? 0x18000U : 0x80000U);
+    while (address < end)
+    {
+        uint32_t length = std::min(end, (address / slotSize + 1) * slotSize) - address;
+        uint8_t *data = palette ? getPalette(address) : getTexture(address);
+        if (data && core->memory.vramChanged(data, length, generation))
+            return true;
+        address += length;
+    }
+    return false;
+}
+
+uint32_t Gpu3DRenderer::decodeTexel(_Polygon *polygon, int s, int t)
+{
     // Decode a texel
     switch (polygon->textureFmt)
     {
@@ -958,6 +1338,15 @@ void Gpu3DRenderer::drawPolygon(int line, int polygonIndex)
     // Instead, simply consider the entire span across the top and bottom of a polygon to be an edge
     bool horizontal = (line == polygonTop[polygonIndex] || line == polygonBot[polygonIndex] - 1);
 
+    // Calculate the interpolation factors across the scanline up front, unless the values are interpolated linearly
+    uint32_t factorBuffer[256];
+    uint32_t *factors = nullptr;
+    if (w1 != w2 || (w1 & 0x007F))
+    {
+        interpolateFactors(factorBuffer, x1, x4, w1, w2);
+        factors = factorBuffer;
+    }
+
     // Draw a line segment
     for (uint32_t x = x1; x < x4; x++)
     {
@@ -975,7 +1364,7 @@ void Gpu3DRenderer::drawPolygon(int line, int polygonIndex)
         uint32_t depth;
         if (polygon->wBuffer)
         {
-            depth = interpolateFill(w1, w2, x1, x, x4, w1, w2);
+            depth = interpolateSpan(w1, w2, x1, x, x4, factors);
             if (polygon->wShift > 0)
                 depth <<= polygon->wShift;
             else if (polygon->wShift < 0)
@@ -1033,20 +1422,20 @@ void Gpu3DRenderer::drawPolygon(int line, int polygonIndex)
         }
 
         // Interpolate the vertex color at the current pixel
-        uint32_t r = interpolateFill(r1, r2, x1, x, x4, w1, w2) >> 3;
-        uint32_t g = interpolateFill(g1, g2, x1, x, x4, w1, w2) >> 3;
-        uint32_t b = interpolateFill(b1, b2, x1, x, x4, w1, w2) >> 3;
+        uint32_t r = interpolateSpan(r1, r2, x1, x, x4, factors) >> 3;
+        uint32_t g = interpolateSpan(g1, g2, x1, x, x4, factors) >> 3;
+        uint32_t b = interpolateSpan(b1, b2, x1, x, x4, factors) >> 3;
         uint32_t color = ((polygon->alpha ? polygon->alpha : 0x3F) << 18) | (b << 12) | (g << 6) | r;
 
         // Blend the texture with the vertex color
         if (polygon->textureFmt != 0)
         {
             // Interpolate the texture coordinates at the current pixel
-            int s = interpolateFill(s1 + 0xFFFF, s2 + 0xFFFF, x1, x, x4, w1, w2) - 0xFFFF;
-            int t = interpolateFill(t1 + 0xFFFF, t2 + 0xFFFF, x1, x, x4, w1, w2) - 0xFFFF;
+            int s = interpolateSpan(s1 + 0xFFFF, s2 + 0xFFFF, x1, x, x4, factors) - 0xFFFF;
+            int t = interpolateSpan(t1 + 0xFFFF, t2 + 0xFFFF, x1, x, x4, factors) - 0xFFFF;
 
             // Read a texel from the texture
-            uint32_t texel = readTexture(polygon, s >> 4, t >> 4);
+            uint32_t texel = readTexture(polygon, polygonTextures[polygonIndex], s >> 4, t >> 4);
 
             // Apply texture blending
             // These formulas are a translation of the pseudocode from GBATEK to C++
@@ -21,12 +21,32 @@
 #define GPU_3D_RENDERER_H
 
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 class Core;
+class Savestate;
 struct Vertex;
 struct _Polygon;
+class Gpu3DRendererGl;
+
+// The frame is split into bands of scanlines, which polygons are sorted into and threads take from a shared counter
+#define BAND_HEIGHT 8
+#define BAND_COUNT  (192 / BAND_HEIGHT)
+
+// A decoded texture remembers the slot mappings and VRAM generation it was decoded with, to tell when it's out of date
+struct CachedTexture
+{
+    std::vector<uint32_t> texels;
+    uint8_t *tex3D[4] = {};
+    uint8_t *pal3D[6] = {};
+    uint32_t generation = 0;
+    uint32_t checked = 0;
+};
 
 class Gpu3DRenderer
 {
@@ -34,10 +54,20 @@ class Gpu3DRenderer
         Gpu3DRenderer(Core *core);
         ~Gpu3DRenderer();
 
+        void syncState(Savestate *state);
+
         void drawScanline(int line);
 
         uint32_t *getLine(int line);
 
+        int       getHighResScale() { return highResScale; }
+        uint32_t *getHighResFrame() { return &highRes[0];  }
+        size_t    getFootprint();
+
+        bool hasHardwareFailed() { return hardwareFailed.load(); }
+
+        void invalidateTextures() { texturesDirty = true; }
+
         uint16_t readDisp3DCnt() { return disp3DCnt; }
 
         void writeDisp3DCnt(uint16_t mask, uint16_t value);
@@ -51,19 +81,45 @@ class Gpu3DRenderer
 
     private:
         Core *core;
+        Gpu3DRendererGl *hardware = nullptr;
+
+        // The hardware renderer falls back to software if it can't be set up, which frontends can check from their own thread
+        // This is kept here instead of in the settings, so it isn't lost when a frontend passes in new ones
+        std::atomic<bool> hardwareFailed { false };
 
-        uint32_t framebuffer[2][256 * 192] = {};
-        uint32_t depthBuffer[2][256 * 192] = {};
-        uint32_t attribBuffer[2][256 * 192] = {};
-        uint8_t stencilBuffer[256 * 192] = {};
+        // The buffers are allocated when 3D is first drawn, so GBA mode and 2D-only software never pay for them
+        std::once_flag buffersFlag;
+        uint32_t (*framebuffer)[256 * 192] = nullptr;
+        uint32_t (*depthBuffer)[256 * 192] = nullptr;
+        uint32_t (*attribBuffer)[256 * 192] = nullptr;
+        uint8_t *stencilBuffer = nullptr;
+
+        std::vector<uint32_t> highRes;
+        int highResScale = 1;
         bool stencilClear[256] = {};
 
         int polygonTop[2048] = {};
         int polygonBot[2048] = {};
+        std::vector<int> bandPolygons[BAND_COUNT][2];
+
+        std::unordered_map<uint64_t, CachedTexture> textureCache;
+        uint32_t *polygonTextures[2048] = {};
+        uint32_t cacheSize = 0;
+        uint32_t textureGeneration = 0;
+        bool texturesDirty = false;
 
-        int activeThreads = 0;
-        std::thread *threads[3] = {};
+        std::vector<std::thread*> threads;
         std::atomic<int> ready[192];
+        std::atomic<bool> bandDrawn[BAND_COUNT];
+        std::atomic<bool> bandFinished[BAND_COUNT];
+        std::atomic<int> nextBand { BAND_COUNT };
+
+        std::mutex mutex;
+        std::condition_variable workCond, doneCond;
+        bool running = false;
+        int frameCount = 0;
+        int bandsDone = BAND_COUNT;
+        int busyThreads = 0;
 
         uint16_t disp3DCnt = 0;
         uint16_t edgeColor[8] = {};
@@ -76,7 +132,11 @@ class Gpu3DRenderer
 
         static uint32_t rgba5ToRgba6(uint32_t color);
 
-        void drawThreaded(int thread);
+        void allocateBuffers();
+        void waitThreads();
+        void stopThreads();
+        void drawThreaded(bool pin);
+        void finishBand(int band);
         void drawScanline1(int line);
         void finishScanline(int line);
 
@@ -88,9 +148,18 @@ class Gpu3DRenderer
         static uint32_t interpolateFill(uint32_t v1, uint32_t v2, uint32_t x1, uint32_t x, uint32_t x2, uint32_t w1, uint32_t w2);
         static uint32_t interpolateEdge(uint32_t v1, uint32_t v2, uint32_t x1, uint32_t x, uint32_t x2, uint32_t w1, uint32_t w2);
         static uint32_t interpolateColor(uint32_t c1, uint32_t c2, uint32_t x1, uint32_t x, uint32_t x2);
-
-        uint32_t readTexture(_Polygon *polygon, int s, int t);
+        static void interpolateFactors(uint32_t *factors, uint32_t x1, uint32_t x2, uint32_t w1, uint32_t w2);
+        static uint32_t interpolateSpan(uint32_t v1, uint32_t v2, uint32_t x1, uint32_t x, uint32_t x2, uint32_t *factors);
+
+        void decodeTextures();
+        void decodeTexture(_Polygon *polygon, CachedTexture *texture, uint32_t generation);
+        bool textureChanged(_Polygon *polygon, CachedTexture *texture);
+        bool rangeChanged(uint32_t address, uint32_t size, bool palette, uint32_t generation);
+        uint32_t decodeTexel(_Polygon *polygon, int s, int t);
+        uint32_t readTexture(_Polygon *polygon, uint32_t *texels, int s, int t);
         void drawPolygon(int line, int polygonIndex);
+
+    friend class Gpu3DRendererGl;
 };
 
 #endif // GPU_3D_RENDERER_H
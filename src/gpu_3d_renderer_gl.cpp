@@ -0,0 +1,605 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifdef OPENGL_3D
+
+#include <cstdio>
+
+#include "gpu_3d_renderer_gl.h"
+#include "core.h"
+
+enum Uniform
+{
+    U_PASS = 0,
+    U_MODE,
+    U_ALPHA,
+    U_ID,
+    U_FOG,
+    U_WBUFFER,
+    U_TEX_FMT,
+    U_HIGHLIGHT,
+    U_TEX_SIZE,
+    U_REPEAT,
+    U_FLIP,
+    U_TOON_TABLE,
+    U_TEX,
+    U_COUNT
+};
+
+enum Pass
+{
+    PASS_OPAQUE = 0,
+    PASS_TRANS_OPAQUE,
+    PASS_TRANS,
+    PASS_SHADOW_MASK
+};
+
+static const char *uniformNames[] =
+{
+    "pass", "mode", "alpha", "polygonId", "fog", "wBuffer", "texFmt",
+    "highlight", "texSize", "repeatTex", "flipTex", "toonTable", "tex"
+};
+
+// Vertices are passed in screen space, with W kept so GL can interpolate perspective-correct like the hardware
+// Z is interpolated linearly in screen space instead, which matches how the DS handles Z-buffering
+static const char *vertexShader =
+R"(#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec3 color;
+layout(location = 2) in vec2 texCoord;
+
+noperspective out float depthZ;
+out float depthW;
+out vec3 vertColor;
+out vec2 vertTexCoord;
+
+void main()
+{
+    float w = max(position.w, 1.0);
+    gl_Position = vec4((position.x / 128.0 - 1.0) * w, (1.0 - position.y / 96.0) * w, 0.0, w);
+    depthZ = position.z;
+    depthW = position.w;
+    vertColor = color;
+    vertTexCoord = texCoord;
+}
+)";
+
+// Colors are handled as 6-bit integers so texture blending can use the same formulas as the software renderer
+static const char *fragmentShader =
+R"(#version 330 core
+
+noperspective in float depthZ;
+in float depthW;
+in vec3 vertColor;
+in vec2 vertTexCoord;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec4 fragAttrib;
+
+uniform sampler2D tex;
+uniform int pass, mode, alpha, polygonId, fog, wBuffer, texFmt, highlight;
+uniform ivec2 texSize, repeatTex, flipTex;
+uniform int toonTable[32];
+
+int wrapCoord(int c, int size, int repeat, int flip)
+{
+    // Clamp the coordinate, or wrap it and flip every second repeat
+    if (repeat == 0) return clamp(c, 0, size - 1);
+    int count = int(floor(float(c) / float(size)));
+    c -= count * size;
+    return (flip != 0 && (count & 1) != 0) ? (size - 1 - c) : c;
+}
+
+ivec3 getToon(int index)
+{
+    int toon = toonTable[index];
+    return ivec3(toon & 0x3F, (toon >> 6) & 0x3F, (toon >> 12) & 0x3F);
+}
+
+void main()
+{
+    ivec4 color = ivec4(clamp(ivec3(vertColor), 0, 63), (alpha != 0) ? alpha : 63);
+
+    if (texFmt != 0)
+    {
+        // Read a texel, converting it back to 6-bit values
+        ivec2 st = ivec2(floor(vertTexCoord / 16.0));
+        st = ivec2(wrapCoord(st.x, texSize.x, repeatTex.x, flipTex.x), wrapCoord(st.y, texSize.y, repeatTex.y, flipTex.y));
+        ivec4 texel = ivec4(round(texelFetch(tex, st, 0) * 255.0)) >> 2;
+
+        // Apply texture blending
+        if (mode == 0) // Modulation
+        {
+            color = ((texel + 1) * (color + 1) - 1) / 64;
+        }
+        else if (mode == 1 || mode == 3) // Decal and shadow
+        {
+            color = ivec4((texel.rgb * texel.a + color.rgb * (63 - texel.a)) / 64, color.a);
+        }
+        else // Toon/Highlight
+        {
+            ivec3 toon = getToon(color.r / 2);
+            ivec3 rgb = (highlight != 0) ? min(((texel.rgb + 1) * (color.rgb + 1) - 1) / 64 + toon, 63) :
+                ((texel.rgb + 1) * (toon + 1) - 1) / 64;
+            color = ivec4(rgb, ((texel.a + 1) * (color.a + 1) - 1) / 64);
+        }
+    }
+    else if (mode == 2) // Toon/Highlight (no texture)
+    {
+        ivec3 toon = getToon(color.r / 2);
+        color.rgb = (highlight != 0) ? min(color.rgb + toon, 63) : toon;
+    }
+
+    // Skip transparent pixels, and pixels that belong to a different pass
+    if (color.a == 0 || (pass == 1 && color.a < 63) || (pass == 2 && color.a == 63))
+        discard;
+
+    fragColor = vec4(color) / 63.0;
+    fragAttrib = vec4(float(polygonId) / 255.0, float(fog), 1.0, 0.0);
+    gl_FragDepth = ((wBuffer != 0) ? min(depthW, 16777215.0) : depthZ) / 16777215.0;
+}
+)";
+
+Gpu3DRendererGl::Gpu3DRendererGl(Core *core): core(core)
+{
+    // Set up the context and GL objects, leaving the renderer invalid if anything fails
+    valid = initContext() && initObjects();
+
+    // Release the context so it can be made current on whichever thread draws the next frame
+    if (context != EGL_NO_CONTEXT)
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+}
+
+Gpu3DRendererGl::~Gpu3DRendererGl()
+{
+    if (context == EGL_NO_CONTEXT) return;
+
+    // Clean up the GL objects
+    if (eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+    {
+        for (auto &texture: textures)
+            glDeleteTextures(1, &texture.second);
+        glDeleteRenderbuffers(6, renderbuffers[0]);
+        glDeleteFramebuffers(2, fbos);
+        glDeleteBuffers(1, &vbo);
+        glDeleteVertexArrays(1, &vao);
+        glDeleteProgram(program);
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+
+    // Clean up the context
+    eglDestroyContext(display, context);
+}
+
+bool Gpu3DRendererGl::initContext()
+{
+    // Get the default display, or a surfaceless one if there's no window system
+    display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+    {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (!getPlatformDisplay) return false;
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) return false;
+    }
+
+    // Create an OpenGL 3.3 core context
+    // Everything is drawn to a framebuffer object, so the context doesn't need a surface
+    if (!eglBindAPI(EGL_OPENGL_API)) return false;
+    EGLint configAttribs[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+    EGLConfig config = EGL_NO_CONFIG_KHR;
+    EGLint count = 0;
+    if (!eglChooseConfig(display, configAttribs, &config, 1, &count) || count == 0)
+        config = EGL_NO_CONFIG_KHR;
+
+    EGLint contextAttribs[] =
+    {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+
+    context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (context == EGL_NO_CONTEXT) return false;
+    return eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context);
+}
+
+bool Gpu3DRendererGl::initObjects()
+{
+    // Compile the shaders
+    const char *sources[] = { vertexShader, fragmentShader };
+    const GLenum types[] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+    program = glCreateProgram();
+
+    for (int i = 0; i < 2; i++)
+    {
+        GLuint shader = glCreateShader(types[i]);
+        glShaderSource(shader, 1, &sources[i], nullptr);
+        glCompileShader(shader);
+
+        GLint status;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        if (!status)
+        {
+            char log[1024];
+            glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+            printf("Failed to compile 3D shader: %s\n", log);
+            glDeleteShader(shader);
+            return false;
+        }
+
+        glAttachShader(program, shader);
+        glDeleteShader(shader);
+    }
+
+    // Link the program
+    GLint status;
+    glLinkProgram(program);
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (!status) return false;
+
+    // Look up the uniforms
+    for (int i = 0; i < U_COUNT; i++)
+        uniforms[i] = glGetUniformLocation(program, uniformNames[i]);
+
+    // Create the native resolution framebuffer
+    glGenFramebuffers(2, fbos);
+    glGenRenderbuffers(6, renderbuffers[0]);
+    if (!resizeFramebuffer(0, 1))
+        return false;
+
+    // Set up the vertex format: position (X, Y, Z, W), color (R, G, B), and texture coordinates (S, T)
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(0 * sizeof(float)));
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(4 * sizeof(float)));
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(7 * sizeof(float)));
+
+    // Set the state that stays the same between frames
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_STENCIL_TEST);
+    glDisable(GL_CULL_FACE);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
+    glBlendEquationSeparate(GL_FUNC_ADD, GL_MAX);
+    glUseProgram(program);
+    glUniform1i(uniforms[U_TEX], 0);
+
+    readColor.resize(256 * 192 * 4);
+    readAttrib.resize(256 * 192 * 4);
+    readDepth.resize(256 * 192);
+    return glGetError() == GL_NO_ERROR;
+}
+
+bool Gpu3DRendererGl::resizeFramebuffer(int index, int scale)
+{
+    // Set up a framebuffer with color, attribute, and depth/stencil attachments at a multiple of the native resolution
+    const GLenum formats[] = { GL_RGBA8, GL_RGBA8, GL_DEPTH24_STENCIL8 };
+    const GLenum attachments[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_DEPTH_STENCIL_ATTACHMENT };
+    glBindFramebuffer(GL_FRAMEBUFFER, fbos[index]);
+
+    for (int i = 0; i < 3; i++)
+    {
+        glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[index][i]);
+        glRenderbufferStorage(GL_RENDERBUFFER, formats[i], 256 * scale, 192 * scale);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachments[i], GL_RENDERBUFFER, renderbuffers[index][i]);
+    }
+
+    glDrawBuffers(2, attachments);
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+GLuint Gpu3DRendererGl::getTexture(_Polygon *polygon)
+{
+    Gpu3DRenderer *renderer = &core->gpu3DRenderer;
+
+    // Drop the GL textures when the software renderer's texture cache is cleared, since their data is no longer valid
+    if (textureGeneration != renderer->textureGeneration)
+    {
+        for (auto &texture: textures)
+            glDeleteTextures(1, &texture.second);
+        textures.clear();
+        textureGeneration = renderer->textureGeneration;
+    }
+
+    // Textures are decoded by the software renderer's cache, so identify them by their decoded data
+    uint32_t *data = renderer->polygonTextures[polygon - core->gpu3D.getPolygons()];
+    GLuint &texture = textures[data];
+
+    if (!texture)
+    {
+        // Expand the 6-bit values to 8 bits, so the shader can shift them back exactly
+        texels.resize(polygon->sizeS * polygon->sizeT * 4);
+        for (int i = 0; i < polygon->sizeS * polygon->sizeT; i++)
+        {
+            for (int j = 0; j < 4; j++)
+            {
+                uint8_t value = (data[i] >> (j * 6)) & 0x3F;
+                texels[i * 4 + j] = (value << 2) | (value >> 4);
+            }
+        }
+
+        // Create and upload a GL texture the first time a texture is seen
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, polygon->sizeS, polygon->sizeT, 0, GL_RGBA, GL_UNSIGNED_BYTE, &texels[0]);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    return texture;
+}
+
+void Gpu3DRendererGl::drawPolygon(_Polygon *polygon, int first, int pass)
+{
+    // Set the polygon parameters
+    glUniform1i(uniforms[U_PASS],    pass);
+    glUniform1i(uniforms[U_MODE],    polygon->mode);
+    glUniform1i(uniforms[U_ALPHA],   polygon->alpha);
+    glUniform1i(uniforms[U_ID],      polygon->id);
+    glUniform1i(uniforms[U_FOG],     polygon->fog);
+    glUniform1i(uniforms[U_WBUFFER], polygon->wBuffer);
+    glUniform1i(uniforms[U_TEX_FMT], polygon->textureFmt);
+
+    // Set the texture parameters
+    if (polygon->textureFmt != 0)
+    {
+        getTexture(polygon);
+        glUniform2i(uniforms[U_TEX_SIZE], polygon->sizeS, polygon->sizeT);
+        glUniform2i(uniforms[U_REPEAT], polygon->repeatS, polygon->repeatT);
+        glUniform2i(uniforms[U_FLIP], polygon->flipS, polygon->flipT);
+    }
+
+    bool shadow = (polygon->mode == 3 && polygon->id != 0);
+    uint16_t disp3DCnt = core->gpu3DRenderer.readDisp3DCnt();
+
+    // The stencil buffer holds the translucent polygon ID (bits 0-5), a translucent flag (bit 6), and the shadow mask (bit 7)
+    if (pass == PASS_SHADOW_MASK)
+    {
+        // Set the shadow mask bit where the depth test fails, without drawing anything
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glDepthMask(GL_FALSE);
+        glDisable(GL_BLEND);
+        glStencilFunc(GL_ALWAYS, 0x80, 0x80);
+        glStencilOp(GL_KEEP, GL_REPLACE, GL_KEEP);
+        glStencilMask(0x80);
+    }
+    else if (pass == PASS_OPAQUE || pass == PASS_TRANS_OPAQUE)
+    {
+        // Draw opaque pixels with depth and attributes, clearing the translucent flag
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        glDepthMask(GL_TRUE);
+        glDisable(GL_BLEND);
+        glStencilFunc(shadow ? GL_EQUAL : GL_ALWAYS, shadow ? 0x80 : 0x00, shadow ? 0x80 : 0x00);
+        glStencilOp(GL_KEEP, GL_KEEP, shadow ? GL_KEEP : GL_REPLACE);
+        glStencilMask(0x7F);
+    }
+    else
+    {
+        // Draw translucent pixels without attributes, only over pixels that aren't already translucent with the same ID
+        glColorMaski(0, GL_TRUE,  GL_TRUE,  GL_TRUE,  GL_TRUE);
+        glColorMaski(1, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glDepthMask(polygon->transNewDepth ? GL_TRUE : GL_FALSE);
+        if (disp3DCnt & BIT(3)) glEnable(GL_BLEND); else glDisable(GL_BLEND);
+        glStencilFunc(shadow ? GL_EQUAL : GL_NOTEQUAL, shadow ? 0x80 : (0x40 | polygon->id), shadow ? 0x80 : 0x7F);
+        glStencilOp(GL_KEEP, GL_KEEP, shadow ? GL_KEEP : GL_REPLACE);
+        glStencilMask(0x7F);
+    }
+
+    // Draw the polygon, using lines for the edges of wireframe polygons
+    glDepthFunc(polygon->depthTestEqual ? GL_LEQUAL : GL_LESS);
+    glDrawArrays((polygon->alpha == 0) ? GL_LINE_LOOP : GL_TRIANGLE_FAN, first, polygon->size);
+}
+
+void Gpu3DRendererGl::drawFrame(uint32_t *framebuffer, uint32_t *depthBuffer, uint32_t *attribBuffer, int scale, uint32_t *highRes)
+{
+    Gpu3DRenderer *renderer = &core->gpu3DRenderer;
+    _Polygon *polygons = core->gpu3D.getPolygons();
+    int count = core->gpu3D.getPolygonCount();
+
+    // Take the context for this thread
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+        return;
+
+    // Resize the high resolution framebuffer if the scale changed
+    // The native resolution framebuffer is drawn to directly when there's no scaling
+    if (scale > 1 && scale != highResScale)
+    {
+        resizeFramebuffer(1, scale);
+        highResScale = scale;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbos[scale > 1]);
+    glViewport(0, 0, 256 * scale, 192 * scale);
+    glUseProgram(program);
+    glBindVertexArray(vao);
+    glActiveTexture(GL_TEXTURE0);
+
+    // Convert the clear values
+    uint32_t color = Gpu3DRenderer::rgba5ToRgba6(((renderer->clearColor & 0x001F0000) >> 1) | (renderer->clearColor & 0x00007FFF));
+    uint32_t depth = (renderer->clearDepth == 0x7FFF) ? 0xFFFFFF : (renderer->clearDepth << 9);
+    GLfloat clearColor[] =
+    {
+        ((color >> 0) & 0x3F) / 63.0f, ((color >> 6) & 0x3F) / 63.0f, ((color >> 12) & 0x3F) / 63.0f, ((color >> 18) & 0x3F) / 63.0f
+    };
+    GLfloat clearAttrib[] = { ((renderer->clearColor >> 24) & 0x3F) / 255.0f, (renderer->clearColor & BIT(15)) ? 1.0f : 0.0f, 0.0f, 0.0f };
+
+    // Clear the buffers with the clear values
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDepthMask(GL_TRUE);
+    glStencilMask(0xFF);
+    glClearBufferfv(GL_COLOR, 0, clearColor);
+    glClearBufferfv(GL_COLOR, 1, clearAttrib);
+    glClearBufferfi(GL_DEPTH_STENCIL, 0, depth / (float)0xFFFFFF, 0);
+
+    // Set the frame parameters
+    GLint toonTable[32];
+    for (int i = 0; i < 32; i++)
+        toonTable[i] = Gpu3DRenderer::rgba5ToRgba6(renderer->toonTable[i]);
+    glUniform1iv(uniforms[U_TOON_TABLE], 32, toonTable);
+    glUniform1i(uniforms[U_HIGHLIGHT], (renderer->disp3DCnt & BIT(1)) ? 1 : 0);
+
+    // Gather the vertices of every polygon, and sort the polygons into opaque and translucent ones
+    std::vector<int> firsts, opaque, translucent;
+    vertices.clear();
+    for (int i = 0; i < count; i++)
+    {
+        _Polygon *polygon = &polygons[i];
+        firsts.push_back(vertices.size() / 9);
+
+        for (int j = 0; j < polygon->size; j++)
+        {
+            // Unclipped quad strip polygons have their vertices crossed, so uncross them
+            int k = (polygon->crossed && j >= 2) ? (5 - j) : j;
+            Vertex *vertex = &polygon->vertices[k];
+            float data[] =
+            {
+                (float)vertex->x, (float)vertex->y, (float)vertex->z, (float)vertex->w,
+                (float)((vertex->color >> 0) & 0x3F), (float)((vertex->color >> 6) & 0x3F), (float)((vertex->color >> 12) & 0x3F),
+                (float)vertex->s, (float)vertex->t
+            };
+            vertices.insert(vertices.end(), data, data + 9);
+        }
+
+        if (polygon->alpha < 0x3F || polygon->textureFmt == 1 || polygon->textureFmt == 6)
+            translucent.push_back(i);
+        else
+            opaque.push_back(i);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.empty() ? nullptr : &vertices[0], GL_STREAM_DRAW);
+
+    // Draw the opaque polygons followed by the translucent ones, the same order the software renderer uses
+    bool stencilClear = false;
+    for (int i = 0; i < (int)(opaque.size() + translucent.size()); i++)
+    {
+        int index = (i < (int)opaque.size()) ? opaque[i] : translucent[i - opaque.size()];
+        _Polygon *polygon = &polygons[index];
+
+        if (polygon->mode == 3 && polygon->id == 0) // Shadow mask polygon
+        {
+            // Clear the shadow mask at the start of a shadow mask polygon group
+            if (!stencilClear)
+            {
+                glStencilMask(0x80);
+                glClear(GL_STENCIL_BUFFER_BIT);
+                stencilClear = true;
+            }
+
+            drawPolygon(polygon, firsts[index], PASS_SHADOW_MASK);
+            continue;
+        }
+
+        stencilClear = false;
+
+        if (i < (int)opaque.size())
+        {
+            drawPolygon(polygon, firsts[index], PASS_OPAQUE);
+        }
+        else
+        {
+            // Translucent polygons can still have opaque pixels, which are drawn like opaque polygons
+            if (polygon->alpha == 0x3F || polygon->alpha == 0)
+                drawPolygon(polygon, firsts[index], PASS_TRANS_OPAQUE);
+            drawPolygon(polygon, firsts[index], PASS_TRANS);
+        }
+    }
+
+    if (scale > 1)
+    {
+        // Read back the high resolution color buffer
+        readHighRes.resize(256 * 192 * scale * scale * 4);
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        glReadPixels(0, 0, 256 * scale, 192 * scale, GL_RGBA, GL_UNSIGNED_BYTE, &readHighRes[0]);
+
+        // Shrink each buffer down to the native resolution framebuffer, which the 2D engine and display capture use
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbos[1]);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbos[0]);
+        for (int i = 0; i < 2; i++)
+        {
+            glReadBuffer(GL_COLOR_ATTACHMENT0 + i);
+            glDrawBuffer(GL_COLOR_ATTACHMENT0 + i);
+            glBlitFramebuffer(0, 0, 256 * scale, 192 * scale, 0, 0, 256, 192, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        }
+        glBlitFramebuffer(0, 0, 256 * scale, 192 * scale, 0, 0, 256, 192, GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT, GL_NEAREST);
+
+        // Restore the draw buffers of the native resolution framebuffer
+        const GLenum attachments[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+        glDrawBuffers(2, attachments);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbos[0]);
+    }
+
+    // Read the buffers back
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glReadPixels(0, 0, 256, 192, GL_RGBA, GL_UNSIGNED_BYTE, &readColor[0]);
+    glReadBuffer(GL_COLOR_ATTACHMENT1);
+    glReadPixels(0, 0, 256, 192, GL_RGBA, GL_UNSIGNED_BYTE, &readAttrib[0]);
+    glReadPixels(0, 0, 256, 192, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, &readDepth[0]);
+
+    // Release the context, since the core could be on a different thread for the next frame
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+    // Convert the results to the software renderer's formats, flipping them since GL starts from the bottom
+    for (int y = 0; y < 192; y++)
+    {
+        for (int x = 0; x < 256; x++)
+        {
+            int i = (191 - y) * 256 + x;
+            int j = y * 256 + x;
+
+            // Convert the 8-bit color values back to 6 bits, marked with the extra bit for 2D blending
+            uint8_t *c = &readColor[i * 4];
+            framebuffer[j] = BIT(26) | (((c[3] * 63 + 127) / 255) << 18) | (((c[2] * 63 + 127) / 255) << 12) |
+                (((c[1] * 63 + 127) / 255) << 6) | ((c[0] * 63 + 127) / 255);
+
+            // Rebuild the polygon ID (0-5), fog bit (13), edge bit (14), and opaque edge alpha (15-20)
+            uint8_t *a = &readAttrib[i * 4];
+            attribBuffer[j] = (a[0] & 0x3F) | ((a[1] > 0x7F) << 13) | ((a[2] > 0x7F) << 14) | (0x3F << 15);
+
+            // Keep the upper 24 bits of the depth/stencil value as the depth
+            depthBuffer[j] = readDepth[i] >> 8;
+        }
+    }
+
+    // Convert the high resolution colors in the same way
+    if (scale > 1)
+    {
+        int width = 256 * scale, height = 192 * scale;
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                uint8_t *c = &readHighRes[((height - 1 - y) * width + x) * 4];
+                highRes[y * width + x] = BIT(26) | (((c[3] * 63 + 127) / 255) << 18) | (((c[2] * 63 + 127) / 255) << 12) |
+                    (((c[1] * 63 + 127) / 255) << 6) | ((c[0] * 63 + 127) / 255);
+            }
+        }
+    }
+}
+
+#endif // OPENGL_3D
@@ -0,0 +1,84 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef GPU_3D_RENDERER_GL_H
+#define GPU_3D_RENDERER_GL_H
+
+#ifdef OPENGL_3D
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#define GL_GLEXT_PROTOTYPES
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+class Core;
+struct _Polygon;
+
+// A hardware backend for the 3D renderer, which draws a whole frame of polygons with OpenGL
+// It owns an offscreen context so it can run on the core thread, separate from any frontend context
+// The result is read back into the software renderer's buffers, which keeps 2D compositing and display capture working
+// Frames can be drawn at a multiple of the native resolution, in which case a high resolution copy of the colors is kept too
+class Gpu3DRendererGl
+{
+    public:
+        Gpu3DRendererGl(Core *core);
+        ~Gpu3DRendererGl();
+
+        bool isValid() { return valid; }
+
+        void drawFrame(uint32_t *framebuffer, uint32_t *depthBuffer, uint32_t *attribBuffer, int scale, uint32_t *highRes);
+
+    private:
+        Core *core;
+        bool valid = false;
+
+        EGLDisplay display = EGL_NO_DISPLAY;
+        EGLContext context = EGL_NO_CONTEXT;
+
+        GLuint program = 0;
+        GLuint fbos[2] = {}, renderbuffers[2][3] = {};
+        int highResScale = 0;
+        GLuint vao = 0, vbo = 0;
+
+        GLint uniforms[16] = {};
+
+        std::vector<float> vertices;
+        std::vector<uint8_t> readColor, readAttrib, readHighRes;
+        std::vector<uint32_t> readDepth;
+        std::vector<uint8_t> texels;
+
+        std::unordered_map<uint32_t*, GLuint> textures;
+        uint32_t textureGeneration = 0;
+
+        bool initContext();
+        bool initObjects();
+        bool resizeFramebuffer(int index, int scale);
+
+        GLuint getTexture(_Polygon *polygon);
+        void drawPolygon(_Polygon *polygon, int first, int pass);
+};
+
+#endif // OPENGL_3D
+
+#endif // GPU_3D_RENDERER_GL_H
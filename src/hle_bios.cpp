@@ -0,0 +1,434 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <vector>
+
+#include "hle_bios.h"
+#include "core.h"
+
+void HleBios::syncState(Savestate *state)
+{
+    // Sync the wait state
+    state->sync(waiting);
+}
+
+void HleBios::buildStub(uint8_t *bios, bool arm9)
+{
+    // Build a minimal BIOS for when a dump isn't available, with every SWI it gets expected to be handled natively
+    // It only has to hang on reset, return from unsupported SWIs, and pass interrupts to the handler set by the game
+    // The ARM9 handler address is at the end of the data TCM, and the ARM7 and GBA ones are at the end of WRAM
+    static const uint32_t vectors[] =
+    {
+        0xEAFFFFFE, // 0x00: B      0x00
+        0x00000000, // 0x04
+        0xE1B0F00E, // 0x08: MOVS   PC,LR
+        0x00000000, // 0x0C
+        0x00000000, // 0x10
+        0x00000000, // 0x14
+        0xEA000000, // 0x18: B      0x20
+        0x00000000  // 0x1C
+    };
+
+    static const uint32_t irq9[] =
+    {
+        0xE92D500F, // STMFD  SP!,{R0-R3,R12,LR}
+        0xEE190F11, // MRC    P15,0,R0,C9,C1,0
+        0xE1A00620, // MOV    R0,R0,LSR #12
+        0xE1A00600, // MOV    R0,R0,LSL #12
+        0xE2800901, // ADD    R0,R0,#0x4000
+        0xE28FE000, // ADD    LR,PC,#0
+        0xE510F004, // LDR    PC,[R0,#-4]
+        0xE8BD500F, // LDMFD  SP!,{R0-R3,R12,LR}
+        0xE25EF004  // SUBS   PC,LR,#4
+    };
+
+    static const uint32_t irq7[] =
+    {
+        0xE92D500F, // STMFD  SP!,{R0-R3,R12,LR}
+        0xE3A00301, // MOV    R0,#0x4000000
+        0xE28FE000, // ADD    LR,PC,#0
+        0xE510F004, // LDR    PC,[R0,#-4]
+        0xE8BD500F, // LDMFD  SP!,{R0-R3,R12,LR}
+        0xE25EF004  // SUBS   PC,LR,#4
+    };
+
+    // Write the opcodes LSB-first, with the interrupt handler right after the vectors
+    const uint32_t *irq = arm9 ? irq9 : irq7;
+    int count = arm9 ? (sizeof(irq9) / sizeof(uint32_t)) : (sizeof(irq7) / sizeof(uint32_t));
+    for (int i = 0; i < 8 + count; i++)
+    {
+        uint32_t opcode = (i < 8) ? vectors[i] : irq[i - 8];
+        for (int j = 0; j < 4; j++)
+            bios[i * 4 + j] = opcode >> (j * 8);
+    }
+}
+
+int HleBios::execute(uint8_t comment, bool thumb, uint32_t **registers)
+{
+    // Run a BIOS function natively, returning the cycles it took, or 0 to let the BIOS handle it
+    // The NDS functions that read data through callbacks are left to the BIOS, since those run game code
+    // Memory could have been remapped since the last call, so the source page is looked up again
+    readPage = 1;
+    if (core->isGbaMode()) // GBA
+    {
+        switch (comment)
+        {
+            case 0x02: return halt();
+            case 0x04: return intrWait(*registers[0], *registers[1], thumb, registers);
+            case 0x05: return intrWait(true, BIT(0), thumb, registers);
+            case 0x06: return divide(false, registers);
+            case 0x07: return divide(true, registers);
+            case 0x08: return squareRoot(registers);
+            case 0x0B: return cpuSet(registers);
+            case 0x0C: return cpuFastSet(registers);
+            case 0x11: return lz77Uncomp(false, registers);
+            case 0x12: return lz77Uncomp(true, registers);
+            case 0x13: return huffUncomp(registers);
+            case 0x14: return rlUncomp(false, registers);
+            case 0x15: return rlUncomp(true, registers);
+        }
+    }
+    else // NDS
+    {
+        switch (comment)
+        {
+            case 0x04: return intrWait(*registers[0], *registers[1], thumb, registers);
+            case 0x05: return intrWait(true, BIT(0), thumb, registers);
+            case 0x06: return halt();
+            case 0x09: return divide(false, registers);
+            case 0x0B: return cpuSet(registers);
+            case 0x0C: return cpuFastSet(registers);
+            case 0x0D: return squareRoot(registers);
+            case 0x11: return lz77Uncomp(false, registers);
+            case 0x14: return rlUncomp(false, registers);
+        }
+    }
+
+    return 0;
+}
+
+int HleBios::halt()
+{
+    // Halt the CPU until an interrupt is requested
+    core->interpreter[cpu].halt(0);
+    return 3;
+}
+
+int HleBios::intrWait(bool discard, uint32_t mask, bool thumb, uint32_t **registers)
+{
+    // Get the address of the interrupt flags that the game's handler sets
+    uint32_t address;
+    if (core->isGbaMode())
+        address = 0x03007FF8;
+    else if (cpu == 0)
+        address = core->cp15.getDtcmAddr() + 0x3FF8;
+    else
+        address = 0x0380FFF8;
+
+    // Discard old flags when the wait starts, if requested
+    uint32_t flags = core->memory.read<uint32_t>(cpu, address);
+    if (discard && !waiting)
+        flags &= ~mask;
+
+    // Finish the wait once one of the flags is set, clearing it
+    if (flags & mask)
+    {
+        core->memory.write<uint32_t>(cpu, address, flags & ~mask);
+        waiting = false;
+        return 3;
+    }
+
+    // Enable interrupts, halt, and move the PC back so the SWI runs again after the next interrupt
+    core->memory.write<uint32_t>(cpu, address, flags);
+    core->interpreter[cpu].writeIme(1);
+    core->interpreter[cpu].halt(0);
+    *registers[15] -= thumb ? 2 : 4;
+    waiting = true;
+    return 3;
+}
+
+int HleBios::divide(bool swap, uint32_t **registers)
+{
+    // Get the operands, which are swapped for the GBA's DivArm
+    int32_t num = *registers[swap ? 1 : 0];
+    int32_t den = *registers[swap ? 0 : 1];
+
+    // Divide the numerator by the denominator, avoiding the cases that would crash the host
+    // Division by zero returns a result of 1 with the sign of the numerator, instead of hanging like the BIOS
+    int32_t div, mod;
+    if (den == 0)
+    {
+        div = (num < 0) ? -1 : 1;
+        mod = num;
+    }
+    else if (num == INT32_MIN && den == -1)
+    {
+        div = INT32_MIN;
+        mod = 0;
+    }
+    else
+    {
+        div = num / den;
+        mod = num % den;
+    }
+
+    *registers[0] = div;
+    *registers[1] = mod;
+    *registers[3] = (div < 0) ? -div : div;
+    return 3;
+}
+
+int HleBios::squareRoot(uint32_t **registers)
+{
+    // Calculate the integer square root of an unsigned 32-bit value, a bit pair at a time
+    uint32_t value = *registers[0];
+    uint32_t root = 0;
+    uint32_t bit = BIT(30);
+    while (bit > value) bit >>= 2;
+
+    while (bit)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    *registers[0] = root;
+    return 3;
+}
+
+int HleBios::cpuSet(uint32_t **registers)
+{
+    // Copy or fill a number of 16-bit or 32-bit units
+    int unit = (*registers[2] & BIT(26)) ? 4 : 2;
+    uint32_t size = (*registers[2] & 0x1FFFFF) * unit;
+    transfer(*registers[1] & ~(unit - 1), *registers[0] & ~(unit - 1), size, unit, *registers[2] & BIT(24));
+    return 3;
+}
+
+int HleBios::cpuFastSet(uint32_t **registers)
+{
+    // Copy or fill a number of 32-bit units, rounded up to blocks of 8
+    uint32_t size = ((*registers[2] & 0x1FFFFF) + 7) / 8 * 32;
+    transfer(*registers[1] & ~3, *registers[0] & ~3, size, 4, *registers[2] & BIT(24));
+    return 3;
+}
+
+int HleBios::lz77Uncomp(bool vram, uint32_t **registers)
+{
+    // Get the decompressed size from the header
+    uint32_t src = *registers[0], dst = *registers[1];
+    uint32_t size = readWord(src) >> 8;
+    std::vector<uint8_t> data((size + 3) & ~3);
+    src += 4;
+
+    // Decompress the data into a buffer, following groups of 8 blocks with a flag byte
+    // A set flag means the block is a reference to earlier data, and a clear flag means it's a literal byte
+    for (uint32_t i = 0; i < size;)
+    {
+        uint8_t flags = readByte(src++);
+        for (int j = 7; j >= 0 && i < size; j--)
+        {
+            if (flags & BIT(j))
+            {
+                uint8_t byte0 = readByte(src++), byte1 = readByte(src++);
+                uint32_t disp = (((byte0 & 0xF) << 8) | byte1) + 1;
+                for (int k = (byte0 >> 4) + 3; k > 0 && i < size; k--, i++)
+                    data[i] = (i >= disp) ? data[i - disp] : core->memory.read<uint8_t>(cpu, dst + i - disp);
+            }
+            else
+            {
+                data[i++] = readByte(src++);
+            }
+        }
+    }
+
+    // Write the data to memory all at once, using 16-bit units for VRAM
+    writeOutput(dst, data.data(), size, vram ? 2 : 1);
+    return 3;
+}
+
+int HleBios::huffUncomp(uint32_t **registers)
+{
+    // Get the data size and decompressed size from the header
+    uint32_t src = *registers[0], dst = *registers[1];
+    uint32_t header = readWord(src);
+    int bits = ((header & 0xF) == 4) ? 4 : 8;
+    uint32_t size = header >> 8;
+    std::vector<uint8_t> data((size + 3) & ~3);
+
+    // Copy the tree, which starts with its size and then the root node
+    uint32_t treeSize = (readByte(src + 4) + 1) * 2;
+    std::vector<uint8_t> tree(treeSize);
+    for (uint32_t i = 0; i < treeSize; i++)
+        tree[i] = readByte(src + 4 + i);
+    src += 4 + treeSize;
+
+    // Decompress the data into a buffer, following the tree for each bit of the 32-bit bitstream units
+    // Node bits 0-5 give the offset to the child pair, and bits 7 and 6 flag if the children are data
+    uint32_t node = 1, value = 0;
+    int shift = 0;
+    for (uint32_t i = 0; i < size;)
+    {
+        uint32_t stream = readWord(src);
+        src += 4;
+
+        for (int j = 31; j >= 0 && i < size; j--)
+        {
+            bool bit = stream & BIT(j);
+            uint32_t child = (node & ~1) + (tree[node] & 0x3F) * 2 + 2 + bit;
+            if (child >= treeSize) break;
+
+            if (!(tree[node] & (bit ? BIT(6) : BIT(7))))
+            {
+                node = child;
+                continue;
+            }
+
+            // Collect the data into 32-bit units, and move them to the buffer once they're full
+            value |= (tree[child] & ((1 << bits) - 1)) << shift;
+            node = 1;
+            if ((shift += bits) == 32)
+            {
+                for (int k = 0; k < 4; k++)
+                    data[i++] = value >> (k * 8);
+                value = shift = 0;
+            }
+        }
+    }
+
+    // Write the data to memory all at once, in 32-bit units
+    writeOutput(dst, data.data(), data.size(), 4);
+    return 3;
+}
+
+int HleBios::rlUncomp(bool vram, uint32_t **registers)
+{
+    // Get the decompressed size from the header
+    uint32_t src = *registers[0], dst = *registers[1];
+    uint32_t size = readWord(src) >> 8;
+    std::vector<uint8_t> data((size + 3) & ~3);
+    src += 4;
+
+    // Decompress the data into a buffer, following a flag byte for each run
+    // A set bit 7 means a byte repeated 3-130 times, and a clear one means 1-128 literal bytes
+    for (uint32_t i = 0; i < size;)
+    {
+        uint8_t flag = readByte(src++);
+        if (flag & BIT(7))
+        {
+            uint8_t value = readByte(src++);
+            for (int j = (flag & 0x7F) + 3; j > 0 && i < size; j--)
+                data[i++] = value;
+        }
+        else
+        {
+            for (int j = (flag & 0x7F) + 1; j > 0 && i < size; j--)
+                data[i++] = readByte(src++);
+        }
+    }
+
+    // Write the data to memory all at once, using 16-bit units for VRAM
+    writeOutput(dst, data.data(), size, vram ? 2 : 1);
+    return 3;
+}
+
+uint8_t HleBios::readByte(uint32_t address)
+{
+    // Read through a host pointer to the current source page, or fall back to the slow path if it isn't mapped
+    // The page is looked up again whenever the source leaves it
+    if ((address & ~0xFFF) != readPage)
+    {
+        readPage = address & ~0xFFF;
+        readData = core->memory.getReadPointer(cpu, readPage);
+    }
+    return readData ? readData[address & 0xFFF] : core->memory.read<uint8_t>(cpu, address);
+}
+
+uint32_t HleBios::readWord(uint32_t address)
+{
+    // Read an unaligned LSB-first word from the source
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++)
+        value |= readByte(address + i) << (i * 8);
+    return value;
+}
+
+void HleBios::transfer(uint32_t dst, uint32_t src, uint32_t size, int unit, bool fixed)
+{
+    // Copy or fill a page at a time using host pointers, falling back to single units for pages that aren't plain memory
+    while (size > 0)
+    {
+        uint32_t bytes = std::min(size, 0x1000 - (dst & 0xFFF));
+        if (!fixed) bytes = std::min(bytes, 0x1000 - (src & 0xFFF));
+
+        if (fixed ? !core->memory.fillBlock(cpu, dst, src, bytes, unit) : !core->memory.copyBlock(cpu, dst, src, bytes))
+        {
+            for (uint32_t i = 0; i < bytes; i += unit)
+            {
+                uint32_t from = fixed ? src : (src + i);
+                if (unit == 4)
+                    core->memory.write<uint32_t>(cpu, dst + i, core->memory.read<uint32_t>(cpu, from));
+                else
+                    core->memory.write<uint16_t>(cpu, dst + i, core->memory.read<uint16_t>(cpu, from));
+            }
+        }
+
+        if (!fixed) src += bytes;
+        dst += bytes;
+        size -= bytes;
+    }
+}
+
+void HleBios::writeOutput(uint32_t dst, const uint8_t *data, uint32_t size, int unit)
+{
+    // Write decompressed data a page at a time, falling back to single units for pages that aren't plain memory
+    // Buffers are padded to 32-bit units, so the size can be rounded up to a full unit
+    dst &= ~(unit - 1);
+    size = (size + unit - 1) & ~(unit - 1);
+
+    while (size > 0)
+    {
+        uint32_t bytes = std::min(size, 0x1000 - (dst & 0xFFF));
+        if (!core->memory.writeBlock(cpu, dst, data, bytes))
+        {
+            for (uint32_t i = 0; i < bytes; i += unit)
+            {
+                switch (unit)
+                {
+                    case 1: core->memory.write<uint8_t>(cpu, dst + i, data[i]);          break;
+                    case 2: core->memory.write<uint16_t>(cpu, dst + i, U8TO16(data, i)); break;
+                    case 4: core->memory.write<uint32_t>(cpu, dst + i, U8TO32(data, i)); break;
+                }
+            }
+        }
+
+        dst += bytes;
+        data += bytes;
+        size -= bytes;
+    }
+}
@@ -0,0 +1,65 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef HLE_BIOS_H
+#define HLE_BIOS_H
+
+#include <cstdint>
+
+class Core;
+class Savestate;
+
+class HleBios
+{
+    public:
+        HleBios(Core *core, bool cpu): core(core), cpu(cpu) {}
+
+        void syncState(Savestate *state);
+
+        static void buildStub(uint8_t *bios, bool arm9);
+        int execute(uint8_t comment, bool thumb, uint32_t **registers);
+
+    private:
+        Core *core;
+        bool cpu;
+
+        // Interrupt waits run the SWI again after each interrupt until the flags they want are set
+        // While waiting, the old flags are only discarded on the first run
+        bool waiting = false;
+
+        uint32_t readPage = 1;
+        uint8_t *readData = nullptr;
+
+        int halt();
+        int intrWait(bool discard, uint32_t mask, bool thumb, uint32_t **registers);
+        int divide(bool swap, uint32_t **registers);
+        int squareRoot(uint32_t **registers);
+        int cpuSet(uint32_t **registers);
+        int cpuFastSet(uint32_t **registers);
+        int lz77Uncomp(bool vram, uint32_t **registers);
+        int huffUncomp(uint32_t **registers);
+        int rlUncomp(bool vram, uint32_t **registers);
+
+        uint8_t readByte(uint32_t address);
+        uint32_t readWord(uint32_t address);
+        void transfer(uint32_t dst, uint32_t src, uint32_t size, int unit, bool fixed);
+        void writeOutput(uint32_t dst, const uint8_t *data, uint32_t size, int unit);
+};
+
+#endif // HLE_BIOS_H
@@ -20,32 +20,65 @@
 #include "input.h"
 #include "core.h"
 
+void Input::syncState(Savestate *state)
+{
+    // Sync the key registers
+    state->sync(keyInput);
+    state->sync(extKeyIn);
+}
+
 void Input::pressKey(int key)
 {
     // Clear key bits to indicate presses
     if (key < 10) // A, B, select, start, right, left, up, down, R, L
-        keyInput &= ~BIT(key);
+        heldKeyInput &= ~BIT(key);
     else if (key < 12) // X, Y
-        extKeyIn &= ~BIT(key - 10);
+        heldExtKeyIn &= ~BIT(key - 10);
+
+    if (!core->movie.isActive())
+        latch();
 }
 
 void Input::releaseKey(int key)
 {
     // Set key bits to indicate releases
     if (key < 10) // A, B, select, start, right, left, up, down, R, L
-        keyInput |= BIT(key);
+        heldKeyInput |= BIT(key);
     else if (key < 12) // X, Y
-        extKeyIn |= BIT(key - 10);
+        heldExtKeyIn |= BIT(key - 10);
+
+    if (!core->movie.isActive())
+        latch();
 }
 
 void Input::pressScreen()
 {
     // Clear the pen down bit to indicate a touch press
-    extKeyIn &= ~BIT(6);
+    heldExtKeyIn &= ~BIT(6);
+
+    if (!core->movie.isActive())
+        latch();
 }
 
 void Input::releaseScreen()
 {
     // Set the pen down bit to indicate a touch release
-    extKeyIn |= BIT(6);
+    heldExtKeyIn |= BIT(6);
+
+    if (!core->movie.isActive())
+        latch();
+}
+
+void Input::latch()
+{
+    // Apply the input held from the frontend
+    keyInput = heldKeyInput;
+    extKeyIn = heldExtKeyIn;
+}
+
+void Input::setKeys(uint16_t keyInput, uint16_t extKeyIn)
+{
+    // Set the key registers directly, as done when replaying a movie
+    this->keyInput = keyInput;
+    this->extKeyIn = extKeyIn;
 }
@@ -20,28 +20,49 @@
 #ifndef INPUT_H
 #define INPUT_H
 
+#include <atomic>
 #include <cstdint>
+#include <functional>
 
 class Core;
+class Savestate;
 
 class Input
 {
     public:
         Input(Core *core): core(core) {}
 
+        void syncState(Savestate *state);
+
         void pressKey(int key);
         void releaseKey(int key);
         void pressScreen();
         void releaseScreen();
 
-        uint16_t readKeyInput() { return keyInput; }
-        uint16_t readExtKeyIn() { return extKeyIn; }
+        void latch();
+        void setKeys(uint16_t keyInput, uint16_t extKeyIn);
+
+        void setPollCallback(std::function<void()> callback) { pollCallback = callback; }
+        void startFrame() { polled = false; }
+        void poll() { if (pollCallback && !polled && !polled.exchange(true)) pollCallback(); }
+
+        uint16_t readKeyInput() { poll(); return keyInput; }
+        uint16_t readExtKeyIn() { poll(); return extKeyIn; }
 
     private:
         Core *core;
 
         uint16_t keyInput = 0x03FF;
         uint16_t extKeyIn = 0x007F;
+
+        // The frontend's input is held here, and only applied right away if a movie isn't waiting for the next frame
+        uint16_t heldKeyInput = 0x03FF;
+        uint16_t heldExtKeyIn = 0x007F;
+
+        // Frontends can sample their input when the game first reads it each frame, instead of before the frame starts
+        // The callback runs on the emulator thread (or the ARM7 thread if it's separate), and should press and release keys
+        std::function<void()> pollCallback;
+        std::atomic<bool> polled { false };
 };
 
 #endif // INPUT_H
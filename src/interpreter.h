@@ -20,27 +20,44 @@
 #ifndef INTERPRETER_H
 #define INTERPRETER_H
 
+#include <atomic>
 #include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 #include "defines.h"
+#include "call_blocks.h"
+#include "memory.h"
 
 class Core;
+class Savestate;
 
 class Interpreter
 {
     public:
         Interpreter(Core *core, bool cpu);
 
+        void syncState(Savestate *state);
+
         void directBoot();
         void enterGbaMode();
 
-        void runOpcode();
+        int runOpcode();
+        int runBlock(uint32_t limit, uint32_t *opcodes);
+        uint32_t getBlockCycles() { return blockTotal; }
+
+        bool initCallBlocks();
+        void invalidateBlocks(int page);
+        void invalidateFetch() { fetchPage = 1; }
 
         void halt(int bit)   { halted |=  BIT(bit); }
         void unhalt(int bit) { halted &= ~BIT(bit); }
         void sendInterrupt(int bit);
 
-        bool shouldRun() { return !halted; }
+        void wakeIdle() { idleValid.store(false, std::memory_order_relaxed); }
+        uint32_t takeIdleCount() { return idleCount.exchange(0, std::memory_order_relaxed); }
+
+        bool shouldRun() { return !halted && !(idle && idleValid); }
 
         uint8_t  readIme()     { return ime;     }
         uint32_t readIe()      { return ie;      }
@@ -67,12 +84,108 @@ class Interpreter
         uint32_t cpsr = 0, *spsr = nullptr;
         uint32_t spsrFiq = 0, spsrSvc = 0, spsrAbt = 0, spsrIrq = 0, spsrUnd = 0;
 
-        uint8_t halted = 0;
+        // Interrupts and wakes can come from the other CPU's thread when the ARM7 is threaded, so those parts are atomic
+        // An idle loop halt only holds while its state is valid, and a wake just clears that, so the CPU can't miss one
+        // between deciding it's idle and halting; the idle flag itself is only changed by the CPU's own thread
+        std::atomic<uint8_t> halted { 0 };
+        bool idle = false;
+        std::atomic<bool> idleValid { false };
+
+        bool idleLoops = false;
+        uint32_t idleState[17] = {};
+        std::atomic<uint32_t> idleCount { 0 };
+
+        bool hleBios = false;
 
         uint8_t ime = 0;
-        uint32_t ie = 0, irf = 0;
+        uint32_t ie = 0;
+        std::atomic<uint32_t> irf { 0 };
         uint8_t postFlg = 0;
 
+        // When memory timing is modeled, each opcode counts its base cycles plus the stalls of its fetch and data accesses
+        // Accesses are sequential if they follow the previous one of the same kind
+        int timing = 0;
+        int cycles = 0;
+        uint32_t nextFetch = 0, nextAccess = 0;
+
+        // Opcodes are fetched through a host pointer to the current code page, if it's in the fast memory map
+        // The page is looked up again when the PC leaves it or the memory map changes; 1 never matches a page
+        uint8_t *fetchData = nullptr;
+        uint32_t fetchPage = 1;
+
+        CallBlocks callBlocks;
+        std::unordered_map<uintptr_t, void*> blocks;
+        std::vector<uintptr_t> pageBlocks[CODE_PAGES];
+        bool blocksInvalid = false;
+        uint32_t blockBudget = 0, blockTotal = 0;
+
+        typedef int (*Instruction)(Interpreter *interp, uint32_t opcode);
+        static Instruction armInstrs[0x1000];
+        static Instruction thumbInstrs[0x100];
+
+        template <int (Interpreter::*op)(uint32_t)> static int instr(Interpreter *interp, uint32_t opcode);
+        template <int (Interpreter::*op)(uint32_t, uint32_t), uint32_t (Interpreter::*op2)(uint32_t), bool neg = false>
+        static int instr(Interpreter *interp, uint32_t opcode);
+        template <int i> static int thumbInstr(Interpreter *interp, uint32_t opcode);
+
+        static Instruction lookupArm(uint16_t index);
+        static bool buildTables();
+        static int armB(Interpreter *interp, uint32_t opcode);
+        static int armBl(Interpreter *interp, uint32_t opcode);
+        static int unknownArm(Interpreter *interp, uint32_t opcode);
+
+        static CallBlocks::Call armCalls[0x10];
+        static CallBlocks::Call armImmCalls[0x20];
+        static CallBlocks::Call thumbCalls[0x100];
+
+        template <int i> struct CallTable;
+        template <int i> static bool armCall(void *interpreter, const CallBlocks::Operands *ops);
+        template <int i> static bool thumbCall(void *interpreter, const CallBlocks::Operands *ops);
+        template <int (Interpreter::*op)(uint32_t, uint32_t)>
+        static bool armImmCall(void *interpreter, const CallBlocks::Operands *ops);
+        template <int (Interpreter::*op)(uint8_t, uint8_t, uint32_t)>
+        static bool thumbImmCall(void *interpreter, const CallBlocks::Operands *ops);
+        template <int (Interpreter::*op)(uint8_t, uint8_t, uint32_t)>
+        static bool thumbRegCall(void *interpreter, const CallBlocks::Operands *ops);
+
+        static CallBlocks::Call decodeArm(uint32_t opcode, CallBlocks::Operands *ops);
+        static CallBlocks::Call decodeThumb(uint16_t opcode, CallBlocks::Operands *ops);
+
+        template <typename T> T fetch(uint32_t address);
+        int fetchCycles(uint32_t address, int size);
+        int accessCycles(uint32_t address, int size, bool write);
+
+        int multiplyCycles(uint32_t value, bool sign);
+        int blockCycles(uint16_t list, bool load);
+
+        int runArmOpcode(uint32_t opcode, uint16_t index);
+        int runThumbOpcode(uint16_t opcode, uint8_t index);
+
+        void *compileBlock(uint8_t *code, uint32_t address, bool thumb);
+        void flushBlocks();
+
+        static bool endsBlockArm(uint32_t opcode);
+        static bool endsBlockThumb(uint16_t opcode);
+
+        bool continueBlock(uint32_t pc, bool thumb, int base)
+        {
+            // Count the cycles of the opcode that just ran, the same way the interpreter does
+            blockTotal += timing ? (base + cycles) : 1;
+
+            // Continue a block only if the PC and mode didn't change, nothing else needs attention, and the next task isn't due
+            return blockTotal < blockBudget && *registers[15] == pc && (bool)(cpsr & BIT(5)) == thumb && !halted && !(idle && idleValid) && !blocksInvalid &&
+                !(ime && (ie & irf) && !(cpsr & BIT(7)));
+        }
+
+        void checkIdle(uint32_t offset)
+        {
+            // Look for an idle loop when a short backward branch is taken
+            if (idleLoops && offset >= 0xFFFFFFB8)
+                detectIdle();
+        }
+
+        void detectIdle();
+
         bool condition(uint32_t opcode);
         void setMode(uint8_t mode);
 
@@ -95,102 +208,112 @@ class Interpreter
         uint32_t rrrS(uint32_t opcode);
         uint32_t immS(uint32_t opcode);
 
-        void _and(uint32_t opcode, uint32_t op2);
-        void eor(uint32_t opcode, uint32_t op2);
-        void sub(uint32_t opcode, uint32_t op2);
-        void rsb(uint32_t opcode, uint32_t op2);
-        void add(uint32_t opcode, uint32_t op2);
-        void adc(uint32_t opcode, uint32_t op2);
-        void sbc(uint32_t opcode, uint32_t op2);
-        void rsc(uint32_t opcode, uint32_t op2);
-        void tst(uint32_t opcode, uint32_t op2);
-        void teq(uint32_t opcode, uint32_t op2);
-        void cmp(uint32_t opcode, uint32_t op2);
-        void cmn(uint32_t opcode, uint32_t op2);
-        void orr(uint32_t opcode, uint32_t op2);
-        void mov(uint32_t opcode, uint32_t op2);
-        void bic(uint32_t opcode, uint32_t op2);
-        void mvn(uint32_t opcode, uint32_t op2);
-        void ands(uint32_t opcode, uint32_t op2);
-        void eors(uint32_t opcode, uint32_t op2);
-        void subs(uint32_t opcode, uint32_t op2);
-        void rsbs(uint32_t opcode, uint32_t op2);
-        void adds(uint32_t opcode, uint32_t op2);
-        void adcs(uint32_t opcode, uint32_t op2);
-        void sbcs(uint32_t opcode, uint32_t op2);
-        void rscs(uint32_t opcode, uint32_t op2);
-        void orrs(uint32_t opcode, uint32_t op2);
-        void movs(uint32_t opcode, uint32_t op2);
-        void bics(uint32_t opcode, uint32_t op2);
-        void mvns(uint32_t opcode, uint32_t op2);
-
-        void mul(uint32_t opcode);
-        void mla(uint32_t opcode);
-        void umull(uint32_t opcode);
-        void umlal(uint32_t opcode);
-        void smull(uint32_t opcode);
-        void smlal(uint32_t opcode);
-        void muls(uint32_t opcode);
-        void mlas(uint32_t opcode);
-        void umulls(uint32_t opcode);
-        void umlals(uint32_t opcode);
-        void smulls(uint32_t opcode);
-        void smlals(uint32_t opcode);
-        void smulbb(uint32_t opcode);
-        void smulbt(uint32_t opcode);
-        void smultb(uint32_t opcode);
-        void smultt(uint32_t opcode);
-        void smulwb(uint32_t opcode);
-        void smulwt(uint32_t opcode);
-        void smlabb(uint32_t opcode);
-        void smlabt(uint32_t opcode);
-        void smlatb(uint32_t opcode);
-        void smlatt(uint32_t opcode);
-        void smlawb(uint32_t opcode);
-        void smlawt(uint32_t opcode);
-        void smlalbb(uint32_t opcode);
-        void smlalbt(uint32_t opcode);
-        void smlaltb(uint32_t opcode);
-        void smlaltt(uint32_t opcode);
-        void qadd(uint32_t opcode);
-        void qsub(uint32_t opcode);
-        void qdadd(uint32_t opcode);
-        void qdsub(uint32_t opcode);
-        void clz(uint32_t opcode);
-
-        void addRegT(uint16_t opcode);
-        void subRegT(uint16_t opcode);
-        void addHT(uint16_t opcode);
-        void cmpHT(uint16_t opcode);
-        void movHT(uint16_t opcode);
-        void addPcT(uint16_t opcode);
-        void addSpT(uint16_t opcode);
-        void addSpImmT(uint16_t opcode);
-        void lslImmT(uint16_t opcode);
-        void lsrImmT(uint16_t opcode);
-        void asrImmT(uint16_t opcode);
-        void addImm3T(uint16_t opcode);
-        void subImm3T(uint16_t opcode);
-        void addImm8T(uint16_t opcode);
-        void subImm8T(uint16_t opcode);
-        void cmpImm8T(uint16_t opcode);
-        void movImm8T(uint16_t opcode);
-        void lslDpT(uint16_t opcode);
-        void lsrDpT(uint16_t opcode);
-        void asrDpT(uint16_t opcode);
-        void rorDpT(uint16_t opcode);
-        void andDpT(uint16_t opcode);
-        void eorDpT(uint16_t opcode);
-        void adcDpT(uint16_t opcode);
-        void sbcDpT(uint16_t opcode);
-        void tstDpT(uint16_t opcode);
-        void cmpDpT(uint16_t opcode);
-        void cmnDpT(uint16_t opcode);
-        void orrDpT(uint16_t opcode);
-        void bicDpT(uint16_t opcode);
-        void mvnDpT(uint16_t opcode);
-        void negDpT(uint16_t opcode);
-        void mulDpT(uint16_t opcode);
+        int _and(uint32_t opcode, uint32_t op2);
+        int eor(uint32_t opcode, uint32_t op2);
+        int sub(uint32_t opcode, uint32_t op2);
+        int rsb(uint32_t opcode, uint32_t op2);
+        int add(uint32_t opcode, uint32_t op2);
+        int adc(uint32_t opcode, uint32_t op2);
+        int sbc(uint32_t opcode, uint32_t op2);
+        int rsc(uint32_t opcode, uint32_t op2);
+        int tst(uint32_t opcode, uint32_t op2);
+        int teq(uint32_t opcode, uint32_t op2);
+        int cmp(uint32_t opcode, uint32_t op2);
+        int cmn(uint32_t opcode, uint32_t op2);
+        int orr(uint32_t opcode, uint32_t op2);
+        int mov(uint32_t opcode, uint32_t op2);
+        int bic(uint32_t opcode, uint32_t op2);
+        int mvn(uint32_t opcode, uint32_t op2);
+        int ands(uint32_t opcode, uint32_t op2);
+        int eors(uint32_t opcode, uint32_t op2);
+        int subs(uint32_t opcode, uint32_t op2);
+        int rsbs(uint32_t opcode, uint32_t op2);
+        int adds(uint32_t opcode, uint32_t op2);
+        int adcs(uint32_t opcode, uint32_t op2);
+        int sbcs(uint32_t opcode, uint32_t op2);
+        int rscs(uint32_t opcode, uint32_t op2);
+        int orrs(uint32_t opcode, uint32_t op2);
+        int movs(uint32_t opcode, uint32_t op2);
+        int bics(uint32_t opcode, uint32_t op2);
+        int mvns(uint32_t opcode, uint32_t op2);
+
+        int mul(uint32_t opcode);
+        int mla(uint32_t opcode);
+        int umull(uint32_t opcode);
+        int umlal(uint32_t opcode);
+        int smull(uint32_t opcode);
+        int smlal(uint32_t opcode);
+        int muls(uint32_t opcode);
+        int mlas(uint32_t opcode);
+        int umulls(uint32_t opcode);
+        int umlals(uint32_t opcode);
+        int smulls(uint32_t opcode);
+        int smlals(uint32_t opcode);
+        int smulbb(uint32_t opcode);
+        int smulbt(uint32_t opcode);
+        int smultb(uint32_t opcode);
+        int smultt(uint32_t opcode);
+        int smulwb(uint32_t opcode);
+        int smulwt(uint32_t opcode);
+        int smlabb(uint32_t opcode);
+        int smlabt(uint32_t opcode);
+        int smlatb(uint32_t opcode);
+        int smlatt(uint32_t opcode);
+        int smlawb(uint32_t opcode);
+        int smlawt(uint32_t opcode);
+        int smlalbb(uint32_t opcode);
+        int smlalbt(uint32_t opcode);
+        int smlaltb(uint32_t opcode);
+        int smlaltt(uint32_t opcode);
+        int qadd(uint32_t opcode);
+        int qsub(uint32_t opcode);
+        int qdadd(uint32_t opcode);
+        int qdsub(uint32_t opcode);
+        int clz(uint32_t opcode);
+
+        int addRegT(uint16_t opcode);
+        int subRegT(uint16_t opcode);
+        int addHT(uint16_t opcode);
+        int cmpHT(uint16_t opcode);
+        int movHT(uint16_t opcode);
+        int addPcT(uint16_t opcode);
+        int addSpT(uint16_t opcode);
+        int addSpImmT(uint16_t opcode);
+        int lslImmT(uint16_t opcode);
+        int lsrImmT(uint16_t opcode);
+        int asrImmT(uint16_t opcode);
+        int addImm3T(uint16_t opcode);
+        int subImm3T(uint16_t opcode);
+        int addImm8T(uint16_t opcode);
+        int subImm8T(uint16_t opcode);
+        int cmpImm8T(uint16_t opcode);
+        int movImm8T(uint16_t opcode);
+        int lslDpT(uint16_t opcode);
+        int lsrDpT(uint16_t opcode);
+        int asrDpT(uint16_t opcode);
+        int rorDpT(uint16_t opcode);
+        int andDpT(uint16_t opcode);
+        int eorDpT(uint16_t opcode);
+        int adcDpT(uint16_t opcode);
+        int sbcDpT(uint16_t opcode);
+        int tstDpT(uint16_t opcode);
+        int cmpDpT(uint16_t opcode);
+        int cmnDpT(uint16_t opcode);
+        int orrDpT(uint16_t opcode);
+        int bicDpT(uint16_t opcode);
+        int mvnDpT(uint16_t opcode);
+        int negDpT(uint16_t opcode);
+        int mulDpT(uint16_t opcode);
+        int addT(uint8_t rd, uint8_t rs, uint32_t op2);
+        int subT(uint8_t rd, uint8_t rs, uint32_t op2);
+        int cmpT(uint8_t rd, uint8_t rs, uint32_t op2);
+        int movT(uint8_t rd, uint8_t rs, uint32_t op2);
+        int lslT(uint8_t rd, uint8_t rs, uint32_t op2);
+        int lsrT(uint8_t rd, uint8_t rs, uint32_t op2);
+        int asrT(uint8_t rd, uint8_t rs, uint32_t op2);
+
+        template <typename T> T read(uint32_t address);
+        template <typename T> void write(uint32_t address, T value);
 
         uint32_t ip(uint32_t opcode);
         uint32_t ipH(uint32_t opcode);
@@ -200,132 +323,138 @@ class Interpreter
         uint32_t rpar(uint32_t opcode);
         uint32_t rprr(uint32_t opcode);
 
-        void ldrsbOf(uint32_t opcode, uint32_t op2);
-        void ldrshOf(uint32_t opcode, uint32_t op2);
-        void ldrbOf(uint32_t opcode, uint32_t op2);
-        void strbOf(uint32_t opcode, uint32_t op2);
-        void ldrhOf(uint32_t opcode, uint32_t op2);
-        void strhOf(uint32_t opcode, uint32_t op2);
-        void ldrOf(uint32_t opcode, uint32_t op2);
-        void strOf(uint32_t opcode, uint32_t op2);
-        void ldrdOf(uint32_t opcode, uint32_t op2);
-        void strdOf(uint32_t opcode, uint32_t op2);
-        void ldrsbPr(uint32_t opcode, uint32_t op2);
-        void ldrshPr(uint32_t opcode, uint32_t op2);
-        void ldrbPr(uint32_t opcode, uint32_t op2);
-        void strbPr(uint32_t opcode, uint32_t op2);
-        void ldrhPr(uint32_t opcode, uint32_t op2);
-        void strhPr(uint32_t opcode, uint32_t op2);
-        void ldrPr(uint32_t opcode, uint32_t op2);
-        void strPr(uint32_t opcode, uint32_t op2);
-        void ldrdPr(uint32_t opcode, uint32_t op2);
-        void strdPr(uint32_t opcode, uint32_t op2);
-        void ldrsbPt(uint32_t opcode, uint32_t op2);
-        void ldrshPt(uint32_t opcode, uint32_t op2);
-        void ldrbPt(uint32_t opcode, uint32_t op2);
-        void strbPt(uint32_t opcode, uint32_t op2);
-        void ldrhPt(uint32_t opcode, uint32_t op2);
-        void strhPt(uint32_t opcode, uint32_t op2);
-        void ldrPt(uint32_t opcode, uint32_t op2);
-        void strPt(uint32_t opcode, uint32_t op2);
-        void ldrdPt(uint32_t opcode, uint32_t op2);
-        void strdPt(uint32_t opcode, uint32_t op2);
-
-        void swpb(uint32_t opcode);
-        void swp(uint32_t opcode);
-        void ldmda(uint32_t opcode);
-        void stmda(uint32_t opcode);
-        void ldmia(uint32_t opcode);
-        void stmia(uint32_t opcode);
-        void ldmdb(uint32_t opcode);
-        void stmdb(uint32_t opcode);
-        void ldmib(uint32_t opcode);
-        void stmib(uint32_t opcode);
-        void ldmdaW(uint32_t opcode);
-        void stmdaW(uint32_t opcode);
-        void ldmiaW(uint32_t opcode);
-        void stmiaW(uint32_t opcode);
-        void ldmdbW(uint32_t opcode);
-        void stmdbW(uint32_t opcode);
-        void ldmibW(uint32_t opcode);
-        void stmibW(uint32_t opcode);
-        void ldmdaU(uint32_t opcode);
-        void stmdaU(uint32_t opcode);
-        void ldmiaU(uint32_t opcode);
-        void stmiaU(uint32_t opcode);
-        void ldmdbU(uint32_t opcode);
-        void stmdbU(uint32_t opcode);
-        void ldmibU(uint32_t opcode);
-        void stmibU(uint32_t opcode);
-        void ldmdaUW(uint32_t opcode);
-        void stmdaUW(uint32_t opcode);
-        void ldmiaUW(uint32_t opcode);
-        void stmiaUW(uint32_t opcode);
-        void ldmdbUW(uint32_t opcode);
-        void stmdbUW(uint32_t opcode);
-        void ldmibUW(uint32_t opcode);
-        void stmibUW(uint32_t opcode);
-        void msrRc(uint32_t opcode);
-        void msrRs(uint32_t opcode);
-        void msrIc(uint32_t opcode);
-        void msrIs(uint32_t opcode);
-        void mrsRc(uint32_t opcode);
-        void mrsRs(uint32_t opcode);
-        void mrc(uint32_t opcode);
-        void mcr(uint32_t opcode);
-
-        void ldrsbRegT(uint16_t opcode);
-        void ldrshRegT(uint16_t opcode);
-        void ldrbRegT(uint16_t opcode);
-        void strbRegT(uint16_t opcode);
-        void ldrhRegT(uint16_t opcode);
-        void strhRegT(uint16_t opcode);
-        void ldrRegT(uint16_t opcode);
-        void strRegT(uint16_t opcode);
-        void ldrbImm5T(uint16_t opcode);
-        void strbImm5T(uint16_t opcode);
-        void ldrhImm5T(uint16_t opcode);
-        void strhImm5T(uint16_t opcode);
-        void ldrImm5T(uint16_t opcode);
-        void strImm5T(uint16_t opcode);
-        void ldrPcT(uint16_t opcode);
-        void ldrSpT(uint16_t opcode);
-        void strSpT(uint16_t opcode);
-        void ldmiaT(uint16_t opcode);
-        void stmiaT(uint16_t opcode);
-        void popT(uint16_t opcode);
-        void pushT(uint16_t opcode);
-        void popPcT(uint16_t opcode);
-        void pushLrT(uint16_t opcode);
-
-        void bx(uint32_t opcode);
-        void blxReg(uint32_t opcode);
-        void b(uint32_t opcode);
-        void bl(uint32_t opcode);
-        void blx(uint32_t opcode);
-        void swi();
-
-        void bxRegT(uint16_t opcode);
-        void blxRegT(uint16_t opcode);
-        void bT(uint16_t opcode);
-        void beqT(uint16_t opcode);
-        void bneT(uint16_t opcode);
-        void bcsT(uint16_t opcode);
-        void bccT(uint16_t opcode);
-        void bmiT(uint16_t opcode);
-        void bplT(uint16_t opcode);
-        void bvsT(uint16_t opcode);
-        void bvcT(uint16_t opcode);
-        void bhiT(uint16_t opcode);
-        void blsT(uint16_t opcode);
-        void bgeT(uint16_t opcode);
-        void bltT(uint16_t opcode);
-        void bgtT(uint16_t opcode);
-        void bleT(uint16_t opcode);
-        void blSetupT(uint16_t opcode);
-        void blOffT(uint16_t opcode);
-        void blxOffT(uint16_t opcode);
-        void swiT();
+        int ldrsbOf(uint32_t opcode, uint32_t op2);
+        int ldrshOf(uint32_t opcode, uint32_t op2);
+        int ldrbOf(uint32_t opcode, uint32_t op2);
+        int strbOf(uint32_t opcode, uint32_t op2);
+        int ldrhOf(uint32_t opcode, uint32_t op2);
+        int strhOf(uint32_t opcode, uint32_t op2);
+        int ldrOf(uint32_t opcode, uint32_t op2);
+        int strOf(uint32_t opcode, uint32_t op2);
+        int ldrdOf(uint32_t opcode, uint32_t op2);
+        int strdOf(uint32_t opcode, uint32_t op2);
+        int ldrsbPr(uint32_t opcode, uint32_t op2);
+        int ldrshPr(uint32_t opcode, uint32_t op2);
+        int ldrbPr(uint32_t opcode, uint32_t op2);
+        int strbPr(uint32_t opcode, uint32_t op2);
+        int ldrhPr(uint32_t opcode, uint32_t op2);
+        int strhPr(uint32_t opcode, uint32_t op2);
+        int ldrPr(uint32_t opcode, uint32_t op2);
+        int strPr(uint32_t opcode, uint32_t op2);
+        int ldrdPr(uint32_t opcode, uint32_t op2);
+        int strdPr(uint32_t opcode, uint32_t op2);
+        int ldrsbPt(uint32_t opcode, uint32_t op2);
+        int ldrshPt(uint32_t opcode, uint32_t op2);
+        int ldrbPt(uint32_t opcode, uint32_t op2);
+        int strbPt(uint32_t opcode, uint32_t op2);
+        int ldrhPt(uint32_t opcode, uint32_t op2);
+        int strhPt(uint32_t opcode, uint32_t op2);
+        int ldrPt(uint32_t opcode, uint32_t op2);
+        int strPt(uint32_t opcode, uint32_t op2);
+        int ldrdPt(uint32_t opcode, uint32_t op2);
+        int strdPt(uint32_t opcode, uint32_t op2);
+
+        int swpb(uint32_t opcode);
+        int swp(uint32_t opcode);
+        int ldmda(uint32_t opcode);
+        int stmda(uint32_t opcode);
+        int ldmia(uint32_t opcode);
+        int stmia(uint32_t opcode);
+        int ldmdb(uint32_t opcode);
+        int stmdb(uint32_t opcode);
+        int ldmib(uint32_t opcode);
+        int stmib(uint32_t opcode);
+        int ldmdaW(uint32_t opcode);
+        int stmdaW(uint32_t opcode);
+        int ldmiaW(uint32_t opcode);
+        int stmiaW(uint32_t opcode);
+        int ldmdbW(uint32_t opcode);
+        int stmdbW(uint32_t opcode);
+        int ldmibW(uint32_t opcode);
+        int stmibW(uint32_t opcode);
+        int ldmdaU(uint32_t opcode);
+        int stmdaU(uint32_t opcode);
+        int ldmiaU(uint32_t opcode);
+        int stmiaU(uint32_t opcode);
+        int ldmdbU(uint32_t opcode);
+        int stmdbU(uint32_t opcode);
+        int ldmibU(uint32_t opcode);
+        int stmibU(uint32_t opcode);
+        int ldmdaUW(uint32_t opcode);
+        int stmdaUW(uint32_t opcode);
+        int ldmiaUW(uint32_t opcode);
+        int stmiaUW(uint32_t opcode);
+        int ldmdbUW(uint32_t opcode);
+        int stmdbUW(uint32_t opcode);
+        int ldmibUW(uint32_t opcode);
+        int stmibUW(uint32_t opcode);
+        int msrRc(uint32_t opcode);
+        int msrRs(uint32_t opcode);
+        int msrIc(uint32_t opcode);
+        int msrIs(uint32_t opcode);
+        int mrsRc(uint32_t opcode);
+        int mrsRs(uint32_t opcode);
+        int mrc(uint32_t opcode);
+        int mcr(uint32_t opcode);
+
+        int ldrsbRegT(uint16_t opcode);
+        int ldrshRegT(uint16_t opcode);
+        int ldrbRegT(uint16_t opcode);
+        int strbRegT(uint16_t opcode);
+        int ldrhRegT(uint16_t opcode);
+        int strhRegT(uint16_t opcode);
+        int ldrRegT(uint16_t opcode);
+        int strRegT(uint16_t opcode);
+        int ldrbImm5T(uint16_t opcode);
+        int strbImm5T(uint16_t opcode);
+        int ldrhImm5T(uint16_t opcode);
+        int strhImm5T(uint16_t opcode);
+        int ldrImm5T(uint16_t opcode);
+        int strImm5T(uint16_t opcode);
+        int ldrPcT(uint16_t opcode);
+        int ldrSpT(uint16_t opcode);
+        int strSpT(uint16_t opcode);
+        int ldmiaT(uint16_t opcode);
+        int stmiaT(uint16_t opcode);
+        int popT(uint16_t opcode);
+        int pushT(uint16_t opcode);
+        int popPcT(uint16_t opcode);
+        int pushLrT(uint16_t opcode);
+        int ldrbT(uint8_t rd, uint8_t rb, uint32_t op2);
+        int strbT(uint8_t rd, uint8_t rb, uint32_t op2);
+        int ldrhT(uint8_t rd, uint8_t rb, uint32_t op2);
+        int strhT(uint8_t rd, uint8_t rb, uint32_t op2);
+        int ldrT(uint8_t rd, uint8_t rb, uint32_t op2);
+        int strT(uint8_t rd, uint8_t rb, uint32_t op2);
+
+        int bx(uint32_t opcode);
+        int blxReg(uint32_t opcode);
+        int b(uint32_t opcode);
+        int bl(uint32_t opcode);
+        int blx(uint32_t opcode);
+        int swi(uint32_t opcode);
+
+        int bxRegT(uint16_t opcode);
+        int blxRegT(uint16_t opcode);
+        int bT(uint16_t opcode);
+        int beqT(uint16_t opcode);
+        int bneT(uint16_t opcode);
+        int bcsT(uint16_t opcode);
+        int bccT(uint16_t opcode);
+        int bmiT(uint16_t opcode);
+        int bplT(uint16_t opcode);
+        int bvsT(uint16_t opcode);
+        int bvcT(uint16_t opcode);
+        int bhiT(uint16_t opcode);
+        int blsT(uint16_t opcode);
+        int bgeT(uint16_t opcode);
+        int bltT(uint16_t opcode);
+        int bgtT(uint16_t opcode);
+        int bleT(uint16_t opcode);
+        int blSetupT(uint16_t opcode);
+        int blOffT(uint16_t opcode);
+        int blxOffT(uint16_t opcode);
+        int swiT(uint16_t opcode);
 };
 
 #endif // INTERPRETER_H
@@ -274,7 +274,7 @@ FORCE_INLINE uint32_t Interpreter::immS(uint32_t opcode) // #i (S)
     return (value << (32 - shift)) | (value >> shift);
 }
 
-FORCE_INLINE void Interpreter::_and(uint32_t opcode, uint32_t op2) // AND Rd,Rn,op2
+FORCE_INLINE int Interpreter::_and(uint32_t opcode, uint32_t op2) // AND Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -287,9 +287,11 @@ FORCE_INLINE void Interpreter::_and(uint32_t opcode, uint32_t op2) // AND Rd,Rn,
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::eor(uint32_t opcode, uint32_t op2) // EOR Rd,Rn,op2
+FORCE_INLINE int Interpreter::eor(uint32_t opcode, uint32_t op2) // EOR Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -302,9 +304,11 @@ FORCE_INLINE void Interpreter::eor(uint32_t opcode, uint32_t op2) // EOR Rd,Rn,o
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::sub(uint32_t opcode, uint32_t op2) // SUB Rd,Rn,op2
+FORCE_INLINE int Interpreter::sub(uint32_t opcode, uint32_t op2) // SUB Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -317,9 +321,11 @@ FORCE_INLINE void Interpreter::sub(uint32_t opcode, uint32_t op2) // SUB Rd,Rn,o
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::rsb(uint32_t opcode, uint32_t op2) // RSB Rd,Rn,op2
+FORCE_INLINE int Interpreter::rsb(uint32_t opcode, uint32_t op2) // RSB Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -332,9 +338,11 @@ FORCE_INLINE void Interpreter::rsb(uint32_t opcode, uint32_t op2) // RSB Rd,Rn,o
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::add(uint32_t opcode, uint32_t op2) // ADD Rd,Rn,op2
+FORCE_INLINE int Interpreter::add(uint32_t opcode, uint32_t op2) // ADD Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -347,9 +355,11 @@ FORCE_INLINE void Interpreter::add(uint32_t opcode, uint32_t op2) // ADD Rd,Rn,o
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::adc(uint32_t opcode, uint32_t op2) // ADC Rd,Rn,op2
+FORCE_INLINE int Interpreter::adc(uint32_t opcode, uint32_t op2) // ADC Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -362,9 +372,11 @@ FORCE_INLINE void Interpreter::adc(uint32_t opcode, uint32_t op2) // ADC Rd,Rn,o
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::sbc(uint32_t opcode, uint32_t op2) // SBC Rd,Rn,op2
+FORCE_INLINE int Interpreter::sbc(uint32_t opcode, uint32_t op2) // SBC Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -377,9 +389,11 @@ FORCE_INLINE void Interpreter::sbc(uint32_t opcode, uint32_t op2) // SBC Rd,Rn,o
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::rsc(uint32_t opcode, uint32_t op2) // RSC Rd,Rn,op2
+FORCE_INLINE int Interpreter::rsc(uint32_t opcode, uint32_t op2) // RSC Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -392,9 +406,11 @@ FORCE_INLINE void Interpreter::rsc(uint32_t opcode, uint32_t op2) // RSC Rd,Rn,o
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::tst(uint32_t opcode, uint32_t op2) // TST Rn,op2
+FORCE_INLINE int Interpreter::tst(uint32_t opcode, uint32_t op2) // TST Rn,op2
 {
     // Decode the other operand
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -406,9 +422,11 @@ FORCE_INLINE void Interpreter::tst(uint32_t opcode, uint32_t op2) // TST Rn,op2
     // Set the flags
     if (res & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (res == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::teq(uint32_t opcode, uint32_t op2) // TEQ Rn,op2
+FORCE_INLINE int Interpreter::teq(uint32_t opcode, uint32_t op2) // TEQ Rn,op2
 {
     // Decode the other operand
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -420,9 +438,11 @@ FORCE_INLINE void Interpreter::teq(uint32_t opcode, uint32_t op2) // TEQ Rn,op2
     // Set the flags
     if (res & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (res == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::cmp(uint32_t opcode, uint32_t op2) // CMP Rn,op2
+FORCE_INLINE int Interpreter::cmp(uint32_t opcode, uint32_t op2) // CMP Rn,op2
 {
     // Decode the other operand
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -437,9 +457,11 @@ FORCE_INLINE void Interpreter::cmp(uint32_t opcode, uint32_t op2) // CMP Rn,op2
     if (op1 >= res)    cpsr |= BIT(29); else cpsr &= ~BIT(29);
     if ((op2 & BIT(31)) != (op1 & BIT(31)) && (res & BIT(31)) == (op2 & BIT(31)))
         cpsr |= BIT(28); else cpsr &= ~BIT(28);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::cmn(uint32_t opcode, uint32_t op2) // CMN Rn,op2
+FORCE_INLINE int Interpreter::cmn(uint32_t opcode, uint32_t op2) // CMN Rn,op2
 {
     // Decode the other operand
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -454,9 +476,11 @@ FORCE_INLINE void Interpreter::cmn(uint32_t opcode, uint32_t op2) // CMN Rn,op2
     if (op1 > res)     cpsr |= BIT(29); else cpsr &= ~BIT(29);
     if ((op2 & BIT(31)) == (op1 & BIT(31)) && (res & BIT(31)) != (op2 & BIT(31)))
         cpsr |= BIT(28); else cpsr &= ~BIT(28);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::orr(uint32_t opcode, uint32_t op2) // ORR Rd,Rn,op2
+FORCE_INLINE int Interpreter::orr(uint32_t opcode, uint32_t op2) // ORR Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -469,9 +493,11 @@ FORCE_INLINE void Interpreter::orr(uint32_t opcode, uint32_t op2) // ORR Rd,Rn,o
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::mov(uint32_t opcode, uint32_t op2) // MOV Rd,op2
+FORCE_INLINE int Interpreter::mov(uint32_t opcode, uint32_t op2) // MOV Rd,op2
 {
     // Decode the other operand
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -482,9 +508,11 @@ FORCE_INLINE void Interpreter::mov(uint32_t opcode, uint32_t op2) // MOV Rd,op2
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::bic(uint32_t opcode, uint32_t op2) // BIC Rd,Rn,op2
+FORCE_INLINE int Interpreter::bic(uint32_t opcode, uint32_t op2) // BIC Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -497,9 +525,11 @@ FORCE_INLINE void Interpreter::bic(uint32_t opcode, uint32_t op2) // BIC Rd,Rn,o
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::mvn(uint32_t opcode, uint32_t op2) // MVN Rd,op2
+FORCE_INLINE int Interpreter::mvn(uint32_t opcode, uint32_t op2) // MVN Rd,op2
 {
     // Decode the other operand
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -510,9 +540,11 @@ FORCE_INLINE void Interpreter::mvn(uint32_t opcode, uint32_t op2) // MVN Rd,op2
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::ands(uint32_t opcode, uint32_t op2) // ANDS Rd,Rn,op2
+FORCE_INLINE int Interpreter::ands(uint32_t opcode, uint32_t op2) // ANDS Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -530,7 +562,7 @@ FORCE_INLINE void Interpreter::ands(uint32_t opcode, uint32_t op2) // ANDS Rd,Rn
             cpsr = *spsr;
             setMode(cpsr);
             *registers[15] = (cpsr & BIT(5)) ? ((*registers[15] & ~1) + 2) : ((*registers[15] & ~3) + 4);
-            return;
+            return 3;
         }
 
         *registers[15] = (*registers[15] & ~3) + 4;
@@ -539,9 +571,11 @@ FORCE_INLINE void Interpreter::ands(uint32_t opcode, uint32_t op2) // ANDS Rd,Rn
     // Set the flags
     if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::eors(uint32_t opcode, uint32_t op2) // EORS Rd,Rn,op2
+FORCE_INLINE int Interpreter::eors(uint32_t opcode, uint32_t op2) // EORS Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -559,7 +593,7 @@ FORCE_INLINE void Interpreter::eors(uint32_t opcode, uint32_t op2) // EORS Rd,Rn
             cpsr = *spsr;
             setMode(cpsr);
             *registers[15] = (cpsr & BIT(5)) ? ((*registers[15] & ~1) + 2) : ((*registers[15] & ~3) + 4);
-            return;
+            return 3;
         }
 
         *registers[15] = (*registers[15] & ~3) + 4;
@@ -568,9 +602,11 @@ FORCE_INLINE void Interpreter::eors(uint32_t opcode, uint32_t op2) // EORS Rd,Rn
     // Set the flags
     if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::subs(uint32_t opcode, uint32_t op2) // SUBS Rd,Rn,op2
+FORCE_INLINE int Interpreter::subs(uint32_t opcode, uint32_t op2) // SUBS Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -588,7 +624,7 @@ FORCE_INLINE void Interpreter::subs(uint32_t opcode, uint32_t op2) // SUBS Rd,Rn
             cpsr = *spsr;
             setMode(cpsr);
             *registers[15] = (cpsr & BIT(5)) ? ((*registers[15] & ~1) + 2) : ((*registers[15] & ~3) + 4);
-            return;
+            return 3;
         }
 
         *registers[15] = (*registers[15] & ~3) + 4;
@@ -600,9 +636,11 @@ FORCE_INLINE void Interpreter::subs(uint32_t opcode, uint32_t op2) // SUBS Rd,Rn
     if (op1 >= *op0)    cpsr |= BIT(29); else cpsr &= ~BIT(29);
     if ((op2 & BIT(31)) != (op1 & BIT(31)) && (*op0 & BIT(31)) == (op2 & BIT(31)))
         cpsr |= BIT(28); else cpsr &= ~BIT(28);
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::rsbs(uint32_t opcode, uint32_t op2) // RSBS Rd,Rn,op2
+FORCE_INLINE int Interpreter::rsbs(uint32_t opcode, uint32_t op2) // RSBS Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -620,7 +658,7 @@ FORCE_INLINE void Interpreter::rsbs(uint32_t opcode, uint32_t op2) // RSBS Rd,Rn
             cpsr = *spsr;
             setMode(cpsr);
             *registers[15] = (cpsr & BIT(5)) ? ((*registers[15] & ~1) + 2) : ((*registers[15] & ~3) + 4);
-            return;
+            return 3;
         }
 
         *registers[15] = (*registers[15] & ~3) + 4;
@@ -632,9 +670,11 @@ FORCE_INLINE void Interpreter::rsbs(uint32_t opcode, uint32_t op2) // RSBS Rd,Rn
     if (op2 >= *op0)    cpsr |= BIT(29); else cpsr &= ~BIT(29);
     if ((op1 & BIT(31)) != (op2 & BIT(31)) && (*op0 & BIT(31)) == (op1 & BIT(31)))
         cpsr |= BIT(28); else cpsr &= ~BIT(28);
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::adds(uint32_t opcode, uint32_t op2) // ADDS Rd,Rn,op2
+FORCE_INLINE int Interpreter::adds(uint32_t opcode, uint32_t op2) // ADDS Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -652,7 +692,7 @@ FORCE_INLINE void Interpreter::adds(uint32_t opcode, uint32_t op2) // ADDS Rd,Rn
             cpsr = *spsr;
             setMode(cpsr);
             *registers[15] = (cpsr & BIT(5)) ? ((*registers[15] & ~1) + 2) : ((*registers[15] & ~3) + 4);
-            return;
+            return 3;
         }
 
         *registers[15] = (*registers[15] & ~3) + 4;
@@ -664,9 +704,11 @@ FORCE_INLINE void Interpreter::adds(uint32_t opcode, uint32_t op2) // ADDS Rd,Rn
     if (op1 > *op0)     cpsr |= BIT(29); else cpsr &= ~BIT(29);
     if ((op2 & BIT(31)) == (op1 & BIT(31)) && (*op0 & BIT(31)) != (op2 & BIT(31)))
         cpsr |= BIT(28); else cpsr &= ~BIT(28);
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::adcs(uint32_t opcode, uint32_t op2) // ADCS Rd,Rn,op2
+FORCE_INLINE int Interpreter::adcs(uint32_t opcode, uint32_t op2) // ADCS Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -684,7 +726,7 @@ FORCE_INLINE void Interpreter::adcs(uint32_t opcode, uint32_t op2) // ADCS Rd,Rn
             cpsr = *spsr;
             setMode(cpsr);
             *registers[15] = (cpsr & BIT(5)) ? ((*registers[15] & ~1) + 2) : ((*registers[15] & ~3) + 4);
-            return;
+            return 3;
         }
 
         *registers[15] = (*registers[15] & ~3) + 4;
@@ -696,9 +738,11 @@ FORCE_INLINE void Interpreter::adcs(uint32_t opcode, uint32_t op2) // ADCS Rd,Rn
     if (op1 > *op0 || (op2 == 0xFFFFFFFF && (cpsr & BIT(29)))) cpsr |= BIT(29); else cpsr &= ~BIT(29);
     if ((op2 & BIT(31)) == (op1 & BIT(31)) && (*op0 & BIT(31)) != (op2 & BIT(31)))
         cpsr |= BIT(28); else cpsr &= ~BIT(28);
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::sbcs(uint32_t opcode, uint32_t op2) // SBCS Rd,Rn,op2
+FORCE_INLINE int Interpreter::sbcs(uint32_t opcode, uint32_t op2) // SBCS Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -716,7 +760,7 @@ FORCE_INLINE void Interpreter::sbcs(uint32_t opcode, uint32_t op2) // SBCS Rd,Rn
             cpsr = *spsr;
             setMode(cpsr);
             *registers[15] = (cpsr & BIT(5)) ? ((*registers[15] & ~1) + 2) : ((*registers[15] & ~3) + 4);
-            return;
+            return 3;
         }
 
         *registers[15] = (*registers[15] & ~3) + 4;
@@ -728,9 +772,11 @@ FORCE_INLINE void Interpreter::sbcs(uint32_t opcode, uint32_t op2) // SBCS Rd,Rn
     if (op1 >= *op0 && (op2 != 0xFFFFFFFF || (cpsr & BIT(29)))) cpsr |= BIT(29); else cpsr &= ~BIT(29);
     if ((op2 & BIT(31)) != (op1 & BIT(31)) && (*op0 & BIT(31)) == (op2 & BIT(31)))
         cpsr |= BIT(28); else cpsr &= ~BIT(28);
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::rscs(uint32_t opcode, uint32_t op2) // RSCS Rd,Rn,op2
+FORCE_INLINE int Interpreter::rscs(uint32_t opcode, uint32_t op2) // RSCS Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -748,7 +794,7 @@ FORCE_INLINE void Interpreter::rscs(uint32_t opcode, uint32_t op2) // RSCS Rd,Rn
             cpsr = *spsr;
             setMode(cpsr);
             *registers[15] = (cpsr & BIT(5)) ? ((*registers[15] & ~1) + 2) : ((*registers[15] & ~3) + 4);
-            return;
+            return 3;
         }
 
         *registers[15] = (*registers[15] & ~3) + 4;
@@ -760,9 +806,11 @@ FORCE_INLINE void Interpreter::rscs(uint32_t opcode, uint32_t op2) // RSCS Rd,Rn
     if (op2 >= *op0 && (op1 != 0xFFFFFFFF || (cpsr & BIT(29)))) cpsr |= BIT(29); else cpsr &= ~BIT(29);
     if ((op1 & BIT(31)) != (op2 & BIT(31)) && (*op0 & BIT(31)) == (op1 & BIT(31)))
         cpsr |= BIT(28); else cpsr &= ~BIT(28);
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::orrs(uint32_t opcode, uint32_t op2) // ORRS Rd,Rn,op2
+FORCE_INLINE int Interpreter::orrs(uint32_t opcode, uint32_t op2) // ORRS Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -780,7 +828,7 @@ FORCE_INLINE void Interpreter::orrs(uint32_t opcode, uint32_t op2) // ORRS Rd,Rn
             cpsr = *spsr;
             setMode(cpsr);
             *registers[15] = (cpsr & BIT(5)) ? ((*registers[15] & ~1) + 2) : ((*registers[15] & ~3) + 4);
-            return;
+            return 3;
         }
 
         *registers[15] = (*registers[15] & ~3) + 4;
@@ -789,9 +837,11 @@ FORCE_INLINE void Interpreter::orrs(uint32_t opcode, uint32_t op2) // ORRS Rd,Rn
     // Set the flags
     if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::movs(uint32_t opcode, uint32_t op2) // MOVS Rd,op2
+FORCE_INLINE int Interpreter::movs(uint32_t opcode, uint32_t op2) // MOVS Rd,op2
 {
     // Decode the other operand
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -807,7 +857,7 @@ FORCE_INLINE void Interpreter::movs(uint32_t opcode, uint32_t op2) // MOVS Rd,op
             cpsr = *spsr;
             setMode(cpsr);
             *registers[15] = (cpsr & BIT(5)) ? ((*registers[15] & ~1) + 2) : ((*registers[15] & ~3) + 4);
-            return;
+            return 3;
         }
 
         *registers[15] = (*registers[15] & ~3) + 4;
@@ -816,9 +866,11 @@ FORCE_INLINE void Interpreter::movs(uint32_t opcode, uint32_t op2) // MOVS Rd,op
     // Set the flags
     if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::bics(uint32_t opcode, uint32_t op2) // BICS Rd,Rn,op2
+FORCE_INLINE int Interpreter::bics(uint32_t opcode, uint32_t op2) // BICS Rd,Rn,op2
 {
     // Decode the other operands
     // When used as Rn when shifting by register, the program counter is read with +4
@@ -836,7 +888,7 @@ FORCE_INLINE void Interpreter::bics(uint32_t opcode, uint32_t op2) // BICS Rd,Rn
             cpsr = *spsr;
             setMode(cpsr);
             *registers[15] = (cpsr & BIT(5)) ? ((*registers[15] & ~1) + 2) : ((*registers[15] & ~3) + 4);
-            return;
+            return 3;
         }
 
         *registers[15] = (*registers[15] & ~3) + 4;
@@ -845,9 +897,11 @@ FORCE_INLINE void Interpreter::bics(uint32_t opcode, uint32_t op2) // BICS Rd,Rn
     // Set the flags
     if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::mvns(uint32_t opcode, uint32_t op2) // MVNS Rd,op2
+FORCE_INLINE int Interpreter::mvns(uint32_t opcode, uint32_t op2) // MVNS Rd,op2
 {
     // Decode the other operand
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -863,7 +917,7 @@ FORCE_INLINE void Interpreter::mvns(uint32_t opcode, uint32_t op2) // MVNS Rd,op
             cpsr = *spsr;
             setMode(cpsr);
             *registers[15] = (cpsr & BIT(5)) ? ((*registers[15] & ~1) + 2) : ((*registers[15] & ~3) + 4);
-            return;
+            return 3;
         }
 
         *registers[15] = (*registers[15] & ~3) + 4;
@@ -872,9 +926,11 @@ FORCE_INLINE void Interpreter::mvns(uint32_t opcode, uint32_t op2) // MVNS Rd,op
     // Set the flags
     if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::mul(uint32_t opcode) // MUL Rd,Rm,Rs
+FORCE_INLINE int Interpreter::mul(uint32_t opcode) // MUL Rd,Rm,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x000F0000) >> 16];
@@ -883,9 +939,11 @@ FORCE_INLINE void Interpreter::mul(uint32_t opcode) // MUL Rd,Rm,Rs
 
     // Multiplication
     *op0 = op1 * op2;
+
+    return cpu ? (1 + multiplyCycles(op2, true)) : 2;
 }
 
-FORCE_INLINE void Interpreter::mla(uint32_t opcode) // MLA Rd,Rm,Rs,Rn
+FORCE_INLINE int Interpreter::mla(uint32_t opcode) // MLA Rd,Rm,Rs,Rn
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x000F0000) >> 16];
@@ -895,9 +953,11 @@ FORCE_INLINE void Interpreter::mla(uint32_t opcode) // MLA Rd,Rm,Rs,Rn
 
     // Multiplication and accumulate
     *op0 = op1 * op2 + op3;
+
+    return cpu ? (2 + multiplyCycles(op2, true)) : 2;
 }
 
-FORCE_INLINE void Interpreter::umull(uint32_t opcode) // UMULL RdLo,RdHi,Rm,Rs
+FORCE_INLINE int Interpreter::umull(uint32_t opcode) // UMULL RdLo,RdHi,Rm,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -909,9 +969,11 @@ FORCE_INLINE void Interpreter::umull(uint32_t opcode) // UMULL RdLo,RdHi,Rm,Rs
     uint64_t res = (uint64_t)op2 * op3;
     *op1 = res >> 32;
     *op0 = res;
+
+    return cpu ? (2 + multiplyCycles(op3, false)) : 3;
 }
 
-FORCE_INLINE void Interpreter::umlal(uint32_t opcode) // UMLAL RdLo,RdHi,Rm,Rs
+FORCE_INLINE int Interpreter::umlal(uint32_t opcode) // UMLAL RdLo,RdHi,Rm,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -924,9 +986,11 @@ FORCE_INLINE void Interpreter::umlal(uint32_t opcode) // UMLAL RdLo,RdHi,Rm,Rs
     res += ((uint64_t)*op1 << 32) | *op0;
     *op1 = res >> 32;
     *op0 = res;
+
+    return cpu ? (3 + multiplyCycles(op3, false)) : 3;
 }
 
-FORCE_INLINE void Interpreter::smull(uint32_t opcode) // SMULL RdLo,RdHi,Rm,Rs
+FORCE_INLINE int Interpreter::smull(uint32_t opcode) // SMULL RdLo,RdHi,Rm,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -939,9 +1003,11 @@ FORCE_INLINE void Interpreter::smull(uint32_t opcode) // SMULL RdLo,RdHi,Rm,Rs
     res *= (int32_t)op3;
     *op1 = res >> 32;
     *op0 = res;
+
+    return cpu ? (2 + multiplyCycles(op3, true)) : 3;
 }
 
-FORCE_INLINE void Interpreter::smlal(uint32_t opcode) // SMLAL RdLo,RdHi,Rm,Rs
+FORCE_INLINE int Interpreter::smlal(uint32_t opcode) // SMLAL RdLo,RdHi,Rm,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -955,9 +1021,11 @@ FORCE_INLINE void Interpreter::smlal(uint32_t opcode) // SMLAL RdLo,RdHi,Rm,Rs
     res += ((int64_t)*op1 << 32) | *op0;
     *op1 = res >> 32;
     *op0 = res;
+
+    return cpu ? (3 + multiplyCycles(op3, true)) : 3;
 }
 
-FORCE_INLINE void Interpreter::muls(uint32_t opcode) // MULS Rd,Rm,Rs
+FORCE_INLINE int Interpreter::muls(uint32_t opcode) // MULS Rd,Rm,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x000F0000) >> 16];
@@ -971,9 +1039,11 @@ FORCE_INLINE void Interpreter::muls(uint32_t opcode) // MULS Rd,Rm,Rs
     if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
     if (cpu == 1) cpsr &= ~BIT(29); // The carry flag is destroyed on ARM7
+
+    return cpu ? (1 + multiplyCycles(op2, true)) : 4;
 }
 
-FORCE_INLINE void Interpreter::mlas(uint32_t opcode) // MLAS Rd,Rm,Rs,Rn
+FORCE_INLINE int Interpreter::mlas(uint32_t opcode) // MLAS Rd,Rm,Rs,Rn
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x000F0000) >> 16];
@@ -988,9 +1058,11 @@ FORCE_INLINE void Interpreter::mlas(uint32_t opcode) // MLAS Rd,Rm,Rs,Rn
     if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
     if (cpu == 1) cpsr &= ~BIT(29); // The carry flag is destroyed on ARM7
+
+    return cpu ? (2 + multiplyCycles(op2, true)) : 4;
 }
 
-FORCE_INLINE void Interpreter::umulls(uint32_t opcode) // UMULLS RdLo,RdHi,Rm,Rs
+FORCE_INLINE int Interpreter::umulls(uint32_t opcode) // UMULLS RdLo,RdHi,Rm,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -1007,9 +1079,11 @@ FORCE_INLINE void Interpreter::umulls(uint32_t opcode) // UMULLS RdLo,RdHi,Rm,Rs
     if (*op1 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (*op1 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
     if (cpu == 1) cpsr &= ~BIT(29); // The carry flag is destroyed on ARM7
+
+    return cpu ? (2 + multiplyCycles(op3, false)) : 5;
 }
 
-FORCE_INLINE void Interpreter::umlals(uint32_t opcode) // UMLALS RdLo,RdHi,Rm,Rs
+FORCE_INLINE int Interpreter::umlals(uint32_t opcode) // UMLALS RdLo,RdHi,Rm,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -1027,9 +1101,11 @@ FORCE_INLINE void Interpreter::umlals(uint32_t opcode) // UMLALS RdLo,RdHi,Rm,Rs
     if (*op1 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (*op1 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
     if (cpu == 1) cpsr &= ~BIT(29); // The carry flag is destroyed on ARM7
+
+    return cpu ? (3 + multiplyCycles(op3, false)) : 5;
 }
 
-FORCE_INLINE void Interpreter::smulls(uint32_t opcode) // SMULLS RdLo,RdHi,Rm,Rs
+FORCE_INLINE int Interpreter::smulls(uint32_t opcode) // SMULLS RdLo,RdHi,Rm,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -1047,9 +1123,11 @@ FORCE_INLINE void Interpreter::smulls(uint32_t opcode) // SMULLS RdLo,RdHi,Rm,Rs
     if (*op1 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (*op1 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
     if (cpu == 1) cpsr &= ~BIT(29); // The carry flag is destroyed on ARM7
+
+    return cpu ? (2 + multiplyCycles(op3, true)) : 5;
 }
 
-FORCE_INLINE void Interpreter::smlals(uint32_t opcode) // SMLALS RdLo,RdHi,Rm,Rs
+FORCE_INLINE int Interpreter::smlals(uint32_t opcode) // SMLALS RdLo,RdHi,Rm,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -1068,11 +1146,13 @@ FORCE_INLINE void Interpreter::smlals(uint32_t opcode) // SMLALS RdLo,RdHi,Rm,Rs
     if (*op1 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (*op1 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
     if (cpu == 1) cpsr &= ~BIT(29); // The carry flag is destroyed on ARM7
+
+    return cpu ? (3 + multiplyCycles(op3, true)) : 5;
 }
 
-FORCE_INLINE void Interpreter::smulbb(uint32_t opcode) // SMULBB Rd,Rm,Rs
+FORCE_INLINE int Interpreter::smulbb(uint32_t opcode) // SMULBB Rd,Rm,Rs
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x000F0000) >> 16];
@@ -1081,11 +1161,13 @@ FORCE_INLINE void Interpreter::smulbb(uint32_t opcode) // SMULBB Rd,Rm,Rs
 
     // Signed half-word multiplication
     *op0 = op1 * op2;
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::smulbt(uint32_t opcode) // SMULBT Rd,Rm,Rs
+FORCE_INLINE int Interpreter::smulbt(uint32_t opcode) // SMULBT Rd,Rm,Rs
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x000F0000) >> 16];
@@ -1094,11 +1176,13 @@ FORCE_INLINE void Interpreter::smulbt(uint32_t opcode) // SMULBT Rd,Rm,Rs
 
     // Signed half-word multiplication
     *op0 = op1 * op2;
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::smultb(uint32_t opcode) // SMULTB Rd,Rm,Rs
+FORCE_INLINE int Interpreter::smultb(uint32_t opcode) // SMULTB Rd,Rm,Rs
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x000F0000) >> 16];
@@ -1107,11 +1191,13 @@ FORCE_INLINE void Interpreter::smultb(uint32_t opcode) // SMULTB Rd,Rm,Rs
 
     // Signed half-word multiplication
     *op0 = op1 * op2;
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::smultt(uint32_t opcode) // SMULTT Rd,Rm,Rs
+FORCE_INLINE int Interpreter::smultt(uint32_t opcode) // SMULTT Rd,Rm,Rs
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x000F0000) >> 16];
@@ -1120,11 +1206,13 @@ FORCE_INLINE void Interpreter::smultt(uint32_t opcode) // SMULTT Rd,Rm,Rs
 
     // Signed half-word multiplication
     *op0 = op1 * op2;
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::smulwb(uint32_t opcode) // SMULWB Rd,Rm,Rs
+FORCE_INLINE int Interpreter::smulwb(uint32_t opcode) // SMULWB Rd,Rm,Rs
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x000F0000) >> 16];
@@ -1133,11 +1221,13 @@ FORCE_INLINE void Interpreter::smulwb(uint32_t opcode) // SMULWB Rd,Rm,Rs
 
     // Signed word by half-word multiplication
     *op0 = ((int64_t)op1 * op2) >> 16;
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::smulwt(uint32_t opcode) // SMULWT Rd,Rm,Rs
+FORCE_INLINE int Interpreter::smulwt(uint32_t opcode) // SMULWT Rd,Rm,Rs
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x000F0000) >> 16];
@@ -1146,11 +1236,13 @@ FORCE_INLINE void Interpreter::smulwt(uint32_t opcode) // SMULWT Rd,Rm,Rs
 
     // Signed word by half-word multiplication
     *op0 = ((int64_t)op1 * op2) >> 16;
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::smlabb(uint32_t opcode) // SMLABB Rd,Rm,Rs,Rn
+FORCE_INLINE int Interpreter::smlabb(uint32_t opcode) // SMLABB Rd,Rm,Rs,Rn
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x000F0000) >> 16];
@@ -1164,11 +1256,13 @@ FORCE_INLINE void Interpreter::smlabb(uint32_t opcode) // SMLABB Rd,Rm,Rs,Rn
 
     // Set the Q flag
     if ((*op0 & BIT(31)) != (res & BIT(31))) cpsr |= BIT(27);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::smlabt(uint32_t opcode) // SMLABT Rd,Rm,Rs,Rn
+FORCE_INLINE int Interpreter::smlabt(uint32_t opcode) // SMLABT Rd,Rm,Rs,Rn
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x000F0000) >> 16];
@@ -1182,11 +1276,13 @@ FORCE_INLINE void Interpreter::smlabt(uint32_t opcode) // SMLABT Rd,Rm,Rs,Rn
 
     // Set the Q flag
     if ((*op0 & BIT(31)) != (res & BIT(31))) cpsr |= BIT(27);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::smlatb(uint32_t opcode) // SMLATB Rd,Rm,Rs,Rn
+FORCE_INLINE int Interpreter::smlatb(uint32_t opcode) // SMLATB Rd,Rm,Rs,Rn
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x000F0000) >> 16];
@@ -1200,11 +1296,13 @@ FORCE_INLINE void Interpreter::smlatb(uint32_t opcode) // SMLATB Rd,Rm,Rs,Rn
 
     // Set the Q flag
     if ((*op0 & BIT(31)) != (res & BIT(31))) cpsr |= BIT(27);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::smlatt(uint32_t opcode) // SMLATT Rd,Rm,Rs,Rn
+FORCE_INLINE int Interpreter::smlatt(uint32_t opcode) // SMLATT Rd,Rm,Rs,Rn
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x000F0000) >> 16];
@@ -1218,11 +1316,13 @@ FORCE_INLINE void Interpreter::smlatt(uint32_t opcode) // SMLATT Rd,Rm,Rs,Rn
 
     // Set the Q flag
     if ((*op0 & BIT(31)) != (res & BIT(31))) cpsr |= BIT(27);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::smlawb(uint32_t opcode) // SMLAWB Rd,Rm,Rs,Rn
+FORCE_INLINE int Interpreter::smlawb(uint32_t opcode) // SMLAWB Rd,Rm,Rs,Rn
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x000F0000) >> 16];
@@ -1236,11 +1336,13 @@ FORCE_INLINE void Interpreter::smlawb(uint32_t opcode) // SMLAWB Rd,Rm,Rs,Rn
 
     // Set the Q flag
     if ((*op0 & BIT(31)) != (res & BIT(31))) cpsr |= BIT(27);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::smlawt(uint32_t opcode) // SMLAWT Rd,Rm,Rs,Rn
+FORCE_INLINE int Interpreter::smlawt(uint32_t opcode) // SMLAWT Rd,Rm,Rs,Rn
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x000F0000) >> 16];
@@ -1254,9 +1356,11 @@ FORCE_INLINE void Interpreter::smlawt(uint32_t opcode) // SMLAWT Rd,Rm,Rs,Rn
 
     // Set the Q flag
     if ((*op0 & BIT(31)) != (res & BIT(31))) cpsr |= BIT(27);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::smlalbb(uint32_t opcode) // SMLALBB RdLo,RdHi,Rm,Rs
+FORCE_INLINE int Interpreter::smlalbb(uint32_t opcode) // SMLALBB RdLo,RdHi,Rm,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -1269,9 +1373,11 @@ FORCE_INLINE void Interpreter::smlalbb(uint32_t opcode) // SMLALBB RdLo,RdHi,Rm,
     res += op2 * op3;
     *op1 = res >> 32;
     *op0 = res;
+
+    return 2;
 }
 
-FORCE_INLINE void Interpreter::smlalbt(uint32_t opcode) // SMLALBT RdLo,RdHi,Rm,Rs
+FORCE_INLINE int Interpreter::smlalbt(uint32_t opcode) // SMLALBT RdLo,RdHi,Rm,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -1284,9 +1390,11 @@ FORCE_INLINE void Interpreter::smlalbt(uint32_t opcode) // SMLALBT RdLo,RdHi,Rm,
     res += op2 * op3;
     *op1 = res >> 32;
     *op0 = res;
+
+    return 2;
 }
 
-FORCE_INLINE void Interpreter::smlaltb(uint32_t opcode) // SMLALTB RdLo,RdHi,Rm,Rs
+FORCE_INLINE int Interpreter::smlaltb(uint32_t opcode) // SMLALTB RdLo,RdHi,Rm,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -1299,9 +1407,11 @@ FORCE_INLINE void Interpreter::smlaltb(uint32_t opcode) // SMLALTB RdLo,RdHi,Rm,
     res += op2 * op3;
     *op1 = res >> 32;
     *op0 = res;
+
+    return 2;
 }
 
-FORCE_INLINE void Interpreter::smlaltt(uint32_t opcode) // SMLALTT RdLo,RdHi,Rm,Rs
+FORCE_INLINE int Interpreter::smlaltt(uint32_t opcode) // SMLALTT RdLo,RdHi,Rm,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -1314,9 +1424,11 @@ FORCE_INLINE void Interpreter::smlaltt(uint32_t opcode) // SMLALTT RdLo,RdHi,Rm,
     res += op2 * op3;
     *op1 = res >> 32;
     *op0 = res;
+
+    return 2;
 }
 
-FORCE_INLINE void Interpreter::qadd(uint32_t opcode) // QADD Rd,Rm,Rn
+FORCE_INLINE int Interpreter::qadd(uint32_t opcode) // QADD Rd,Rm,Rn
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -1337,9 +1449,11 @@ FORCE_INLINE void Interpreter::qadd(uint32_t opcode) // QADD Rd,Rm,Rn
     }
 
     *op0 = res;
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::qsub(uint32_t opcode) // QSUB Rd,Rm,Rn
+FORCE_INLINE int Interpreter::qsub(uint32_t opcode) // QSUB Rd,Rm,Rn
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -1360,9 +1474,11 @@ FORCE_INLINE void Interpreter::qsub(uint32_t opcode) // QSUB Rd,Rm,Rn
     }
 
     *op0 = res;
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::qdadd(uint32_t opcode) // QDADD Rd,Rm,Rn
+FORCE_INLINE int Interpreter::qdadd(uint32_t opcode) // QDADD Rd,Rm,Rn
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -1395,9 +1511,11 @@ FORCE_INLINE void Interpreter::qdadd(uint32_t opcode) // QDADD Rd,Rm,Rn
     }
 
     *op0 = res;
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::qdsub(uint32_t opcode) // QDSUB Rd,Rm,Rn
+FORCE_INLINE int Interpreter::qdsub(uint32_t opcode) // QDSUB Rd,Rm,Rn
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -1430,11 +1548,13 @@ FORCE_INLINE void Interpreter::qdsub(uint32_t opcode) // QDSUB Rd,Rm,Rn
     }
 
     *op0 = res;
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::clz(uint32_t opcode) // CLZ Rd,Rm
+FORCE_INLINE int Interpreter::clz(uint32_t opcode) // CLZ Rd,Rm
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -1448,14 +1568,15 @@ FORCE_INLINE void Interpreter::clz(uint32_t opcode) // CLZ Rd,Rm
         count++;
     }
     *op0 = 32 - count;
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::addRegT(uint16_t opcode) // ADD Rd,Rs,Rn
+FORCE_INLINE int Interpreter::addT(uint8_t rd, uint8_t rs, uint32_t op2) // ADD Rd,Rs,op2
 {
-    // Decode the operands
-    uint32_t *op0 = registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint32_t op2 = *registers[(opcode & 0x01C0) >> 6];
+    // Decode the other operands
+    uint32_t *op0 = registers[rd];
+    uint32_t op1 = *registers[rs];
 
     // Addition
     *op0 = op1 + op2;
@@ -1466,14 +1587,15 @@ FORCE_INLINE void Interpreter::addRegT(uint16_t opcode) // ADD Rd,Rs,Rn
     if (op1 > *op0)     cpsr |= BIT(29); else cpsr &= ~BIT(29);
     if ((op2 & BIT(31)) == (op1 & BIT(31)) && (*op0 & BIT(31)) != (op2 & BIT(31)))
         cpsr |= BIT(28); else cpsr &= ~BIT(28);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::subRegT(uint16_t opcode) // SUB Rd,Rs,Rn
+FORCE_INLINE int Interpreter::subT(uint8_t rd, uint8_t rs, uint32_t op2) // SUB Rd,Rs,op2
 {
-    // Decode the operands
-    uint32_t *op0 = registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint32_t op2 = *registers[(opcode & 0x01C0) >> 6];
+    // Decode the other operands
+    uint32_t *op0 = registers[rd];
+    uint32_t op1 = *registers[rs];
 
     // Subtraction
     *op0 = op1 - op2;
@@ -1484,9 +1606,115 @@ FORCE_INLINE void Interpreter::subRegT(uint16_t opcode) // SUB Rd,Rs,Rn
     if (op1 >= *op0)    cpsr |= BIT(29); else cpsr &= ~BIT(29);
     if ((op2 & BIT(31)) != (op1 & BIT(31)) && (*op0 & BIT(31)) == (op2 & BIT(31)))
         cpsr |= BIT(28); else cpsr &= ~BIT(28);
+
+    return 1;
+}
+
+FORCE_INLINE int Interpreter::cmpT(uint8_t rd, uint8_t, uint32_t op2) // CMP Rd,op2
+{
+    // Rs is unused, but the parameter keeps the signature shared with the other operand forms
+    // Decode the other operand
+    uint32_t op1 = *registers[rd];
+
+    // Compare
+    uint32_t res = op1 - op2;
+
+    // Set the flags
+    if (res & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
+    if (res == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+    if (op1 >= res)    cpsr |= BIT(29); else cpsr &= ~BIT(29);
+    if ((op2 & BIT(31)) != (op1 & BIT(31)) && (res & BIT(31)) == (op2 & BIT(31)))
+        cpsr |= BIT(28); else cpsr &= ~BIT(28);
+
+    return 1;
+}
+
+FORCE_INLINE int Interpreter::movT(uint8_t rd, uint8_t, uint32_t op2) // MOV Rd,op2
+{
+    // Rs is unused, but the parameter keeps the signature shared with the other operand forms
+    // Decode the other operand
+    uint32_t *op0 = registers[rd];
+
+    // Move
+    *op0 = op2;
+
+    // Set the flags
+    if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
+    if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+
+    return 1;
+}
+
+FORCE_INLINE int Interpreter::lslT(uint8_t rd, uint8_t rs, uint32_t op2) // LSL Rd,Rs,#i
+{
+    // Decode the other operands
+    uint32_t *op0 = registers[rd];
+    uint32_t op1 = *registers[rs];
+
+    // Logical shift left
+    *op0 = op1 << op2;
+
+    // Set the flags
+    if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
+    if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+    if (op2 > 0)
+    {
+        if (op1 & BIT(32 - op2)) cpsr |= BIT(29); else cpsr &= ~BIT(29);
+    }
+
+    return 1;
+}
+
+FORCE_INLINE int Interpreter::lsrT(uint8_t rd, uint8_t rs, uint32_t op2) // LSR Rd,Rs,#i
+{
+    // Decode the other operands
+    uint32_t *op0 = registers[rd];
+    uint32_t op1 = *registers[rs];
+
+    // Logical shift right
+    // A shift of 0 translates to a shift of 32
+    *op0 = op2 ? (op1 >> op2) : 0;
+
+    // Set the flags
+    if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
+    if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+    if (op1 & BIT(op2 ? (op2 - 1) : 31)) cpsr |= BIT(29); else cpsr &= ~BIT(29);
+
+    return 1;
+}
+
+FORCE_INLINE int Interpreter::asrT(uint8_t rd, uint8_t rs, uint32_t op2) // ASR Rd,Rs,#i
+{
+    // Decode the other operands
+    uint32_t *op0 = registers[rd];
+    uint32_t op1 = *registers[rs];
+
+    // Arithmetic shift right
+    // A shift of 0 translates to a shift of 32
+    *op0 = op2 ? ((int32_t)op1 >> op2) : ((op1 & BIT(31)) ? 0xFFFFFFFF : 0);
+
+    // Set the flags
+    if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
+    if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+    if ((op2 == 0 && (op1 & BIT(31))) || (op2 > 0 && (op1 & BIT(op2 - 1))))
+        cpsr |= BIT(29); else cpsr &= ~BIT(29);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::addHT(uint16_t opcode) // ADD Rd,Rs
+FORCE_INLINE int Interpreter::addRegT(uint16_t opcode) // ADD Rd,Rs,Rn
+{
+    // Decode the operands
+    return addT(opcode & 0x0007, (opcode & 0x0038) >> 3, *registers[(opcode & 0x01C0) >> 6]);
+}
+
+FORCE_INLINE int Interpreter::subRegT(uint16_t opcode) // SUB Rd,Rs,Rn
+{
+    // Decode the operands
+    return subT(opcode & 0x0007, (opcode & 0x0038) >> 3, *registers[(opcode & 0x01C0) >> 6]);
+}
+
+FORCE_INLINE int Interpreter::addHT(uint16_t opcode) // ADD Rd,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[((opcode & 0x0080) >> 4) | (opcode & 0x0007)];
@@ -1498,9 +1726,11 @@ FORCE_INLINE void Interpreter::addHT(uint16_t opcode) // ADD Rd,Rs
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~1) + 2;
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::cmpHT(uint16_t opcode) // CMP Rd,Rs
+FORCE_INLINE int Interpreter::cmpHT(uint16_t opcode) // CMP Rd,Rs
 {
     // Decode the operands
     uint32_t op1 = *registers[((opcode & 0x0080) >> 4) | (opcode & 0x0007)];
@@ -1515,9 +1745,11 @@ FORCE_INLINE void Interpreter::cmpHT(uint16_t opcode) // CMP Rd,Rs
     if (op1 >= res)    cpsr |= BIT(29); else cpsr &= ~BIT(29);
     if ((op2 & BIT(31)) != (op1 & BIT(31)) && (res & BIT(31)) == (op2 & BIT(31)))
         cpsr |= BIT(28); else cpsr &= ~BIT(28);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::movHT(uint16_t opcode) // MOV Rd,Rs
+FORCE_INLINE int Interpreter::movHT(uint16_t opcode) // MOV Rd,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[((opcode & 0x0080) >> 4) | (opcode & 0x0007)];
@@ -1529,9 +1761,11 @@ FORCE_INLINE void Interpreter::movHT(uint16_t opcode) // MOV Rd,Rs
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~1) + 2;
+
+    return (op0 == registers[15]) ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::addPcT(uint16_t opcode) // ADD Rd,PC,#i
+FORCE_INLINE int Interpreter::addPcT(uint16_t opcode) // ADD Rd,PC,#i
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0700) >> 8];
@@ -1540,9 +1774,11 @@ FORCE_INLINE void Interpreter::addPcT(uint16_t opcode) // ADD Rd,PC,#i
 
     // Addition
     *op0 = op1 + op2;
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::addSpT(uint16_t opcode) // ADD Rd,SP,#i
+FORCE_INLINE int Interpreter::addSpT(uint16_t opcode) // ADD Rd,SP,#i
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0700) >> 8];
@@ -1551,9 +1787,11 @@ FORCE_INLINE void Interpreter::addSpT(uint16_t opcode) // ADD Rd,SP,#i
 
     // Addition
     *op0 = op1 + op2;
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::addSpImmT(uint16_t opcode) // ADD SP,#i
+FORCE_INLINE int Interpreter::addSpImmT(uint16_t opcode) // ADD SP,#i
 {
     // Decode the operands
     uint32_t *op0 = registers[13];
@@ -1561,167 +1799,65 @@ FORCE_INLINE void Interpreter::addSpImmT(uint16_t opcode) // ADD SP,#i
 
     // Addition
     *op0 += op2;
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::lslImmT(uint16_t opcode) // LSL Rd,Rs,#i
+FORCE_INLINE int Interpreter::lslImmT(uint16_t opcode) // LSL Rd,Rs,#i
 {
     // Decode the operands
-    uint32_t *op0 = registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint8_t op2 = (opcode & 0x07C0) >> 6;
-
-    // Logical shift left
-    *op0 = op1 << op2;
-
-    // Set the flags
-    if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
-    if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
-    if (op2 > 0)
-    {
-        if (op1 & BIT(32 - op2)) cpsr |= BIT(29); else cpsr &= ~BIT(29);
-    }
+    return lslT(opcode & 0x0007, (opcode & 0x0038) >> 3, (opcode & 0x07C0) >> 6);
 }
 
-FORCE_INLINE void Interpreter::lsrImmT(uint16_t opcode) // LSR Rd,Rs,#i
+FORCE_INLINE int Interpreter::lsrImmT(uint16_t opcode) // LSR Rd,Rs,#i
 {
     // Decode the operands
-    uint32_t *op0 = registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint8_t op2 = (opcode & 0x07C0) >> 6;
-
-    // Logical shift right
-    // A shift of 0 translates to a shift of 32
-    *op0 = op2 ? (op1 >> op2) : 0;
-
-    // Set the flags
-    if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
-    if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
-    if (op1 & BIT(op2 ? (op2 - 1) : 31)) cpsr |= BIT(29); else cpsr &= ~BIT(29);
+    return lsrT(opcode & 0x0007, (opcode & 0x0038) >> 3, (opcode & 0x07C0) >> 6);
 }
 
-FORCE_INLINE void Interpreter::asrImmT(uint16_t opcode) // ASR Rd,Rs,#i
+FORCE_INLINE int Interpreter::asrImmT(uint16_t opcode) // ASR Rd,Rs,#i
 {
     // Decode the operands
-    uint32_t *op0 = registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint8_t op2 = (opcode & 0x07C0) >> 6;
-
-    // Arithmetic shift right
-    // A shift of 0 translates to a shift of 32
-    *op0 = op2 ? ((int32_t)op1 >> op2) : ((op1 & BIT(31)) ? 0xFFFFFFFF : 0);
-
-    // Set the flags
-    if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
-    if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
-    if ((op2 == 0 && (op1 & BIT(31))) || (op2 > 0 && (op1 & BIT(op2 - 1))))
-        cpsr |= BIT(29); else cpsr &= ~BIT(29);
+    return asrT(opcode & 0x0007, (opcode & 0x0038) >> 3, (opcode & 0x07C0) >> 6);
 }
 
-FORCE_INLINE void Interpreter::addImm3T(uint16_t opcode) // ADD Rd,Rs,#i
+FORCE_INLINE int Interpreter::addImm3T(uint16_t opcode) // ADD Rd,Rs,#i
 {
     // Decode the operands
-    uint32_t *op0 = registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint32_t op2 = (opcode & 0x01C0) >> 6;
-
-    // Addition
-    *op0 = op1 + op2;
-
-    // Set the flags
-    if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
-    if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
-    if (op1 > *op0)     cpsr |= BIT(29); else cpsr &= ~BIT(29);
-    if ((op2 & BIT(31)) == (op1 & BIT(31)) && (*op0 & BIT(31)) != (op2 & BIT(31)))
-        cpsr |= BIT(28); else cpsr &= ~BIT(28);
+    return addT(opcode & 0x0007, (opcode & 0x0038) >> 3, (opcode & 0x01C0) >> 6);
 }
 
-FORCE_INLINE void Interpreter::subImm3T(uint16_t opcode) // SUB Rd,Rs,#i
+FORCE_INLINE int Interpreter::subImm3T(uint16_t opcode) // SUB Rd,Rs,#i
 {
     // Decode the operands
-    uint32_t *op0 = registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint32_t op2 = (opcode & 0x01C0) >> 6;
-
-    // Subtraction
-    *op0 = op1 - op2;
-
-    // Set the flags
-    if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
-    if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
-    if (op1 >= *op0)    cpsr |= BIT(29); else cpsr &= ~BIT(29);
-    if ((op2 & BIT(31)) != (op1 & BIT(31)) && (*op0 & BIT(31)) == (op2 & BIT(31)))
-        cpsr |= BIT(28); else cpsr &= ~BIT(28);
+    return subT(opcode & 0x0007, (opcode & 0x0038) >> 3, (opcode & 0x01C0) >> 6);
 }
 
-FORCE_INLINE void Interpreter::addImm8T(uint16_t opcode) // ADD Rd,#i
+FORCE_INLINE int Interpreter::addImm8T(uint16_t opcode) // ADD Rd,#i
 {
     // Decode the operands
-    uint32_t *op0 = registers[(opcode & 0x0700) >> 8];
-    uint32_t op1 = *registers[(opcode & 0x0700) >> 8];
-    uint32_t op2 = opcode & 0x00FF;
-
-    // Addition
-    *op0 += op2;
-
-    // Set the flags
-    if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
-    if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
-    if (op1 > *op0)     cpsr |= BIT(29); else cpsr &= ~BIT(29);
-    if ((op2 & BIT(31)) == (op1 & BIT(31)) && (*op0 & BIT(31)) != (op2 & BIT(31)))
-        cpsr |= BIT(28); else cpsr &= ~BIT(28);
+    return addT((opcode & 0x0700) >> 8, (opcode & 0x0700) >> 8, opcode & 0x00FF);
 }
 
-FORCE_INLINE void Interpreter::subImm8T(uint16_t opcode) // SUB Rd,#i
+FORCE_INLINE int Interpreter::subImm8T(uint16_t opcode) // SUB Rd,#i
 {
     // Decode the operands
-    uint32_t *op0 = registers[(opcode & 0x0700) >> 8];
-    uint32_t op1 = *registers[(opcode & 0x0700) >> 8];
-    uint32_t op2 = opcode & 0x00FF;
-
-    // Subtraction
-    *op0 -= op2;
-
-    // Set the flags
-    if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
-    if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
-    if (op1 >= *op0)    cpsr |= BIT(29); else cpsr &= ~BIT(29);
-    if ((op2 & BIT(31)) != (op1 & BIT(31)) && (*op0 & BIT(31)) == (op2 & BIT(31)))
-        cpsr |= BIT(28); else cpsr &= ~BIT(28);
+    return subT((opcode & 0x0700) >> 8, (opcode & 0x0700) >> 8, opcode & 0x00FF);
 }
 
-
-FORCE_INLINE void Interpreter::cmpImm8T(uint16_t opcode) // CMP Rd,#i
+FORCE_INLINE int Interpreter::cmpImm8T(uint16_t opcode) // CMP Rd,#i
 {
     // Decode the operands
-    uint32_t op1 = *registers[(opcode & 0x0700) >> 8];
-    uint32_t op2 = opcode & 0x00FF;
-
-    // Compare
-    uint32_t res = op1 - op2;
-
-    // Set the flags
-    if (res & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
-    if (res == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
-    if (op1 >= res)    cpsr |= BIT(29); else cpsr &= ~BIT(29);
-    if ((op2 & BIT(31)) != (op1 & BIT(31)) && (res & BIT(31)) == (op2 & BIT(31)))
-        cpsr |= BIT(28); else cpsr &= ~BIT(28);
+    return cmpT((opcode & 0x0700) >> 8, 0, opcode & 0x00FF);
 }
 
-FORCE_INLINE void Interpreter::movImm8T(uint16_t opcode) // MOV Rd,#i
+FORCE_INLINE int Interpreter::movImm8T(uint16_t opcode) // MOV Rd,#i
 {
-    // Decode the other operand
-    uint32_t *op0 = registers[(opcode & 0x0700) >> 8];
-    uint32_t op2 = opcode & 0x00FF;
-
-    // Move
-    *op0 = op2;
-
-    // Set the flags
-    if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
-    if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+    // Decode the operands
+    return movT((opcode & 0x0700) >> 8, 0, opcode & 0x00FF);
 }
 
-FORCE_INLINE void Interpreter::lslDpT(uint16_t opcode) // LSL Rd,Rs
+FORCE_INLINE int Interpreter::lslDpT(uint16_t opcode) // LSL Rd,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[opcode & 0x0007];
@@ -1739,9 +1875,11 @@ FORCE_INLINE void Interpreter::lslDpT(uint16_t opcode) // LSL Rd,Rs
     {
         if (op2 <= 32 && (op1 & BIT(32 - op2))) cpsr |= BIT(29); else cpsr &= ~BIT(29);
     }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::lsrDpT(uint16_t opcode) // LSR Rd,Rs
+FORCE_INLINE int Interpreter::lsrDpT(uint16_t opcode) // LSR Rd,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[opcode & 0x0007];
@@ -1759,9 +1897,11 @@ FORCE_INLINE void Interpreter::lsrDpT(uint16_t opcode) // LSR Rd,Rs
     {
         if (op2 <= 32 && (op1 & BIT(op2 - 1))) cpsr |= BIT(29); else cpsr &= ~BIT(29);
     }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::asrDpT(uint16_t opcode) // ASR Rd,Rs
+FORCE_INLINE int Interpreter::asrDpT(uint16_t opcode) // ASR Rd,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[opcode & 0x0007];
@@ -1780,9 +1920,11 @@ FORCE_INLINE void Interpreter::asrDpT(uint16_t opcode) // ASR Rd,Rs
         if ((op2 > 32 && (op1 & BIT(31))) || (op2 <= 32 && (op1 & BIT(op2 - 1))))
             cpsr |= BIT(29); else cpsr &= ~BIT(29);
     }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::rorDpT(uint16_t opcode) // ROR Rd,Rs
+FORCE_INLINE int Interpreter::rorDpT(uint16_t opcode) // ROR Rd,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[opcode & 0x0007];
@@ -1799,9 +1941,11 @@ FORCE_INLINE void Interpreter::rorDpT(uint16_t opcode) // ROR Rd,Rs
     {
         if (op1 & BIT((op2 - 1) % 32)) cpsr |= BIT(29); else cpsr &= ~BIT(29);
     }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::andDpT(uint16_t opcode) // AND Rd,Rs
+FORCE_INLINE int Interpreter::andDpT(uint16_t opcode) // AND Rd,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[opcode & 0x0007];
@@ -1813,9 +1957,11 @@ FORCE_INLINE void Interpreter::andDpT(uint16_t opcode) // AND Rd,Rs
     // Set the flags
     if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::eorDpT(uint16_t opcode) // EOR Rd,Rs
+FORCE_INLINE int Interpreter::eorDpT(uint16_t opcode) // EOR Rd,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[opcode & 0x0007];
@@ -1827,9 +1973,11 @@ FORCE_INLINE void Interpreter::eorDpT(uint16_t opcode) // EOR Rd,Rs
     // Set the flags
     if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::adcDpT(uint16_t opcode) // ADC Rd,Rs
+FORCE_INLINE int Interpreter::adcDpT(uint16_t opcode) // ADC Rd,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[opcode & 0x0007];
@@ -1845,9 +1993,11 @@ FORCE_INLINE void Interpreter::adcDpT(uint16_t opcode) // ADC Rd,Rs
     if (op1 > *op0 || (op2 == 0xFFFFFFFF && (cpsr & BIT(29)))) cpsr |= BIT(29); else cpsr &= ~BIT(29);
     if ((op2 & BIT(31)) == (op1 & BIT(31)) && (*op0 & BIT(31)) != (op2 & BIT(31)))
         cpsr |= BIT(28); else cpsr &= ~BIT(28);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::sbcDpT(uint16_t opcode) // SBC Rd,Rs
+FORCE_INLINE int Interpreter::sbcDpT(uint16_t opcode) // SBC Rd,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[opcode & 0x0007];
@@ -1863,9 +2013,11 @@ FORCE_INLINE void Interpreter::sbcDpT(uint16_t opcode) // SBC Rd,Rs
     if (op1 >= *op0 && (op2 != 0xFFFFFFFF || (cpsr & BIT(29)))) cpsr |= BIT(29); else cpsr &= ~BIT(29);
     if ((op2 & BIT(31)) != (op1 & BIT(31)) && (*op0 & BIT(31)) == (op2 & BIT(31)))
         cpsr |= BIT(28); else cpsr &= ~BIT(28);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::tstDpT(uint16_t opcode) // TST Rd,Rs
+FORCE_INLINE int Interpreter::tstDpT(uint16_t opcode) // TST Rd,Rs
 {
     // Decode the operands
     uint32_t op1 = *registers[opcode & 0x0007];
@@ -1877,9 +2029,11 @@ FORCE_INLINE void Interpreter::tstDpT(uint16_t opcode) // TST Rd,Rs
     // Set the flags
     if (res & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (res == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::cmpDpT(uint16_t opcode) // CMP Rd,Rs
+FORCE_INLINE int Interpreter::cmpDpT(uint16_t opcode) // CMP Rd,Rs
 {
     // Decode the operands
     uint32_t op1 = *registers[opcode & 0x0007];
@@ -1894,9 +2048,11 @@ FORCE_INLINE void Interpreter::cmpDpT(uint16_t opcode) // CMP Rd,Rs
     if (op1 >= res)    cpsr |= BIT(29); else cpsr &= ~BIT(29);
     if ((op2 & BIT(31)) != (op1 & BIT(31)) && (res & BIT(31)) == (op2 & BIT(31)))
         cpsr |= BIT(28); else cpsr &= ~BIT(28);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::cmnDpT(uint16_t opcode) // CMN Rd,Rs
+FORCE_INLINE int Interpreter::cmnDpT(uint16_t opcode) // CMN Rd,Rs
 {
     // Decode the operands
     uint32_t op1 = *registers[opcode & 0x0007];
@@ -1911,9 +2067,11 @@ FORCE_INLINE void Interpreter::cmnDpT(uint16_t opcode) // CMN Rd,Rs
     if (op1 > res)     cpsr |= BIT(29); else cpsr &= ~BIT(29);
     if ((op2 & BIT(31)) == (op1 & BIT(31)) && (res & BIT(31)) != (op2 & BIT(31)))
         cpsr |= BIT(28); else cpsr &= ~BIT(28);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::orrDpT(uint16_t opcode) // ORR Rd,Rs
+FORCE_INLINE int Interpreter::orrDpT(uint16_t opcode) // ORR Rd,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[opcode & 0x0007];
@@ -1925,9 +2083,11 @@ FORCE_INLINE void Interpreter::orrDpT(uint16_t opcode) // ORR Rd,Rs
     // Set the flags
     if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::bicDpT(uint16_t opcode) // BIC Rd,Rs
+FORCE_INLINE int Interpreter::bicDpT(uint16_t opcode) // BIC Rd,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[opcode & 0x0007];
@@ -1939,9 +2099,11 @@ FORCE_INLINE void Interpreter::bicDpT(uint16_t opcode) // BIC Rd,Rs
     // Set the flags
     if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::mvnDpT(uint16_t opcode) // MVN Rd,Rs
+FORCE_INLINE int Interpreter::mvnDpT(uint16_t opcode) // MVN Rd,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[opcode & 0x0007];
@@ -1953,9 +2115,11 @@ FORCE_INLINE void Interpreter::mvnDpT(uint16_t opcode) // MVN Rd,Rs
     // Set the flags
     if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::negDpT(uint16_t opcode) // NEG Rd,Rs
+FORCE_INLINE int Interpreter::negDpT(uint16_t opcode) // NEG Rd,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[opcode & 0x0007];
@@ -1971,9 +2135,11 @@ FORCE_INLINE void Interpreter::negDpT(uint16_t opcode) // NEG Rd,Rs
     if (op1 >= *op0)    cpsr |= BIT(29); else cpsr &= ~BIT(29);
     if ((op2 & BIT(31)) != (op1 & BIT(31)) && (*op0 & BIT(31)) == (op2 & BIT(31)))
         cpsr |= BIT(28); else cpsr &= ~BIT(28);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::mulDpT(uint16_t opcode) // MUL Rd,Rs
+FORCE_INLINE int Interpreter::mulDpT(uint16_t opcode) // MUL Rd,Rs
 {
     // Decode the operands
     uint32_t *op0 = registers[opcode & 0x0007];
@@ -1986,6 +2152,8 @@ FORCE_INLINE void Interpreter::mulDpT(uint16_t opcode) // MUL Rd,Rs
     if (*op0 & BIT(31)) cpsr |= BIT(31); else cpsr &= ~BIT(31);
     if (*op0 == 0)      cpsr |= BIT(30); else cpsr &= ~BIT(30);
     if (cpu == 1) cpsr &= ~BIT(29); // The carry flag is destroyed on ARM7
+
+    return cpu ? (1 + multiplyCycles(op2, true)) : 4;
 }
 
 #endif // INTERPRETER_ALU
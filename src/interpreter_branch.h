@@ -22,7 +22,7 @@
 
 #include "core.h"
 
-FORCE_INLINE void Interpreter::bx(uint32_t opcode) // BX Rn
+FORCE_INLINE int Interpreter::bx(uint32_t opcode) // BX Rn
 {
     // Decode the operand
     uint32_t op0 = *registers[opcode & 0x0000000F];
@@ -37,11 +37,13 @@ FORCE_INLINE void Interpreter::bx(uint32_t opcode) // BX Rn
     {
         *registers[15] = (op0 & ~3) + 4;
     }
+
+    return 3;
 }
 
-FORCE_INLINE void Interpreter::blxReg(uint32_t opcode) // BLX Rn
+FORCE_INLINE int Interpreter::blxReg(uint32_t opcode) // BLX Rn
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operand
     uint32_t op0 = *registers[opcode & 0x0000000F];
@@ -57,18 +59,23 @@ FORCE_INLINE void Interpreter::blxReg(uint32_t opcode) // BLX Rn
     {
         *registers[15] = (op0 & ~3) + 4;
     }
+
+    return 3;
 }
 
-FORCE_INLINE void Interpreter::b(uint32_t opcode) // B label
+FORCE_INLINE int Interpreter::b(uint32_t opcode) // B label
 {
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(23)) ? 0xFC000000 : 0) | ((opcode & 0x00FFFFFF) << 2);
 
     // Branch to offset
     *registers[15] += op0 + 4;
+    checkIdle(op0);
+
+    return 3;
 }
 
-FORCE_INLINE void Interpreter::bl(uint32_t opcode) // BL label
+FORCE_INLINE int Interpreter::bl(uint32_t opcode) // BL label
 {
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(23)) ? 0xFC000000 : 0) | ((opcode & 0x00FFFFFF) << 2);
@@ -76,11 +83,13 @@ FORCE_INLINE void Interpreter::bl(uint32_t opcode) // BL label
     // Branch to offset with link
     *registers[14] = *registers[15] - 4;
     *registers[15] += op0 + 4;
+
+    return 3;
 }
 
-FORCE_INLINE void Interpreter::blx(uint32_t opcode) // BLX label
+FORCE_INLINE int Interpreter::blx(uint32_t opcode) // BLX label
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(23)) ? 0xFC000000 : 0) | ((opcode & 0x00FFFFFF) << 2) | ((opcode & BIT(24)) >> 23);
@@ -89,10 +98,19 @@ FORCE_INLINE void Interpreter::blx(uint32_t opcode) // BLX label
     *registers[14] = *registers[15] - 4;
     *registers[15] += op0 + 2;
     cpsr |= BIT(5);
+
+    return 3;
 }
 
-FORCE_INLINE void Interpreter::swi() // SWI #i
+FORCE_INLINE int Interpreter::swi(uint32_t opcode) // SWI #i
 {
+    // Run the BIOS function natively if HLE is enabled and supports it
+    if (hleBios)
+    {
+        if (int cycles = core->hleBios[cpu].execute(opcode >> 16, false, registers))
+            return cycles;
+    }
+
     // Software interrupt
     uint32_t cpsrOld = cpsr;
     setMode(0x13); // Supervisor
@@ -100,9 +118,11 @@ FORCE_INLINE void Interpreter::swi() // SWI #i
     cpsr |= BIT(7);
     *registers[14] = *registers[15] - 4;
     *registers[15] = ((cpu == 0) ? core->cp15.getExceptionAddr() : 0x00000000) + 0x08 + 4;
+
+    return 3;
 }
 
-FORCE_INLINE void Interpreter::bxRegT(uint16_t opcode) // BX Rs
+FORCE_INLINE int Interpreter::bxRegT(uint16_t opcode) // BX Rs
 {
     // Decode the operand
     uint32_t op0 = *registers[(opcode & 0x0078) >> 3];
@@ -117,11 +137,13 @@ FORCE_INLINE void Interpreter::bxRegT(uint16_t opcode) // BX Rs
         cpsr &= ~BIT(5);
         *registers[15] = (op0 & ~3) + 4;
     }
+
+    return 3;
 }
 
-FORCE_INLINE void Interpreter::blxRegT(uint16_t opcode) // BLX Rs
+FORCE_INLINE int Interpreter::blxRegT(uint16_t opcode) // BLX Rs
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operand
     uint32_t op0 = *registers[(opcode & 0x0078) >> 3];
@@ -137,167 +159,258 @@ FORCE_INLINE void Interpreter::blxRegT(uint16_t opcode) // BLX Rs
         cpsr &= ~BIT(5);
         *registers[15] = (op0 & ~3) + 4;
     }
+
+    return 3;
 }
 
-FORCE_INLINE void Interpreter::beqT(uint16_t opcode) // BEQ label
+FORCE_INLINE int Interpreter::beqT(uint16_t opcode) // BEQ label
 {
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(7)) ? 0xFFFFFE00 : 0) | ((opcode & 0x00FF) << 1);
 
     // Branch to offset if equal
     if (cpsr & BIT(30))
+    {
         *registers[15] += op0 + 2;
+        checkIdle(op0);
+        return 3;
+    }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::bneT(uint16_t opcode) // BNE label
+FORCE_INLINE int Interpreter::bneT(uint16_t opcode) // BNE label
 {
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(7)) ? 0xFFFFFE00 : 0) | ((opcode & 0x00FF) << 1);
 
     // Branch to offset if not equal
     if (!(cpsr & BIT(30)))
+    {
         *registers[15] += op0 + 2;
+        checkIdle(op0);
+        return 3;
+    }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::bcsT(uint16_t opcode) // BCS label
+FORCE_INLINE int Interpreter::bcsT(uint16_t opcode) // BCS label
 {
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(7)) ? 0xFFFFFE00 : 0) | ((opcode & 0x00FF) << 1);
 
     // Branch to offset if carry set
     if (cpsr & BIT(29))
+    {
         *registers[15] += op0 + 2;
+        checkIdle(op0);
+        return 3;
+    }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::bccT(uint16_t opcode) // BCC label
+FORCE_INLINE int Interpreter::bccT(uint16_t opcode) // BCC label
 {
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(7)) ? 0xFFFFFE00 : 0) | ((opcode & 0x00FF) << 1);
 
     // Branch to offset if carry clear
     if (!(cpsr & BIT(29)))
+    {
         *registers[15] += op0 + 2;
+        checkIdle(op0);
+        return 3;
+    }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::bmiT(uint16_t opcode) // BMI label
+FORCE_INLINE int Interpreter::bmiT(uint16_t opcode) // BMI label
 {
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(7)) ? 0xFFFFFE00 : 0) | ((opcode & 0x00FF) << 1);
 
     // Branch to offset if negative
     if (cpsr & BIT(31))
+    {
         *registers[15] += op0 + 2;
+        checkIdle(op0);
+        return 3;
+    }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::bplT(uint16_t opcode) // BPL label
+FORCE_INLINE int Interpreter::bplT(uint16_t opcode) // BPL label
 {
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(7)) ? 0xFFFFFE00 : 0) | ((opcode & 0x00FF) << 1);
 
     // Branch to offset if positive
     if (!(cpsr & BIT(31)))
+    {
         *registers[15] += op0 + 2;
+        checkIdle(op0);
+        return 3;
+    }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::bvsT(uint16_t opcode) // BVS label
+FORCE_INLINE int Interpreter::bvsT(uint16_t opcode) // BVS label
 {
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(7)) ? 0xFFFFFE00 : 0) | ((opcode & 0x00FF) << 1);
 
     // Branch to offset if overflow set
     if (cpsr & BIT(28))
+    {
         *registers[15] += op0 + 2;
+        checkIdle(op0);
+        return 3;
+    }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::bvcT(uint16_t opcode) // BVC label
+FORCE_INLINE int Interpreter::bvcT(uint16_t opcode) // BVC label
 {
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(7)) ? 0xFFFFFE00 : 0) | ((opcode & 0x00FF) << 1);
 
     // Branch to offset if overflow clear
     if (!(cpsr & BIT(28)))
+    {
         *registers[15] += op0 + 2;
+        checkIdle(op0);
+        return 3;
+    }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::bhiT(uint16_t opcode) // BHI label
+FORCE_INLINE int Interpreter::bhiT(uint16_t opcode) // BHI label
 {
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(7)) ? 0xFFFFFE00 : 0) | ((opcode & 0x00FF) << 1);
 
     // Branch to offset if higher
     if ((cpsr & BIT(29)) && !(cpsr & BIT(30)))
+    {
         *registers[15] += op0 + 2;
+        checkIdle(op0);
+        return 3;
+    }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::blsT(uint16_t opcode) // BLS label
+FORCE_INLINE int Interpreter::blsT(uint16_t opcode) // BLS label
 {
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(7)) ? 0xFFFFFE00 : 0) | ((opcode & 0x00FF) << 1);
 
     // Branch to offset if lower or same
     if (!(cpsr & BIT(29)) || (cpsr & BIT(30)))
+    {
         *registers[15] += op0 + 2;
+        checkIdle(op0);
+        return 3;
+    }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::bgeT(uint16_t opcode) // BGE label
+FORCE_INLINE int Interpreter::bgeT(uint16_t opcode) // BGE label
 {
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(7)) ? 0xFFFFFE00 : 0) | ((opcode & 0x00FF) << 1);
 
     // Branch to offset if signed greater or equal
     if ((cpsr & BIT(31)) == (cpsr & BIT(28)) << 3)
+    {
         *registers[15] += op0 + 2;
+        checkIdle(op0);
+        return 3;
+    }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::bltT(uint16_t opcode) // BLT label
+FORCE_INLINE int Interpreter::bltT(uint16_t opcode) // BLT label
 {
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(7)) ? 0xFFFFFE00 : 0) | ((opcode & 0x00FF) << 1);
 
     // Branch to offset if signed less than
     if ((cpsr & BIT(31)) != (cpsr & BIT(28)) << 3)
+    {
         *registers[15] += op0 + 2;
+        checkIdle(op0);
+        return 3;
+    }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::bgtT(uint16_t opcode) // BGT label
+FORCE_INLINE int Interpreter::bgtT(uint16_t opcode) // BGT label
 {
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(7)) ? 0xFFFFFE00 : 0) | ((opcode & 0x00FF) << 1);
 
     // Branch to offset if signed greater than
     if (!(cpsr & BIT(30)) && (cpsr & BIT(31)) == (cpsr & BIT(28)) << 3)
+    {
         *registers[15] += op0 + 2;
+        checkIdle(op0);
+        return 3;
+    }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::bleT(uint16_t opcode) // BLE label
+FORCE_INLINE int Interpreter::bleT(uint16_t opcode) // BLE label
 {
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(7)) ? 0xFFFFFE00 : 0) | ((opcode & 0x00FF) << 1);
 
     // Branch to offset if signed less or equal
     if ((cpsr & BIT(30)) || (cpsr & BIT(31)) != (cpsr & BIT(28)) << 3)
+    {
         *registers[15] += op0 + 2;
+        checkIdle(op0);
+        return 3;
+    }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::bT(uint16_t opcode) // B label
+FORCE_INLINE int Interpreter::bT(uint16_t opcode) // B label
 {
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(10)) ? 0xFFFFF000 : 0) | ((opcode & 0x07FF) << 1);
 
     // Branch to offset
     *registers[15] += op0 + 2;
+    checkIdle(op0);
+
+    return 3;
 }
 
-FORCE_INLINE void Interpreter::blSetupT(uint16_t opcode) // BL/BLX label
+FORCE_INLINE int Interpreter::blSetupT(uint16_t opcode) // BL/BLX label
 {
     // Decode the operand
     uint32_t op0 = ((opcode & BIT(10)) ? 0xFFFFF000 : 0) | ((opcode & 0x07FF) << 1);
 
     // Set the upper 11 bits of the target address for a long BL/BLX
     *registers[14] = *registers[15] + (op0 << 11);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::blOffT(uint16_t opcode) // BL label
+FORCE_INLINE int Interpreter::blOffT(uint16_t opcode) // BL label
 {
     // Decode the operand
     uint32_t op0 = (opcode & 0x07FF) << 1;
@@ -306,11 +419,13 @@ FORCE_INLINE void Interpreter::blOffT(uint16_t opcode) // BL label
     uint32_t ret = *registers[15] - 1;
     *registers[15] = ((*registers[14] + op0) & ~1) + 2;
     *registers[14] = ret;
+
+    return 3;
 }
 
-FORCE_INLINE void Interpreter::blxOffT(uint16_t opcode) // BLX label
+FORCE_INLINE int Interpreter::blxOffT(uint16_t opcode) // BLX label
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operand
     uint32_t op0 = (opcode & 0x07FF) << 1;
@@ -320,10 +435,19 @@ FORCE_INLINE void Interpreter::blxOffT(uint16_t opcode) // BLX label
     uint32_t ret = *registers[15] - 1;
     *registers[15] = ((*registers[14] + op0) & ~3) + 4;
     *registers[14] = ret;
+
+    return 3;
 }
 
-FORCE_INLINE void Interpreter::swiT() // SWI #i
+FORCE_INLINE int Interpreter::swiT(uint16_t opcode) // SWI #i
 {
+    // Run the BIOS function natively if HLE is enabled and supports it
+    if (hleBios)
+    {
+        if (int cycles = core->hleBios[cpu].execute(opcode, true, registers))
+            return cycles;
+    }
+
     // Software interrupt
     uint32_t cpsrOld = cpsr;
     setMode(0x13); // Supervisor
@@ -332,6 +456,8 @@ FORCE_INLINE void Interpreter::swiT() // SWI #i
     cpsr |= BIT(7);
     *registers[14] = *registers[15] - 2;
     *registers[15] = ((cpu == 0) ? core->cp15.getExceptionAddr() : 0x00000000) + 0x08 + 4;
+
+    return 3;
 }
 
 #endif // INTERPRETER_BRANCH
@@ -22,6 +22,20 @@
 
 #include "core.h"
 
+template <typename T> FORCE_INLINE T Interpreter::read(uint32_t address)
+{
+    // Read from memory, counting the stall cycles if timing is modeled
+    if (timing) cycles += accessCycles(address, sizeof(T), false) - 1;
+    return core->memory.read<T>(cpu, address);
+}
+
+template <typename T> FORCE_INLINE void Interpreter::write(uint32_t address, T value)
+{
+    // Write to memory, counting the stall cycles if timing is modeled
+    if (timing) cycles += accessCycles(address, sizeof(T), true) - 1;
+    core->memory.write<T>(cpu, address, value);
+}
+
 FORCE_INLINE uint32_t Interpreter::ip(uint32_t opcode) // #i (B/_)
 {
     // Immediate offset for byte and word transfers
@@ -83,28 +97,30 @@ FORCE_INLINE uint32_t Interpreter::rprr(uint32_t opcode) // Rm,ROR #i
     return shift ? ((value << (32 - shift)) | (value >> shift)) : (((cpsr & BIT(29)) << 2) | (value >> 1));
 }
 
-FORCE_INLINE void Interpreter::ldrsbOf(uint32_t opcode, uint32_t op2) // LDRSB Rd,[Rn,op2]
+FORCE_INLINE int Interpreter::ldrsbOf(uint32_t opcode, uint32_t op2) // LDRSB Rd,[Rn,op2]
 {
     // Decode the other operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
     uint32_t op1 = *registers[(opcode & 0x000F0000) >> 16];
 
     // Signed byte load, pre-adjust without writeback
-    *op0 = core->memory.read<int8_t>(cpu, op1 + op2);
+    *op0 = read<int8_t>(op1 + op2);
 
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 5 : (cpu ? 3 : 1);
 }
 
-FORCE_INLINE void Interpreter::ldrshOf(uint32_t opcode, uint32_t op2) // LDRSH Rd,[Rn,op2]
+FORCE_INLINE int Interpreter::ldrshOf(uint32_t opcode, uint32_t op2) // LDRSH Rd,[Rn,op2]
 {
     // Decode the other operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
     uint32_t op1 = *registers[(opcode & 0x000F0000) >> 16];
 
     // Signed half-word load, pre-adjust without writeback
-    *op0 = core->memory.read<int16_t>(cpu, op1 += op2);
+    *op0 = read<int16_t>(op1 += op2);
 
     // Shift misaligned reads on ARM7
     if (cpu == 1 && (op1 & 1))
@@ -113,16 +129,18 @@ FORCE_INLINE void Interpreter::ldrshOf(uint32_t opcode, uint32_t op2) // LDRSH R
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 5 : (cpu ? 3 : 1);
 }
 
-FORCE_INLINE void Interpreter::ldrbOf(uint32_t opcode, uint32_t op2) // LDRB Rd,[Rn,op2]
+FORCE_INLINE int Interpreter::ldrbOf(uint32_t opcode, uint32_t op2) // LDRB Rd,[Rn,op2]
 {
     // Decode the other operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
     uint32_t op1 = *registers[(opcode & 0x000F0000) >> 16];
 
     // Byte load, pre-adjust without writeback
-    *op0 = core->memory.read<uint8_t>(cpu, op1 + op2);
+    *op0 = read<uint8_t>(op1 + op2);
 
     // Handle pipelining and THUMB switching
     if (op0 == registers[15])
@@ -137,9 +155,11 @@ FORCE_INLINE void Interpreter::ldrbOf(uint32_t opcode, uint32_t op2) // LDRB Rd,
             *registers[15] = (*registers[15] & ~3) + 4;
         }
     }
+
+    return (op0 == registers[15]) ? 5 : (cpu ? 3 : 1);
 }
 
-FORCE_INLINE void Interpreter::strbOf(uint32_t opcode, uint32_t op2) // STRB Rd,[Rn,op2]
+FORCE_INLINE int Interpreter::strbOf(uint32_t opcode, uint32_t op2) // STRB Rd,[Rn,op2]
 {
     // Decode the other operands
     // When used as Rd, the program counter is read with +4
@@ -147,17 +167,19 @@ FORCE_INLINE void Interpreter::strbOf(uint32_t opcode, uint32_t op2) // STRB Rd,
     uint32_t op1 = *registers[(opcode & 0x000F0000) >> 16];
 
     // Byte store, pre-adjust without writeback
-    core->memory.write<uint8_t>(cpu, op1 + op2, op0);
+    write<uint8_t>(op1 + op2, op0);
+
+    return cpu ? 2 : 1;
 }
 
-FORCE_INLINE void Interpreter::ldrhOf(uint32_t opcode, uint32_t op2) // LDRH Rd,[Rn,op2]
+FORCE_INLINE int Interpreter::ldrhOf(uint32_t opcode, uint32_t op2) // LDRH Rd,[Rn,op2]
 {
     // Decode the other operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
     uint32_t op1 = *registers[(opcode & 0x000F0000) >> 16];
 
     // Half-word load, pre-adjust without writeback
-    *op0 = core->memory.read<uint16_t>(cpu, op1 += op2);
+    *op0 = read<uint16_t>(op1 += op2);
 
     // Rotate misaligned reads on ARM7
     if (cpu == 1 && (op1 & 1))
@@ -166,9 +188,11 @@ FORCE_INLINE void Interpreter::ldrhOf(uint32_t opcode, uint32_t op2) // LDRH Rd,
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 5 : (cpu ? 3 : 1);
 }
 
-FORCE_INLINE void Interpreter::strhOf(uint32_t opcode, uint32_t op2) // STRH Rd,[Rn,op2]
+FORCE_INLINE int Interpreter::strhOf(uint32_t opcode, uint32_t op2) // STRH Rd,[Rn,op2]
 {
     // Decode the other operands
     // When used as Rd, the program counter is read with +4
@@ -176,17 +200,19 @@ FORCE_INLINE void Interpreter::strhOf(uint32_t opcode, uint32_t op2) // STRH Rd,
     uint32_t op1 = *registers[(opcode & 0x000F0000) >> 16];
 
     // Half-word store, pre-adjust without writeback
-    core->memory.write<uint16_t>(cpu, op1 + op2, op0);
+    write<uint16_t>(op1 + op2, op0);
+
+    return cpu ? 2 : 1;
 }
 
-FORCE_INLINE void Interpreter::ldrOf(uint32_t opcode, uint32_t op2) // LDR Rd,[Rn,op2]
+FORCE_INLINE int Interpreter::ldrOf(uint32_t opcode, uint32_t op2) // LDR Rd,[Rn,op2]
 {
     // Decode the other operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
     uint32_t op1 = *registers[(opcode & 0x000F0000) >> 16];
 
     // Word load, pre-adjust without writeback
-    *op0 = core->memory.read<uint32_t>(cpu, op1 += op2);
+    *op0 = read<uint32_t>(op1 += op2);
 
     // Rotate misaligned reads
     if (op1 & 3)
@@ -208,9 +234,11 @@ FORCE_INLINE void Interpreter::ldrOf(uint32_t opcode, uint32_t op2) // LDR Rd,[R
             *registers[15] = (*registers[15] & ~3) + 4;
         }
     }
+
+    return (op0 == registers[15]) ? 5 : (cpu ? 3 : 1);
 }
 
-FORCE_INLINE void Interpreter::strOf(uint32_t opcode, uint32_t op2) // STR Rd,[Rn,op2]
+FORCE_INLINE int Interpreter::strOf(uint32_t opcode, uint32_t op2) // STR Rd,[Rn,op2]
 {
     // Decode the other operands
     // When used as Rd, the program counter is read with +4
@@ -218,38 +246,44 @@ FORCE_INLINE void Interpreter::strOf(uint32_t opcode, uint32_t op2) // STR Rd,[R
     uint32_t op1 = *registers[(opcode & 0x000F0000) >> 16];
 
     // Word store, pre-adjust without writeback
-    core->memory.write<uint32_t>(cpu, op1 + op2, op0);
+    write<uint32_t>(op1 + op2, op0);
+
+    return cpu ? 2 : 1;
 }
 
-FORCE_INLINE void Interpreter::ldrdOf(uint32_t opcode, uint32_t op2) // LDRD Rd,[Rn,op2]
+FORCE_INLINE int Interpreter::ldrdOf(uint32_t opcode, uint32_t op2) // LDRD Rd,[Rn,op2]
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the other operands
     uint8_t op0 = (opcode & 0x0000F000) >> 12;
-    if (op0 == 15) return;
+    if (op0 == 15) return 1;
     uint32_t op1 = *registers[(opcode & 0x000F0000) >> 16];
 
     // Double word load, pre-adjust without writeback
-    *registers[op0]     = core->memory.read<uint32_t>(cpu, op1 + op2);
-    *registers[op0 + 1] = core->memory.read<uint32_t>(cpu, op1 + op2 + 4);
+    *registers[op0]     = read<uint32_t>(op1 + op2);
+    *registers[op0 + 1] = read<uint32_t>(op1 + op2 + 4);
+
+    return 2;
 }
 
-FORCE_INLINE void Interpreter::strdOf(uint32_t opcode, uint32_t op2) // STRD Rd,[Rn,op2]
+FORCE_INLINE int Interpreter::strdOf(uint32_t opcode, uint32_t op2) // STRD Rd,[Rn,op2]
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the other operands
     uint8_t op0 = (opcode & 0x0000F000) >> 12;
-    if (op0 == 15) return;
+    if (op0 == 15) return 1;
     uint32_t op1 = *registers[(opcode & 0x000F0000) >> 16];
 
     // Double word store, pre-adjust without writeback
-    core->memory.write<uint32_t>(cpu, op1 + op2,     *registers[op0]);
-    core->memory.write<uint32_t>(cpu, op1 + op2 + 4, *registers[op0 + 1]);
+    write<uint32_t>(op1 + op2,     *registers[op0]);
+    write<uint32_t>(op1 + op2 + 4, *registers[op0 + 1]);
+
+    return 2;
 }
 
-FORCE_INLINE void Interpreter::ldrsbPr(uint32_t opcode, uint32_t op2) // LDRSB Rd,[Rn,op2]!
+FORCE_INLINE int Interpreter::ldrsbPr(uint32_t opcode, uint32_t op2) // LDRSB Rd,[Rn,op2]!
 {
     // Decode the other operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -257,14 +291,16 @@ FORCE_INLINE void Interpreter::ldrsbPr(uint32_t opcode, uint32_t op2) // LDRSB R
 
     // Signed byte load, pre-adjust with writeback
     *op1 += op2;
-    *op0 = core->memory.read<int8_t>(cpu, *op1);
+    *op0 = read<int8_t>(*op1);
 
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 5 : (cpu ? 3 : 1);
 }
 
-FORCE_INLINE void Interpreter::ldrshPr(uint32_t opcode, uint32_t op2) // LDRSH Rd,[Rn,op2]!
+FORCE_INLINE int Interpreter::ldrshPr(uint32_t opcode, uint32_t op2) // LDRSH Rd,[Rn,op2]!
 {
     // Decode the other operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -273,7 +309,7 @@ FORCE_INLINE void Interpreter::ldrshPr(uint32_t opcode, uint32_t op2) // LDRSH R
 
     // Signed half-word load, pre-adjust with writeback
     *op1 += op2;
-    *op0 = core->memory.read<int16_t>(cpu, address = *op1);
+    *op0 = read<int16_t>(address = *op1);
 
     // Shift misaligned reads on ARM7
     if (cpu == 1 && (address & 1))
@@ -282,9 +318,11 @@ FORCE_INLINE void Interpreter::ldrshPr(uint32_t opcode, uint32_t op2) // LDRSH R
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 5 : (cpu ? 3 : 1);
 }
 
-FORCE_INLINE void Interpreter::ldrbPr(uint32_t opcode, uint32_t op2) // LDRB Rd,[Rn,op2]!
+FORCE_INLINE int Interpreter::ldrbPr(uint32_t opcode, uint32_t op2) // LDRB Rd,[Rn,op2]!
 {
     // Decode the other operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -292,7 +330,7 @@ FORCE_INLINE void Interpreter::ldrbPr(uint32_t opcode, uint32_t op2) // LDRB Rd,
 
     // Byte load, pre-adjust with writeback
     *op1 += op2;
-    *op0 = core->memory.read<uint8_t>(cpu, *op1);
+    *op0 = read<uint8_t>(*op1);
 
     // Handle pipelining and THUMB switching
     if (op0 == registers[15])
@@ -307,9 +345,11 @@ FORCE_INLINE void Interpreter::ldrbPr(uint32_t opcode, uint32_t op2) // LDRB Rd,
             *registers[15] = (*registers[15] & ~3) + 4;
         }
     }
+
+    return (op0 == registers[15]) ? 5 : (cpu ? 3 : 1);
 }
 
-FORCE_INLINE void Interpreter::strbPr(uint32_t opcode, uint32_t op2) // STRB Rd,[Rn,op2]!
+FORCE_INLINE int Interpreter::strbPr(uint32_t opcode, uint32_t op2) // STRB Rd,[Rn,op2]!
 {
     // Decode the other operands
     // When used as Rd, the program counter is read with +4
@@ -318,10 +358,12 @@ FORCE_INLINE void Interpreter::strbPr(uint32_t opcode, uint32_t op2) // STRB Rd,
 
     // Byte store, pre-adjust with writeback
     *op1 += op2;
-    core->memory.write<uint8_t>(cpu, *op1, op0);
+    write<uint8_t>(*op1, op0);
+
+    return cpu ? 2 : 1;
 }
 
-FORCE_INLINE void Interpreter::ldrhPr(uint32_t opcode, uint32_t op2) // LDRH Rd,[Rn,op2]!
+FORCE_INLINE int Interpreter::ldrhPr(uint32_t opcode, uint32_t op2) // LDRH Rd,[Rn,op2]!
 {
     // Decode the other operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -330,7 +372,7 @@ FORCE_INLINE void Interpreter::ldrhPr(uint32_t opcode, uint32_t op2) // LDRH Rd,
 
     // Half-word load, pre-adjust with writeback
     *op1 += op2;
-    *op0 = core->memory.read<uint16_t>(cpu, address = *op1);
+    *op0 = read<uint16_t>(address = *op1);
 
     // Rotate misaligned reads on ARM7
     if (cpu == 1 && (address & 1))
@@ -339,9 +381,11 @@ FORCE_INLINE void Interpreter::ldrhPr(uint32_t opcode, uint32_t op2) // LDRH Rd,
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 5 : (cpu ? 3 : 1);
 }
 
-FORCE_INLINE void Interpreter::strhPr(uint32_t opcode, uint32_t op2) // STRH Rd,[Rn,op2]!
+FORCE_INLINE int Interpreter::strhPr(uint32_t opcode, uint32_t op2) // STRH Rd,[Rn,op2]!
 {
     // Decode the other operands
     // When used as Rd, the program counter is read with +4
@@ -350,10 +394,12 @@ FORCE_INLINE void Interpreter::strhPr(uint32_t opcode, uint32_t op2) // STRH Rd,
 
     // Half-word store, pre-adjust with writeback
     *op1 += op2;
-    core->memory.write<uint16_t>(cpu, *op1, op0);
+    write<uint16_t>(*op1, op0);
+
+    return cpu ? 2 : 1;
 }
 
-FORCE_INLINE void Interpreter::ldrPr(uint32_t opcode, uint32_t op2) // LDR Rd,[Rn,op2]!
+FORCE_INLINE int Interpreter::ldrPr(uint32_t opcode, uint32_t op2) // LDR Rd,[Rn,op2]!
 {
     // Decode the other operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -362,7 +408,7 @@ FORCE_INLINE void Interpreter::ldrPr(uint32_t opcode, uint32_t op2) // LDR Rd,[R
 
     // Word load, pre-adjust with writeback
     *op1 += op2;
-    *op0 = core->memory.read<uint32_t>(cpu, address = *op1);
+    *op0 = read<uint32_t>(address = *op1);
 
     // Rotate misaligned reads
     if (address & 3)
@@ -384,9 +430,11 @@ FORCE_INLINE void Interpreter::ldrPr(uint32_t opcode, uint32_t op2) // LDR Rd,[R
             *registers[15] = (*registers[15] & ~3) + 4;
         }
     }
+
+    return (op0 == registers[15]) ? 5 : (cpu ? 3 : 1);
 }
 
-FORCE_INLINE void Interpreter::strPr(uint32_t opcode, uint32_t op2) // STR Rd,[Rn,op2]!
+FORCE_INLINE int Interpreter::strPr(uint32_t opcode, uint32_t op2) // STR Rd,[Rn,op2]!
 {
     // Decode the other operands
     // When used as Rd, the program counter is read with +4
@@ -395,55 +443,63 @@ FORCE_INLINE void Interpreter::strPr(uint32_t opcode, uint32_t op2) // STR Rd,[R
 
     // Word store, pre-adjust with writeback
     *op1 += op2;
-    core->memory.write<uint32_t>(cpu, *op1, op0);
+    write<uint32_t>(*op1, op0);
+
+    return cpu ? 2 : 1;
 }
 
-FORCE_INLINE void Interpreter::ldrdPr(uint32_t opcode, uint32_t op2) // LDRD Rd,[Rn,op2]!
+FORCE_INLINE int Interpreter::ldrdPr(uint32_t opcode, uint32_t op2) // LDRD Rd,[Rn,op2]!
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the other operands
     uint8_t op0 = (opcode & 0x0000F000) >> 12;
-    if (op0 == 15) return;
+    if (op0 == 15) return 1;
     uint32_t *op1 = registers[(opcode & 0x000F0000) >> 16];
 
     // Double word load, pre-adjust with writeback
     *op1 += op2;
-    *registers[op0]     = core->memory.read<uint32_t>(cpu, *op1);
-    *registers[op0 + 1] = core->memory.read<uint32_t>(cpu, *op1 + 4);
+    *registers[op0]     = read<uint32_t>(*op1);
+    *registers[op0 + 1] = read<uint32_t>(*op1 + 4);
+
+    return 2;
 }
 
-FORCE_INLINE void Interpreter::strdPr(uint32_t opcode, uint32_t op2) // STRD Rd,[Rn,op2]!
+FORCE_INLINE int Interpreter::strdPr(uint32_t opcode, uint32_t op2) // STRD Rd,[Rn,op2]!
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the other operands
     uint8_t op0 = (opcode & 0x0000F000) >> 12;
-    if (op0 == 15) return;
+    if (op0 == 15) return 1;
     uint32_t *op1 = registers[(opcode & 0x000F0000) >> 16];
 
     // Double word store, pre-adjust with writeback
     *op1 += op2;
-    core->memory.write<uint32_t>(cpu, *op1,     *registers[op0]);
-    core->memory.write<uint32_t>(cpu, *op1 + 4, *registers[op0 + 1]);
+    write<uint32_t>(*op1,     *registers[op0]);
+    write<uint32_t>(*op1 + 4, *registers[op0 + 1]);
+
+    return 2;
 }
 
-FORCE_INLINE void Interpreter::ldrsbPt(uint32_t opcode, uint32_t op2) // LDRSB Rd,[Rn],op2
+FORCE_INLINE int Interpreter::ldrsbPt(uint32_t opcode, uint32_t op2) // LDRSB Rd,[Rn],op2
 {
     // Decode the other operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
     uint32_t *op1 = registers[(opcode & 0x000F0000) >> 16];
 
     // Signed byte load, post-adjust
-    *op0 = core->memory.read<int8_t>(cpu, *op1);
+    *op0 = read<int8_t>(*op1);
     if (op0 != op1) *op1 += op2;
 
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 5 : (cpu ? 3 : 1);
 }
 
-FORCE_INLINE void Interpreter::ldrshPt(uint32_t opcode, uint32_t op2) // LDRSH Rd,[Rn],op2
+FORCE_INLINE int Interpreter::ldrshPt(uint32_t opcode, uint32_t op2) // LDRSH Rd,[Rn],op2
 {
     // Decode the other operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -451,7 +507,7 @@ FORCE_INLINE void Interpreter::ldrshPt(uint32_t opcode, uint32_t op2) // LDRSH R
     uint32_t address;
 
     // Signed half-word load, post-adjust
-    *op0 = core->memory.read<int16_t>(cpu, address = *op1);
+    *op0 = read<int16_t>(address = *op1);
     if (op0 != op1) *op1 += op2;
 
     // Shift misaligned reads on ARM7
@@ -461,16 +517,18 @@ FORCE_INLINE void Interpreter::ldrshPt(uint32_t opcode, uint32_t op2) // LDRSH R
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 5 : (cpu ? 3 : 1);
 }
 
-FORCE_INLINE void Interpreter::ldrbPt(uint32_t opcode, uint32_t op2) // LDRB Rd,[Rn],op2
+FORCE_INLINE int Interpreter::ldrbPt(uint32_t opcode, uint32_t op2) // LDRB Rd,[Rn],op2
 {
     // Decode the other operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
     uint32_t *op1 = registers[(opcode & 0x000F0000) >> 16];
 
     // Byte load, post-adjust
-    *op0 = core->memory.read<uint8_t>(cpu, *op1);
+    *op0 = read<uint8_t>(*op1);
     if (op0 != op1) *op1 += op2;
 
     // Handle pipelining and THUMB switching
@@ -486,9 +544,11 @@ FORCE_INLINE void Interpreter::ldrbPt(uint32_t opcode, uint32_t op2) // LDRB Rd,
             *registers[15] = (*registers[15] & ~3) + 4;
         }
     }
+
+    return (op0 == registers[15]) ? 5 : (cpu ? 3 : 1);
 }
 
-FORCE_INLINE void Interpreter::strbPt(uint32_t opcode, uint32_t op2) // STRB Rd,[Rn],op2
+FORCE_INLINE int Interpreter::strbPt(uint32_t opcode, uint32_t op2) // STRB Rd,[Rn],op2
 {
     // Decode the other operands
     // When used as Rd, the program counter is read with +4
@@ -496,11 +556,13 @@ FORCE_INLINE void Interpreter::strbPt(uint32_t opcode, uint32_t op2) // STRB Rd,
     uint32_t *op1 = registers[(opcode & 0x000F0000) >> 16];
 
     // Byte store, post-adjust
-    core->memory.write<uint8_t>(cpu, *op1, op0);
+    write<uint8_t>(*op1, op0);
     *op1 += op2;
+
+    return cpu ? 2 : 1;
 }
 
-FORCE_INLINE void Interpreter::ldrhPt(uint32_t opcode, uint32_t op2) // LDRH Rd,[Rn],op2
+FORCE_INLINE int Interpreter::ldrhPt(uint32_t opcode, uint32_t op2) // LDRH Rd,[Rn],op2
 {
     // Decode the other operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -508,7 +570,7 @@ FORCE_INLINE void Interpreter::ldrhPt(uint32_t opcode, uint32_t op2) // LDRH Rd,
     uint32_t address;
 
     // Half-word load, post-adjust
-    *op0 = core->memory.read<uint16_t>(cpu, address = *op1);
+    *op0 = read<uint16_t>(address = *op1);
     *op1 += op2;
 
     // Rotate misaligned reads on ARM7
@@ -518,9 +580,11 @@ FORCE_INLINE void Interpreter::ldrhPt(uint32_t opcode, uint32_t op2) // LDRH Rd,
     // Handle pipelining
     if (op0 == registers[15])
         *registers[15] = (*registers[15] & ~3) + 4;
+
+    return (op0 == registers[15]) ? 5 : (cpu ? 3 : 1);
 }
 
-FORCE_INLINE void Interpreter::strhPt(uint32_t opcode, uint32_t op2) // STRH Rd,[Rn],op2
+FORCE_INLINE int Interpreter::strhPt(uint32_t opcode, uint32_t op2) // STRH Rd,[Rn],op2
 {
     // Decode the other operands
     // When used as Rd, the program counter is read with +4
@@ -528,11 +592,13 @@ FORCE_INLINE void Interpreter::strhPt(uint32_t opcode, uint32_t op2) // STRH Rd,
     uint32_t *op1 = registers[(opcode & 0x000F0000) >> 16];
 
     // Half-word store, post-adjust
-    core->memory.write<uint16_t>(cpu, *op1, op0);
+    write<uint16_t>(*op1, op0);
     *op1 += op2;
+
+    return cpu ? 2 : 1;
 }
 
-FORCE_INLINE void Interpreter::ldrPt(uint32_t opcode, uint32_t op2) // LDR Rd,[Rn],op2
+FORCE_INLINE int Interpreter::ldrPt(uint32_t opcode, uint32_t op2) // LDR Rd,[Rn],op2
 {
     // Decode the other operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -540,7 +606,7 @@ FORCE_INLINE void Interpreter::ldrPt(uint32_t opcode, uint32_t op2) // LDR Rd,[R
     uint32_t address;
 
     // Word load
-    *op0 = core->memory.read<uint32_t>(cpu, address = *op1);
+    *op0 = read<uint32_t>(address = *op1);
 
     // Rotate misaligned reads
     if (address & 3)
@@ -565,9 +631,11 @@ FORCE_INLINE void Interpreter::ldrPt(uint32_t opcode, uint32_t op2) // LDR Rd,[R
             *registers[15] = (*registers[15] & ~3) + 4;
         }
     }
+
+    return (op0 == registers[15]) ? 5 : (cpu ? 3 : 1);
 }
 
-FORCE_INLINE void Interpreter::strPt(uint32_t opcode, uint32_t op2) // STR Rd,[Rn],op2
+FORCE_INLINE int Interpreter::strPt(uint32_t opcode, uint32_t op2) // STR Rd,[Rn],op2
 {
     // Decode the other operands
     // When used as Rd, the program counter is read with +4
@@ -575,41 +643,47 @@ FORCE_INLINE void Interpreter::strPt(uint32_t opcode, uint32_t op2) // STR Rd,[R
     uint32_t *op1 = registers[(opcode & 0x000F0000) >> 16];
 
     // Word store, post-adjust
-    core->memory.write<uint32_t>(cpu, *op1, op0);
+    write<uint32_t>(*op1, op0);
     *op1 += op2;
+
+    return cpu ? 2 : 1;
 }
 
-FORCE_INLINE void Interpreter::ldrdPt(uint32_t opcode, uint32_t op2) // LDRD Rd,[Rn],op2
+FORCE_INLINE int Interpreter::ldrdPt(uint32_t opcode, uint32_t op2) // LDRD Rd,[Rn],op2
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the other operands
     uint8_t op0 = (opcode & 0x0000F000) >> 12;
-    if (op0 == 15) return;
+    if (op0 == 15) return 1;
     uint32_t *op1 = registers[(opcode & 0x000F0000) >> 16];
 
     // Double word load, post-adjust
-    *registers[op0]     = core->memory.read<uint32_t>(cpu, *op1);
-    *registers[op0 + 1] = core->memory.read<uint32_t>(cpu, *op1 + 4);
+    *registers[op0]     = read<uint32_t>(*op1);
+    *registers[op0 + 1] = read<uint32_t>(*op1 + 4);
     *op1 += op2;
+
+    return 2;
 }
 
-FORCE_INLINE void Interpreter::strdPt(uint32_t opcode, uint32_t op2) // STRD Rd,[Rn],op2
+FORCE_INLINE int Interpreter::strdPt(uint32_t opcode, uint32_t op2) // STRD Rd,[Rn],op2
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the other operands
     uint8_t op0 = (opcode & 0x0000F000) >> 12;
-    if (op0 == 15) return;
+    if (op0 == 15) return 1;
     uint32_t *op1 = registers[(opcode & 0x000F0000) >> 16];
 
     // Double word store, post-adjust
-    core->memory.write<uint32_t>(cpu, *op1,     *registers[op0]);
-    core->memory.write<uint32_t>(cpu, *op1 + 4, *registers[op0 + 1]);
+    write<uint32_t>(*op1,     *registers[op0]);
+    write<uint32_t>(*op1 + 4, *registers[op0 + 1]);
     *op1 += op2;
+
+    return 2;
 }
 
-FORCE_INLINE void Interpreter::swpb(uint32_t opcode) // SWPB Rd,Rm,[Rn]
+FORCE_INLINE int Interpreter::swpb(uint32_t opcode) // SWPB Rd,Rm,[Rn]
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -617,11 +691,13 @@ FORCE_INLINE void Interpreter::swpb(uint32_t opcode) // SWPB Rd,Rm,[Rn]
     uint32_t op2 = *registers[(opcode & 0x000F0000) >> 16];
 
     // Swap
-    *op0 = core->memory.read<uint8_t>(cpu, op2);
-    core->memory.write<uint8_t>(cpu, op2, op1);
+    *op0 = read<uint8_t>(op2);
+    write<uint8_t>(op2, op1);
+
+    return cpu ? 4 : 2;
 }
 
-FORCE_INLINE void Interpreter::swp(uint32_t opcode) // SWP Rd,Rm,[Rn]
+FORCE_INLINE int Interpreter::swp(uint32_t opcode) // SWP Rd,Rm,[Rn]
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
@@ -629,8 +705,8 @@ FORCE_INLINE void Interpreter::swp(uint32_t opcode) // SWP Rd,Rm,[Rn]
     uint32_t op2 = *registers[(opcode & 0x000F0000) >> 16];
 
     // Swap
-    *op0 = core->memory.read<uint32_t>(cpu, op2);
-    core->memory.write<uint32_t>(cpu, op2, op1);
+    *op0 = read<uint32_t>(op2);
+    write<uint32_t>(op2, op1);
 
     // Rotate misaligned reads
     if (op2 & 3)
@@ -638,9 +714,11 @@ FORCE_INLINE void Interpreter::swp(uint32_t opcode) // SWP Rd,Rm,[Rn]
         int shift = (op2 & 3) * 8;
         *op0 = (*op0 << (32 - shift)) | (*op0 >> shift);
     }
+
+    return cpu ? 4 : 2;
 }
 
-FORCE_INLINE void Interpreter::ldmda(uint32_t opcode) // LDMDA Rn, <Rlist>
+FORCE_INLINE int Interpreter::ldmda(uint32_t opcode) // LDMDA Rn, <Rlist>
 {
     // Decode the operand
     uint32_t op0 = *registers[(opcode & 0x000F0000) >> 16];
@@ -658,7 +736,7 @@ FORCE_INLINE void Interpreter::ldmda(uint32_t opcode) // LDMDA Rn, <Rlist>
         if (opcode & BIT(i))
         {
             op0 += 4;
-            *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+            *registers[i] = read<uint32_t>(op0);
         }
     }
 
@@ -675,9 +753,11 @@ FORCE_INLINE void Interpreter::ldmda(uint32_t opcode) // LDMDA Rn, <Rlist>
             *registers[15] = (*registers[15] & ~3) + 4;
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, true);
 }
 
-FORCE_INLINE void Interpreter::stmda(uint32_t opcode) // STMDA Rn, <Rlist>
+FORCE_INLINE int Interpreter::stmda(uint32_t opcode) // STMDA Rn, <Rlist>
 {
     // Decode the operand
     uint32_t op0 = *registers[(opcode & 0x000F0000) >> 16];
@@ -695,12 +775,14 @@ FORCE_INLINE void Interpreter::stmda(uint32_t opcode) // STMDA Rn, <Rlist>
         if (opcode & BIT(i))
         {
             op0 += 4;
-            core->memory.write<uint32_t>(cpu, op0, *registers[i]);
+            write<uint32_t>(op0, *registers[i]);
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, false);
 }
 
-FORCE_INLINE void Interpreter::ldmia(uint32_t opcode) // LDMIA Rn, <Rlist>
+FORCE_INLINE int Interpreter::ldmia(uint32_t opcode) // LDMIA Rn, <Rlist>
 {
     // Decode the operand
     uint32_t op0 = *registers[(opcode & 0x000F0000) >> 16];
@@ -710,7 +792,7 @@ FORCE_INLINE void Interpreter::ldmia(uint32_t opcode) // LDMIA Rn, <Rlist>
     {
         if (opcode & BIT(i))
         {
-            *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+            *registers[i] = read<uint32_t>(op0);
             op0 += 4;
         }
     }
@@ -728,9 +810,11 @@ FORCE_INLINE void Interpreter::ldmia(uint32_t opcode) // LDMIA Rn, <Rlist>
             *registers[15] = (*registers[15] & ~3) + 4;
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, true);
 }
 
-FORCE_INLINE void Interpreter::stmia(uint32_t opcode) // STMIA Rn, <Rlist>
+FORCE_INLINE int Interpreter::stmia(uint32_t opcode) // STMIA Rn, <Rlist>
 {
     // Decode the operand
     uint32_t op0 = *registers[(opcode & 0x000F0000) >> 16];
@@ -740,13 +824,15 @@ FORCE_INLINE void Interpreter::stmia(uint32_t opcode) // STMIA Rn, <Rlist>
     {
         if (opcode & BIT(i))
         {
-            core->memory.write<uint32_t>(cpu, op0, *registers[i]);
+            write<uint32_t>(op0, *registers[i]);
             op0 += 4;
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, false);
 }
 
-FORCE_INLINE void Interpreter::ldmdb(uint32_t opcode) // LDMDB Rn, <Rlist>
+FORCE_INLINE int Interpreter::ldmdb(uint32_t opcode) // LDMDB Rn, <Rlist>
 {
     // Decode the operand
     uint32_t op0 = *registers[(opcode & 0x000F0000) >> 16];
@@ -763,7 +849,7 @@ FORCE_INLINE void Interpreter::ldmdb(uint32_t opcode) // LDMDB Rn, <Rlist>
     {
         if (opcode & BIT(i))
         {
-            *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+            *registers[i] = read<uint32_t>(op0);
             op0 += 4;
         }
     }
@@ -781,9 +867,11 @@ FORCE_INLINE void Interpreter::ldmdb(uint32_t opcode) // LDMDB Rn, <Rlist>
             *registers[15] = (*registers[15] & ~3) + 4;
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, true);
 }
 
-FORCE_INLINE void Interpreter::stmdb(uint32_t opcode) // STMDB Rn, <Rlist>
+FORCE_INLINE int Interpreter::stmdb(uint32_t opcode) // STMDB Rn, <Rlist>
 {
     // Decode the operand
     uint32_t op0 = *registers[(opcode & 0x000F0000) >> 16];
@@ -800,13 +888,15 @@ FORCE_INLINE void Interpreter::stmdb(uint32_t opcode) // STMDB Rn, <Rlist>
     {
         if (opcode & BIT(i))
         {
-            core->memory.write<uint32_t>(cpu, op0, *registers[i]);
+            write<uint32_t>(op0, *registers[i]);
             op0 += 4;
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, false);
 }
 
-FORCE_INLINE void Interpreter::ldmib(uint32_t opcode) // LDMIB Rn, <Rlist>
+FORCE_INLINE int Interpreter::ldmib(uint32_t opcode) // LDMIB Rn, <Rlist>
 {
     // Decode the operand
     uint32_t op0 = *registers[(opcode & 0x000F0000) >> 16];
@@ -817,7 +907,7 @@ FORCE_INLINE void Interpreter::ldmib(uint32_t opcode) // LDMIB Rn, <Rlist>
         if (opcode & BIT(i))
         {
             op0 += 4;
-            *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+            *registers[i] = read<uint32_t>(op0);
         }
     }
 
@@ -834,9 +924,11 @@ FORCE_INLINE void Interpreter::ldmib(uint32_t opcode) // LDMIB Rn, <Rlist>
             *registers[15] = (*registers[15] & ~3) + 4;
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, true);
 }
 
-FORCE_INLINE void Interpreter::stmib(uint32_t opcode) // STMIB Rn, <Rlist>
+FORCE_INLINE int Interpreter::stmib(uint32_t opcode) // STMIB Rn, <Rlist>
 {
     // Decode the operand
     uint32_t op0 = *registers[(opcode & 0x000F0000) >> 16];
@@ -847,12 +939,14 @@ FORCE_INLINE void Interpreter::stmib(uint32_t opcode) // STMIB Rn, <Rlist>
         if (opcode & BIT(i))
         {
             op0 += 4;
-            core->memory.write<uint32_t>(cpu, op0, *registers[i]);
+            write<uint32_t>(op0, *registers[i]);
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, false);
 }
 
-FORCE_INLINE void Interpreter::ldmdaW(uint32_t opcode) // LDMDA Rn!, <Rlist>
+FORCE_INLINE int Interpreter::ldmdaW(uint32_t opcode) // LDMDA Rn!, <Rlist>
 {
     // Decode the operand
     int n = (opcode & 0x000F0000) >> 16;
@@ -873,7 +967,7 @@ FORCE_INLINE void Interpreter::ldmdaW(uint32_t opcode) // LDMDA Rn!, <Rlist>
         if (opcode & BIT(i))
         {
             op0 += 4;
-            *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+            *registers[i] = read<uint32_t>(op0);
         }
     }
 
@@ -896,9 +990,11 @@ FORCE_INLINE void Interpreter::ldmdaW(uint32_t opcode) // LDMDA Rn!, <Rlist>
             *registers[15] = (*registers[15] & ~3) + 4;
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, true);
 }
 
-FORCE_INLINE void Interpreter::stmdaW(uint32_t opcode) // STMDA Rn!, <Rlist>
+FORCE_INLINE int Interpreter::stmdaW(uint32_t opcode) // STMDA Rn!, <Rlist>
 {
     // Decode the operand
     int n = (opcode & 0x000F0000) >> 16;
@@ -924,15 +1020,17 @@ FORCE_INLINE void Interpreter::stmdaW(uint32_t opcode) // STMDA Rn!, <Rlist>
         if (opcode & BIT(i))
         {
             op0 += 4;
-            core->memory.write<uint32_t>(cpu, op0, *registers[i]);
+            write<uint32_t>(op0, *registers[i]);
         }
     }
 
     // Writeback
     *registers[n] = writeback;
+
+    return blockCycles(opcode & 0xFFFF, false);
 }
 
-FORCE_INLINE void Interpreter::ldmiaW(uint32_t opcode) // LDMIA Rn!, <Rlist>
+FORCE_INLINE int Interpreter::ldmiaW(uint32_t opcode) // LDMIA Rn!, <Rlist>
 {
     // Decode the operand
     int n = (opcode & 0x000F0000) >> 16;
@@ -943,7 +1041,7 @@ FORCE_INLINE void Interpreter::ldmiaW(uint32_t opcode) // LDMIA Rn!, <Rlist>
     {
         if (opcode & BIT(i))
         {
-            *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+            *registers[i] = read<uint32_t>(op0);
             op0 += 4;
         }
     }
@@ -967,9 +1065,11 @@ FORCE_INLINE void Interpreter::ldmiaW(uint32_t opcode) // LDMIA Rn!, <Rlist>
             *registers[15] = (*registers[15] & ~3) + 4;
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, true);
 }
 
-FORCE_INLINE void Interpreter::stmiaW(uint32_t opcode) // STMIA Rn!, <Rlist>
+FORCE_INLINE int Interpreter::stmiaW(uint32_t opcode) // STMIA Rn!, <Rlist>
 {
     // Decode the operand
     int n = (opcode & 0x000F0000) >> 16;
@@ -993,16 +1093,18 @@ FORCE_INLINE void Interpreter::stmiaW(uint32_t opcode) // STMIA Rn!, <Rlist>
     {
         if (opcode & BIT(i))
         {
-            core->memory.write<uint32_t>(cpu, op0, *registers[i]);
+            write<uint32_t>(op0, *registers[i]);
             op0 += 4;
         }
     }
 
     // Writeback
     *registers[n] = op0;
+
+    return blockCycles(opcode & 0xFFFF, false);
 }
 
-FORCE_INLINE void Interpreter::ldmdbW(uint32_t opcode) // LDMDB Rn!, <Rlist>
+FORCE_INLINE int Interpreter::ldmdbW(uint32_t opcode) // LDMDB Rn!, <Rlist>
 {
     // Decode the operand
     int n = (opcode & 0x000F0000) >> 16;
@@ -1022,7 +1124,7 @@ FORCE_INLINE void Interpreter::ldmdbW(uint32_t opcode) // LDMDB Rn!, <Rlist>
     {
         if (opcode & BIT(i))
         {
-            *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+            *registers[i] = read<uint32_t>(op0);
             op0 += 4;
         }
     }
@@ -1046,9 +1148,11 @@ FORCE_INLINE void Interpreter::ldmdbW(uint32_t opcode) // LDMDB Rn!, <Rlist>
             *registers[15] = (*registers[15] & ~3) + 4;
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, true);
 }
 
-FORCE_INLINE void Interpreter::stmdbW(uint32_t opcode) // STMDB Rn!, <Rlist>
+FORCE_INLINE int Interpreter::stmdbW(uint32_t opcode) // STMDB Rn!, <Rlist>
 {
     // Decode the operand
     int n = (opcode & 0x000F0000) >> 16;
@@ -1073,16 +1177,18 @@ FORCE_INLINE void Interpreter::stmdbW(uint32_t opcode) // STMDB Rn!, <Rlist>
     {
         if (opcode & BIT(i))
         {
-            core->memory.write<uint32_t>(cpu, op0, *registers[i]);
+            write<uint32_t>(op0, *registers[i]);
             op0 += 4;
         }
     }
 
     // Writeback
     *registers[n] = writeback;
+
+    return blockCycles(opcode & 0xFFFF, false);
 }
 
-FORCE_INLINE void Interpreter::ldmibW(uint32_t opcode) // LDMIB Rn!, <Rlist>
+FORCE_INLINE int Interpreter::ldmibW(uint32_t opcode) // LDMIB Rn!, <Rlist>
 {
     // Decode the operand
     int n = (opcode & 0x000F0000) >> 16;
@@ -1094,7 +1200,7 @@ FORCE_INLINE void Interpreter::ldmibW(uint32_t opcode) // LDMIB Rn!, <Rlist>
         if (opcode & BIT(i))
         {
             op0 += 4;
-            *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+            *registers[i] = read<uint32_t>(op0);
         }
     }
 
@@ -1117,9 +1223,11 @@ FORCE_INLINE void Interpreter::ldmibW(uint32_t opcode) // LDMIB Rn!, <Rlist>
             *registers[15] = (*registers[15] & ~3) + 4;
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, true);
 }
 
-FORCE_INLINE void Interpreter::stmibW(uint32_t opcode) // STMIB Rn!, <Rlist>
+FORCE_INLINE int Interpreter::stmibW(uint32_t opcode) // STMIB Rn!, <Rlist>
 {
     // Decode the operand
     int n = (opcode & 0x000F0000) >> 16;
@@ -1144,15 +1252,17 @@ FORCE_INLINE void Interpreter::stmibW(uint32_t opcode) // STMIB Rn!, <Rlist>
         if (opcode & BIT(i))
         {
             op0 += 4;
-            core->memory.write<uint32_t>(cpu, op0, *registers[i]);
+            write<uint32_t>(op0, *registers[i]);
         }
     }
 
     // Writeback
     *registers[n] = op0;
+
+    return blockCycles(opcode & 0xFFFF, false);
 }
 
-FORCE_INLINE void Interpreter::ldmdaU(uint32_t opcode) // LDMDA Rn, <Rlist>^
+FORCE_INLINE int Interpreter::ldmdaU(uint32_t opcode) // LDMDA Rn, <Rlist>^
 {
     // Decode the operand
     uint32_t op0 = *registers[(opcode & 0x000F0000) >> 16];
@@ -1172,7 +1282,7 @@ FORCE_INLINE void Interpreter::ldmdaU(uint32_t opcode) // LDMDA Rn, <Rlist>^
             if (opcode & BIT(i))
             {
                 op0 += 4;
-                *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+                *registers[i] = read<uint32_t>(op0);
             }
         }
 
@@ -1202,13 +1312,15 @@ FORCE_INLINE void Interpreter::ldmdaU(uint32_t opcode) // LDMDA Rn, <Rlist>^
             if (opcode & BIT(i))
             {
                 op0 += 4;
-                registersUsr[i] = core->memory.read<uint32_t>(cpu, op0);
+                registersUsr[i] = read<uint32_t>(op0);
             }
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, true);
 }
 
-FORCE_INLINE void Interpreter::stmdaU(uint32_t opcode) // STMDA Rn, <Rlist>^
+FORCE_INLINE int Interpreter::stmdaU(uint32_t opcode) // STMDA Rn, <Rlist>^
 {
     // Decode the operand
     uint32_t op0 = *registers[(opcode & 0x000F0000) >> 16];
@@ -1226,12 +1338,14 @@ FORCE_INLINE void Interpreter::stmdaU(uint32_t opcode) // STMDA Rn, <Rlist>^
         if (opcode & BIT(i))
         {
             op0 += 4;
-            core->memory.write<uint32_t>(cpu, op0, registersUsr[i]);
+            write<uint32_t>(op0, registersUsr[i]);
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, false);
 }
 
-FORCE_INLINE void Interpreter::ldmiaU(uint32_t opcode) // LDMIA Rn, <Rlist>^
+FORCE_INLINE int Interpreter::ldmiaU(uint32_t opcode) // LDMIA Rn, <Rlist>^
 {
     // Decode the operand
     uint32_t op0 = *registers[(opcode & 0x000F0000) >> 16];
@@ -1243,7 +1357,7 @@ FORCE_INLINE void Interpreter::ldmiaU(uint32_t opcode) // LDMIA Rn, <Rlist>^
         {
             if (opcode & BIT(i))
             {
-                *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+                *registers[i] = read<uint32_t>(op0);
                 op0 += 4;
             }
         }
@@ -1273,14 +1387,16 @@ FORCE_INLINE void Interpreter::ldmiaU(uint32_t opcode) // LDMIA Rn, <Rlist>^
         {
             if (opcode & BIT(i))
             {
-                registersUsr[i] = core->memory.read<uint32_t>(cpu, op0);
+                registersUsr[i] = read<uint32_t>(op0);
                 op0 += 4;
             }
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, true);
 }
 
-FORCE_INLINE void Interpreter::stmiaU(uint32_t opcode) // STMIA Rn, <Rlist>^
+FORCE_INLINE int Interpreter::stmiaU(uint32_t opcode) // STMIA Rn, <Rlist>^
 {
     // Decode the operand
     uint32_t op0 = *registers[(opcode & 0x000F0000) >> 16];
@@ -1290,13 +1406,15 @@ FORCE_INLINE void Interpreter::stmiaU(uint32_t opcode) // STMIA Rn, <Rlist>^
     {
         if (opcode & BIT(i))
         {
-            core->memory.write<uint32_t>(cpu, op0, registersUsr[i]);
+            write<uint32_t>(op0, registersUsr[i]);
             op0 += 4;
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, false);
 }
 
-FORCE_INLINE void Interpreter::ldmdbU(uint32_t opcode) // LDMDB Rn, <Rlist>^
+FORCE_INLINE int Interpreter::ldmdbU(uint32_t opcode) // LDMDB Rn, <Rlist>^
 {
     // Decode the operand
     uint32_t op0 = *registers[(opcode & 0x000F0000) >> 16];
@@ -1315,7 +1433,7 @@ FORCE_INLINE void Interpreter::ldmdbU(uint32_t opcode) // LDMDB Rn, <Rlist>^
         {
             if (opcode & BIT(i))
             {
-                *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+                *registers[i] = read<uint32_t>(op0);
                 op0 += 4;
             }
         }
@@ -1345,14 +1463,16 @@ FORCE_INLINE void Interpreter::ldmdbU(uint32_t opcode) // LDMDB Rn, <Rlist>^
         {
             if (opcode & BIT(i))
             {
-                registersUsr[i] = core->memory.read<uint32_t>(cpu, op0);
+                registersUsr[i] = read<uint32_t>(op0);
                 op0 += 4;
             }
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, true);
 }
 
-FORCE_INLINE void Interpreter::stmdbU(uint32_t opcode) // STMDB Rn, <Rlist>^
+FORCE_INLINE int Interpreter::stmdbU(uint32_t opcode) // STMDB Rn, <Rlist>^
 {
     // Decode the operand
     uint32_t op0 = *registers[(opcode & 0x000F0000) >> 16];
@@ -1369,13 +1489,15 @@ FORCE_INLINE void Interpreter::stmdbU(uint32_t opcode) // STMDB Rn, <Rlist>^
     {
         if (opcode & BIT(i))
         {
-            core->memory.write<uint32_t>(cpu, op0, registersUsr[i]);
+            write<uint32_t>(op0, registersUsr[i]);
             op0 += 4;
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, false);
 }
 
-FORCE_INLINE void Interpreter::ldmibU(uint32_t opcode) // LDMIB Rn, <Rlist>^
+FORCE_INLINE int Interpreter::ldmibU(uint32_t opcode) // LDMIB Rn, <Rlist>^
 {
     // Decode the operand
     uint32_t op0 = *registers[(opcode & 0x000F0000) >> 16];
@@ -1388,7 +1510,7 @@ FORCE_INLINE void Interpreter::ldmibU(uint32_t opcode) // LDMIB Rn, <Rlist>^
             if (opcode & BIT(i))
             {
                 op0 += 4;
-                *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+                *registers[i] = read<uint32_t>(op0);
             }
         }
 
@@ -1418,13 +1540,15 @@ FORCE_INLINE void Interpreter::ldmibU(uint32_t opcode) // LDMIB Rn, <Rlist>^
             if (opcode & BIT(i))
             {
                 op0 += 4;
-                registersUsr[i] = core->memory.read<uint32_t>(cpu, op0);
+                registersUsr[i] = read<uint32_t>(op0);
             }
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, true);
 }
 
-FORCE_INLINE void Interpreter::stmibU(uint32_t opcode) // STMIB Rn, <Rlist>^
+FORCE_INLINE int Interpreter::stmibU(uint32_t opcode) // STMIB Rn, <Rlist>^
 {
     // Decode the operand
     uint32_t op0 = *registers[(opcode & 0x000F0000) >> 16];
@@ -1435,12 +1559,14 @@ FORCE_INLINE void Interpreter::stmibU(uint32_t opcode) // STMIB Rn, <Rlist>^
         if (opcode & BIT(i))
         {
             op0 += 4;
-            core->memory.write<uint32_t>(cpu, op0, registersUsr[i]);
+            write<uint32_t>(op0, registersUsr[i]);
         }
     }
+
+    return blockCycles(opcode & 0xFFFF, false);
 }
 
-FORCE_INLINE void Interpreter::ldmdaUW(uint32_t opcode) // LDMDA Rn!, <Rlist>^
+FORCE_INLINE int Interpreter::ldmdaUW(uint32_t opcode) // LDMDA Rn!, <Rlist>^
 {
     // Decode the operand
     int n = (opcode & 0x000F0000) >> 16;
@@ -1463,7 +1589,7 @@ FORCE_INLINE void Interpreter::ldmdaUW(uint32_t opcode) // LDMDA Rn!, <Rlist>^
             if (opcode & BIT(i))
             {
                 op0 += 4;
-                *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+                *registers[i] = read<uint32_t>(op0);
             }
         }
 
@@ -1493,7 +1619,7 @@ FORCE_INLINE void Interpreter::ldmdaUW(uint32_t opcode) // LDMDA Rn!, <Rlist>^
             if (opcode & BIT(i))
             {
                 op0 += 4;
-                registersUsr[i] = core->memory.read<uint32_t>(cpu, op0);
+                registersUsr[i] = read<uint32_t>(op0);
             }
         }
     }
@@ -1503,9 +1629,11 @@ FORCE_INLINE void Interpreter::ldmdaUW(uint32_t opcode) // LDMDA Rn!, <Rlist>^
     // On ARM7, if Rn is in Rlist, writeback never happens
     if (!(opcode & BIT(n)) || (cpu == 0 && ((opcode & 0x0000FFFF) == BIT(n) || (opcode & 0x0000FFFF & ~(BIT(n + 1) - 1)))))
         *registers[n] = writeback;
+
+    return blockCycles(opcode & 0xFFFF, true);
 }
 
-FORCE_INLINE void Interpreter::stmdaUW(uint32_t opcode) // STMDA Rn!, <Rlist>^
+FORCE_INLINE int Interpreter::stmdaUW(uint32_t opcode) // STMDA Rn!, <Rlist>^
 {
     // Decode the operand
     int n = (opcode & 0x000F0000) >> 16;
@@ -1531,15 +1659,17 @@ FORCE_INLINE void Interpreter::stmdaUW(uint32_t opcode) // STMDA Rn!, <Rlist>^
         if (opcode & BIT(i))
         {
             op0 += 4;
-            core->memory.write<uint32_t>(cpu, op0, registersUsr[i]);
+            write<uint32_t>(op0, registersUsr[i]);
         }
     }
 
     // Writeback
     *registers[n] = writeback;
+
+    return blockCycles(opcode & 0xFFFF, false);
 }
 
-FORCE_INLINE void Interpreter::ldmiaUW(uint32_t opcode) // LDMIA Rn!, <Rlist>^
+FORCE_INLINE int Interpreter::ldmiaUW(uint32_t opcode) // LDMIA Rn!, <Rlist>^
 {
     // Decode the operand
     int n = (opcode & 0x000F0000) >> 16;
@@ -1552,7 +1682,7 @@ FORCE_INLINE void Interpreter::ldmiaUW(uint32_t opcode) // LDMIA Rn!, <Rlist>^
         {
             if (opcode & BIT(i))
             {
-                *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+                *registers[i] = read<uint32_t>(op0);
                 op0 += 4;
             }
         }
@@ -1582,7 +1712,7 @@ FORCE_INLINE void Interpreter::ldmiaUW(uint32_t opcode) // LDMIA Rn!, <Rlist>^
         {
             if (opcode & BIT(i))
             {
-                registersUsr[i] = core->memory.read<uint32_t>(cpu, op0);
+                registersUsr[i] = read<uint32_t>(op0);
                 op0 += 4;
             }
         }
@@ -1593,9 +1723,11 @@ FORCE_INLINE void Interpreter::ldmiaUW(uint32_t opcode) // LDMIA Rn!, <Rlist>^
     // On ARM7, if Rn is in Rlist, writeback never happens
     if (!(opcode & BIT(n)) || (cpu == 0 && ((opcode & 0x0000FFFF) == BIT(n) || (opcode & 0x0000FFFF & ~(BIT(n + 1) - 1)))))
         *registers[n] = op0;
+
+    return blockCycles(opcode & 0xFFFF, true);
 }
 
-FORCE_INLINE void Interpreter::stmiaUW(uint32_t opcode) // STMIA Rn!, <Rlist>^
+FORCE_INLINE int Interpreter::stmiaUW(uint32_t opcode) // STMIA Rn!, <Rlist>^
 {
     // Decode the operand
     int n = (opcode & 0x000F0000) >> 16;
@@ -1619,16 +1751,18 @@ FORCE_INLINE void Interpreter::stmiaUW(uint32_t opcode) // STMIA Rn!, <Rlist>^
     {
         if (opcode & BIT(i))
         {
-            core->memory.write<uint32_t>(cpu, op0, registersUsr[i]);
+            write<uint32_t>(op0, registersUsr[i]);
             op0 += 4;
         }
     }
 
     // Writeback
     *registers[n] = op0;
+
+    return blockCycles(opcode & 0xFFFF, false);
 }
 
-FORCE_INLINE void Interpreter::ldmdbUW(uint32_t opcode) // LDMDB Rn!, <Rlist>^
+FORCE_INLINE int Interpreter::ldmdbUW(uint32_t opcode) // LDMDB Rn!, <Rlist>^
 {
     // Decode the operand
     int n = (opcode & 0x000F0000) >> 16;
@@ -1650,7 +1784,7 @@ FORCE_INLINE void Interpreter::ldmdbUW(uint32_t opcode) // LDMDB Rn!, <Rlist>^
         {
             if (opcode & BIT(i))
             {
-                *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+                *registers[i] = read<uint32_t>(op0);
                 op0 += 4;
             }
         }
@@ -1680,7 +1814,7 @@ FORCE_INLINE void Interpreter::ldmdbUW(uint32_t opcode) // LDMDB Rn!, <Rlist>^
         {
             if (opcode & BIT(i))
             {
-                registersUsr[i] = core->memory.read<uint32_t>(cpu, op0);
+                registersUsr[i] = read<uint32_t>(op0);
                 op0 += 4;
             }
         }
@@ -1691,9 +1825,11 @@ FORCE_INLINE void Interpreter::ldmdbUW(uint32_t opcode) // LDMDB Rn!, <Rlist>^
     // On ARM7, if Rn is in Rlist, writeback never happens
     if (!(opcode & BIT(n)) || (cpu == 0 && ((opcode & 0x0000FFFF) == BIT(n) || (opcode & 0x0000FFFF & ~(BIT(n + 1) - 1)))))
         *registers[n] = writeback;
+
+    return blockCycles(opcode & 0xFFFF, true);
 }
 
-FORCE_INLINE void Interpreter::stmdbUW(uint32_t opcode) // STMDB Rn!, <Rlist>^
+FORCE_INLINE int Interpreter::stmdbUW(uint32_t opcode) // STMDB Rn!, <Rlist>^
 {
     // Decode the operand
     int n = (opcode & 0x000F0000) >> 16;
@@ -1718,16 +1854,18 @@ FORCE_INLINE void Interpreter::stmdbUW(uint32_t opcode) // STMDB Rn!, <Rlist>^
     {
         if (opcode & BIT(i))
         {
-            core->memory.write<uint32_t>(cpu, op0, registersUsr[i]);
+            write<uint32_t>(op0, registersUsr[i]);
             op0 += 4;
         }
     }
 
     // Writeback
     *registers[n] = writeback;
+
+    return blockCycles(opcode & 0xFFFF, false);
 }
 
-FORCE_INLINE void Interpreter::ldmibUW(uint32_t opcode) // LDMIB Rn!, <Rlist>^
+FORCE_INLINE int Interpreter::ldmibUW(uint32_t opcode) // LDMIB Rn!, <Rlist>^
 {
     // Decode the operand
     int n = (opcode & 0x000F0000) >> 16;
@@ -1741,7 +1879,7 @@ FORCE_INLINE void Interpreter::ldmibUW(uint32_t opcode) // LDMIB Rn!, <Rlist>^
             if (opcode & BIT(i))
             {
                 op0 += 4;
-                *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+                *registers[i] = read<uint32_t>(op0);
             }
         }
 
@@ -1771,7 +1909,7 @@ FORCE_INLINE void Interpreter::ldmibUW(uint32_t opcode) // LDMIB Rn!, <Rlist>^
             if (opcode & BIT(i))
             {
                 op0 += 4;
-                registersUsr[i] = core->memory.read<uint32_t>(cpu, op0);
+                registersUsr[i] = read<uint32_t>(op0);
             }
         }
     }
@@ -1781,9 +1919,11 @@ FORCE_INLINE void Interpreter::ldmibUW(uint32_t opcode) // LDMIB Rn!, <Rlist>^
     // On ARM7, if Rn is in Rlist, writeback never happens
     if (!(opcode & BIT(n)) || (cpu == 0 && ((opcode & 0x0000FFFF) == BIT(n) || (opcode & 0x0000FFFF & ~(BIT(n + 1) - 1)))))
         *registers[n] = op0;
+
+    return blockCycles(opcode & 0xFFFF, true);
 }
 
-FORCE_INLINE void Interpreter::stmibUW(uint32_t opcode) // STMIB Rn!, <Rlist>^
+FORCE_INLINE int Interpreter::stmibUW(uint32_t opcode) // STMIB Rn!, <Rlist>^
 {
     // Decode the operand
     int n = (opcode & 0x000F0000) >> 16;
@@ -1808,15 +1948,17 @@ FORCE_INLINE void Interpreter::stmibUW(uint32_t opcode) // STMIB Rn!, <Rlist>^
         if (opcode & BIT(i))
         {
             op0 += 4;
-            core->memory.write<uint32_t>(cpu, op0, registersUsr[i]);
+            write<uint32_t>(op0, registersUsr[i]);
         }
     }
 
     // Writeback
     *registers[n] = op0;
+
+    return blockCycles(opcode & 0xFFFF, false);
 }
 
-FORCE_INLINE void Interpreter::msrRc(uint32_t opcode) // MSR CPSR,Rm
+FORCE_INLINE int Interpreter::msrRc(uint32_t opcode) // MSR CPSR,Rm
 {
     // Decode the operand
     uint32_t op1 = *registers[opcode & 0x0000000F];
@@ -1835,9 +1977,11 @@ FORCE_INLINE void Interpreter::msrRc(uint32_t opcode) // MSR CPSR,Rm
         if (opcode & BIT(17 + i))
             cpsr = (cpsr & ~(0x0000FF00 << (i * 8))) | (op1 & (0x0000FF00 << (i * 8)));
     }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::msrRs(uint32_t opcode) // MSR SPSR,Rm
+FORCE_INLINE int Interpreter::msrRs(uint32_t opcode) // MSR SPSR,Rm
 {
     // Decode the operand
     uint32_t op1 = *registers[opcode & 0x0000000F];
@@ -1851,9 +1995,11 @@ FORCE_INLINE void Interpreter::msrRs(uint32_t opcode) // MSR SPSR,Rm
                 *spsr = (*spsr & ~(0x000000FF << (i * 8))) | (op1 & (0x000000FF << (i * 8)));
         }
     }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::msrIc(uint32_t opcode) // MSR CPSR,#i
+FORCE_INLINE int Interpreter::msrIc(uint32_t opcode) // MSR CPSR,#i
 {
     // Decode the operand
     // Can be any 8 bits rotated right by a multiple of 2
@@ -1875,9 +2021,11 @@ FORCE_INLINE void Interpreter::msrIc(uint32_t opcode) // MSR CPSR,#i
         if (opcode & BIT(17 + i))
             cpsr = (cpsr & ~(0x0000FF00 << (i * 8))) | (op1 & (0x0000FF00 << (i * 8)));
     }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::msrIs(uint32_t opcode) // MSR SPSR,#i
+FORCE_INLINE int Interpreter::msrIs(uint32_t opcode) // MSR SPSR,#i
 {
     // Decode the operand
     // Can be any 8 bits rotated right by a multiple of 2
@@ -1894,29 +2042,35 @@ FORCE_INLINE void Interpreter::msrIs(uint32_t opcode) // MSR SPSR,#i
                 *spsr = (*spsr & ~(0x000000FF << (i * 8))) | (op1 & (0x000000FF << (i * 8)));
         }
     }
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::mrsRc(uint32_t opcode) // MRS Rd,CPSR
+FORCE_INLINE int Interpreter::mrsRc(uint32_t opcode) // MRS Rd,CPSR
 {
     // Decode the operand
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
 
     // Copy the status flags to a register
     *op0 = cpsr;
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::mrsRs(uint32_t opcode) // MRS Rd,SPSR
+FORCE_INLINE int Interpreter::mrsRs(uint32_t opcode) // MRS Rd,SPSR
 {
     // Decode the operand
     uint32_t *op0 = registers[(opcode & 0x0000F000) >> 12];
 
     // Copy the saved status flags to a register
     if (spsr) *op0 = *spsr;
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::mrc(uint32_t opcode) // MRC Pn,<cpopc>,Rd,Cn,Cm,<cp>
+FORCE_INLINE int Interpreter::mrc(uint32_t opcode) // MRC Pn,<cpopc>,Rd,Cn,Cm,<cp>
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operands
     uint32_t *op2 = registers[(opcode & 0x0000F000) >> 12];
@@ -1926,11 +2080,13 @@ FORCE_INLINE void Interpreter::mrc(uint32_t opcode) // MRC Pn,<cpopc>,Rd,Cn,Cm,<
 
     // Read from a CP15 register
     *op2 = core->cp15.read(op3, op4, op5);
+
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::mcr(uint32_t opcode) // MCR Pn,<cpopc>,Rd,Cn,Cm,<cp>
+FORCE_INLINE int Interpreter::mcr(uint32_t opcode) // MCR Pn,<cpopc>,Rd,Cn,Cm,<cp>
 {
-    if (cpu == 1) return; // ARM9 exclusive
+    if (cpu == 1) return 1; // ARM9 exclusive
 
     // Decode the operands
     uint32_t op2 = *registers[(opcode & 0x0000F000) >> 12];
@@ -1940,91 +2096,70 @@ FORCE_INLINE void Interpreter::mcr(uint32_t opcode) // MCR Pn,<cpopc>,Rd,Cn,Cm,<
 
     // Write to a CP15 register
     core->cp15.write(op3, op4, op5, op2);
-}
 
-FORCE_INLINE void Interpreter::ldrsbRegT(uint16_t opcode) // LDRSB Rd,[Rb,Ro]
-{
-    // Decode the operands
-    uint32_t *op0 = registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint32_t op2 = *registers[(opcode & 0x01C0) >> 6];
-
-    // Signed byte load, pre-adjust without writeback
-    *op0 = core->memory.read<int8_t>(cpu, op1 + op2);
+    return 1;
 }
 
-FORCE_INLINE void Interpreter::ldrshRegT(uint16_t opcode) // LDRSH Rd,[Rb,Ro]
+FORCE_INLINE int Interpreter::ldrbT(uint8_t rd, uint8_t rb, uint32_t op2) // LDRB Rd,[Rb,op2]
 {
-    // Decode the operands
-    uint32_t *op0 = registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint32_t op2 = *registers[(opcode & 0x01C0) >> 6];
+    // Decode the other operands
+    uint32_t *op0 = registers[rd];
+    uint32_t op1 = *registers[rb];
 
-    // Signed half-word load, pre-adjust without writeback
-    *op0 = core->memory.read<int16_t>(cpu, op1 += op2);
+    // Byte load, pre-adjust without writeback
+    *op0 = read<uint8_t>(op1 + op2);
 
-    // Shift misaligned reads on ARM7
-    if (cpu == 1 && (op1 & 1))
-        *op0 = (int16_t)*op0 >> 8;
+    return cpu ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::ldrbRegT(uint16_t opcode) // LDRB Rd,[Rb,Ro]
+FORCE_INLINE int Interpreter::strbT(uint8_t rd, uint8_t rb, uint32_t op2) // STRB Rd,[Rb,op2]
 {
-    // Decode the operands
-    uint32_t *op0 = registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint32_t op2 = *registers[(opcode & 0x01C0) >> 6];
-
-    // Byte load, pre-adjust without writeback
-    *op0 = core->memory.read<uint8_t>(cpu, op1 + op2);
-}
+    // Decode the other operands
+    uint32_t op0 = *registers[rd];
+    uint32_t op1 = *registers[rb];
 
-FORCE_INLINE void Interpreter::strbRegT(uint16_t opcode) // STRB Rd,[Rb,Ro]
-{
-    // Decode the operands
-    uint32_t op0 = *registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint32_t op2 = *registers[(opcode & 0x01C0) >> 6];
+    // Byte store, pre-adjust without writeback
+    write<uint8_t>(op1 + op2, op0);
 
-    // Byte write, pre-adjust without writeback
-    core->memory.write<uint8_t>(cpu, op1 + op2, op0);
+    return cpu ? 2 : 1;
 }
 
-FORCE_INLINE void Interpreter::ldrhRegT(uint16_t opcode) // LDRH Rd,[Rb,Ro]
+FORCE_INLINE int Interpreter::ldrhT(uint8_t rd, uint8_t rb, uint32_t op2) // LDRH Rd,[Rb,op2]
 {
-    // Decode the operands
-    uint32_t *op0 = registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint32_t op2 = *registers[(opcode & 0x01C0) >> 6];
+    // Decode the other operands
+    uint32_t *op0 = registers[rd];
+    uint32_t op1 = *registers[rb];
 
     // Half-word load, pre-adjust without writeback
-    *op0 = core->memory.read<uint16_t>(cpu, op1 += op2);
+    *op0 = read<uint16_t>(op1 += op2);
 
     // Rotate misaligned reads on ARM7
     if (cpu == 1 && (op1 & 1))
         *op0 = (*op0 << 24) | (*op0 >> 8);
+
+    return cpu ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::strhRegT(uint16_t opcode) // STRH Rd,[Rb,Ro]
+FORCE_INLINE int Interpreter::strhT(uint8_t rd, uint8_t rb, uint32_t op2) // STRH Rd,[Rb,op2]
 {
-    // Decode the operands
-    uint32_t op0 = *registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint32_t op2 = *registers[(opcode & 0x01C0) >> 6];
+    // Decode the other operands
+    uint32_t op0 = *registers[rd];
+    uint32_t op1 = *registers[rb];
+
+    // Half-word store, pre-adjust without writeback
+    write<uint16_t>(op1 + op2, op0);
 
-    // Half-word write, pre-adjust without writeback
-    core->memory.write<uint16_t>(cpu, op1 + op2, op0);
+    return cpu ? 2 : 1;
 }
 
-FORCE_INLINE void Interpreter::ldrRegT(uint16_t opcode) // LDR Rd,[Rb,Ro]
+FORCE_INLINE int Interpreter::ldrT(uint8_t rd, uint8_t rb, uint32_t op2) // LDR Rd,[Rb,op2]
 {
-    // Decode the operands
-    uint32_t *op0 = registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint32_t op2 = *registers[(opcode & 0x01C0) >> 6];
+    // Decode the other operands
+    uint32_t *op0 = registers[rd];
+    uint32_t op1 = *registers[rb];
 
     // Word load, pre-adjust without writeback
-    *op0 = core->memory.read<uint32_t>(cpu, op1 += op2);
+    *op0 = read<uint32_t>(op1 += op2);
 
     // Rotate misaligned reads
     if (op1 & 3)
@@ -2032,97 +2167,125 @@ FORCE_INLINE void Interpreter::ldrRegT(uint16_t opcode) // LDR Rd,[Rb,Ro]
         int shift = (op1 & 3) * 8;
         *op0 = (*op0 << (32 - shift)) | (*op0 >> shift);
     }
+
+    return cpu ? 3 : 1;
+}
+
+FORCE_INLINE int Interpreter::strT(uint8_t rd, uint8_t rb, uint32_t op2) // STR Rd,[Rb,op2]
+{
+    // Decode the other operands
+    uint32_t op0 = *registers[rd];
+    uint32_t op1 = *registers[rb];
+
+    // Word store, pre-adjust without writeback
+    write<uint32_t>(op1 + op2, op0);
+
+    return cpu ? 2 : 1;
 }
 
-FORCE_INLINE void Interpreter::strRegT(uint16_t opcode) // STR Rd,[Rb,Ro]
+FORCE_INLINE int Interpreter::ldrsbRegT(uint16_t opcode) // LDRSB Rd,[Rb,Ro]
 {
     // Decode the operands
-    uint32_t op0 = *registers[opcode & 0x0007];
+    uint32_t *op0 = registers[opcode & 0x0007];
     uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
     uint32_t op2 = *registers[(opcode & 0x01C0) >> 6];
 
-    // Word write, pre-adjust without writeback
-    core->memory.write<uint32_t>(cpu, op1 + op2, op0);
+    // Signed byte load, pre-adjust without writeback
+    *op0 = read<int8_t>(op1 + op2);
+
+    return cpu ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::ldrbImm5T(uint16_t opcode) // LDRB Rd,[Rb,#i]
+FORCE_INLINE int Interpreter::ldrshRegT(uint16_t opcode) // LDRSH Rd,[Rb,Ro]
 {
     // Decode the operands
     uint32_t *op0 = registers[opcode & 0x0007];
     uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint32_t op2 = (opcode & 0x07C0) >> 6;
+    uint32_t op2 = *registers[(opcode & 0x01C0) >> 6];
 
-    // Byte load, pre-adjust without writeback
-    *op0 = core->memory.read<uint8_t>(cpu, op1 + op2);
+    // Signed half-word load, pre-adjust without writeback
+    *op0 = read<int16_t>(op1 += op2);
+
+    // Shift misaligned reads on ARM7
+    if (cpu == 1 && (op1 & 1))
+        *op0 = (int16_t)*op0 >> 8;
+
+    return cpu ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::strbImm5T(uint16_t opcode) // STRB Rd,[Rb,#i]
+FORCE_INLINE int Interpreter::ldrbRegT(uint16_t opcode) // LDRB Rd,[Rb,Ro]
 {
     // Decode the operands
-    uint32_t op0 = *registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint32_t op2 = (opcode & 0x07C0) >> 6;
+    return ldrbT(opcode & 0x0007, (opcode & 0x0038) >> 3, *registers[(opcode & 0x01C0) >> 6]);
+}
 
-    // Byte store, pre-adjust without writeback
-    core->memory.write<uint8_t>(cpu, op1 + op2, op0);
+FORCE_INLINE int Interpreter::strbRegT(uint16_t opcode) // STRB Rd,[Rb,Ro]
+{
+    // Decode the operands
+    return strbT(opcode & 0x0007, (opcode & 0x0038) >> 3, *registers[(opcode & 0x01C0) >> 6]);
 }
 
-FORCE_INLINE void Interpreter::ldrhImm5T(uint16_t opcode) // LDRH Rd,[Rb,#i]
+FORCE_INLINE int Interpreter::ldrhRegT(uint16_t opcode) // LDRH Rd,[Rb,Ro]
 {
     // Decode the operands
-    uint32_t *op0 = registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint32_t op2 = (opcode & 0x07C0) >> 5;
+    return ldrhT(opcode & 0x0007, (opcode & 0x0038) >> 3, *registers[(opcode & 0x01C0) >> 6]);
+}
 
-    // Half-word load, pre-adjust without writeback
-    *op0 = core->memory.read<uint16_t>(cpu, op1 += op2);
+FORCE_INLINE int Interpreter::strhRegT(uint16_t opcode) // STRH Rd,[Rb,Ro]
+{
+    // Decode the operands
+    return strhT(opcode & 0x0007, (opcode & 0x0038) >> 3, *registers[(opcode & 0x01C0) >> 6]);
+}
 
-    // Rotate misaligned reads on ARM7
-    if (cpu == 1 && (op1 & 1))
-        *op0 = (*op0 << 24) | (*op0 >> 8);
+FORCE_INLINE int Interpreter::ldrRegT(uint16_t opcode) // LDR Rd,[Rb,Ro]
+{
+    // Decode the operands
+    return ldrT(opcode & 0x0007, (opcode & 0x0038) >> 3, *registers[(opcode & 0x01C0) >> 6]);
 }
 
-FORCE_INLINE void Interpreter::strhImm5T(uint16_t opcode) // STRH Rd,[Rb,#i]
+FORCE_INLINE int Interpreter::strRegT(uint16_t opcode) // STR Rd,[Rb,Ro]
 {
     // Decode the operands
-    uint32_t op0 = *registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint32_t op2 = (opcode & 0x07C0) >> 5;
+    return strT(opcode & 0x0007, (opcode & 0x0038) >> 3, *registers[(opcode & 0x01C0) >> 6]);
+}
 
-    // Half-word store, pre-adjust without writeback
-    core->memory.write<uint16_t>(cpu, op1 + op2, op0);
+FORCE_INLINE int Interpreter::ldrbImm5T(uint16_t opcode) // LDRB Rd,[Rb,#i]
+{
+    // Decode the operands
+    return ldrbT(opcode & 0x0007, (opcode & 0x0038) >> 3, (opcode & 0x07C0) >> 6);
 }
 
-FORCE_INLINE void Interpreter::ldrImm5T(uint16_t opcode) // LDR Rd,[Rb,#i]
+FORCE_INLINE int Interpreter::strbImm5T(uint16_t opcode) // STRB Rd,[Rb,#i]
 {
     // Decode the operands
-    uint32_t *op0 = registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint32_t op2 = (opcode & 0x07C0) >> 4;
+    return strbT(opcode & 0x0007, (opcode & 0x0038) >> 3, (opcode & 0x07C0) >> 6);
+}
 
-    // Word load, pre-adjust without writeback
-    *op0 = core->memory.read<uint32_t>(cpu, op1 += op2);
+FORCE_INLINE int Interpreter::ldrhImm5T(uint16_t opcode) // LDRH Rd,[Rb,#i]
+{
+    // Decode the operands
+    return ldrhT(opcode & 0x0007, (opcode & 0x0038) >> 3, (opcode & 0x07C0) >> 5);
+}
 
-    // Rotate misaligned reads
-    if (op1 & 3)
-    {
-        int shift = (op1 & 3) * 8;
-        *op0 = (*op0 << (32 - shift)) | (*op0 >> shift);
-    }
+FORCE_INLINE int Interpreter::strhImm5T(uint16_t opcode) // STRH Rd,[Rb,#i]
+{
+    // Decode the operands
+    return strhT(opcode & 0x0007, (opcode & 0x0038) >> 3, (opcode & 0x07C0) >> 5);
 }
 
-FORCE_INLINE void Interpreter::strImm5T(uint16_t opcode) // STR Rd,[Rb,#i]
+FORCE_INLINE int Interpreter::ldrImm5T(uint16_t opcode) // LDR Rd,[Rb,#i]
 {
     // Decode the operands
-    uint32_t op0 = *registers[opcode & 0x0007];
-    uint32_t op1 = *registers[(opcode & 0x0038) >> 3];
-    uint32_t op2 = (opcode & 0x07C0) >> 4;
+    return ldrT(opcode & 0x0007, (opcode & 0x0038) >> 3, (opcode & 0x07C0) >> 4);
+}
 
-    // Word store, pre-adjust without writeback
-    core->memory.write<uint32_t>(cpu, op1 + op2, op0);
+FORCE_INLINE int Interpreter::strImm5T(uint16_t opcode) // STR Rd,[Rb,#i]
+{
+    // Decode the operands
+    return strT(opcode & 0x0007, (opcode & 0x0038) >> 3, (opcode & 0x07C0) >> 4);
 }
 
-FORCE_INLINE void Interpreter::ldrPcT(uint16_t opcode) // LDR Rd,[PC,#i]
+FORCE_INLINE int Interpreter::ldrPcT(uint16_t opcode) // LDR Rd,[PC,#i]
 {
     // Decode the operands
     uint32_t *op0 = registers[(opcode & 0x0700) >> 8];
@@ -2130,7 +2293,7 @@ FORCE_INLINE void Interpreter::ldrPcT(uint16_t opcode) // LDR Rd,[PC,#i]
     uint32_t op2 = (opcode & 0x00FF) << 2;
 
     // Word load, pre-adjust without writeback
-    *op0 = core->memory.read<uint32_t>(cpu, op1 += op2);
+    *op0 = read<uint32_t>(op1 += op2);
 
     // Rotate misaligned reads
     if (op1 & 3)
@@ -2138,38 +2301,23 @@ FORCE_INLINE void Interpreter::ldrPcT(uint16_t opcode) // LDR Rd,[PC,#i]
         int shift = (op1 & 3) * 8;
         *op0 = (*op0 << (32 - shift)) | (*op0 >> shift);
     }
+
+    return cpu ? 3 : 1;
 }
 
-FORCE_INLINE void Interpreter::ldrSpT(uint16_t opcode) // LDR Rd,[SP,#i]
+FORCE_INLINE int Interpreter::ldrSpT(uint16_t opcode) // LDR Rd,[SP,#i]
 {
     // Decode the operands
-    uint32_t *op0 = registers[(opcode & 0x0700) >> 8];
-    uint32_t op1 = *registers[13];
-    uint32_t op2 = (opcode & 0x00FF) << 2;
-
-    // Word load, pre-adjust without writeback
-    *op0 = core->memory.read<uint32_t>(cpu, op1 += op2);
-
-    // Rotate misaligned reads
-    if (op1 & 3)
-    {
-        int shift = (op1 & 3) * 8;
-        *op0 = (*op0 << (32 - shift)) | (*op0 >> shift);
-    }
+    return ldrT((opcode & 0x0700) >> 8, 13, (opcode & 0x00FF) << 2);
 }
 
-FORCE_INLINE void Interpreter::strSpT(uint16_t opcode) // STR Rd,[SP,#i]
+FORCE_INLINE int Interpreter::strSpT(uint16_t opcode) // STR Rd,[SP,#i]
 {
     // Decode the operands
-    uint32_t op0 = *registers[(opcode & 0x0700) >> 8];
-    uint32_t op1 = *registers[13];
-    uint32_t op2 = (opcode & 0x00FF) << 2;
-
-    // Word store, pre-adjust without writeback
-    core->memory.write<uint32_t>(cpu, op1 + op2, op0);
+    return strT((opcode & 0x0700) >> 8, 13, (opcode & 0x00FF) << 2);
 }
 
-FORCE_INLINE void Interpreter::ldmiaT(uint16_t opcode) // LDMIA Rb!,<Rlist>
+FORCE_INLINE int Interpreter::ldmiaT(uint16_t opcode) // LDMIA Rb!,<Rlist>
 {
     // Decode the operand
     int n = (opcode & 0x0700) >> 8;
@@ -2180,7 +2328,7 @@ FORCE_INLINE void Interpreter::ldmiaT(uint16_t opcode) // LDMIA Rb!,<Rlist>
     {
         if (opcode & BIT(i))
         {
-            *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+            *registers[i] = read<uint32_t>(op0);
             op0 += 4;
         }
     }
@@ -2190,9 +2338,11 @@ FORCE_INLINE void Interpreter::ldmiaT(uint16_t opcode) // LDMIA Rb!,<Rlist>
     // On ARM7, if Rn is in Rlist, writeback never happens
     if (!(opcode & BIT(n)) || (cpu == 0 && ((opcode & 0x00FF) == BIT(n) || (opcode & 0x00FF & ~(BIT(n + 1) - 1)))))
         *registers[n] = op0;
+
+    return blockCycles(opcode & 0xFF, true);
 }
 
-FORCE_INLINE void Interpreter::stmiaT(uint16_t opcode) // STMIA Rb!,<Rlist>
+FORCE_INLINE int Interpreter::stmiaT(uint16_t opcode) // STMIA Rb!,<Rlist>
 {
     // Decode the operand
     int n = (opcode & 0x0700) >> 8;
@@ -2216,16 +2366,18 @@ FORCE_INLINE void Interpreter::stmiaT(uint16_t opcode) // STMIA Rb!,<Rlist>
     {
         if (opcode & BIT(i))
         {
-            core->memory.write<uint32_t>(cpu, op0, *registers[i]);
+            write<uint32_t>(op0, *registers[i]);
             op0 += 4;
         }
     }
 
     // Writeback
     *registers[n] = op0;
+
+    return blockCycles(opcode & 0xFF, false);
 }
 
-FORCE_INLINE void Interpreter::popT(uint16_t opcode) // POP <Rlist>
+FORCE_INLINE int Interpreter::popT(uint16_t opcode) // POP <Rlist>
 {
     // Decode the operand
     uint32_t op0 = *registers[13];
@@ -2235,16 +2387,18 @@ FORCE_INLINE void Interpreter::popT(uint16_t opcode) // POP <Rlist>
     {
         if (opcode & BIT(i))
         {
-            *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+            *registers[i] = read<uint32_t>(op0);
             op0 += 4;
         }
     }
 
     // Writeback
     *registers[13] = op0;
+
+    return blockCycles(opcode & 0xFF, true);
 }
 
-FORCE_INLINE void Interpreter::pushT(uint16_t opcode) // PUSH <Rlist>
+FORCE_INLINE int Interpreter::pushT(uint16_t opcode) // PUSH <Rlist>
 {
     // Decode the operand
     uint32_t op0 = *registers[13];
@@ -2264,13 +2418,15 @@ FORCE_INLINE void Interpreter::pushT(uint16_t opcode) // PUSH <Rlist>
     {
         if (opcode & BIT(i))
         {
-            core->memory.write<uint32_t>(cpu, op0, *registers[i]);
+            write<uint32_t>(op0, *registers[i]);
             op0 += 4;
         }
     }
+
+    return blockCycles(opcode & 0xFF, false);
 }
 
-FORCE_INLINE void Interpreter::popPcT(uint16_t opcode) // POP <Rlist>,PC
+FORCE_INLINE int Interpreter::popPcT(uint16_t opcode) // POP <Rlist>,PC
 {
     // Decode the operand
     uint32_t op0 = *registers[13];
@@ -2280,11 +2436,11 @@ FORCE_INLINE void Interpreter::popPcT(uint16_t opcode) // POP <Rlist>,PC
     {
         if (opcode & BIT(i))
         {
-            *registers[i] = core->memory.read<uint32_t>(cpu, op0);
+            *registers[i] = read<uint32_t>(op0);
             op0 += 4;
         }
     }
-    *registers[15] = core->memory.read<uint32_t>(cpu, op0);
+    *registers[15] = read<uint32_t>(op0);
     op0 += 4;
 
     // Writeback
@@ -2300,9 +2456,11 @@ FORCE_INLINE void Interpreter::popPcT(uint16_t opcode) // POP <Rlist>,PC
         cpsr &= ~BIT(5);
         *registers[15] = (*registers[15] & ~3) + 4;
     }
+
+    return blockCycles((opcode & 0xFF) | BIT(15), true);
 }
 
-FORCE_INLINE void Interpreter::pushLrT(uint16_t opcode) // PUSH <Rlist>,LR
+FORCE_INLINE int Interpreter::pushLrT(uint16_t opcode) // PUSH <Rlist>,LR
 {
     // Decode the operand
     uint32_t op0 = *registers[13];
@@ -2323,12 +2481,14 @@ FORCE_INLINE void Interpreter::pushLrT(uint16_t opcode) // PUSH <Rlist>,LR
     {
         if (opcode & BIT(i))
         {
-            core->memory.write<uint32_t>(cpu, op0, *registers[i]);
+            write<uint32_t>(op0, *registers[i]);
             op0 += 4;
         }
     }
-    core->memory.write<uint32_t>(cpu, op0, *registers[14]);
+    write<uint32_t>(op0, *registers[14]);
     op0 += 4;
+
+    return blockCycles((opcode & 0xFF) | BIT(14), false);
 }
 
 #endif // INTERPRETER_TRANSFER
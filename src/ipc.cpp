@@ -20,6 +20,37 @@
 #include "ipc.h"
 #include "core.h"
 
+void Ipc::syncState(Savestate *state)
+{
+    // Sync the FIFOs and registers
+    syncFifo(state, 0);
+    syncFifo(state, 1);
+    state->sync(ipcSync);
+    state->sync(ipcFifoCnt);
+    state->sync(ipcFifoRecv);
+}
+
+void Ipc::syncFifo(Savestate *state, int fifo)
+{
+    // Sync the size of a FIFO, followed by its words from front to back
+    // This matches the layout of a synced queue, so states don't depend on how the FIFOs are stored
+    uint32_t size = fifoSizes[fifo];
+    state->sync(size);
+    if (state->isLoading())
+    {
+        fifoHeads[fifo] = 0;
+        fifoSizes[fifo] = (size > 16) ? 16 : size;
+    }
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        uint32_t value = fifos[fifo][(fifoHeads[fifo] + i) & 0xF];
+        state->sync(value);
+        if (state->isLoading() && i < 16)
+            fifos[fifo][i] = value;
+    }
+}
+
 void Ipc::writeIpcSync(bool cpu, uint16_t mask, uint16_t value)
 {
     // Write to one of the IPCSYNC registers
@@ -37,11 +68,10 @@ void Ipc::writeIpcSync(bool cpu, uint16_t mask, uint16_t value)
 void Ipc::writeIpcFifoCnt(bool cpu, uint16_t mask, uint16_t value)
 {
     // Clear the FIFO if the clear bit is set
-    if ((value & BIT(3)) && !fifos[cpu].empty())
+    if ((value & BIT(3)) && fifoSizes[cpu] > 0)
     {
         // Empty the FIFO
-        while (!fifos[cpu].empty())
-            fifos[cpu].pop();
+        fifoSizes[cpu] = 0;
         ipcFifoRecv[!cpu] = 0;
 
         // Set the FIFO empty bits and clear the FIFO full bits
@@ -75,12 +105,12 @@ void Ipc::writeIpcFifoSend(bool cpu, uint32_t mask, uint32_t value)
 {
     if (ipcFifoCnt[cpu] & BIT(15)) // FIFO enabled
     {
-        if (fifos[cpu].size() < 16) // FIFO not full
+        if (fifoSizes[cpu] < 16) // FIFO not full
         {
             // Push a word to the FIFO
-            fifos[cpu].push(value & mask);
+            fifos[cpu][(fifoHeads[cpu] + fifoSizes[cpu]++) & 0xF] = value & mask;
 
-            if (fifos[cpu].size() == 1)
+            if (fifoSizes[cpu] == 1)
             {
                 // If the FIFO is no longer empty, clear the empty bits
                 ipcFifoCnt[cpu]  &= ~BIT(0);
@@ -90,7 +120,7 @@ void Ipc::writeIpcFifoSend(bool cpu, uint32_t mask, uint32_t value)
                 if (ipcFifoCnt[!cpu] & BIT(10))
                     core->interpreter[!cpu].sendInterrupt(18);
             }
-            else if (fifos[cpu].size() == 16)
+            else if (fifoSizes[cpu] == 16)
             {
                 // If the FIFO is now full, set the full bits
                 ipcFifoCnt[cpu]  |= BIT(1);
@@ -107,17 +137,18 @@ void Ipc::writeIpcFifoSend(bool cpu, uint32_t mask, uint32_t value)
 
 uint32_t Ipc::readIpcFifoRecv(bool cpu)
 {
-    if (!fifos[!cpu].empty())
+    if (fifoSizes[!cpu] > 0)
     {
         // Receive a word from the FIFO
-        ipcFifoRecv[cpu] = fifos[!cpu].front();
+        ipcFifoRecv[cpu] = fifos[!cpu][fifoHeads[!cpu]];
 
         if (ipcFifoCnt[cpu] & BIT(15)) // FIFO enabled
         {
             // Remove the received word from the FIFO
-            fifos[!cpu].pop();
+            fifoHeads[!cpu] = (fifoHeads[!cpu] + 1) & 0xF;
+            fifoSizes[!cpu]--;
 
-            if (fifos[!cpu].empty())
+            if (fifoSizes[!cpu] == 0)
             {
                 // If the FIFO is now empty, set the empty bits
                 ipcFifoCnt[cpu]  |= BIT(8);
@@ -127,7 +158,7 @@ uint32_t Ipc::readIpcFifoRecv(bool cpu)
                 if (ipcFifoCnt[!cpu] & BIT(2))
                     core->interpreter[!cpu].sendInterrupt(17);
             }
-            else if (fifos[!cpu].size() == 15)
+            else if (fifoSizes[!cpu] == 15)
             {
                 // If the FIFO is no longer full, clear the full bits
                 ipcFifoCnt[cpu]  &= ~BIT(9);
@@ -21,15 +21,17 @@
 #define IPC_H
 
 #include <cstdint>
-#include <queue>
 
 class Core;
+class Savestate;
 
 class Ipc
 {
     public:
         Ipc(Core *core): core(core) {}
 
+        void syncState(Savestate *state);
+
         uint16_t readIpcSync(bool cpu)    { return ipcSync[cpu];    }
         uint16_t readIpcFifoCnt(bool cpu) { return ipcFifoCnt[cpu]; }
         uint32_t readIpcFifoRecv(bool cpu);
@@ -41,11 +43,18 @@ class Ipc
     private:
         Core *core;
 
-        std::queue<uint32_t> fifos[2];
+        // Each FIFO is a fixed ring buffer, matching the 16 words that hardware can hold
+        // All FIFO and sync state is only touched by the register accessors, which would be the points to synchronize at
+        // if the CPUs were ever run on separate threads
+        uint32_t fifos[2][16] = {};
+        int fifoHeads[2] = {};
+        int fifoSizes[2] = {};
 
         uint16_t ipcSync[2] = {};
         uint16_t ipcFifoCnt[2] = { 0x0101, 0x0101 };
         uint32_t ipcFifoRecv[2] = {};
+
+        void syncFifo(Savestate *state, int fifo);
 };
 
 #endif // IPC_H
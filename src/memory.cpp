@@ -21,30 +21,609 @@
 
 #include "memory.h"
 #include "core.h"
-#include "settings.h"
+
+// Cycles taken by N16, S16, N32, and S32 accesses to each 16MB region, in each CPU's own cycles
+// The ARM9 runs at twice the bus speed, and 32-bit accesses on a 16-bit bus take two bus cycles
+// Region 0xF stands in for everything above it, which is only the ARM9 BIOS
+// The GBA table is built from the WAITCNT settings instead, since games change them
+const uint8_t Memory::waitstates[2][0x10][4] =
+{
+    // ARM9
+    {
+        {  1,  1,  1,  1 }, {  1,  1,  1,  1 }, // Instruction TCM
+        { 16,  2, 18,  4 },                     // Main RAM
+        {  2,  2,  2,  2 },                     // Shared WRAM
+        {  2,  2,  2,  2 },                     // I/O registers
+        {  2,  2,  4,  4 },                     // Palettes
+        {  2,  2,  4,  4 },                     // VRAM
+        {  2,  2,  2,  2 },                     // OAM
+        { 20, 12, 32, 24 }, { 20, 12, 32, 24 }, // GBA ROM
+        { 20, 20, 40, 40 },                     // GBA SRAM
+        {  2,  2,  2,  2 }, {  2,  2,  2,  2 }, // Unmapped
+        {  2,  2,  2,  2 }, {  2,  2,  2,  2 },
+        {  2,  2,  2,  2 }                      // ARM9 BIOS
+    },
+
+    // ARM7
+    {
+        {  1,  1,  1,  1 }, {  1,  1,  1,  1 }, // ARM7 BIOS
+        {  8,  1,  9,  2 },                     // Main RAM
+        {  1,  1,  1,  1 },                     // WRAM
+        {  1,  1,  1,  1 },                     // I/O registers
+        {  1,  1,  1,  1 },                     // Unmapped
+        {  1,  1,  1,  1 },                     // VRAM
+        {  1,  1,  1,  1 },                     // Unmapped
+        { 10,  6, 16, 12 }, { 10,  6, 16, 12 }, // GBA ROM
+        { 10, 10, 20, 20 },                     // GBA SRAM
+        {  1,  1,  1,  1 }, {  1,  1,  1,  1 }, // Unmapped
+        {  1,  1,  1,  1 }, {  1,  1,  1,  1 },
+        {  1,  1,  1,  1 }
+    }
+};
+
+Memory::Memory(Core *core): core(core)
+{
+    // Build the GBA timing table for the default WAITCNT settings
+    updateGbaWaitstates();
+}
+
+void Memory::syncState(Savestate *state)
+{
+    // Sync the general memory
+    // The BIOS files are loaded from files, so they aren't part of the state
+    state->sync(ram);
+    state->sync(wram);
+    state->sync(instrTcm);
+    state->sync(dataTcm);
+    state->sync(wram7);
+    state->sync(wifiRam);
+
+    // Sync the video memory
+    state->sync(palette);
+    state->sync(vramA);
+    state->sync(vramB);
+    state->sync(vramC);
+    state->sync(vramD);
+    state->sync(vramE);
+    state->sync(vramF);
+    state->sync(vramG);
+    state->sync(vramH);
+    state->sync(vramI);
+    state->sync(oam);
+
+    // Sync the registers
+    state->sync(dmaFill);
+    state->sync(vramCnt);
+    state->sync(vramStat);
+    state->sync(wramCnt);
+    state->sync(haltCnt);
+    state->sync(waitCnt);
+
+    if (state->isLoading())
+    {
+        // Rebuild the VRAM mappings; every block is remapped on any VRAMCNT write
+        writeVramCnt(0, vramCnt[0]);
+
+        // Count all video memory as changed, since it was replaced
+        for (int i = 0; i < VRAM_PAGES; i++)
+            pageGenerations[i] = vramGeneration;
+        for (int i = 0; i <= BANK_OAM; i++)
+            bankGenerations[i] = vramGeneration;
+
+        // Rebuild the GBA timing table for the loaded WAITCNT settings
+        updateGbaWaitstates();
+
+        // Forget which pages had compiled code, and rebuild the memory maps
+        memset(codePages, 0, sizeof(codePages));
+        updateMap(0, 0x00000000, 0x10000000);
+        updateMap(1, 0x00000000, 0x10000000);
+    }
+}
 
 void Memory::loadBios()
 {
+    // Without the BIOS files, HLE stubs can be used instead, but only when directly booting
+    bool stub = core->config.hleBios && core->config.directBoot;
+
     // Attempt to load the ARM9 BIOS
-    FILE *bios9File = fopen(Settings::getBios9Path().c_str(), "rb");
-    if (!bios9File) throw 1;
-    fread(bios9, sizeof(uint8_t), 0x1000, bios9File);
-    fclose(bios9File);
+    if (FILE *bios9File = fopen(core->config.bios9Path.c_str(), "rb"))
+    {
+        fread(bios9, sizeof(uint8_t), 0x1000, bios9File);
+        fclose(bios9File);
+    }
+    else if (stub)
+    {
+        HleBios::buildStub(bios9, true);
+    }
+    else
+    {
+        throw 1;
+    }
 
     // Attempt to load the ARM7 BIOS
-    FILE *bios7File = fopen(Settings::getBios7Path().c_str(), "rb");
-    if (!bios7File) throw 1;
-    fread(bios7, sizeof(uint8_t), 0x4000, bios7File);
-    fclose(bios7File);
+    if (FILE *bios7File = fopen(core->config.bios7Path.c_str(), "rb"))
+    {
+        fread(bios7, sizeof(uint8_t), 0x4000, bios7File);
+        fclose(bios7File);
+    }
+    else if (stub)
+    {
+        HleBios::buildStub(bios7, false);
+    }
+    else
+    {
+        throw 1;
+    }
 }
 
 void Memory::loadGbaBios()
 {
     // Attempt to load the GBA BIOS
-    FILE *gbaBiosFile = fopen(Settings::getGbaBiosPath().c_str(), "rb");
-    if (!gbaBiosFile) throw 1;
-    fread(gbaBios, sizeof(uint8_t), 0x4000, gbaBiosFile);
-    fclose(gbaBiosFile);
+    // Without the BIOS file, an HLE stub can be used instead, which makes entering GBA mode boot the ROM directly
+    if (FILE *gbaBiosFile = fopen(core->config.gbaBiosPath.c_str(), "rb"))
+    {
+        fread(gbaBios, sizeof(uint8_t), 0x4000, gbaBiosFile);
+        fclose(gbaBiosFile);
+    }
+    else if (core->config.hleBios)
+    {
+        HleBios::buildStub(gbaBios, false);
+        gbaBiosStub = true;
+    }
+    else
+    {
+        throw 1;
+    }
+}
+
+uint8_t *Memory::getCodePointer(bool cpu, uint32_t address)
+{
+    // Get a pointer to code that can be compiled into a block, or null if the page isn't suitable
+    // Only pages that are fully backed by RAM, TCM, BIOS, or ROM are allowed; anything else is left to the interpreter
+    uint32_t page = address & ~0xFFF;
+
+    if (cpu == 0) // ARM9
+    {
+        if (core->cp15.getItcmEnabled() && address < core->cp15.getItcmSize()) // Instruction TCM
+            return ((page | 0xFFF) < core->cp15.getItcmSize()) ? &instrTcm[address & 0x7FFF] : nullptr;
+
+        // Don't compile from pages that overlap with the data TCM
+        if (core->cp15.getDtcmEnabled() && page < core->cp15.getDtcmAddr() + core->cp15.getDtcmSize() &&
+            (page | 0xFFF) >= core->cp15.getDtcmAddr())
+            return nullptr;
+
+        switch (address & 0xFF000000)
+        {
+            case 0x02000000: // Main RAM
+            {
+                return &ram[address & 0x3FFFFF];
+            }
+
+            case 0x03000000: // Shared WRAM
+            {
+                switch (wramCnt)
+                {
+                    case 0: return &wram[(address & 0x7FFF)];
+                    case 1: return &wram[(address & 0x3FFF) + 0x4000];
+                    case 2: return &wram[(address & 0x3FFF)];
+                }
+                return nullptr;
+            }
+
+            case 0xFF000000: // ARM9 BIOS
+            {
+                if ((address & 0xFFFF8000) == 0xFFFF0000)
+                    return &bios9[address & 0xFFFF];
+                return nullptr;
+            }
+        }
+    }
+    else if (core->isGbaMode()) // GBA
+    {
+        switch (address & 0xFF000000)
+        {
+            case 0x00000000: // GBA BIOS
+            {
+                if (address < 0x4000)
+                    return &gbaBios[address];
+                return nullptr;
+            }
+
+            case 0x02000000: // On-board WRAM
+            {
+                return &ram[address & 0x3FFFF];
+            }
+
+            case 0x03000000: // On-chip WRAM
+            {
+                return &wram[address & 0x7FFF];
+            }
+
+            case 0x08000000: case 0x09000000:
+            case 0x0A000000: case 0x0B000000:
+            case 0x0C000000: // ROM
+            {
+                if (((address & 0x01FFFFFF) | 0xFFF) < (uint32_t)core->cartridge.getGbaRomSize())
+                    return &core->cartridge.getGbaRom()[address & 0x01FFFFFF];
+                return nullptr;
+            }
+        }
+    }
+    else // ARM7
+    {
+        switch (address & 0xFF000000)
+        {
+            case 0x00000000: // ARM7 BIOS
+            {
+                if (address < 0x4000)
+                    return &bios7[address];
+                return nullptr;
+            }
+
+            case 0x02000000: // Main RAM
+            {
+                return &ram[address & 0x3FFFFF];
+            }
+
+            case 0x03000000: // WRAM
+            {
+                if (!(address & 0x00800000)) // Shared WRAM
+                {
+                    switch (wramCnt)
+                    {
+                        case 1: return &wram[(address & 0x3FFF)];
+                        case 2: return &wram[(address & 0x3FFF) + 0x4000];
+                        case 3: return &wram[(address & 0x7FFF)];
+                    }
+                }
+                return &wram7[address & 0xFFFF]; // ARM7 WRAM
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+int Memory::codePage(uint8_t *data)
+{
+    // Get the index of the writable host page containing the given data, or -1 if it isn't a code page
+    uintptr_t ptr = (uintptr_t)data;
+    if (ptr - (uintptr_t)ram      < sizeof(ram))      return ((ptr - (uintptr_t)ram)      >> 12);
+    if (ptr - (uintptr_t)wram     < sizeof(wram))     return ((ptr - (uintptr_t)wram)     >> 12) + (0x400000 >> 12);
+    if (ptr - (uintptr_t)instrTcm < sizeof(instrTcm)) return ((ptr - (uintptr_t)instrTcm) >> 12) + (0x408000 >> 12);
+    if (ptr - (uintptr_t)wram7    < sizeof(wram7))    return ((ptr - (uintptr_t)wram7)    >> 12) + (0x410000 >> 12);
+    return -1;
+}
+
+int Memory::getWaitstates(bool cpu, uint32_t address, AccessType type)
+{
+    // Look up the cycles taken by an access to a memory region, without modeling caches or TCM
+    uint32_t region = address >> 24;
+    if (region > 0xF) region = 0xF;
+    return (cpu && core->isGbaMode()) ? gbaWaitstates[region][type] : waitstates[cpu][region][type];
+}
+
+void Memory::updateGbaWaitstates()
+{
+    // Fill in the GBA regions with fixed timings, which are in CPU cycles like the rest of the table
+    static const uint8_t fixed[8][4] =
+    {
+        { 1, 1, 1, 1 }, { 1, 1, 1, 1 }, // GBA BIOS
+        { 3, 3, 6, 6 },                 // On-board WRAM
+        { 1, 1, 1, 1 },                 // On-chip WRAM
+        { 1, 1, 1, 1 },                 // I/O registers
+        { 1, 1, 2, 2 },                 // Palettes
+        { 1, 1, 2, 2 },                 // VRAM
+        { 1, 1, 1, 1 }                  // OAM
+    };
+    memcpy(gbaWaitstates, fixed, sizeof(fixed));
+
+    // Fill in the ROM regions from their WAITCNT wait states, with 32-bit accesses split into two 16-bit ones
+    static const uint8_t firsts[4] = { 4, 3, 2, 8 };
+    static const uint8_t seconds[3][2] = { { 2, 1 }, { 4, 1 }, { 8, 1 } };
+    for (int i = 0; i < 3; i++)
+    {
+        uint8_t n = 1 + firsts[(waitCnt >> (2 + i * 3)) & 0x3];
+        uint8_t s = 1 + seconds[i][(waitCnt >> (4 + i * 3)) & 0x1];
+        for (int j = 0; j < 2; j++)
+        {
+            uint8_t *cycles = gbaWaitstates[0x8 + i * 2 + j];
+            cycles[ACCESS_N16] = n;
+            cycles[ACCESS_S16] = s;
+            cycles[ACCESS_N32] = n + s;
+            cycles[ACCESS_S32] = s * 2;
+        }
+    }
+
+    // Fill in the SRAM regions, which are on an 8-bit bus and never sequential
+    uint8_t sram = 1 + firsts[waitCnt & 0x3];
+    memset(gbaWaitstates[0xE], sram, sizeof(gbaWaitstates[0xE]) * 2);
+}
+
+int Memory::vramOffset(const uint8_t *data, int *bank)
+{
+    // Get the offset of the given data in tracked video memory and its bank, or -1 if it isn't video memory
+    // The VRAM blocks are laid out in order, and palette and OAM each get a 4KB page after them
+    uintptr_t ptr = (uintptr_t)data;
+    if (ptr - (uintptr_t)vramA   < sizeof(vramA))   { *bank = BANK_A;   return (ptr - (uintptr_t)vramA);             }
+    if (ptr - (uintptr_t)vramB   < sizeof(vramB))   { *bank = BANK_B;   return (ptr - (uintptr_t)vramB)   + 0x20000; }
+    if (ptr - (uintptr_t)vramC   < sizeof(vramC))   { *bank = BANK_C;   return (ptr - (uintptr_t)vramC)   + 0x40000; }
+    if (ptr - (uintptr_t)vramD   < sizeof(vramD))   { *bank = BANK_D;   return (ptr - (uintptr_t)vramD)   + 0x60000; }
+    if (ptr - (uintptr_t)vramE   < sizeof(vramE))   { *bank = BANK_E;   return (ptr - (uintptr_t)vramE)   + 0x80000; }
+    if (ptr - (uintptr_t)vramF   < sizeof(vramF))   { *bank = BANK_F;   return (ptr - (uintptr_t)vramF)   + 0x90000; }
+    if (ptr - (uintptr_t)vramG   < sizeof(vramG))   { *bank = BANK_G;   return (ptr - (uintptr_t)vramG)   + 0x94000; }
+    if (ptr - (uintptr_t)vramH   < sizeof(vramH))   { *bank = BANK_H;   return (ptr - (uintptr_t)vramH)   + 0x98000; }
+    if (ptr - (uintptr_t)vramI   < sizeof(vramI))   { *bank = BANK_I;   return (ptr - (uintptr_t)vramI)   + 0xA0000; }
+    if (ptr - (uintptr_t)palette < sizeof(palette)) { *bank = BANK_PAL; return (ptr - (uintptr_t)palette) + 0xA4000; }
+    if (ptr - (uintptr_t)oam     < sizeof(oam))     { *bank = BANK_OAM; return (ptr - (uintptr_t)oam)     + 0xA5000; }
+    return -1;
+}
+
+void Memory::vramWritten(const uint8_t *data, uint32_t size)
+{
+    // Stamp the pages covered by a write to video memory and their bank with the current generation
+    // Ranges never cross the end of a bank, so the pages are all found from the first offset
+    int bank;
+    int offset = vramOffset(data, &bank);
+    if (offset < 0 || size == 0) return;
+    for (uint32_t i = offset >> 12; i <= (offset + size - 1) >> 12; i++)
+        pageGenerations[i] = vramGeneration;
+    bankGenerations[bank] = vramGeneration;
+}
+
+bool Memory::vramChanged(const uint8_t *data, uint32_t size, uint32_t generation)
+{
+    // Check if any page covered by a range of video memory was written after the given generation
+    // The bank is checked first, so ranges in banks that haven't changed don't need to look at their pages
+    int bank;
+    int offset = vramOffset(data, &bank);
+    if (offset < 0 || size == 0 || bankGenerations[bank] <= generation) return false;
+    for (uint32_t i = offset >> 12; i <= (offset + size - 1) >> 12; i++)
+    {
+        if (pageGenerations[i] > generation)
+            return true;
+    }
+    return false;
+}
+
+int Memory::markCode(bool cpu, uint8_t *data)
+{
+    // Mark the page containing the given data as having compiled code for a CPU
+    // Read-only memory is never written to, so it returns -1 and doesn't need to be tracked
+    int page = codePage(data);
+    if (page >= 0) codePages[page] |= BIT(cpu);
+    return page;
+}
+
+void Memory::updateMap(bool cpu, uint32_t start, uint32_t end)
+{
+    // Update the fast memory map for a range of 4KB pages
+    // Only pages that are fully backed by one block of memory are mapped; anything else is left to the slow path
+    for (uint32_t address = start; address < end; address += 0x1000)
+    {
+        uint8_t *read = nullptr, *write = nullptr;
+
+        if (cpu == 0) // ARM9
+        {
+            if (core->cp15.getItcmEnabled() && address < core->cp15.getItcmSize()) // Instruction TCM
+            {
+                read = write = &instrTcm[address & 0x7FFF];
+            }
+            else if (core->cp15.getDtcmEnabled() && address >= core->cp15.getDtcmAddr() &&
+                address < core->cp15.getDtcmAddr() + core->cp15.getDtcmSize()) // Data TCM
+            {
+                read = write = &dataTcm[(address - core->cp15.getDtcmAddr()) & 0x3FFF];
+            }
+            else
+            {
+                switch (address & 0xFF000000)
+                {
+                    case 0x02000000: // Main RAM
+                    {
+                        read = write = &ram[address & 0x3FFFFF];
+                        break;
+                    }
+
+                    case 0x03000000: // Shared WRAM
+                    {
+                        switch (wramCnt)
+                        {
+                            case 0: read = write = &wram[(address & 0x7FFF)];          break;
+                            case 1: read = write = &wram[(address & 0x3FFF) + 0x4000]; break;
+                            case 2: read = write = &wram[(address & 0x3FFF)];          break;
+                        }
+                        break;
+                    }
+
+                    case 0x06000000: // VRAM
+                    {
+                        switch (address & 0xFFE00000)
+                        {
+                            case 0x06000000: read =  engABg[(address & 0x7FFFF) >> 14]; break;
+                            case 0x06200000: read =  engBBg[(address & 0x1FFFF) >> 14]; break;
+                            case 0x06400000: read = engAObj[(address & 0x3FFFF) >> 14]; break;
+                            case 0x06600000: read = engBObj[(address & 0x1FFFF) >> 14]; break;
+                            default:         read =    lcdc[(address & 0xFFFFF) >> 14]; break;
+                        }
+                        if (read) write = (read += (address & 0x3FFF));
+                        break;
+                    }
+                }
+            }
+        }
+        else if (core->isGbaMode()) // GBA
+        {
+            switch (address & 0xFF000000)
+            {
+                case 0x00000000: // GBA BIOS
+                {
+                    if (address < 0x4000)
+                        read = &gbaBios[address];
+                    break;
+                }
+
+                case 0x02000000: // On-board WRAM
+                {
+                    read = write = &ram[address & 0x3FFFF];
+                    break;
+                }
+
+                case 0x03000000: // On-chip WRAM
+                {
+                    read = write = &wram[address & 0x7FFF];
+                    break;
+                }
+
+                case 0x06000000: // VRAM
+                {
+                    read = write = &vramC[address & ((address & 0x10000) ? 0x17FFF : 0xFFFF)];
+                    break;
+                }
+
+                case 0x08000000: case 0x09000000:
+                case 0x0A000000: case 0x0B000000:
+                case 0x0C000000: // ROM
+                {
+                    if (((address & 0x01FFFFFF) | 0xFFF) < (uint32_t)core->cartridge.getGbaRomSize())
+                        read = &core->cartridge.getGbaRom()[address & 0x01FFFFFF];
+                    break;
+                }
+            }
+        }
+        else // ARM7
+        {
+            switch (address & 0xFF000000)
+            {
+                case 0x00000000: // ARM7 BIOS
+                {
+                    if (address < 0x4000)
+                        read = &bios7[address];
+                    break;
+                }
+
+                case 0x02000000: // Main RAM
+                {
+                    read = write = &ram[address & 0x3FFFFF];
+                    break;
+                }
+
+                case 0x03000000: // WRAM
+                {
+                    if (!(address & 0x00800000)) // Shared WRAM
+                    {
+                        switch (wramCnt)
+                        {
+                            case 1: read = write = &wram[(address & 0x3FFF)];          break;
+                            case 2: read = write = &wram[(address & 0x3FFF) + 0x4000]; break;
+                            case 3: read = write = &wram[(address & 0x7FFF)];          break;
+                        }
+                    }
+                    if (!read) read = write = &wram7[address & 0xFFFF]; // ARM7 WRAM
+                    break;
+                }
+
+                case 0x06000000: // VRAM
+                {
+                    read = vram7[(address & 0x3FFFF) >> 17];
+                    if (read) write = (read += (address & 0x1FFFF));
+                    break;
+                }
+            }
+        }
+
+        readMap[cpu][address >> 12]  = read;
+        writeMap[cpu][address >> 12] = write;
+    }
+
+    // Make the CPU look up its code page again, in case it was remapped
+    core->interpreter[cpu].invalidateFetch();
+}
+
+void Memory::blockWritten(bool cpu, uint32_t address, uint8_t *data, uint32_t size)
+{
+    // Handle the side effects of a block write within one page, the same way individual writes would
+    core->interpreter[0].wakeIdle();
+    core->interpreter[1].wakeIdle();
+
+    // Let a 2D engine know if its mapped VRAM is changing, or wait for queued scanlines if LCDC VRAM is displayed
+    // Palette and OAM aren't in the fast map, so they never get here
+    if ((cpu == 0 || core->isGbaMode()) && (address & 0xFF000000) == 0x06000000 && (address & 0xFF800000) != 0x06800000)
+        core->gpu2D[core->isGbaMode() ? 0 : (bool)(address & 0x200000)].invalidate();
+    else if (cpu == 0 && (address & 0xFF800000) == 0x06800000 && (core->gpu2D[0].readDispCnt() & 0x30000) == 0x20000)
+        core->gpu.sync2D();
+
+    // Track changes to VRAM for anything that caches it
+    if ((address & 0xFF000000) == 0x06000000)
+        vramWritten(data, size);
+
+    // Invalidate any compiled code in the page that was written to
+    int page = codePage(data);
+    if (page >= 0 && codePages[page])
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            if (codePages[page] & BIT(i))
+                core->interpreter[i].invalidateBlocks(page);
+        }
+        codePages[page] = 0;
+    }
+}
+
+uint8_t *Memory::getReadPointer(bool cpu, uint32_t address)
+{
+    // Get a host pointer for reading up to the end of a page, or null if the page isn't in the fast memory map
+    uint8_t *data = (address < 0x10000000) ? readMap[cpu][address >> 12] : nullptr;
+    return data ? (data + (address & 0xFFF)) : nullptr;
+}
+
+uint8_t *Memory::getWritePointer(bool cpu, uint32_t address)
+{
+    // Get a host pointer for writing up to the end of a page, or null if the page isn't in the fast memory map
+    uint8_t *data = (address < 0x10000000) ? writeMap[cpu][address >> 12] : nullptr;
+    return data ? (data + (address & 0xFFF)) : nullptr;
+}
+
+bool Memory::writeBlock(bool cpu, uint32_t dst, const uint8_t *data, uint32_t size)
+{
+    // Write a block of data that doesn't cross a page, if the destination is in the fast memory map
+    uint8_t *to = getWritePointer(cpu, dst);
+    if (!to) return false;
+    blockWritten(cpu, dst, to, size);
+    memcpy(to, data, size);
+    return true;
+}
+
+bool Memory::copyBlock(bool cpu, uint32_t dst, uint32_t src, uint32_t size)
+{
+    // Copy a block that doesn't cross a page on either side, if both sides are in the fast memory map
+    uint8_t *from = getReadPointer(cpu, src);
+    uint8_t *to = getWritePointer(cpu, dst);
+    if (!from || !to) return false;
+
+    // Copying forward into an overlapping block repeats the data, which a host copy wouldn't do
+    if (to > from && to < from + size)
+        return false;
+
+    blockWritten(cpu, dst, to, size);
+    memmove(to, from, size);
+    return true;
+}
+
+bool Memory::fillBlock(bool cpu, uint32_t dst, uint32_t src, uint32_t size, uint32_t unit)
+{
+    // Fill a block that doesn't cross a page with a repeated unit of data, if both sides are in the fast memory map
+    // The source has to be plain memory, since reading I/O registers like FIFOs can give a new value every time
+    uint8_t *from = getReadPointer(cpu, src);
+    uint8_t *to = getWritePointer(cpu, dst);
+    if (!from || !to) return false;
+
+    // Copy the unit first, in case the source is inside the block
+    uint8_t data[4];
+    memcpy(data, from, unit);
+    blockWritten(cpu, dst, to, size);
+    for (uint32_t i = 0; i < size; i += unit)
+        memcpy(&to[i], data, unit);
+    return true;
 }
 
 template int8_t   Memory::read(bool cpu, uint32_t address);
@@ -57,9 +636,14 @@ template <typename T> T Memory::read(bool cpu, uint32_t address)
     // Align the address
     address &= ~(sizeof(T) - 1);
 
-    uint8_t *data = nullptr;
+    // Look up the address in the fast memory map, and fall back to the slow path if it isn't mapped
+    uint8_t *data = (address < 0x10000000) ? readMap[cpu][address >> 12] : nullptr;
 
-    if (cpu == 0) // ARM9
+    if (data)
+    {
+        data += (address & 0xFFF);
+    }
+    else if (cpu == 0) // ARM9
     {
         // Get a pointer to the ARM9 memory mapped to the given address
         if (core->cp15.getItcmEnabled() && address < core->cp15.getItcmSize()) // Instruction TCM
@@ -320,9 +904,18 @@ template <typename T> void Memory::write(bool cpu, uint32_t address, T value)
     // Align the address
     address &= ~(sizeof(T) - 1);
 
-    uint8_t *data = nullptr;
+    // Wake the CPUs from idle loops, since they could be waiting on what's written
+    core->interpreter[0].wakeIdle();
+    core->interpreter[1].wakeIdle();
 
-    if (cpu == 0) // ARM9
+    // Look up the address in the fast memory map, and fall back to the slow path if it isn't mapped
+    uint8_t *data = (address < 0x10000000) ? writeMap[cpu][address >> 12] : nullptr;
+
+    if (data)
+    {
+        data += (address & 0xFFF);
+    }
+    else if (cpu == 0) // ARM9
     {
         // Get a pointer to the ARM9 memory mapped to the given address
         if (core->cp15.getItcmEnabled() && address < core->cp15.getItcmSize()) // Instruction TCM
@@ -517,9 +1110,52 @@ template <typename T> void Memory::write(bool cpu, uint32_t address, T value)
 
     if (data)
     {
+        // Let a 2D engine know if its palette, OAM, or mapped VRAM is changing
+        // LCDC VRAM isn't tracked, since banks mapped there aren't used for 2D drawing
+        if ((cpu == 0 || core->isGbaMode()) && address >= 0x05000000 && address < 0x08000000 &&
+            (address & 0xFF800000) != 0x06800000)
+        {
+            for (unsigned int i = 0; i < sizeof(T); i++)
+            {
+                if (data[i] != (uint8_t)(value >> (i * 8)))
+                {
+                    // Palette and OAM are split in half between the engines, and VRAM alternates every 2MB
+                    // The GBA only uses engine A, and mirrors its palette and OAM instead
+                    bool engine = core->isGbaMode() ? 0 : (address < 0x06000000 ||
+                        address >= 0x07000000) ? (address & 0x400) : (address & 0x200000);
+                    core->gpu2D[engine].invalidate();
+                    if (address >= 0x07000000)
+                        core->gpu2D[engine].invalidateObjects();
+                    break;
+                }
+            }
+        }
+        else if (cpu == 0 && (address & 0xFF800000) == 0x06800000 &&
+            (core->gpu2D[0].readDispCnt() & 0x30000) == 0x20000)
+        {
+            // LCDC VRAM is only read by the 2D engines in VRAM display mode, where queued scanlines still need it
+            core->gpu.sync2D();
+        }
+
         // Write an LSB-first value to the data at the pointer
         for (unsigned int i = 0; i < sizeof(T); i++)
             data[i] = value >> (i * 8);
+
+        // Track changes to palette, OAM, and VRAM for anything that caches them
+        if (address >= 0x05000000 && address < 0x08000000)
+            vramWritten(data, sizeof(T));
+
+        // Invalidate any compiled code in the page that was written to
+        int page = codePage(data);
+        if (page >= 0 && codePages[page])
+        {
+            for (int i = 0; i < 2; i++)
+            {
+                if (codePages[page] & BIT(i))
+                    core->interpreter[i].invalidateBlocks(page);
+            }
+            codePages[page] = 0;
+        }
     }
     else if (core->isGbaMode())
     {
@@ -533,6 +1169,9 @@ template <typename T> void Memory::write(bool cpu, uint32_t address, T value)
 
 template <typename T> T Memory::ioRead9(uint32_t address)
 {
+    // I/O accesses are where the CPUs sync when they run on separate threads
+    auto lock = core->syncCpus(0);
+
     T value = 0;
     unsigned int i = 0;
 
@@ -926,6 +1565,9 @@ template <typename T> T Memory::ioRead9(uint32_t address)
 
 template <typename T> T Memory::ioRead7(uint32_t address)
 {
+    // I/O accesses are where the CPUs sync when they run on separate threads
+    auto lock = core->syncCpus(1);
+
     T value = 0;
     unsigned int i = 0;
 
@@ -1144,6 +1786,8 @@ template <typename T> T Memory::ioRead7(uint32_t address)
             case 0x4800025: base -= 0x4800024; size = 2; data = core->wifi.readWBssid(2);           break; // W_BSSID_2
             case 0x480002A:
             case 0x480002B: base -= 0x480002A; size = 2; data = core->wifi.readWAidFull();          break; // W_AID_FULL
+            case 0x4800030:
+            case 0x4800031: base -= 0x4800030; size = 2; data = core->wifi.readWRxcnt();            break; // W_RXCNT
             case 0x480003C:
             case 0x480003D: base -= 0x480003C; size = 2; data = core->wifi.readWPowerstate();       break; // W_POWERSTATE
             case 0x4800040:
@@ -1152,6 +1796,8 @@ template <typename T> T Memory::ioRead7(uint32_t address)
             case 0x4800051: base -= 0x4800050; size = 2; data = core->wifi.readWRxbufBegin();       break; // W_RXBUF_BEGIN
             case 0x4800052:
             case 0x4800053: base -= 0x4800052; size = 2; data = core->wifi.readWRxbufEnd();         break; // W_RXBUF_END
+            case 0x4800054:
+            case 0x4800055: base -= 0x4800054; size = 2; data = core->wifi.readWRxbufWrcsr();       break; // W_RXBUF_WRCSR
             case 0x4800056:
             case 0x4800057: base -= 0x4800056; size = 2; data = core->wifi.readWRxbufWrAddr();      break; // W_RXBUF_WR_ADDR
             case 0x4800058:
@@ -1174,6 +1820,20 @@ template <typename T> T Memory::ioRead7(uint32_t address)
             case 0x4800075: base -= 0x4800074; size = 2; data = core->wifi.readWTxbufGap();         break; // W_TXBUF_GAP
             case 0x4800076:
             case 0x4800077: base -= 0x4800076; size = 2; data = core->wifi.readWTxbufGapdisp();     break; // W_TXBUF_GAPDISP
+            case 0x4800090:
+            case 0x4800091: base -= 0x4800090; size = 2; data = core->wifi.readWTxbufLoc(1);        break; // W_TXBUF_CMD
+            case 0x48000A0:
+            case 0x48000A1: base -= 0x48000A0; size = 2; data = core->wifi.readWTxbufLoc(0);        break; // W_TXBUF_LOC1
+            case 0x48000A4:
+            case 0x48000A5: base -= 0x48000A4; size = 2; data = core->wifi.readWTxbufLoc(2);        break; // W_TXBUF_LOC2
+            case 0x48000A8:
+            case 0x48000A9: base -= 0x48000A8; size = 2; data = core->wifi.readWTxbufLoc(3);        break; // W_TXBUF_LOC3
+            case 0x48000B0:
+            case 0x48000B1: base -= 0x48000B0; size = 2; data = core->wifi.readWTxreqRead();        break; // W_TXREQ_READ
+            case 0x48000B6:
+            case 0x48000B7: base -= 0x48000B6; size = 2; data = core->wifi.readWTxbusy();           break; // W_TXBUSY
+            case 0x48000B8:
+            case 0x48000B9: base -= 0x48000B8; size = 2; data = core->wifi.readWTxstat();           break; // W_TXSTAT
             case 0x4800120:
             case 0x4800121: base -= 0x4800120; size = 2; data = core->wifi.readWConfig(0);          break; // W_CONFIG_120
             case 0x4800122:
@@ -1382,6 +2042,8 @@ template <typename T> T Memory::ioReadGba(uint32_t address)
             case 0x4000201: base -= 0x4000200; size = 2; data = core->interpreter[1].readIe();      break; // IE
             case 0x4000202:
             case 0x4000203: base -= 0x4000202; size = 2; data = core->interpreter[1].readIrf();     break; // IF
+            case 0x4000204:
+            case 0x4000205: base -= 0x4000204; size = 2; data = readGbaWaitCnt();                   break; // WAITCNT
             case 0x4000208: base -= 0x4000208; size = 1; data = core->interpreter[1].readIme();     break; // IME
             case 0x4000300: base -= 0x4000300; size = 1; data = core->interpreter[1].readPostFlg(); break; // POSTFLG
 
@@ -1410,6 +2072,9 @@ template <typename T> T Memory::ioReadGba(uint32_t address)
 
 template <typename T> void Memory::ioWrite9(uint32_t address, T value)
 {
+    // I/O accesses are where the CPUs sync when they run on separate threads
+    auto lock = core->syncCpus(0);
+
     unsigned int i = 0;
 
     // Write a value to one or more ARM9 I/O registers
@@ -2104,6 +2769,9 @@ template <typename T> void Memory::ioWrite9(uint32_t address, T value)
 
 template <typename T> void Memory::ioWrite7(uint32_t address, T value)
 {
+    // I/O accesses are where the CPUs sync when they run on separate threads
+    auto lock = core->syncCpus(1);
+
     unsigned int i = 0;
 
     // Write a value to one or more ARM7 I/O registers
@@ -2514,6 +3182,8 @@ template <typename T> void Memory::ioWrite7(uint32_t address, T value)
             case 0x4800025: base -= 0x4800024; size = 2; core->wifi.writeWBssid(2, mask << (base * 8), data << (base * 8));          break; // W_BSSID_2
             case 0x480002A:
             case 0x480002B: base -= 0x480002A; size = 2; core->wifi.writeWAidFull(mask << (base * 8), data << (base * 8));           break; // W_AID_FULL
+            case 0x4800030:
+            case 0x4800031: base -= 0x4800030; size = 2; core->wifi.writeWRxcnt(mask << (base * 8), data << (base * 8));             break; // W_RXCNT
             case 0x480003C:
             case 0x480003D: base -= 0x480003C; size = 2; core->wifi.writeWPowerstate(mask << (base * 8), data << (base * 8));        break; // W_POWERSTATE
             case 0x4800040:
@@ -2544,6 +3214,18 @@ template <typename T> void Memory::ioWrite7(uint32_t address, T value)
             case 0x4800075: base -= 0x4800074; size = 2; core->wifi.writeWTxbufGap(mask << (base * 8), data << (base * 8));          break; // W_TXBUF_GAP
             case 0x4800076:
             case 0x4800077: base -= 0x4800076; size = 2; core->wifi.writeWTxbufGapdisp(mask << (base * 8), data << (base * 8));      break; // W_TXBUF_GAPDISP
+            case 0x4800090:
+            case 0x4800091: base -= 0x4800090; size = 2; core->wifi.writeWTxbufLoc(1, mask << (base * 8), data << (base * 8));       break; // W_TXBUF_CMD
+            case 0x48000A0:
+            case 0x48000A1: base -= 0x48000A0; size = 2; core->wifi.writeWTxbufLoc(0, mask << (base * 8), data << (base * 8));       break; // W_TXBUF_LOC1
+            case 0x48000A4:
+            case 0x48000A5: base -= 0x48000A4; size = 2; core->wifi.writeWTxbufLoc(2, mask << (base * 8), data << (base * 8));       break; // W_TXBUF_LOC2
+            case 0x48000A8:
+            case 0x48000A9: base -= 0x48000A8; size = 2; core->wifi.writeWTxbufLoc(3, mask << (base * 8), data << (base * 8));       break; // W_TXBUF_LOC3
+            case 0x48000AA:
+            case 0x48000AB: base -= 0x48000AA; size = 2; core->wifi.writeWTxreqReset(mask << (base * 8), data << (base * 8));        break; // W_TXREQ_RESET
+            case 0x48000AC:
+            case 0x48000AD: base -= 0x48000AC; size = 2; core->wifi.writeWTxreqSet(mask << (base * 8), data << (base * 8));          break; // W_TXREQ_SET
             case 0x4800120:
             case 0x4800121: base -= 0x4800120; size = 2; core->wifi.writeWConfig(0,  mask << (base * 8), data << (base * 8));        break; // W_CONFIG_120
             case 0x4800122:
@@ -2814,6 +3496,8 @@ template <typename T> void Memory::ioWriteGba(uint32_t address, T value)
             case 0x4000201: base -= 0x4000200; size = 2; core->interpreter[1].writeIe(mask << (base * 8), data << (base * 8));    break; // IE
             case 0x4000202:
             case 0x4000203: base -= 0x4000202; size = 2; core->interpreter[1].writeIrf(mask << (base * 8), data << (base * 8));   break; // IF
+            case 0x4000204:
+            case 0x4000205: base -= 0x4000204; size = 2; writeGbaWaitCnt(mask << (base * 8), data << (base * 8));                 break; // WAITCNT
             case 0x4000208: base -= 0x4000208; size = 1; core->interpreter[1].writeIme(data << (base * 8));                       break; // IME
             case 0x4000300: base -= 0x4000300; size = 1; core->interpreter[1].writePostFlg(data << (base * 8));                   break; // POSTFLG
             case 0x4000301: base -= 0x4000301; size = 1; writeGbaHaltCnt(data << (base * 8));                                     break; // HALTCNT
@@ -2846,12 +3530,17 @@ void Memory::writeDmaFill(int channel, uint32_t mask, uint32_t value)
 
 void Memory::writeVramCnt(int index, uint8_t value)
 {
+    // Keep the ARM7 from accessing VRAM while the mappings change, in case it's on its own thread
+    core->pauseArm7();
+
     // Write to one of the VRAMCNT registers and invalidate the 3D if a parameter changed
     const uint8_t masks[] = { 0x9B, 0x9B, 0x9F, 0x9F, 0x87, 0x9F, 0x9F, 0x83, 0x83 };
     if ((value & masks[index]) != (vramCnt[index] & masks[index]))
     {
         vramCnt[index] = value & masks[index];
         core->gpu.invalidate3D();
+        core->gpu2D[0].invalidate();
+        core->gpu2D[1].invalidate();
     }
 
     // Clear the previous mappings
@@ -2986,12 +3675,23 @@ void Memory::writeVramCnt(int index, uint8_t value)
             case 3:                             tex3D[ofs]              = &vramA[0];       break; // 3D texture
         }
     }
+
+    // Update the VRAM mappings for both CPUs
+    updateMap(0, 0x06000000, 0x07000000);
+    updateMap(1, 0x06000000, 0x07000000);
+    core->resumeArm7();
 }
 
 void Memory::writeWramCnt(uint8_t value)
 {
-    // Write to the WRAMCNT register
+    // Write to the WRAMCNT register, keeping the ARM7 from accessing shared WRAM while it changes
+    core->pauseArm7();
     wramCnt = value & 0x03;
+
+    // Update the shared WRAM mappings for both CPUs
+    updateMap(0, 0x03000000, 0x04000000);
+    updateMap(1, 0x03000000, 0x04000000);
+    core->resumeArm7();
 }
 
 void Memory::writeHaltCnt(uint8_t value)
@@ -3022,6 +3722,15 @@ void Memory::writeHaltCnt(uint8_t value)
     }
 }
 
+void Memory::writeGbaWaitCnt(uint16_t mask, uint16_t value)
+{
+    // Write to the WAITCNT register, which controls GBA cartridge timing
+    // Bit 15 reports the cartridge type, which is always GBA
+    mask &= 0x5FFF;
+    waitCnt = (waitCnt & ~mask) | (value & mask);
+    updateGbaWaitstates();
+}
+
 void Memory::writeGbaHaltCnt(uint8_t value)
 {
     // Halt the CPU
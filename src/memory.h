@@ -22,22 +22,71 @@
 
 #include <cstdint>
 
+#include "defines.h"
+
+// Number of 4KB host pages that code can be compiled from (main RAM, shared WRAM, instruction TCM, and ARM7 WRAM)
+#define CODE_PAGES ((0x400000 + 0x8000 + 0x8000 + 0x10000) >> 12)
+
+// Number of 4KB host pages that are tracked for changes (VRAM blocks A-I, then a page each for palette and OAM)
+#define VRAM_PAGES ((0xA4000 >> 12) + 2)
+
+enum AccessType
+{
+    ACCESS_N16 = 0, ACCESS_S16,
+    ACCESS_N32, ACCESS_S32
+};
+
+enum VramBank
+{
+    BANK_A = 0, BANK_B, BANK_C, BANK_D, BANK_E,
+    BANK_F, BANK_G, BANK_H, BANK_I,
+    BANK_PAL, BANK_OAM
+};
+
 class Core;
+class Savestate;
 
 class Memory
 {
     public:
-        Memory(Core *core): core(core) {};
+        Memory(Core *core);
+
+        void syncState(Savestate *state);
 
         void loadBios();
         void loadGbaBios();
+        bool isGbaBiosStub() { return gbaBiosStub; }
 
         template <typename T> T read(bool cpu, uint32_t address);
         template <typename T> void write(bool cpu, uint32_t address, T value);
 
+        void updateMap(bool cpu, uint32_t start, uint32_t end);
+
+        uint8_t *getReadPointer(bool cpu, uint32_t address);
+        uint8_t *getWritePointer(bool cpu, uint32_t address);
+        bool writeBlock(bool cpu, uint32_t dst, const uint8_t *data, uint32_t size);
+        bool copyBlock(bool cpu, uint32_t dst, uint32_t src, uint32_t size);
+        bool fillBlock(bool cpu, uint32_t dst, uint32_t src, uint32_t size, uint32_t unit);
+
+        uint8_t *getCodePointer(bool cpu, uint32_t address);
+        int markCode(bool cpu, uint8_t *data);
+
+        int getWaitstates(bool cpu, uint32_t address, AccessType type);
+        bool getGbaPrefetch() { return waitCnt & BIT(14); }
+
+        uint32_t nextVramGeneration() { return vramGeneration++; }
+        bool vramChanged(const uint8_t *data, uint32_t size, uint32_t generation);
+        bool bankChanged(VramBank bank, uint32_t generation) { return bankGenerations[bank] > generation; }
+        void vramWritten(const uint8_t *data, uint32_t size);
+
         uint8_t  *getPalette()    { return palette;    }
         uint8_t  *getOam()        { return oam;        }
+        uint8_t **getLcdc()       { return lcdc;       }
+        uint8_t **getEngABg()     { return engABg;     }
+        uint8_t **getEngAObj()    { return engAObj;    }
         uint8_t **getEngAExtPal() { return engAExtPal; }
+        uint8_t **getEngBBg()     { return engBBg;     }
+        uint8_t **getEngBObj()    { return engBObj;    }
         uint8_t **getEngBExtPal() { return engBExtPal; }
         uint8_t **getTex3D()      { return tex3D;      }
         uint8_t **getPal3D()      { return pal3D;      }
@@ -45,9 +94,13 @@ class Memory
     private:
         Core *core;
 
+        static const uint8_t waitstates[2][0x10][4];
+        uint8_t gbaWaitstates[0x10][4] = {};
+
         uint8_t bios9[0x8000]   = {}; // 32KB ARM9 BIOS
         uint8_t bios7[0x4000]   = {}; // 16KB ARM7 BIOS
         uint8_t gbaBios[0x4000] = {}; // 16KB GBA BIOS
+        bool gbaBiosStub = false;
 
         uint8_t ram[0x400000]    = {}; //  4MB main RAM
         uint8_t wram[0x8000]     = {}; // 32KB shared WRAM
@@ -84,6 +137,23 @@ class Memory
         uint8_t vramStat = 0;
         uint8_t wramCnt = 0;
         uint8_t haltCnt = 0;
+        uint16_t waitCnt = 0;
+
+        uint8_t *readMap[2][0x10000]  = {}; // Host pointers for each 4KB page below 0x10000000, or null for the slow path
+        uint8_t *writeMap[2][0x10000] = {};
+
+        uint8_t codePages[CODE_PAGES] = {};
+
+        // Each page and bank of video memory remembers the generation it was last written in
+        // Consumers take a generation number, and anything written after that counts as changed since it
+        uint32_t vramGeneration = 1;
+        uint32_t pageGenerations[VRAM_PAGES] = {};
+        uint32_t bankGenerations[BANK_OAM + 1] = {};
+
+        int codePage(uint8_t *data);
+        int vramOffset(const uint8_t *data, int *bank);
+        void blockWritten(bool cpu, uint32_t address, uint8_t *data, uint32_t size);
+        void updateGbaWaitstates();
 
         template <typename T> T ioRead9(uint32_t address);
         template <typename T> T ioRead7(uint32_t address);
@@ -97,11 +167,13 @@ class Memory
         uint8_t  readVramStat()           { return vramStat;         }
         uint8_t  readWramCnt()            { return wramCnt;          }
         uint8_t  readHaltCnt()            { return haltCnt;          }
+        uint16_t readGbaWaitCnt()         { return waitCnt;          }
 
         void writeDmaFill(int channel, uint32_t mask, uint32_t value);
         void writeVramCnt(int index, uint8_t value);
         void writeWramCnt(uint8_t value);
         void writeHaltCnt(uint8_t value);
+        void writeGbaWaitCnt(uint16_t mask, uint16_t value);
         void writeGbaHaltCnt(uint8_t value);
 };
 
@@ -0,0 +1,188 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdio>
+
+#include "movie.h"
+#include "core.h"
+
+#define MOVIE_MAGIC   0x564F4D4E // "NMOV"
+#define MOVIE_VERSION 1
+
+Movie::~Movie()
+{
+    // Make sure a recording gets written
+    stop();
+}
+
+uint32_t Movie::hash(uint32_t hash, uint32_t value)
+{
+    // Add a value to an FNV-1a hash
+    return (hash ^ value) * 16777619;
+}
+
+bool Movie::startRecording(std::string path)
+{
+    // Make sure the movie can be written before starting
+    stop();
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+    fclose(file);
+
+    // Start a new movie, with the RTC counting from the current time
+    // This should be called before the first frame, since movies are replayed from boot
+    this->path = path;
+    frames.clear();
+    startTime = std::time(nullptr);
+    frame = 0;
+    desyncFrame = -1;
+    state = MOVIE_RECORDING;
+    return true;
+}
+
+bool Movie::startPlayback(std::string path)
+{
+    // Open a movie file and check its header
+    stop();
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+
+    uint32_t magic = 0, version = 0, count = 0;
+    uint64_t time = 0;
+    fread(&magic, sizeof(magic), 1, file);
+    fread(&version, sizeof(version), 1, file);
+    fread(&time, sizeof(time), 1, file);
+    fread(&count, sizeof(count), 1, file);
+    if (magic != MOVIE_MAGIC || version != MOVIE_VERSION)
+    {
+        fclose(file);
+        return false;
+    }
+
+    // Load the frames, and start replaying them from boot
+    frames.resize(count);
+    if (count > 0 && fread(&frames[0], sizeof(MovieFrame), count, file) != count)
+    {
+        fclose(file);
+        frames.clear();
+        return false;
+    }
+    fclose(file);
+
+    startTime = time;
+    frame = 0;
+    desyncFrame = -1;
+    state = MOVIE_PLAYING;
+    return true;
+}
+
+void Movie::stop()
+{
+    // Write the frames of a recording to its file
+    if (state == MOVIE_RECORDING)
+    {
+        FILE *file = fopen(path.c_str(), "wb");
+        if (file)
+        {
+            uint32_t magic = MOVIE_MAGIC, version = MOVIE_VERSION, count = frames.size();
+            fwrite(&magic, sizeof(magic), 1, file);
+            fwrite(&version, sizeof(version), 1, file);
+            fwrite(&startTime, sizeof(startTime), 1, file);
+            fwrite(&count, sizeof(count), 1, file);
+            if (count > 0)
+                fwrite(&frames[0], sizeof(MovieFrame), count, file);
+            fclose(file);
+        }
+    }
+
+    state = MOVIE_NONE;
+}
+
+std::time_t Movie::getTime()
+{
+    // Count the time from the start of the movie, at about 59.83 frames per second
+    return startTime + (uint64_t)frame * (263 * 355 * 6) / 33513982;
+}
+
+void Movie::startFrame()
+{
+    // Frames that run-ahead will roll back aren't part of the movie, and just keep the input of the real frame
+    if (core->runAhead.isSpeculative())
+        return;
+
+    if (state == MOVIE_RECORDING)
+    {
+        // Sample the frontend's input and apply it for the whole frame, and record it
+        core->input.poll();
+        core->input.latch();
+        core->spi.latchTouch();
+        MovieFrame data = { core->input.readKeyInput(), core->input.readExtKeyIn(), core->spi.getTouchX(), core->spi.getTouchY(), 0, 0 };
+        frames.push_back(data);
+    }
+    else if (frame < frames.size())
+    {
+        // Replay the recorded input
+        core->input.setKeys(frames[frame].keyInput, frames[frame].extKeyIn);
+        core->spi.setTouchAdc(frames[frame].touchX, frames[frame].touchY);
+    }
+    else
+    {
+        // Hand the input back to the frontend once the movie runs out
+        state = MOVIE_NONE;
+        core->input.latch();
+        core->spi.latchTouch();
+        return;
+    }
+
+    videoHash = audioHash = 0x811C9DC5;
+}
+
+void Movie::finishFrame()
+{
+    if (core->runAhead.isSpeculative())
+        return;
+
+    if (state == MOVIE_RECORDING)
+    {
+        // Record the hashes of the frame's output
+        frames.back().videoHash = videoHash;
+        frames.back().audioHash = audioHash;
+    }
+    else if (desyncFrame == -1 && (frames[frame].videoHash != videoHash || frames[frame].audioHash != audioHash))
+    {
+        // Remember the first frame with output that didn't match the recording
+        desyncFrame = frame;
+    }
+
+    frame++;
+}
+
+void Movie::hashVideo(const uint32_t *data, int size)
+{
+    // Add a completed frame to the video hash
+    for (int i = 0; i < size; i++)
+        videoHash = hash(videoHash, data[i]);
+}
+
+void Movie::hashAudio(uint32_t sample)
+{
+    // Add a sample to the audio hash
+    audioHash = hash(audioHash, sample);
+}
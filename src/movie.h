@@ -0,0 +1,86 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef MOVIE_H
+#define MOVIE_H
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+class Core;
+
+enum MovieState
+{
+    MOVIE_NONE = 0,
+    MOVIE_RECORDING,
+    MOVIE_PLAYING
+};
+
+struct MovieFrame
+{
+    uint16_t keyInput, extKeyIn;
+    uint16_t touchX, touchY;
+    uint32_t videoHash, audioHash;
+};
+
+// A movie records the input of every frame from boot, so the same run can be replayed exactly
+// While one is active, input from the frontend is held until the next frame, and the RTC counts from a fixed time
+// Each frame also has a hash of its video and audio, so a replay can report the first frame that came out different
+class Movie
+{
+    public:
+        Movie(Core *core): core(core) {}
+        ~Movie();
+
+        bool startRecording(std::string path);
+        bool startPlayback(std::string path);
+        void stop();
+
+        bool isActive()    { return state != MOVIE_NONE;      }
+        bool isRecording() { return state == MOVIE_RECORDING; }
+        bool isPlaying()   { return state == MOVIE_PLAYING;   }
+
+        uint32_t getFrame()       { return frame;        }
+        uint32_t getLength()      { return frames.size(); }
+        int      getDesyncFrame() { return desyncFrame;  }
+        std::time_t getTime();
+
+        void startFrame();
+        void finishFrame();
+        void hashVideo(const uint32_t *data, int size);
+        void hashAudio(uint32_t sample);
+
+    private:
+        Core *core;
+
+        MovieState state = MOVIE_NONE;
+        std::string path;
+        std::vector<MovieFrame> frames;
+        uint64_t startTime = 0;
+        uint32_t frame = 0;
+        int desyncFrame = -1;
+
+        uint32_t videoHash = 0, audioHash = 0;
+        static uint32_t hash(uint32_t hash, uint32_t value);
+};
+
+#endif // MOVIE_H
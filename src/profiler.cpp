@@ -0,0 +1,107 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "profiler.h"
+
+void Profiler::count()
+{
+    // Add the time since the last switch to the current section
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    frame.times[current] += std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastTime).count();
+    lastTime = now;
+}
+
+void Profiler::startFrame()
+{
+    // Apply any change to the enabled state between frames
+    enabled = requested.load();
+    if (!enabled) return;
+
+    // Start counting from the beginning of the frame, ignoring time spent outside of the core
+    current = PROFILE_CPU;
+    lastTime = std::chrono::steady_clock::now();
+}
+
+void Profiler::endFrame()
+{
+    // Count the remaining time of the frame
+    count();
+
+    // Save the results of the frame and add them to the totals
+    std::lock_guard<std::mutex> guard(mutex);
+    lastFrame = frame;
+    for (int i = 0; i < PROFILE_COUNT; i++)
+        total.times[i] += frame.times[i];
+    for (int i = 0; i < COUNTER_COUNT; i++)
+        total.counts[i] += frame.counts[i];
+
+    // Clear the results for the next frame
+    frame = ProfileFrame();
+}
+
+ProfileSection Profiler::enter(ProfileSection section)
+{
+    // Switch to a new section, returning the old one so it can be restored
+    count();
+    ProfileSection previous = current;
+    current = section;
+    return previous;
+}
+
+void Profiler::leave(ProfileSection previous)
+{
+    // Switch back to the section that was active before
+    count();
+    current = previous;
+}
+
+void Profiler::reset()
+{
+    // Clear the totals
+    std::lock_guard<std::mutex> guard(mutex);
+    total = ProfileFrame();
+}
+
+ProfileFrame Profiler::getLastFrame()
+{
+    // Get a copy of the results from the last frame
+    std::lock_guard<std::mutex> guard(mutex);
+    return lastFrame;
+}
+
+ProfileFrame Profiler::getTotal()
+{
+    // Get a copy of the results added up since the last reset
+    std::lock_guard<std::mutex> guard(mutex);
+    return total;
+}
+
+const char *Profiler::getName(ProfileSection section)
+{
+    // Get a short name for a section, used when reporting results
+    static const char *names[] = { "cpu", "2d", "3d", "spu", "dma" };
+    return names[section];
+}
+
+const char *Profiler::getName(ProfileCounter counter)
+{
+    // Get a short name for a counter, used when reporting results
+    static const char *names[] = { "arm9_opcodes", "arm7_opcodes", "arm9_idle_loops", "arm7_idle_loops", "tasks", "gx_commands", "polygons" };
+    return names[counter];
+}
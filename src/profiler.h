@@ -0,0 +1,107 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+enum ProfileSection
+{
+    PROFILE_CPU = 0,
+    PROFILE_2D,
+    PROFILE_3D,
+    PROFILE_SPU,
+    PROFILE_DMA,
+    PROFILE_COUNT
+};
+
+enum ProfileCounter
+{
+    COUNTER_ARM9_OPCODES = 0,
+    COUNTER_ARM7_OPCODES,
+    COUNTER_ARM9_IDLE_LOOPS,
+    COUNTER_ARM7_IDLE_LOOPS,
+    COUNTER_TASKS,
+    COUNTER_GX_COMMANDS,
+    COUNTER_POLYGONS,
+    COUNTER_COUNT
+};
+
+struct ProfileFrame
+{
+    uint64_t times[PROFILE_COUNT] = {};
+    uint64_t counts[COUNTER_COUNT] = {};
+};
+
+// The profiler splits the time spent on the core thread between sections
+// Time is exclusive, so a DMA transfer started from a scanline counts as DMA and not 2D
+// Anything that isn't in a specific section, including the scheduler, counts as CPU time
+// Counters track how much work was done, such as opcodes run and polygons drawn
+// Enabling takes effect at the start of the next frame, so it's safe to change from another thread
+class Profiler
+{
+    public:
+        bool isEnabled()             { return enabled;          }
+        void setEnabled(bool enable) { requested.store(enable); }
+
+        void startFrame();
+        void endFrame();
+
+        ProfileSection enter(ProfileSection section);
+        void leave(ProfileSection previous);
+        void add(ProfileCounter counter, uint32_t value = 1) { if (enabled) frame.counts[counter] += value; }
+
+        void reset();
+        ProfileFrame getLastFrame();
+        ProfileFrame getTotal();
+
+        static const char *getName(ProfileSection section);
+        static const char *getName(ProfileCounter counter);
+
+    private:
+        bool enabled = false;
+        std::atomic<bool> requested { false };
+
+        ProfileSection current = PROFILE_CPU;
+        std::chrono::steady_clock::time_point lastTime;
+
+        ProfileFrame frame, lastFrame, total;
+        std::mutex mutex;
+
+        void count();
+};
+
+// Counts the time until the end of a scope towards a section, if the profiler is enabled
+class ProfileScope
+{
+    public:
+        ProfileScope(Profiler *profiler, ProfileSection section):
+            profiler(profiler->isEnabled() ? profiler : nullptr) { if (this->profiler) previous = profiler->enter(section); }
+        ~ProfileScope() { if (profiler) profiler->leave(previous); }
+
+    private:
+        Profiler *profiler;
+        ProfileSection previous = PROFILE_CPU;
+};
+
+#endif // PROFILER_H
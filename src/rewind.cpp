@@ -0,0 +1,207 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cstring>
+
+#include "rewind.h"
+#include "core.h"
+
+Rewind::Rewind(Core *core): core(core)
+{
+    // Get the history limits, with the length in seconds and the budget in megabytes
+    // A budget of 0 disables rewinding, and nothing is recorded; this is the default, since recording takes a full
+    // savestate on the core thread every frame, which waits for the 2D, 3D, and geometry threads to catch up
+    if (core->config.rewindBudget > 0 && core->config.rewindLength > 0)
+    {
+        budget = (size_t)core->config.rewindBudget << 20;
+        maxFrames = core->config.rewindLength * 60;
+    }
+}
+
+Rewind::~Rewind()
+{
+    // Clean up the thread
+    if (thread)
+    {
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            running = false;
+        }
+        cond.notify_all();
+        thread->join();
+        delete thread;
+    }
+}
+
+void Rewind::encodeDelta(std::vector<uint8_t> *older, std::vector<uint8_t> *newer, std::vector<uint8_t> *delta)
+{
+    // Start the delta with the size of the older state, so it can be restored exactly
+    uint32_t size = older->size();
+    delta->clear();
+    delta->insert(delta->end(), (uint8_t*)&size, (uint8_t*)&size + sizeof(uint32_t));
+
+    // XOR the states together, treating bytes past the end of either one as zero
+    // Most of a state stays the same between frames and XORs to zero, so the result is run-length encoded
+    // Each run is stored as a count of unchanged bytes, followed by a count of changed bytes and their values
+    size_t common = std::min(older->size(), newer->size());
+    size_t length = std::max(older->size(), newer->size());
+    #define DIFF(i) (((i) < older->size() ? (*older)[i] : 0) ^ ((i) < newer->size() ? (*newer)[i] : 0))
+
+    for (size_t i = 0; i < length;)
+    {
+        // Skip over unchanged bytes, checking 8 at a time while both states have them
+        size_t start = i;
+        while (i + 8 <= common && memcmp(&(*older)[i], &(*newer)[i], 8) == 0) i += 8;
+        while (i < length && DIFF(i) == 0) i++;
+        uint32_t skip = i - start;
+
+        // Collect changed bytes, ending the run once enough unchanged bytes follow to be worth a new run
+        start = i;
+        while (i < length)
+        {
+            size_t j = i;
+            while (j < length && j < i + 8 && DIFF(j) == 0) j++;
+            if (j == length || j == i + 8) break;
+            i = j + 1;
+        }
+        uint32_t count = i - start;
+
+        // Add the run to the delta
+        delta->insert(delta->end(), (uint8_t*)&skip,  (uint8_t*)&skip  + sizeof(uint32_t));
+        delta->insert(delta->end(), (uint8_t*)&count, (uint8_t*)&count + sizeof(uint32_t));
+        for (size_t j = start; j < i; j++)
+            delta->push_back(DIFF(j));
+    }
+
+    #undef DIFF
+}
+
+void Rewind::applyDelta(std::vector<uint8_t> *state, std::vector<uint8_t> *delta)
+{
+    // Size the state to cover the older state, so the XOR can fill in any bytes it had past the newer one
+    uint32_t size;
+    memcpy(&size, &(*delta)[0], sizeof(uint32_t));
+    if (state->size() < size)
+        state->resize(size, 0);
+
+    // XOR the changed bytes of each run back into the state
+    size_t address = 0;
+    for (size_t i = sizeof(uint32_t); i + sizeof(uint32_t) * 2 <= delta->size();)
+    {
+        uint32_t skip, count;
+        memcpy(&skip,  &(*delta)[i], sizeof(uint32_t)); i += sizeof(uint32_t);
+        memcpy(&count, &(*delta)[i], sizeof(uint32_t)); i += sizeof(uint32_t);
+        address += skip;
+        for (uint32_t j = 0; j < count; j++)
+            (*state)[address++] ^= (*delta)[i++];
+    }
+
+    // Trim the state back to the older size
+    state->resize(size);
+}
+
+void Rewind::recordFrame()
+{
+    if (budget == 0) return;
+
+    // Start the compression thread the first time a frame is recorded
+    if (!thread)
+    {
+        running = true;
+        thread = new std::thread(&Rewind::compressThreaded, this);
+    }
+
+    // Skip this frame if the last one is still being compressed, so the core never has to wait
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (busy) return;
+    }
+
+    // Take a snapshot and hand it to the compression thread
+    // The pending buffer is only touched by the thread while it's busy, and it keeps its capacity between frames
+    core->saveState(&pending);
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        busy = true;
+    }
+    cond.notify_all();
+}
+
+bool Rewind::rewindFrame()
+{
+    // Wait for the compression thread to finish with the last frame
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock, [&]{ return !busy; });
+    if (current.empty()) return false;
+
+    // Step the current state back a frame, unless the history has run out
+    // In that case the oldest state is loaded again, which holds on the first frame of the history
+    if (!deltas.empty())
+    {
+        applyDelta(&current, &deltas.back());
+        deltaSize -= deltas.back().size();
+        deltas.pop_back();
+    }
+
+    // Load the state and run a frame from it to produce video and audio
+    // The frame isn't recorded, so the next rewind continues from the loaded state
+    core->loadState(&current);
+    lock.unlock();
+    core->runFrame();
+    return true;
+}
+
+void Rewind::compressThreaded()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true)
+    {
+        // Wait until a new frame is recorded
+        cond.wait(lock, [&]{ return busy || !running; });
+        if (!running) return;
+        lock.unlock();
+
+        // Encode the difference between the new frame and the last one
+        // The delta leads back from the new frame, so the history can be unwound from the most recent frame
+        std::vector<uint8_t> delta;
+        if (!current.empty())
+            encodeDelta(&current, &pending, &delta);
+        current.swap(pending);
+
+        lock.lock();
+
+        // Add the delta to the history, and drop the oldest frames that go over the limits
+        if (!delta.empty())
+        {
+            deltaSize += delta.size();
+            deltas.push_back(std::move(delta));
+        }
+        while (!deltas.empty() && (deltaSize > budget || deltas.size() > maxFrames))
+        {
+            deltaSize -= deltas.front().size();
+            deltas.pop_front();
+        }
+
+        // Signal that the frame is done
+        busy = false;
+        cond.notify_all();
+    }
+}
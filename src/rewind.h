@@ -0,0 +1,62 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef REWIND_H
+#define REWIND_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Core;
+
+class Rewind
+{
+    public:
+        Rewind(Core *core);
+        ~Rewind();
+
+        void recordFrame();
+        bool rewindFrame();
+
+    private:
+        Core *core;
+
+        size_t budget = 0;
+        size_t maxFrames = 0;
+
+        std::thread *thread = nullptr;
+        std::mutex mutex;
+        std::condition_variable cond;
+        bool running = false, busy = false;
+
+        std::vector<uint8_t> pending, current;
+        std::deque<std::vector<uint8_t>> deltas;
+        size_t deltaSize = 0;
+
+        static void encodeDelta(std::vector<uint8_t> *older, std::vector<uint8_t> *newer, std::vector<uint8_t> *delta);
+        static void applyDelta(std::vector<uint8_t> *state, std::vector<uint8_t> *delta);
+
+        void compressThreaded();
+};
+
+#endif // REWIND_H
@@ -41,6 +41,30 @@
 // When writing a bit to the RTC, you should set bit 0 at the same time as setting SCK to low
 // When reading a bit from the RTC, you should read bit 0 after setting SCK to low (or high?)
 
+void Rtc::syncState(Savestate *state)
+{
+    // Sync the transfer state and registers
+    state->sync(writeCount);
+    state->sync(command);
+    state->sync(status1);
+    state->sync(dateTime);
+    state->sync(rtc);
+}
+
+std::tm *Rtc::getTime()
+{
+    // Get the local time, or the time in a movie so it's the same every replay
+    // Movie time is kept in UTC, so replays don't depend on the time zone either
+    if (core->movie.isActive())
+    {
+        std::time_t t = core->movie.getTime();
+        return std::gmtime(&t);
+    }
+
+    std::time_t t = std::time(nullptr);
+    return std::localtime(&t);
+}
+
 void Rtc::writeRtc(uint8_t value)
 {
     if (value & BIT(2)) // CS high
@@ -74,8 +98,7 @@ void Rtc::writeRtc(uint8_t value)
                             if (writeCount == 8)
                             {
                                 // Get the local time
-                                std::time_t t = std::time(nullptr);
-                                std::tm *time = std::localtime(&t);
+                                std::tm *time = getTime();
                                 time->tm_year %= 100; // The DS only counts years 2000-2099
                                 time->tm_mon++; // The DS starts month values at 1, not 0
 
@@ -106,8 +129,7 @@ void Rtc::writeRtc(uint8_t value)
                             if (writeCount == 8)
                             {
                                 // Get the local time
-                                std::time_t t = std::time(nullptr);
-                                std::tm *time = std::localtime(&t);
+                                std::tm *time = getTime();
 
                                 // Convert to 12-hour mode if enabled
                                 uint8_t hour = time->tm_hour;
@@ -21,14 +21,18 @@
 #define RTC_H
 
 #include <cstdint>
+#include <ctime>
 
 class Core;
+class Savestate;
 
 class Rtc
 {
     public:
         Rtc(Core *core): core(core) {}
 
+        void syncState(Savestate *state);
+
         uint8_t readRtc() { return rtc; }
 
         void writeRtc(uint8_t value);
@@ -42,6 +46,8 @@ class Rtc
         uint8_t dateTime[7] = {};
 
         uint8_t rtc = 0;
+
+        std::tm *getTime();
 };
 
 #endif // RTC_H
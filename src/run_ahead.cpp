@@ -0,0 +1,67 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <algorithm>
+
+#include "run_ahead.h"
+#include "core.h"
+
+RunAhead::RunAhead(Core *core): core(core)
+{
+    // Get the number of frames to run ahead, with 0 disabling it
+    frames = std::max(0, std::min(core->config.runAhead, 4));
+}
+
+void RunAhead::runFrame()
+{
+    // Run frames normally if run-ahead is disabled
+    if (frames == 0)
+    {
+        core->runFrame();
+        return;
+    }
+
+    // Run the real frame, which produces the audio but isn't shown since a later frame takes its place
+    // Frames that won't be shown are also left undrawn, with the decision for each made during the one before it
+    hidden = true;
+    nextHidden = (frames > 1);
+    core->runFrame();
+
+    // Save the real state, reusing the buffer's capacity so this doesn't allocate after the first frame
+    // Save memory isn't part of the state, so it's backed up as well, to undo writes the real frames might not make
+    core->saveState(&state);
+    core->cartridge.backupSave();
+
+    // Run ahead with the current input, only showing the last frame and dropping all of their audio
+    speculative = true;
+    for (int i = 1; i <= frames; i++)
+    {
+        hidden = (i < frames);
+        nextHidden = true;
+        core->runFrame();
+    }
+
+    // Go back to the real state, where the next real frame continues
+    // It's marked as hidden while loading so it won't be drawn, and the flags are cleared for anything else that runs frames
+    hidden = true;
+    core->loadState(&state);
+    core->cartridge.restoreSave();
+    speculative = hidden = nextHidden = false;
+}
@@ -0,0 +1,53 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef RUN_AHEAD_H
+#define RUN_AHEAD_H
+
+#include <cstdint>
+#include <vector>
+
+class Core;
+
+// Run-ahead hides the frames of lag between input and display by running a few frames ahead of the real one
+// Each displayed frame is run from a savestate of the real frame, which is then loaded again to continue
+class RunAhead
+{
+    public:
+        RunAhead(Core *core);
+
+        void runFrame();
+
+        bool isSpeculative() { return speculative; }
+        bool isHidden()      { return hidden;      }
+        bool isNextHidden()  { return nextHidden;  }
+
+    private:
+        Core *core;
+
+        int frames = 0;
+        std::vector<uint8_t> state;
+
+        bool speculative = false;
+        bool hidden = false;
+        bool nextHidden = false;
+};
+
+#endif // RUN_AHEAD_H
@@ -0,0 +1,168 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "save_writer.h"
+
+SaveWriter::~SaveWriter()
+{
+    // Let the thread finish any queued write and stop
+    if (thread)
+    {
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            running = false;
+        }
+        cond.notify_all();
+        thread->join();
+        delete thread;
+    }
+}
+
+void SaveWriter::mark(uint32_t address, uint32_t size)
+{
+    // Mark the pages covered by a write as dirty
+    if (size == 0) return;
+    uint32_t last = (address + size - 1) >> 12;
+    if (pages.size() <= last)
+        pages.resize(last + 1, false);
+    for (uint32_t i = address >> 12; i <= last; i++)
+        pages[i] = true;
+    dirty = changed = true;
+    marks++;
+}
+
+void SaveWriter::markAll()
+{
+    // Mark the whole save as dirty, which also covers it changing size
+    full = dirty = changed = true;
+    marks++;
+}
+
+void SaveWriter::update(const uint8_t *data, int size)
+{
+    // Restart the wait whenever the save has changed since the last frame
+    if (changed)
+    {
+        changed = false;
+        idleFrames = 0;
+    }
+    if (!dirty) return;
+
+    // Queue a write once the save has been left alone for a second, or after 10 seconds of constant changes
+    if (++idleFrames >= 60 || ++dirtyFrames >= 600)
+        queue(data, size);
+}
+
+void SaveWriter::flush(const uint8_t *data, int size)
+{
+    // Queue any changes right away and wait for them to be written
+    changed = false;
+    if (dirty)
+        queue(data, size);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock, [&] { return !queued && !writing; });
+}
+
+void SaveWriter::queue(const uint8_t *data, int size)
+{
+    dirty = false;
+    idleFrames = dirtyFrames = 0;
+    if (size < 0) size = 0;
+
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+
+        // Copy the dirty pages to the shadow buffer, or everything if the size changed
+        if (full || shadow.size() != (size_t)size)
+        {
+            shadow.assign(data, data + size);
+            full = false;
+        }
+        else
+        {
+            for (size_t i = 0; i < pages.size(); i++)
+            {
+                if (!pages[i] || (i << 12) >= (size_t)size) continue;
+                size_t length = std::min<size_t>(0x1000, size - (i << 12));
+                memcpy(&shadow[i << 12], &data[i << 12], length);
+            }
+        }
+
+        for (size_t i = 0; i < pages.size(); i++)
+            pages[i] = false;
+        queued = true;
+
+        // Start the writer thread the first time it's needed
+        if (!thread)
+        {
+            running = true;
+            thread = new std::thread(&SaveWriter::runThread, this);
+        }
+    }
+
+    cond.notify_all();
+}
+
+void SaveWriter::runThread()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true)
+    {
+        // Wait for a write to be queued, and only stop once there are none left
+        cond.wait(lock, [&] { return queued || !running; });
+        if (!queued) break;
+
+        // Take a copy of the shadow buffer so the emulator can keep queueing changes while the file is written
+        std::vector<uint8_t> data = shadow;
+        queued = false;
+        writing = true;
+        lock.unlock();
+
+        // Write to a temporary file and move it over the save, so a crash can't leave it half-written
+        std::string temp = name + ".tmp";
+        FILE *file = fopen(temp.c_str(), "wb");
+        if (file)
+        {
+            bool written = (data.empty() || fwrite(data.data(), sizeof(uint8_t), data.size(), file) == data.size());
+            written &= (fclose(file) == 0);
+
+            // Renaming over an existing file fails on some platforms, so remove the old one first if it does
+            if (written && rename(temp.c_str(), name.c_str()) != 0)
+            {
+                remove(name.c_str());
+                rename(temp.c_str(), name.c_str());
+            }
+            else if (!written)
+            {
+                remove(temp.c_str());
+            }
+        }
+
+        lock.lock();
+        writing = false;
+        cond.notify_all();
+    }
+}
@@ -0,0 +1,66 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef SAVE_WRITER_H
+#define SAVE_WRITER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes a save file on a separate thread, so saving doesn't stall emulation
+// Writes to save memory mark 4KB pages as dirty, and only those pages are copied to a shadow buffer for the writer
+// Updates are debounced until save memory has been left alone for a while, and files are replaced atomically
+class SaveWriter
+{
+    public:
+        ~SaveWriter();
+
+        void setName(std::string name) { this->name = name; }
+
+        void mark(uint32_t address, uint32_t size = 1);
+        void markAll();
+        uint32_t getMarks() { return marks; }
+
+        void update(const uint8_t *data, int size);
+        void flush(const uint8_t *data, int size);
+
+    private:
+        std::string name;
+        std::vector<bool> pages;
+        bool dirty = false, changed = false, full = false;
+        uint32_t marks = 0;
+        int idleFrames = 0, dirtyFrames = 0;
+
+        bool running = false;
+        std::thread *thread = nullptr;
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::vector<uint8_t> shadow;
+        bool queued = false, writing = false;
+
+        void queue(const uint8_t *data, int size);
+        void runThread();
+};
+
+#endif // SAVE_WRITER_H
@@ -0,0 +1,55 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstring>
+
+#include "savestate.h"
+
+void Savestate::syncData(void *value, size_t size)
+{
+    if (loading)
+    {
+        // Copy data out of the state, or mark the state invalid if it runs out
+        if (!valid || offset + size > data->size())
+        {
+            valid = false;
+            return;
+        }
+        memcpy(value, &(*data)[offset], size);
+    }
+    else
+    {
+        // Append data to the state, reusing the vector's existing capacity
+        data->insert(data->end(), (uint8_t*)value, (uint8_t*)value + size);
+    }
+
+    offset += size;
+}
+
+uint32_t Savestate::getTaskId(std::function<void()> *task)
+{
+    // Look up the ID of a task, which is the order it was registered in
+    // Components register their tasks in a fixed order, so the IDs are stable between runs
+    for (uint32_t i = 0; i < tasks.size(); i++)
+    {
+        if (tasks[i] == task)
+            return i;
+    }
+    return -1;
+}
@@ -0,0 +1,88 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SAVESTATE_H
+#define SAVESTATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#define STATE_MAGIC   0x5354534E // "NSTS"
+#define STATE_VERSION 11
+
+// A savestate is synced by passing it through each component in a fixed order
+// The same sync code is used for saving and loading, so the two can't get out of step
+class Savestate
+{
+    public:
+        Savestate(std::vector<uint8_t> *data, bool loading): data(data), loading(loading) {}
+
+        bool isLoading() { return loading; }
+        bool isValid()   { return valid;   }
+
+        void syncData(void *value, size_t size);
+        template <typename T> void sync(T &value) { syncData(&value, sizeof(T)); }
+        template <typename T> void syncQueue(std::queue<T> &queue);
+
+        void addTask(std::function<void()> *task) { tasks.push_back(task); }
+        uint32_t getTaskId(std::function<void()> *task);
+        std::function<void()> *getTask(uint32_t id) { return (id < tasks.size()) ? tasks[id] : nullptr; }
+
+    private:
+        std::vector<uint8_t> *data;
+        bool loading;
+        bool valid = true;
+        size_t offset = 0;
+
+        std::vector<std::function<void()>*> tasks;
+};
+
+template <typename T> void Savestate::syncQueue(std::queue<T> &queue)
+{
+    // Sync the size of a queue, followed by its values from front to back
+    uint32_t size = queue.size();
+    sync(size);
+
+    if (loading)
+    {
+        // Rebuild the queue from the saved values
+        queue = std::queue<T>();
+        for (uint32_t i = 0; i < size && valid; i++)
+        {
+            T value;
+            sync(value);
+            queue.push(value);
+        }
+    }
+    else
+    {
+        // Save a copy of the queue so the original is left alone
+        std::queue<T> copy = queue;
+        while (!copy.empty())
+        {
+            sync(copy.front());
+            copy.pop();
+        }
+    }
+}
+
+#endif // SAVESTATE_H
@@ -21,28 +21,39 @@
 #include "defines.h"
 
 std::string Settings::filename = "noods.ini";
-
-int Settings::directBoot = 1;
-int Settings::fpsLimiter = 1;
-int Settings::threaded2D = 1;
-int Settings::threaded3D = 1;
-std::string Settings::bios9Path = "bios9.bin";
-std::string Settings::bios7Path = "bios7.bin";
-std::string Settings::firmwarePath = "firmware.bin";
-std::string Settings::gbaBiosPath = "gba_bios.bin";
-std::string Settings::sdImagePath = "sd.img";
+Config Settings::config;
 
 std::vector<Setting> Settings::settings =
 {
-    Setting("directBoot",   &directBoot,   false),
-    Setting("fpsLimiter",   &fpsLimiter,   false),
-    Setting("threaded2D",   &threaded2D,   false),
-    Setting("threaded3D",   &threaded3D,   false),
-    Setting("bios9Path",    &bios9Path,    true),
-    Setting("bios7Path",    &bios7Path,    true),
-    Setting("firmwarePath", &firmwarePath, true),
-    Setting("gbaBiosPath",  &gbaBiosPath,  true),
-    Setting("sdImagePath",  &sdImagePath,  true)
+    Setting("directBoot",   &config.directBoot,   false),
+    Setting("fpsLimiter",   &config.fpsLimiter,   false),
+    Setting("frameSkip",    &config.frameSkip,    false),
+    Setting("resampler",    &config.resampler,    false),
+    Setting("threaded2D",   &config.threaded2D,   false),
+    Setting("threaded3D",   &config.threaded3D,   false),
+    Setting("threadedGeo",  &config.threadedGeo,  false),
+    Setting("hardware3D",   &config.hardware3D,   false),
+    Setting("scale3D",      &config.scale3D,      false),
+    Setting("dualScreen3D", &config.dualScreen3D, false),
+    Setting("callBlocks",   &config.callBlocks,   false),
+    Setting("batchCpus",    &config.batchCpus,    false),
+    Setting("threadedArm7", &config.threadedArm7, false),
+    Setting("arm7Window",   &config.arm7Window,   false),
+    Setting("idleLoops",    &config.idleLoops,    false),
+    Setting("memTiming",    &config.memTiming,    false),
+    Setting("hleBios",      &config.hleBios,      false),
+    Setting("rewindLength", &config.rewindLength, false),
+    Setting("rewindBudget", &config.rewindBudget, false),
+    Setting("runAhead",     &config.runAhead,     false),
+    Setting("wifiPort",     &config.wifiPort,     false),
+    Setting("pinThreads",   &config.pinThreads,   false),
+    Setting("bios9Path",    &config.bios9Path,    true),
+    Setting("bios7Path",    &config.bios7Path,    true),
+    Setting("firmwarePath", &config.firmwarePath, true),
+    Setting("gbaBiosPath",  &config.gbaBiosPath,  true),
+    Setting("sdImagePath",  &config.sdImagePath,  true),
+    Setting("wifiPeer",     &config.wifiPeer,     true),
+    Setting("telemetry",    &config.telemetry,    true)
 };
 
 void Settings::add(std::vector<Setting> platformSettings)
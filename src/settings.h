@@ -32,6 +32,41 @@ struct Setting
     bool isString;
 };
 
+// The settings a core runs with, which are copied into each core so that several can run with their own
+// Frontends keep their saved settings in the Settings class, and pass a copy of them to each core they create
+struct Config
+{
+    int directBoot = 1;
+    int fpsLimiter = 1;
+    int frameSkip = 0;
+    int resampler = 1;
+    int threaded2D = 1;
+    int threaded3D = 1;
+    int threadedGeo = 0;
+    int hardware3D = 0;
+    int scale3D = 1;
+    int dualScreen3D = 0;
+    int callBlocks = 0;
+    int batchCpus = 0;
+    int threadedArm7 = 0;
+    int arm7Window = 2130;
+    int idleLoops = 0;
+    int memTiming = 0;
+    int hleBios = 0;
+    int rewindLength = 10;
+    int rewindBudget = 0;
+    int runAhead = 0;
+    int wifiPort = 0;
+    int pinThreads = 0;
+    std::string bios9Path = "bios9.bin";
+    std::string bios7Path = "bios7.bin";
+    std::string firmwarePath = "firmware.bin";
+    std::string gbaBiosPath = "gba_bios.bin";
+    std::string sdImagePath = "sd.img";
+    std::string wifiPeer = "255.255.255.255:7064";
+    std::string telemetry = "";
+};
+
 class Settings
 {
     public:
@@ -39,40 +74,73 @@ class Settings
         static bool load(std::string filename = "noods.ini");
         static bool save();
 
-        static int         getDirectBoot()   { return directBoot;   }
-        static int         getFpsLimiter()   { return fpsLimiter;   }
-        static int         getThreaded2D()   { return threaded2D;   }
-        static int         getThreaded3D()   { return threaded3D;   }
-        static std::string getBios9Path()    { return bios9Path;    }
-        static std::string getBios7Path()    { return bios7Path;    }
-        static std::string getFirmwarePath() { return firmwarePath; }
-        static std::string getGbaBiosPath()  { return gbaBiosPath;  }
-        static std::string getSdImagePath()  { return sdImagePath;  }
-
-        static void setDirectBoot(int value)           { directBoot   = value; }
-        static void setFpsLimiter(int value)           { fpsLimiter   = value; }
-        static void setThreaded2D(int value)           { threaded2D   = value; }
-        static void setThreaded3D(int value)           { threaded3D   = value; }
-        static void setBios9Path(std::string value)    { bios9Path    = value; }
-        static void setBios7Path(std::string value)    { bios7Path    = value; }
-        static void setFirmwarePath(std::string value) { firmwarePath = value; }
-        static void setGbaBiosPath(std::string value)  { gbaBiosPath  = value; }
-        static void setSdImagePath(std::string value)  { sdImagePath  = value; }
+        static const Config &getConfig() { return config; }
+
+        static int         getDirectBoot()   { return config.directBoot;   }
+        static int         getFpsLimiter()   { return config.fpsLimiter;   }
+        static int         getFrameSkip()    { return config.frameSkip;    }
+        static int         getResampler()    { return config.resampler;    }
+        static int         getThreaded2D()   { return config.threaded2D;   }
+        static int         getThreaded3D()   { return config.threaded3D;   }
+        static int         getThreadedGeo()  { return config.threadedGeo;  }
+        static int         getHardware3D()   { return config.hardware3D;   }
+        static int         getScale3D()      { return config.scale3D;      }
+        static int         getDualScreen3D() { return config.dualScreen3D; }
+        static int         getCallBlocks()   { return config.callBlocks;   }
+        static int         getBatchCpus()    { return config.batchCpus;    }
+        static int         getThreadedArm7() { return config.threadedArm7; }
+        static int         getArm7Window()   { return config.arm7Window;   }
+        static int         getIdleLoops()    { return config.idleLoops;    }
+        static int         getMemTiming()    { return config.memTiming;    }
+        static int         getHleBios()      { return config.hleBios;      }
+        static int         getRewindLength() { return config.rewindLength; }
+        static int         getRewindBudget() { return config.rewindBudget; }
+        static int         getRunAhead()     { return config.runAhead;     }
+        static int         getWifiPort()     { return config.wifiPort;     }
+        static int         getPinThreads()   { return config.pinThreads;   }
+        static std::string getBios9Path()    { return config.bios9Path;    }
+        static std::string getBios7Path()    { return config.bios7Path;    }
+        static std::string getFirmwarePath() { return config.firmwarePath; }
+        static std::string getGbaBiosPath()  { return config.gbaBiosPath;  }
+        static std::string getSdImagePath()  { return config.sdImagePath;  }
+        static std::string getWifiPeer()     { return config.wifiPeer;     }
+        static std::string getTelemetry()    { return config.telemetry;    }
+
+        static void setDirectBoot(int value)           { config.directBoot   = value; }
+        static void setFpsLimiter(int value)           { config.fpsLimiter   = value; }
+        static void setFrameSkip(int value)            { config.frameSkip    = value; }
+        static void setResampler(int value)            { config.resampler    = value; }
+        static void setThreaded2D(int value)           { config.threaded2D   = value; }
+        static void setThreaded3D(int value)           { config.threaded3D   = value; }
+        static void setThreadedGeo(int value)          { config.threadedGeo  = value; }
+        static void setHardware3D(int value)           { config.hardware3D   = value; }
+        static void setScale3D(int value)              { config.scale3D      = value; }
+        static void setDualScreen3D(int value)         { config.dualScreen3D = value; }
+        static void setCallBlocks(int value)           { config.callBlocks   = value; }
+        static void setBatchCpus(int value)            { config.batchCpus    = value; }
+        static void setThreadedArm7(int value)         { config.threadedArm7 = value; }
+        static void setArm7Window(int value)           { config.arm7Window   = value; }
+        static void setIdleLoops(int value)            { config.idleLoops    = value; }
+        static void setMemTiming(int value)            { config.memTiming    = value; }
+        static void setHleBios(int value)              { config.hleBios      = value; }
+        static void setRewindLength(int value)         { config.rewindLength = value; }
+        static void setRewindBudget(int value)         { config.rewindBudget = value; }
+        static void setRunAhead(int value)             { config.runAhead     = value; }
+        static void setWifiPort(int value)             { config.wifiPort     = value; }
+        static void setPinThreads(int value)           { config.pinThreads   = value; }
+        static void setBios9Path(std::string value)    { config.bios9Path    = value; }
+        static void setBios7Path(std::string value)    { config.bios7Path    = value; }
+        static void setFirmwarePath(std::string value) { config.firmwarePath = value; }
+        static void setGbaBiosPath(std::string value)  { config.gbaBiosPath  = value; }
+        static void setSdImagePath(std::string value)  { config.sdImagePath  = value; }
+        static void setWifiPeer(std::string value)     { config.wifiPeer     = value; }
+        static void setTelemetry(std::string value)    { config.telemetry    = value; }
 
     private:
         Settings() {} // Private to prevent instantiation
 
         static std::string filename;
-
-        static int directBoot;
-        static int fpsLimiter;
-        static int threaded2D;
-        static int threaded3D;
-        static std::string bios9Path;
-        static std::string bios7Path;
-        static std::string firmwarePath;
-        static std::string gbaBiosPath;
-        static std::string sdImagePath;
+        static Config config;
 
         static std::vector<Setting> settings;
 };
@@ -19,12 +19,24 @@
 
 #include "spi.h"
 #include "core.h"
-#include "settings.h"
+
+void Spi::syncState(Savestate *state)
+{
+    // Sync the transfer state and registers
+    // The firmware is loaded from a file, so it isn't part of the state
+    state->sync(writeCount);
+    state->sync(address);
+    state->sync(command);
+    state->sync(touchX);
+    state->sync(touchY);
+    state->sync(spiCnt);
+    state->sync(spiData);
+}
 
 void Spi::loadFirmware()
 {
     // Attempt to load the firmware
-    FILE *firmwareFile = fopen(Settings::getFirmwarePath().c_str(), "rb");
+    FILE *firmwareFile = fopen(core->config.firmwarePath.c_str(), "rb");
     if (!firmwareFile) throw 1;
     fread(firmware, sizeof(uint8_t), 0x40000, firmwareFile);
     fclose(firmwareFile);
@@ -56,15 +68,34 @@ void Spi::setTouch(int x, int y)
     if (y < 1) y = 1; else if (y > 190) y = 190;
 
     // Convert the coordinates to ADC values
-    if (scrX2 - scrX1 != 0) touchX = (x - (scrX1 - 1)) * (adcX2 - adcX1) / (scrX2 - scrX1) + adcX1;
-    if (scrY2 - scrY1 != 0) touchY = (y - (scrY1 - 1)) * (adcY2 - adcY1) / (scrY2 - scrY1) + adcY1;
+    // They're held until the next frame if a movie is active, like the rest of the input
+    if (scrX2 - scrX1 != 0) heldTouchX = (x - (scrX1 - 1)) * (adcX2 - adcX1) / (scrX2 - scrX1) + adcX1;
+    if (scrY2 - scrY1 != 0) heldTouchY = (y - (scrY1 - 1)) * (adcY2 - adcY1) / (scrY2 - scrY1) + adcY1;
+    if (!core->movie.isActive())
+        latchTouch();
 }
 
 void Spi::clearTouch()
 {
     // Set the ADC values to their default state
-    touchX = 0x000;
-    touchY = 0xFFF;
+    heldTouchX = 0x000;
+    heldTouchY = 0xFFF;
+    if (!core->movie.isActive())
+        latchTouch();
+}
+
+void Spi::latchTouch()
+{
+    // Apply the touch position held from the frontend
+    touchX = heldTouchX;
+    touchY = heldTouchY;
+}
+
+void Spi::setTouchAdc(uint16_t x, uint16_t y)
+{
+    // Set the ADC values directly, as done when replaying a movie
+    touchX = x;
+    touchY = y;
 }
 
 void Spi::writeSpiCnt(uint16_t mask, uint16_t value)
@@ -129,6 +160,9 @@ void Spi::writeSpiData(uint8_t value)
 
             case 2: // Touchscreen
             {
+                // Make sure the frontend's touch input is up to date before it's sent
+                core->input.poll();
+
                 switch ((command & 0x70) >> 4) // Channel
                 {
                     case 1: // Y-coordinate
@@ -23,18 +23,26 @@
 #include <cstdint>
 
 class Core;
+class Savestate;
 
 class Spi
 {
     public:
         Spi(Core *core): core(core) {}
 
+        void syncState(Savestate *state);
+
         void loadFirmware();
         void directBoot();
 
         void setTouch(int x, int y);
         void clearTouch();
 
+        uint16_t getTouchX() { return touchX; }
+        uint16_t getTouchY() { return touchY; }
+        void latchTouch();
+        void setTouchAdc(uint16_t x, uint16_t y);
+
         uint16_t readSpiCnt()  { return spiCnt;  }
         uint8_t  readSpiData() { return spiData; }
 
@@ -51,6 +59,7 @@ class Spi
         uint8_t command = 0;
 
         uint16_t touchX = 0x000, touchY = 0xFFF;
+        uint16_t heldTouchX = 0x000, heldTouchY = 0xFFF;
         uint16_t spiCnt = 0;
         uint8_t spiData = 0;
 };
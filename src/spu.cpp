@@ -17,12 +17,18 @@
     along with NooDS. If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <chrono>
-#include <cstring>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 #include "spu.h"
 #include "core.h"
-#include "settings.h"
 
 const int Spu::indexTable[] =
 {
@@ -43,97 +49,347 @@ const int16_t Spu::adpcmTable[] =
 
 Spu::Spu(Core *core): core(core)
 {
-    // Mark the buffer as not ready
-    ready.store(false);
+    // Start with an empty sample buffer
+    ringHead.store(0);
+    ringTail.store(0);
+    requestSize.store(0);
 
     // Prepare tasks to be used with the scheduler
-    runGbaSampleTask = std::bind(&Spu::runGbaSample, this);
-    runSampleTask = std::bind(&Spu::runSample, this);
+    runGbaSampleTask = std::bind(&Spu::runGbaBatch, this);
+    for (int i = 0; i < 2; i++)
+        gbaFifoTask[i] = std::bind(&Spu::runGbaFifo, this, i);
+    runSampleTask = std::bind(&Spu::runBatch, this);
+
+    // Take the settings that playback uses
+    updateConfig();
 }
 
-Spu::~Spu()
+void Spu::updateConfig()
 {
-    // Free the buffers
-    delete[] bufferIn;
-    delete[] bufferOut;
+    // Copy the settings that the audio thread uses whenever the core's settings change
+    pinAudio.store(core->config.pinThreads);
+    audioLimiter.store(core->config.fpsLimiter);
+    audioResampler.store(core->config.resampler);
+}
+
+void Spu::syncState(Savestate *state)
+{
+    // Register the tasks so they can be referenced by ID
+    state->addTask(&runGbaSampleTask);
+    state->addTask(&gbaFifoTask[0]);
+    state->addTask(&gbaFifoTask[1]);
+    state->addTask(&runSampleTask);
+
+    // Sync the GBA sound state
+    // The output buffers are handed to the frontend, so they aren't part of the state
+    state->sync(gbaFrameSequencer);
+    state->sync(gbaSoundTimers);
+    state->sync(gbaEnvelopes);
+    state->sync(gbaEnvTimers);
+    state->sync(gbaSweepTimer);
+    state->sync(gbaWaveDigit);
+    state->sync(gbaNoiseValue);
+    state->sync(gbaWaveRam);
+    state->sync(gbaSampleCycles);
+    state->sync(gbaFifos);
+    state->sync(gbaFifoHeads);
+    state->sync(gbaFifoSizes);
+    state->sync(gbaSamples);
+    state->sync(gbaFifoCycles);
+    state->sync(gbaFifoPeriods);
+
+    // Sync the NDS sound state
+    state->sync(enabled);
+    state->sync(sampleCycles);
+    state->sync(adpcmValue);
+    state->sync(adpcmLoopValue);
+    state->sync(adpcmIndex);
+    state->sync(adpcmLoopIndex);
+    state->sync(adpcmToggle);
+    state->sync(dutyCycles);
+    state->sync(noiseValues);
+    state->sync(soundCurrent);
+    state->sync(soundTimers);
+    state->sync(sndCapCurrent);
+    state->sync(sndCapTimers);
+
+    // Sync the GBA registers
+    state->sync(gbaSoundCntL);
+    state->sync(gbaSoundCntH);
+    state->sync(gbaSoundCntX);
+    state->sync(gbaMainSoundCntL);
+    state->sync(gbaMainSoundCntH);
+    state->sync(gbaMainSoundCntX);
+    state->sync(gbaSoundBias);
+
+    // Sync the NDS registers
+    state->sync(soundCnt);
+    state->sync(soundSad);
+    state->sync(soundTmr);
+    state->sync(soundPnt);
+    state->sync(soundLen);
+    state->sync(mainSoundCnt);
+    state->sync(soundBias);
+    state->sync(sndCapCnt);
+    state->sync(sndCapDad);
+    state->sync(sndCapLen);
+}
+
+void Spu::resetCycles()
+{
+    // Adjust the next sample cycle for a global cycle reset, catching up first so it can't go negative
+    if (core->isGbaMode())
+    {
+        // Adjust the next GBA sample and FIFO overflow cycles the same way
+        runGbaSamples();
+        gbaSampleCycles -= core->getGlobalCycles();
+        for (int i = 0; i < 2; i++)
+            gbaFifoCycles[i] -= core->getGlobalCycles();
+        return;
+    }
+
+    runSamples();
+    sampleCycles -= core->getGlobalCycles();
 }
 
 void Spu::scheduleInit()
 {
     // Schedule the initial NDS SPU task (this will reschedule itself indefinitely)
-    core->schedule(Task(&runSampleTask, 512 * 2));
+    // Each task mixes a block of 16 samples, ending at the one it's scheduled for
+    sampleCycles = core->getGlobalCycles() + 512 * 2;
+    core->schedule(Task(&runSampleTask, 512 * 2 * 16, true));
 }
 
 void Spu::gbaScheduleInit()
 {
     // Schedule the initial GBA SPU task (this will reschedule itself indefinitely)
-    core->schedule(Task(&runGbaSampleTask, 512));
+    // Each task mixes a block of 16 samples, ending at the one it's scheduled for
+    gbaSampleCycles = core->getGlobalCycles() + 512;
+    core->schedule(Task(&runGbaSampleTask, 512 * 16));
+    updateGbaFifos();
+}
+
+TARGET_CLONES void Spu::interpolate(const uint32_t *samples, const float *weights, int16_t *out)
+{
+    // Weight 4 stereo samples and sum them, with both channels handled in the same vector
+#if defined(__x86_64__) || defined(_M_X64)
+    __m128i data = _mm_loadu_si128((const __m128i*)samples);
+    __m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(data, data), 16));
+    __m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(data, data), 16));
+    __m128 w = _mm_loadu_ps(weights);
+    __m128 sum = _mm_add_ps(_mm_mul_ps(lo, _mm_unpacklo_ps(w, w)), _mm_mul_ps(hi, _mm_unpackhi_ps(w, w)));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    __m128i result = _mm_cvtps_epi32(sum);
+    uint32_t packed = _mm_cvtsi128_si32(_mm_packs_epi32(result, result));
+    out[0] = packed >>  0;
+    out[1] = packed >> 16;
+#elif defined(__aarch64__)
+    int16x8_t data = vreinterpretq_s16_u32(vld1q_u32(samples));
+    float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(data)));
+    float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(data)));
+    float32x4_t w = vld1q_f32(weights);
+    float32x4_t sum = vaddq_f32(vmulq_f32(lo, vzip1q_f32(w, w)), vmulq_f32(hi, vzip2q_f32(w, w)));
+    int32x2_t result = vcvtn_s32_f32(vadd_f32(vget_low_f32(sum), vget_high_f32(sum)));
+    int16x4_t packed = vqmovn_s32(vcombine_s32(result, result));
+    out[0] = vget_lane_s16(packed, 0);
+    out[1] = vget_lane_s16(packed, 1);
+#else
+    for (int c = 0; c < 2; c++)
+    {
+        float sum = 0;
+        for (int i = 0; i < 4; i++)
+            sum += (int16_t)(samples[i] >> (c * 16)) * weights[i];
+        out[c] = std::max(-32768.0f, std::min(32767.0f, sum + ((sum < 0) ? -0.5f : 0.5f)));
+    }
+#endif
 }
 
-uint32_t *Spu::getSamples(int count)
+void Spu::getSamples(int16_t *buffer, int count, int rate)
 {
-    // Initialize the buffers
-    if (bufferSize != count)
+    // Place the audio thread the first time it asks for samples
+    if (pinAudio.load() && std::this_thread::get_id() != audioThread)
     {
-        delete[] bufferIn;
-        delete[] bufferOut;
-        bufferIn  = new uint32_t[count];
-        bufferOut = new uint32_t[count];
-        bufferSize = count;
-        bufferPointer = 0;
+        audioThread = std::this_thread::get_id();
+        ThreadPlacement::place(THREAD_AUDIO);
     }
 
-    bool wait;
+    // Step through the samples at the ratio between the NDS and output rates
+    uint32_t step = ((uint64_t)32768 << 16) / rate;
+
+    // Remember the request size in NDS samples, so the core knows how far ahead of playback it can run
+    int needed = std::max<int>(((uint64_t)step * count) >> 16, 1);
+    requestSize.store(std::min(needed, 0x1000));
 
-    // If FPS limit is enabled, try to wait until the buffer is filled
-    // If the emulation isn't full speed, waiting would starve the audio buffer
-    // So if it's taking too long, just let it play an empty buffer
-    if (Settings::getFpsLimiter() == 2) // Accurate
+    uint32_t tail = ringTail.load();
+    int available = ringHead.load() - tail;
+
+    // Adjust the playback rate by up to 0.5% to keep about two requests queued, leaving one after playback
+    if (audioLimiter.load() == 3) // Paced
     {
-        std::chrono::steady_clock::time_point waitTime = std::chrono::steady_clock::now();
-        wait = false;
+        int offset = std::max(-needed, std::min(needed, available - needed * 2));
+        step += (int64_t)step * offset / (needed * 200);
+    }
+
+    // Interpolation reads up to 2 samples past the current one, and 1 before it
+    // The one before has already been played, but stays in the buffer since the core never fills it completely
+    int resampler = audioResampler.load();
+    int ahead = (resampler == 2) ? 2 : resampler;
+    uint32_t end = ratePosition + step * count;
 
-        // Use a while loop to constantly check if the wait condition has been satisfied
-        // This is wasteful, but ensures a swift break from the wait state
-        while (!ready.load())
+    if ((int)(end >> 16) + ahead < available)
+    {
+        const uint32_t *ring = ringBuffer;
+        for (int i = 0; i < count; i++)
         {
-            if (std::chrono::steady_clock::now() - waitTime > std::chrono::microseconds(1000000 / 60))
+            uint32_t position = ratePosition + step * i;
+            uint32_t index = tail + (position >> 16);
+            float f = (position & 0xFFFF) / 65536.0f;
+
+            switch (resampler)
             {
-                wait = true;
-                break;
+                case 0: // Nearest
+                {
+                    uint32_t sample = ring[index & 0x1FFF];
+                    buffer[i * 2 + 0] = sample >>  0;
+                    buffer[i * 2 + 1] = sample >> 16;
+                    break;
+                }
+
+                case 1: // Linear
+                {
+                    uint32_t samples[4] = { ring[index & 0x1FFF], ring[(index + 1) & 0x1FFF] };
+                    float weights[4] = { 1 - f, f, 0, 0 };
+                    interpolate(samples, weights, &buffer[i * 2]);
+                    break;
+                }
+
+                default: // Cubic (Catmull-Rom)
+                {
+                    uint32_t samples[4] =
+                    {
+                        ring[(index - 1) & 0x1FFF], ring[index & 0x1FFF],
+                        ring[(index + 1) & 0x1FFF], ring[(index + 2) & 0x1FFF]
+                    };
+                    float weights[4] =
+                    {
+                        ((-f + 2) * f - 1) * f / 2,
+                        ((3 * f - 5) * f * f + 2) / 2,
+                        ((-3 * f + 4) * f + 1) * f / 2,
+                        (f - 1) * f * f / 2
+                    };
+                    interpolate(samples, weights, &buffer[i * 2]);
+                    break;
+                }
             }
         }
+
+        // Signal that the samples were played
+        ratePosition = end & 0xFFFF;
+        lastSample = (uint16_t)buffer[count * 2 - 2] | (buffer[count * 2 - 1] << 16);
+        ringTail.store(tail + (end >> 16));
+        return;
     }
-    else // Disabled/Light
+
+    // If not enough samples are queued, play what's there and fill the rest with the last played sample
+    // This prevents crackles when running slow, and counts as an underrun for telemetry
+    core->telemetry.addUnderrun();
+    int size = std::min<int>(end >> 16, available);
+    for (int i = 0; i < count; i++)
     {
-        // Use a condition variable to save CPU cycles
-        // This might take longer than expected due to the OS scheduler and other factors
-        std::unique_lock<std::mutex> lock(mutex2);
-        wait = !cond2.wait_for(lock, std::chrono::microseconds(1000000 / 60), [&]{ return ready.load(); });
+        uint32_t index = (ratePosition + step * i) >> 16;
+        if ((int)index < size) lastSample = ringBuffer[(tail + index) & 0x1FFF];
+        buffer[i * 2 + 0] = lastSample >>  0;
+        buffer[i * 2 + 1] = lastSample >> 16;
     }
 
-    uint32_t *out = new uint32_t[count];
-    
-    if (wait)
+    // Signal that the samples were played
+    ratePosition = 0;
+    ringTail.store(tail + size);
+}
+
+void Spu::runGbaBatch()
+{
+    // Catch up to the end of the block, and schedule the next one
+    runGbaSamples();
+    core->schedule(Task(&runGbaSampleTask, gbaSampleCycles + 512 * 15 - core->getGlobalCycles()));
+}
+
+void Spu::runGbaSamples()
+{
+    // Mix every GBA sample that was due by the current cycle, draining the FIFOs up to each one
+    if (gbaSampleCycles <= core->getGlobalCycles())
     {
-        // Fill the output buffer with the last played sample to prevent crackles when running slow
-        for (int i = 0; i < count; i++)
-            out[i] = bufferOut[count - 1];
+        ProfileScope scope(&core->profiler, PROFILE_SPU);
+        while (gbaSampleCycles <= core->getGlobalCycles())
+        {
+            runGbaFifos(gbaSampleCycles);
+            runGbaSample();
+            gbaSampleCycles += 512;
+        }
     }
-    else
+
+    // Drain the FIFOs up to the current cycle, so they're current for anything that accesses them
+    runGbaFifos(core->getGlobalCycles());
+}
+
+void Spu::runGbaFifos(uint32_t cycles)
+{
+    for (int i = 0; i < 2; i++)
     {
-        // Fill the output buffer with new data
-        memcpy(out, bufferOut, count * sizeof(uint32_t));
+        // Count the timer overflows that passed, skipping FIFOs without a timer running on the scheduler
+        if (!gbaFifoPeriods[i] || (int32_t)(cycles - gbaFifoCycles[i]) < 0)
+            continue;
+        uint32_t count = (cycles - gbaFifoCycles[i]) / gbaFifoPeriods[i] + 1;
+        gbaFifoCycles[i] += count * gbaFifoPeriods[i];
+
+        // Take a sample for each overflow, keeping the last one if the FIFO runs dry
+        uint32_t pops = std::min<uint32_t>(count, gbaFifoSizes[i]);
+        if (pops == 0) continue;
+        gbaSamples[i] = gbaFifos[i][(gbaFifoHeads[i] + pops - 1) & 0x1F];
+        gbaFifoHeads[i] = (gbaFifoHeads[i] + pops) & 0x1F;
+        gbaFifoSizes[i] -= pops;
     }
+}
 
-    // Signal that the buffer was played
+void Spu::runGbaFifo(int fifo)
+{
+    // Catch up to the overflow that dropped the FIFO to half, and request more data from the DMA
+    runGbaSamples();
+    if (gbaFifoSizes[fifo] <= 16)
+        core->dma[1].trigger(3, fifo ? 0x04 : 0x02);
+    scheduleGbaFifo(fifo);
+}
+
+void Spu::scheduleGbaFifo(int fifo)
+{
+    // Schedule an event for the overflow that will leave the FIFO half empty or less
+    // Every overflow requests data once it's there, so the event then happens on the next one
+    core->cancel(&gbaFifoTask[fifo]);
+    if (!gbaFifoPeriods[fifo]) return;
+    uint32_t pops = std::max(gbaFifoSizes[fifo] - 16, 1);
+    uint32_t cycles = gbaFifoCycles[fifo] + (pops - 1) * gbaFifoPeriods[fifo];
+    core->schedule(Task(&gbaFifoTask[fifo], cycles - core->getGlobalCycles()));
+}
+
+void Spu::updateGbaFifos()
+{
+    // Follow the timers that feed the FIFOs, after they've been caught up under the old settings
+    // Timers in count-up mode aren't on the scheduler, so their overflows drive the FIFOs directly instead
+    for (int i = 0; i < 2; i++)
     {
-        std::lock_guard<std::mutex> guard(mutex1);
-        ready.store(false);
-        cond1.notify_one();
+        int timer = (gbaMainSoundCntH >> (10 + i * 4)) & 0x1;
+        if (core->timers[1].getOverflow(timer, &gbaFifoCycles[i], &gbaFifoPeriods[i]))
+        {
+            // Skip any overflow on the current cycle, since the FIFO already caught up to it
+            while ((int32_t)(gbaFifoCycles[i] - core->getGlobalCycles()) <= 0)
+                gbaFifoCycles[i] += gbaFifoPeriods[i];
+        }
+        else
+        {
+            gbaFifoPeriods[i] = 0;
+        }
+        scheduleGbaFifo(i);
     }
-
-    return out;
 }
 
 void Spu::runGbaSample()
@@ -360,19 +616,15 @@ void Spu::runGbaSample()
                 sampleRight += data[i] * (gbaMainSoundCntL & 0x0007) / 7;
         }
 
-        // Mix FIFO channel A
-        // The maximum volume is +/-0x200, achieved by shifting the data left by 2
-        if (gbaMainSoundCntH & BIT(9))
-            sampleLeft += gbaSampleA << ((gbaMainSoundCntH & BIT(2)) ? 2 : 1);
-        if (gbaMainSoundCntH & BIT(8))
-            sampleRight += gbaSampleA << ((gbaMainSoundCntH & BIT(2)) ? 2 : 1);
-
-        // Mix FIFO channel B
+        // Mix the FIFO channels
         // The maximum volume is +/-0x200, achieved by shifting the data left by 2
-        if (gbaMainSoundCntH & BIT(13))
-            sampleLeft += gbaSampleB << ((gbaMainSoundCntH & BIT(3)) ? 2 : 1);
-        if (gbaMainSoundCntH & BIT(12))
-            sampleRight += gbaSampleB << ((gbaMainSoundCntH & BIT(3)) ? 2 : 1);
+        for (int i = 0; i < 2; i++)
+        {
+            if (gbaMainSoundCntH & BIT(9 + i * 4))
+                sampleLeft += gbaSamples[i] << ((gbaMainSoundCntH & BIT(2 + i)) ? 2 : 1);
+            if (gbaMainSoundCntH & BIT(8 + i * 4))
+                sampleRight += gbaSamples[i] << ((gbaMainSoundCntH & BIT(2 + i)) ? 2 : 1);
+        }
 
         // Increment the frame sequencer
         // The frame sequencer runs at 512Hz, and has 8 steps before repeating
@@ -394,18 +646,29 @@ void Spu::runGbaSample()
     sampleLeft  = (sampleLeft  - 0x200) << 5;
     sampleRight = (sampleRight - 0x200) << 5;
 
-    if (bufferSize > 0)
-    {
-        // Write the samples to the buffer
-        bufferIn[bufferPointer++] = (sampleRight << 16) | (sampleLeft & 0xFFFF);
+    // Send the samples to the buffer
+    pushSample((sampleRight << 16) | (sampleLeft & 0xFFFF));
+}
 
-        // Handle a full buffer
-        if (bufferPointer == bufferSize)
-            swapBuffers();
-    }
+void Spu::runBatch()
+{
+    // Catch up to the end of the block, and schedule the next one
+    runSamples();
+    core->schedule(Task(&runSampleTask, sampleCycles + 512 * 2 * 15 - core->getGlobalCycles(), true));
+}
 
-    // Reschedule the task for the next sample
-    core->schedule(Task(&runGbaSampleTask, 512));
+void Spu::runSamples()
+{
+    // Mix every sample that was due by the current cycle
+    if (sampleCycles > core->getGlobalCycles())
+        return;
+
+    ProfileScope scope(&core->profiler, PROFILE_SPU);
+    while (sampleCycles <= core->getGlobalCycles())
+    {
+        runSample();
+        sampleCycles += 512 * 2;
+    }
 }
 
 void Spu::runSample()
@@ -693,47 +956,47 @@ void Spu::runSample()
     sampleLeft  = (sampleLeft  - 0x200) << 5;
     sampleRight = (sampleRight - 0x200) << 5;
 
-    if (bufferSize > 0)
-    {
-        // Write the samples to the buffer
-        bufferIn[bufferPointer++] = (sampleRight << 16) | (sampleLeft & 0xFFFF);
-
-        // Handle a full buffer
-        if (bufferPointer == bufferSize)
-            swapBuffers();
-    }
-
-    // Reschedule the task for the next sample
-    core->schedule(Task(&runSampleTask, 512 * 2));
+    // Send the samples to the buffer
+    pushSample((sampleRight << 16) | (sampleLeft & 0xFFFF));
 }
 
-void Spu::swapBuffers()
+void Spu::pushSample(uint32_t sample)
 {
-    // Wait until the buffer has been played, keeping the emulator throttled to 60 FPS
-    // Synchronizing to the audio eliminites the potential for nasty audio crackles
-    if (Settings::getFpsLimiter() == 2) // Accurate
+    // Drop samples until the frontend requests some, and drop those of frames that run-ahead will roll back
+    // Samples are hashed before that if a movie is active, so the hash doesn't depend on the frontend
+    if (core->runAhead.isSpeculative()) return;
+    if (core->movie.isActive()) core->movie.hashAudio(sample);
+    int size = requestSize.load();
+    if (size == 0) return;
+
+    // Wait while two requests' worth of samples are queued, keeping the emulator throttled to 60 FPS
+    // Synchronizing to the audio eliminates the potential for nasty audio crackles
+    uint32_t head = ringHead.load();
+    int limiter = core->config.fpsLimiter;
+    if ((limiter == 1 || limiter == 2) && head - ringTail.load() >= (uint32_t)size * 2)
     {
         std::chrono::steady_clock::time_point waitTime = std::chrono::steady_clock::now();
-        while (ready.load() && std::chrono::steady_clock::now() - waitTime <= std::chrono::microseconds(1000000));
-    }
-    else if (Settings::getFpsLimiter() == 1) // Light
-    {
-        std::unique_lock<std::mutex> lock(mutex1);
-        cond1.wait_for(lock, std::chrono::microseconds(1000000), [&]{ return !ready.load(); });
-    }
-
-    // Swap the buffers
-    SWAP(bufferOut, bufferIn);
+        while (head - ringTail.load() >= (uint32_t)size * 2)
+        {
+            // If the frontend stops requesting samples, drop them until it starts again
+            if (std::chrono::steady_clock::now() - waitTime > std::chrono::microseconds(1000000))
+            {
+                requestSize.store(0);
+                return;
+            }
 
-    // Signal that the buffer is ready to play
-    {
-        std::lock_guard<std::mutex> guard(mutex2);
-        ready.store(true);
-        cond2.notify_one();
+            // Spin for accurate timing, or sleep to save CPU cycles
+            if (limiter == 1) // Light
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
     }
 
-    // Reset the buffer pointer
-    bufferPointer = 0;
+    // Add the sample to the buffer, or drop it if the buffer is full
+    // When paced by a timer, samples past four requests are dropped too, so latency can't build up
+    // A few slots are kept free so the last played sample stays around for interpolation
+    if (head - ringTail.load() >= (uint32_t)((limiter == 3) ? std::min(size * 4, 0x1FFC) : 0x1FFC)) return;
+    ringBuffer[head & 0x1FFF] = sample;
+    ringHead.store(head + 1);
 }
 
 void Spu::startChannel(int channel)
@@ -773,37 +1036,31 @@ void Spu::startChannel(int channel)
 
 void Spu::gbaFifoTimer(int timer)
 {
-    if (((gbaMainSoundCntH & BIT(10)) >> 10) == timer) // FIFO A
+    // Handle an overflow of a timer in count-up mode, which drives the FIFOs directly
+    runGbaSamples();
+    for (int i = 0; i < 2; i++)
     {
-        // Get a new sample
-        if (!gbaFifoA.empty())
-        {
-            gbaSampleA = gbaFifoA.front();
-            gbaFifoA.pop();
-        }
-
-        // Request more data from the DMA if half empty
-        if (gbaFifoA.size() <= 16)
-            core->dma[1].trigger(3, 0x02);
-    }
+        if (((gbaMainSoundCntH >> (10 + i * 4)) & 0x1) != timer || gbaFifoPeriods[i])
+            continue;
 
-    if (((gbaMainSoundCntH & BIT(14)) >> 14) == timer) // FIFO B
-    {
         // Get a new sample
-        if (!gbaFifoB.empty())
+        if (gbaFifoSizes[i] > 0)
         {
-            gbaSampleB = gbaFifoB.front();
-            gbaFifoB.pop();
+            gbaSamples[i] = gbaFifos[i][gbaFifoHeads[i]];
+            gbaFifoHeads[i] = (gbaFifoHeads[i] + 1) & 0x1F;
+            gbaFifoSizes[i]--;
         }
 
         // Request more data from the DMA if half empty
-        if (gbaFifoB.size() <= 16)
-            core->dma[1].trigger(3, 0x04);
+        if (gbaFifoSizes[i] <= 16)
+            core->dma[1].trigger(3, i ? 0x04 : 0x02);
     }
 }
 
 void Spu::writeGbaSoundCntL(int channel, uint8_t value)
 {
+    // Catch up on samples before anything changes
+    runGbaSamples();
     if (!(gbaMainSoundCntX & BIT(7))) return;
 
     // Write to one of the GBA SOUNDCNT_L registers
@@ -813,6 +1070,8 @@ void Spu::writeGbaSoundCntL(int channel, uint8_t value)
 
 void Spu::writeGbaSoundCntH(int channel, uint16_t mask, uint16_t value)
 {
+    // Catch up on samples before anything changes
+    runGbaSamples();
     if (!(gbaMainSoundCntX & BIT(7))) return;
 
     // Write to one of the GBA SOUNDCNT_H registers
@@ -826,6 +1085,8 @@ void Spu::writeGbaSoundCntH(int channel, uint16_t mask, uint16_t value)
 
 void Spu::writeGbaSoundCntX(int channel, uint16_t mask, uint16_t value)
 {
+    // Catch up on samples before anything changes
+    runGbaSamples();
     if (!(gbaMainSoundCntX & BIT(7))) return;
 
     // Write to one of the GBA SOUNDCNT_X registers
@@ -864,6 +1125,8 @@ void Spu::writeGbaSoundCntX(int channel, uint16_t mask, uint16_t value)
 
 void Spu::writeGbaMainSoundCntL(uint16_t mask, uint16_t value)
 {
+    // Catch up on samples before anything changes
+    runGbaSamples();
     if (!(gbaMainSoundCntX & BIT(7))) return;
 
     // Write to the main GBA SOUNDCNT_L register
@@ -873,27 +1136,29 @@ void Spu::writeGbaMainSoundCntL(uint16_t mask, uint16_t value)
 
 void Spu::writeGbaMainSoundCntH(uint16_t mask, uint16_t value)
 {
+    // Catch up on samples before anything changes
+    runGbaSamples();
+
     // Write to the main GBA SOUNDCNT_H register
     mask &= 0x770F;
     gbaMainSoundCntH = (gbaMainSoundCntH & ~mask) | (value & mask);
 
-    // Empty FIFO A if requested
-    if (value & BIT(11))
+    // Empty the FIFOs if requested
+    for (int i = 0; i < 2; i++)
     {
-        while (!gbaFifoA.empty())
-            gbaFifoA.pop();
+        if (value & BIT(11 + i * 4))
+            gbaFifoHeads[i] = gbaFifoSizes[i] = 0;
     }
 
-    // Empty FIFO B if requested
-    if (value & BIT(15))
-    {
-        while (!gbaFifoB.empty())
-            gbaFifoB.pop();
-    }
+    // Follow the timers now selected for the FIFOs
+    updateGbaFifos();
 }
 
 void Spu::writeGbaMainSoundCntX(uint8_t value)
 {
+    // Catch up on samples before anything changes
+    runGbaSamples();
+
     // Write to the main GBA SOUNDCNT_X register
     gbaMainSoundCntX = (gbaMainSoundCntX & ~0x80) | (value & 0x80);
 
@@ -914,6 +1179,9 @@ void Spu::writeGbaMainSoundCntX(uint8_t value)
 
 void Spu::writeGbaSoundBias(uint16_t mask, uint16_t value)
 {
+    // Catch up on samples before anything changes
+    runGbaSamples();
+
     // Write to the GBA SOUNDBIAS register
     mask &= 0xC3FE;
     gbaSoundBias = (gbaSoundBias & ~mask) | (value & mask);
@@ -928,25 +1196,36 @@ void Spu::writeGbaWaveRam(int index, uint8_t value)
 void Spu::writeGbaFifoA(uint32_t mask, uint32_t value)
 {
     // Push PCM8 data to the GBA sound FIFO A
-    for (int i = 0; i < 32; i += 8)
-    {
-        if (gbaFifoA.size() < 32 && (mask & (0xFF << i)))
-            gbaFifoA.push(value >> i);
-    }
+    writeGbaFifo(0, mask, value);
 }
 
 void Spu::writeGbaFifoB(uint32_t mask, uint32_t value)
 {
     // Push PCM8 data to the GBA sound FIFO B
+    writeGbaFifo(1, mask, value);
+}
+
+void Spu::writeGbaFifo(int fifo, uint32_t mask, uint32_t value)
+{
+    // Drain the FIFO up to the current cycle, so the data lands behind what was already played
+    runGbaSamples();
+
+    // Push PCM8 data to the end of the ring, dropping anything that doesn't fit
     for (int i = 0; i < 32; i += 8)
     {
-        if (gbaFifoB.size() < 32 && (mask & (0xFF << i)))
-            gbaFifoB.push(value >> i);
+        if (gbaFifoSizes[fifo] < 32 && (mask & (0xFF << i)))
+            gbaFifos[fifo][(gbaFifoHeads[fifo] + gbaFifoSizes[fifo]++) & 0x1F] = value >> i;
     }
+
+    // Move the refill request to match the new size
+    scheduleGbaFifo(fifo);
 }
 
 void Spu::writeSoundCnt(int channel, uint32_t mask, uint32_t value)
 {
+    // Catch up on samples before anything changes
+    runSamples();
+
     bool enable = (!(soundCnt[channel] & BIT(31)) && (value & BIT(31)));
 
     // Write to one of the SOUNDCNT registers
@@ -962,6 +1241,9 @@ void Spu::writeSoundCnt(int channel, uint32_t mask, uint32_t value)
 
 void Spu::writeSoundSad(int channel, uint32_t mask, uint32_t value)
 {
+    // Catch up on samples before anything changes
+    runSamples();
+
     // Write to one of the SOUNDSAD registers
     mask &= 0x07FFFFFC;
     soundSad[channel] = (soundSad[channel] & ~mask) | (value & mask);
@@ -978,18 +1260,27 @@ void Spu::writeSoundSad(int channel, uint32_t mask, uint32_t value)
 
 void Spu::writeSoundTmr(int channel, uint16_t mask, uint16_t value)
 {
+    // Catch up on samples before anything changes
+    runSamples();
+
     // Write to one of the SOUNDTMR registers
     soundTmr[channel] = (soundTmr[channel] & ~mask) | (value & mask);
 }
 
 void Spu::writeSoundPnt(int channel, uint16_t mask, uint16_t value)
 {
+    // Catch up on samples before anything changes
+    runSamples();
+
     // Write to one of the SOUNDPNT registers
     soundPnt[channel] = (soundPnt[channel] & ~mask) | (value & mask);
 }
 
 void Spu::writeSoundLen(int channel, uint32_t mask, uint32_t value)
 {
+    // Catch up on samples before anything changes
+    runSamples();
+
     // Write to one of the SOUNDLEN registers
     mask &= 0x003FFFFF;
     soundLen[channel] = (soundLen[channel] & ~mask) | (value & mask);
@@ -997,6 +1288,9 @@ void Spu::writeSoundLen(int channel, uint32_t mask, uint32_t value)
 
 void Spu::writeMainSoundCnt(uint16_t mask, uint16_t value)
 {
+    // Catch up on samples before anything changes
+    runSamples();
+
     bool enable = (!(mainSoundCnt & BIT(15)) && (value & BIT(15)));
 
     // Write to the main SOUNDCNT register
@@ -1021,6 +1315,9 @@ void Spu::writeMainSoundCnt(uint16_t mask, uint16_t value)
 
 void Spu::writeSoundBias(uint16_t mask, uint16_t value)
 {
+    // Catch up on samples before anything changes
+    runSamples();
+
     // Write to the SOUNDBIAS register
     mask &= 0x03FF;
     soundBias = (soundBias & ~mask) | (value & mask);
@@ -1028,6 +1325,9 @@ void Spu::writeSoundBias(uint16_t mask, uint16_t value)
 
 void Spu::writeSndCapCnt(int channel, uint8_t value)
 {
+    // Catch up on samples before anything changes
+    runSamples();
+
     // Start the capture if the enable bit changes from 0 to 1
     if (!(sndCapCnt[channel] & BIT(7)) && (value & BIT(7)))
     {
@@ -1041,6 +1341,9 @@ void Spu::writeSndCapCnt(int channel, uint8_t value)
 
 void Spu::writeSndCapDad(int channel, uint32_t mask, uint32_t value)
 {
+    // Catch up on samples before anything changes
+    runSamples();
+
     // Write to one of the SNDCAPDAD registers
     mask &= 0x07FFFFFC;
     sndCapDad[channel] = (sndCapDad[channel] & ~mask) | (value & mask);
@@ -1052,6 +1355,9 @@ void Spu::writeSndCapDad(int channel, uint32_t mask, uint32_t value)
 
 void Spu::writeSndCapLen(int channel, uint16_t mask, uint16_t value)
 {
+    // Catch up on samples before anything changes
+    runSamples();
+
     // Write to one of the SNDCAPLEN registers
     sndCapLen[channel] = (sndCapLen[channel] & ~mask) | (value & mask);
 }
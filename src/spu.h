@@ -21,40 +21,45 @@
 #define SPU_H
 
 #include <atomic>
-#include <condition_variable>
 #include <cstdint>
 #include <functional>
-#include <queue>
-#include <mutex>
+#include <thread>
 
 class Core;
+class Savestate;
 
 class Spu
 {
     public:
         Spu(Core *core);
-        ~Spu();
+
+        void syncState(Savestate *state);
+        void resetCycles();
 
         void scheduleInit();
         void gbaScheduleInit();
+        void updateConfig();
 
-        uint32_t *getSamples(int count);
+        void getSamples(int16_t *buffer, int count, int rate);
+        int getSampleCount() { return ringHead.load() - ringTail.load(); }
 
+        void runGbaSamples();
+        void updateGbaFifos();
         void gbaFifoTimer(int timer);
 
         uint8_t  readGbaSoundCntL(int channel);
         uint16_t readGbaSoundCntH(int channel);
         uint16_t readGbaSoundCntX(int channel);
-        uint16_t readGbaMainSoundCntL() { return gbaMainSoundCntL; }
-        uint16_t readGbaMainSoundCntH() { return gbaMainSoundCntH; }
-        uint8_t  readGbaMainSoundCntX() { return gbaMainSoundCntX; }
-        uint16_t readGbaSoundBias()     { return gbaSoundBias;     }
+        uint16_t readGbaMainSoundCntL() { return gbaMainSoundCntL;                  }
+        uint16_t readGbaMainSoundCntH() { return gbaMainSoundCntH;                  }
+        uint8_t  readGbaMainSoundCntX() { runGbaSamples(); return gbaMainSoundCntX; }
+        uint16_t readGbaSoundBias()     { return gbaSoundBias;                      }
         uint8_t  readGbaWaveRam(int index);
 
-        uint32_t readSoundCnt(int channel)  { return soundCnt[channel];  }
-        uint16_t readMainSoundCnt()         { return mainSoundCnt;       }
-        uint16_t readSoundBias()            { return soundBias;          }
-        uint8_t  readSndCapCnt(int channel) { return sndCapCnt[channel]; }
+        uint32_t readSoundCnt(int channel)  { runSamples(); return soundCnt[channel];  }
+        uint16_t readMainSoundCnt()         { return mainSoundCnt;                      }
+        uint16_t readSoundBias()            { return soundBias;                         }
+        uint8_t  readSndCapCnt(int channel) { runSamples(); return sndCapCnt[channel]; }
         uint32_t readSndCapDad(int channel) { return sndCapDad[channel]; }
 
         void writeGbaSoundCntL(int channel, uint8_t value);
@@ -82,12 +87,24 @@ class Spu
     private:
         Core *core;
 
-        uint32_t *bufferIn = nullptr, *bufferOut = nullptr;
-        int bufferSize = 0, bufferPointer = 0;
-
-        std::condition_variable cond1, cond2;
-        std::mutex mutex1, mutex2;
-        std::atomic<bool> ready;
+        // Samples are passed to the frontend through a lock-free ring buffer, with the core as the only producer
+        // The FPS limiter keeps the core from running more than two requests' worth of samples ahead of playback
+        uint32_t ringBuffer[0x2000] = {};
+        std::atomic<uint32_t> ringHead;
+        std::atomic<uint32_t> ringTail;
+        std::atomic<int> requestSize;
+        uint32_t lastSample = 0;
+        std::thread::id audioThread;
+
+        // The settings that playback uses are copied here, since the audio thread can't read the core's settings
+        std::atomic<bool> pinAudio { false };
+        std::atomic<int> audioLimiter { 0 };
+        std::atomic<int> audioResampler { 0 };
+
+        // When frames are paced by a timer instead of the audio, the two clocks drift apart
+        // Playback is then resampled slightly faster or slower to keep about one request of samples queued
+        // Output is always resampled from 32768Hz to the rate the frontend asks for, at a position kept in 16.16 fixed-point
+        uint32_t ratePosition = 0;
 
         int gbaFrameSequencer = 0;
         int gbaSoundTimers[4] = {};
@@ -98,10 +115,22 @@ class Spu
         uint16_t gbaNoiseValue = 0;
 
         uint8_t gbaWaveRam[2][16] = {};
-        std::queue<int8_t> gbaFifoA, gbaFifoB;
-        int8_t gbaSampleA = 0, gbaSampleB = 0;
 
+        // GBA samples are also mixed lazily in blocks, with the DirectSound FIFOs drained as they go
+        // The FIFOs are 32-byte rings, and the timer overflows that feed them are counted instead of run as events
+        // Each FIFO only schedules an event for the overflow that drops it to half, which is when it requests a refill
+        uint32_t gbaSampleCycles = 0;
+        int8_t gbaFifos[2][32] = {};
+        uint8_t gbaFifoHeads[2] = {};
+        uint8_t gbaFifoSizes[2] = {};
+        int8_t gbaSamples[2] = {};
+        uint32_t gbaFifoCycles[2] = {};
+        uint32_t gbaFifoPeriods[2] = {};
+
+        // NDS samples are mixed lazily in blocks, instead of each being scheduled 512 ARM7 cycles after the last
+        // Anything that reads or changes channel state first catches up on the samples that are due
         uint16_t enabled = 0;
+        uint32_t sampleCycles = 0;
 
         static const int indexTable[8];
         static const int16_t adpcmTable[89];
@@ -137,12 +166,21 @@ class Spu
         uint16_t sndCapLen[2] = {};
 
         std::function<void()> runGbaSampleTask;
+        std::function<void()> gbaFifoTask[2];
         std::function<void()> runSampleTask;
 
+        void runGbaBatch();
         void runGbaSample();
+        void runGbaFifos(uint32_t cycles);
+        void runGbaFifo(int fifo);
+        void scheduleGbaFifo(int fifo);
+        void writeGbaFifo(int fifo, uint32_t mask, uint32_t value);
+        void runBatch();
+        void runSamples();
         void runSample();
 
-        void swapBuffers();
+        static void interpolate(const uint32_t *samples, const float *weights, int16_t *out);
+        void pushSample(uint32_t sample);
         void startChannel(int channel);
 };
 
@@ -18,14 +18,16 @@
 */
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <dirent.h>
 #include <switch.h>
+#include <mutex>
 #include <thread>
 #include <malloc.h>
 
 #include "switch_ui.h"
-#include "../common/nds_icon.h"
+#include "../common/rom_index.h"
 #include "../common/screen_layout.h"
 #include "../core.h"
 #include "../settings.h"
@@ -35,7 +37,7 @@ const uint32_t keyMap[] =
     KEY_A,     KEY_B,    KEY_MINUS, KEY_PLUS,
     KEY_RIGHT, KEY_LEFT, KEY_UP,    KEY_DOWN,
     KEY_ZR,    KEY_ZL,   KEY_X,     KEY_Y,
-    (KEY_L | KEY_R)
+    (KEY_L | KEY_R), KEY_RSTICK
 };
 
 const int clockSpeeds[] = { 1020000000, 1224000000, 1581000000, 1785000000 };
@@ -47,6 +49,11 @@ int switchOverclock = 3;
 std::string ndsPath, gbaPath;
 
 bool running = false;
+bool rewinding = false;
+
+std::mutex inputMutex;
+uint32_t heldKeys = 0;
+std::atomic<bool> pauseRequested(false);
 
 ClkrstSession cpuSession;
 
@@ -61,11 +68,66 @@ std::thread *coreThread, *audioThread;
 ScreenLayout layout;
 bool gbaMode = false;
 
+void pollInput()
+{
+    // Scan for input and send it to the core
+    // The core calls this when the game first reads input each frame, so the input is as recent as possible
+    // The main loop also calls it, to catch the pause key and keep input flowing if a game doesn't read it
+    std::lock_guard<std::mutex> guard(inputMutex);
+    hidScanInput();
+    uint32_t held = hidKeysHeld(CONTROLLER_P1_AUTO);
+    uint32_t pressed = held & ~heldKeys;
+    uint32_t released = heldKeys & ~held;
+    heldKeys = held;
+
+    // Send input to the core
+    for (int i = 0; i < 12; i++)
+    {
+        if (pressed & keyMap[i])
+            core->input.pressKey(i);
+        else if (released & keyMap[i])
+            core->input.releaseKey(i);
+    }
+
+    // Rewind while the rewind key is held, and remember if the pause menu was requested
+    rewinding = held & keyMap[13];
+    if (pressed & keyMap[12])
+        pauseRequested = true;
+
+    // Scan for touch input
+    if (hidTouchCount() > 0)
+    {
+        touchPosition touch;
+        hidTouchRead(&touch, 0);
+
+        // Determine the touch position relative to the emulated touch screen
+        int touchX = layout.getTouchX(touch.px, touch.py);
+        int touchY = layout.getTouchY(touch.px, touch.py);
+
+        // Send the touch coordinates to the core
+        core->input.pressScreen();
+        core->spi.setTouch(touchX, touchY);
+    }
+    else
+    {
+        // If the screen isn't being touched, release the touch screen press
+        core->input.releaseScreen();
+        core->spi.clearTouch();
+    }
+}
+
 void runCore()
 {
     // Run the emulator
     while (running)
-        core->runFrame();
+    {
+        // Step back through the rewind history while rewind is held, or run and record a new frame
+        if (!rewinding || !core->rewind.rewindFrame())
+        {
+            core->runAhead.runFrame();
+            core->rewind.recordFrame();
+        }
+    }
 }
 
 void outputAudio()
@@ -76,16 +138,8 @@ void outputAudio()
         int16_t *buffer = (int16_t*)audioReleasedBuffer->buffer;
 
         // The NDS sample rate is 32768Hz, but audout uses 48000Hz
-        // Get 699 samples at 32768Hz, which is equal to approximately 1024 samples at 48000Hz
-        uint32_t *original = core->spu.getSamples(699);
-
-        // Stretch the 699 samples out to 1024 samples in the audio buffer
-        for (int i = 0; i < 1024; i++)
-        {
-            uint32_t sample = original[i * 699 / 1024];
-            buffer[i * 2 + 0] = sample >>  0;
-            buffer[i * 2 + 1] = sample >> 16;
-        }
+        // The SPU resamples directly into the audio buffer
+        core->spu.getSamples(buffer, 1024, 48000);
 
         audoutAppendAudioOutBuffer(audioReleasedBuffer);
     }
@@ -120,6 +174,11 @@ void startCore()
         audoutAppendAudioOutBuffer(&audioBuffers[i]);
     }
 
+    // Sample input when the game reads it
+    heldKeys = hidKeysHeld(CONTROLLER_P1_AUTO);
+    pauseRequested = false;
+    core->input.setPollCallback(pollInput);
+
     // Start the threads
     audioThread = new std::thread(outputAudio);
     coreThread = new std::thread(runCore);
@@ -152,10 +211,12 @@ void stopCore()
 void settingsMenu()
 {
     const std::vector<std::string> toggle      = { "Off", "On"                                    };
+    const std::vector<std::string> frameSkip   = { "Off", "Automatic", "1 Frame", "2 Frames", "3 Frames" };
     const std::vector<std::string> rotation    = { "None", "Clockwise", "Counter-Clockwise"       };
     const std::vector<std::string> arrangement = { "Automatic", "Vertical", "Horizontal"          };
     const std::vector<std::string> sizing      = { "Even", "Enlarge Top", "Enlarge Bottom"        };
     const std::vector<std::string> gap         = { "None", "Quarter", "Half", "Full"              };
+    const std::vector<std::string> resampler   = { "Nearest", "Linear", "Cubic"                   };
     const std::vector<std::string> overclock   = { "1020 MHz", "1224 MHz", "1581 MHz", "1785 MHz" };
 
     unsigned int index = 0;
@@ -167,8 +228,11 @@ void settingsMenu()
         {
             ListItem("Direct Boot",        toggle[Settings::getDirectBoot()]),
             ListItem("FPS Limiter",        toggle[Settings::getFpsLimiter()]),
+            ListItem("Frame Skip",         frameSkip[Settings::getFrameSkip()]),
+            ListItem("Audio Resampling",   resampler[Settings::getResampler()]),
             ListItem("Threaded 2D",        toggle[Settings::getThreaded2D()]),
             ListItem("Threaded 3D",        toggle[(bool)Settings::getThreaded3D()]),
+            ListItem("Threaded Geometry",  toggle[Settings::getThreadedGeo()]),
             ListItem("Screen Rotation",    rotation[ScreenLayout::getScreenRotation()]),
             ListItem("Screen Arrangement", arrangement[ScreenLayout::getScreenArrangement()]),
             ListItem("Screen Sizing",      sizing[ScreenLayout::getScreenSizing()]),
@@ -194,24 +258,28 @@ void settingsMenu()
             {
                 case  0: Settings::setDirectBoot(!Settings::getDirectBoot());                                break;
                 case  1: Settings::setFpsLimiter(!Settings::getFpsLimiter());                                break;
-                case  2: Settings::setThreaded2D(!Settings::getThreaded2D());                                break;
-                case  3: Settings::setThreaded3D(!Settings::getThreaded3D());                                break;
-                case  4: ScreenLayout::setScreenRotation((ScreenLayout::getScreenRotation()       + 1) % 3); break;
-                case  5: ScreenLayout::setScreenArrangement((ScreenLayout::getScreenArrangement() + 1) % 3); break;
-                case  6: ScreenLayout::setScreenSizing((ScreenLayout::getScreenSizing()           + 1) % 3); break;
-                case  7: ScreenLayout::setScreenGap((ScreenLayout::getScreenGap()                 + 1) % 4); break;
-                case  8: ScreenLayout::setIntegerScale(!ScreenLayout::getIntegerScale());                    break;
-                case  9: ScreenLayout::setGbaCrop(!ScreenLayout::getGbaCrop());                              break;
-                case 10: screenFilter   = !screenFilter;                                                     break;
-                case 11: showFpsCounter = !showFpsCounter;                                                   break;
-                case 12: switchOverclock = (switchOverclock + 1) % 4;                                        break;
+                case  2: Settings::setFrameSkip((Settings::getFrameSkip()                         + 1) % 5); break;
+                case  3: Settings::setResampler((Settings::getResampler()                         + 1) % 3); break;
+                case  4: Settings::setThreaded2D(!Settings::getThreaded2D());                                break;
+                case  5: Settings::setThreaded3D(!Settings::getThreaded3D());                                break;
+                case  6: Settings::setThreadedGeo(!Settings::getThreadedGeo());                              break;
+                case  7: ScreenLayout::setScreenRotation((ScreenLayout::getScreenRotation()       + 1) % 3); break;
+                case  8: ScreenLayout::setScreenArrangement((ScreenLayout::getScreenArrangement() + 1) % 3); break;
+                case  9: ScreenLayout::setScreenSizing((ScreenLayout::getScreenSizing()           + 1) % 3); break;
+                case 10: ScreenLayout::setScreenGap((ScreenLayout::getScreenGap()                 + 1) % 4); break;
+                case 11: ScreenLayout::setIntegerScale(!ScreenLayout::getIntegerScale());                    break;
+                case 12: ScreenLayout::setGbaCrop(!ScreenLayout::getGbaCrop());                              break;
+                case 13: screenFilter   = !screenFilter;                                                     break;
+                case 14: showFpsCounter = !showFpsCounter;                                                   break;
+                case 15: switchOverclock = (switchOverclock + 1) % 4;                                        break;
             }
         }
         else
         {
-            // Close the settings menu
+            // Close the settings menu, passing the changes to the core if one is running
             layout.update(1280, 720, gbaMode);
             Settings::save();
+            if (core) core->setConfig(Settings::getConfig());
             return;
         }
     }
@@ -228,10 +296,13 @@ void fileBrowser()
     uint32_t *folder = SwitchUI::bmpToTexture(SwitchUI::isDarkTheme() ? "romfs:/folder-dark.bmp" : "romfs:/folder-light.bmp");
     romfsExit();
 
+    // Keep decoded NDS icons in an index next to the settings, so folders don't have to reopen every ROM
+    RomIndex romIndex("noods-roms.idx");
+
     while (true)
     {
         std::vector<ListItem> files;
-        std::vector<NdsIcon*> icons;
+        std::vector<RomInfo*> icons;
         DIR *dir = opendir(path.c_str());
         dirent *entry;
 
@@ -248,8 +319,9 @@ void fileBrowser()
             else if (name.find(".nds", name.length() - 4) != std::string::npos)
             {
                 // Add an NDS ROM with its decoded icon to the list
-                icons.push_back(new NdsIcon(path + "/" + name));
-                files.push_back(ListItem(name, "", icons[icons.size() - 1]->getIcon(), 32));
+                icons.push_back(new RomInfo());
+                romIndex.get(path + "/" + name, icons[icons.size() - 1]);
+                files.push_back(ListItem(name, "", icons[icons.size() - 1]->icon, 32));
             }
             else if (name.find(".gba", name.length() - 4) != std::string::npos)
             {
@@ -261,13 +333,16 @@ void fileBrowser()
         closedir(dir);
         sort(files.begin(), files.end());
 
+        // Index the folders inside this one while the menu is open
+        romIndex.scan(path);
+
         // Create the file browser menu
         Selection menu = SwitchUI::menu("NooDS", &files, index, "Settings", "Exit");
         index = menu.index;
 
         // Free the NDS icon memory
         for (unsigned int i = 0; i < icons.size(); i++)
-            delete[] icons[i];
+            delete icons[i];
 
         // Handle menu input
         if (menu.pressed & KEY_A)
@@ -565,44 +640,12 @@ int main()
 
     while (appletMainLoop() && running)
     {
-        // Scan for key input
-        hidScanInput();
-        uint32_t pressed = hidKeysDown(CONTROLLER_P1_AUTO);
-        uint32_t released = hidKeysUp(CONTROLLER_P1_AUTO);
-
-        // Send input to the core
-        for (int i = 0; i < 12; i++)
-        {
-            if (pressed & keyMap[i])
-                core->input.pressKey(i);
-            else if (released & keyMap[i])
-                core->input.releaseKey(i);
-        }
-
-        // Scan for touch input
-        if (hidTouchCount() > 0)
-        {
-            touchPosition touch;
-            hidTouchRead(&touch, 0);
-
-            // Determine the touch position relative to the emulated touch screen
-            int touchX = layout.getTouchX(touch.px, touch.py);
-            int touchY = layout.getTouchY(touch.px, touch.py);
-
-            // Send the touch coordinates to the core
-            core->input.pressScreen();
-            core->spi.setTouch(touchX, touchY);
-        }
-        else
-        {
-            // If the screen isn't being touched, release the touch screen press
-            core->input.releaseScreen();
-            core->spi.clearTouch();
-        }
+        // Scan for input, in case the game hasn't read it since the last frame
+        pollInput();
 
         // Request a new frame
         bool gba = (core->isGbaMode() && ScreenLayout::getGbaCrop());
-        uint32_t *framebuffer = core->gpu.getFrame(gba);
+        const uint32_t *framebuffer = core->gpu.getFrame(gba);
 
         // Update GBA mode status to match the new frame
         if (gbaMode != gba)
@@ -638,12 +681,14 @@ int main()
                 SwitchUI::drawString(std::to_string(core->getFps()) + " FPS", 5, 0, 48, Color(255, 255, 255));
 
             SwitchUI::update();
-            delete[] framebuffer;
         }
 
         // Open the pause menu if requested
-        if (pressed & keyMap[12])
+        if (pauseRequested)
+        {
+            pauseRequested = false;
             pauseMenu();
+        }
     }
 
     // Clean up
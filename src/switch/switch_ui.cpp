@@ -260,7 +260,7 @@ uint32_t *SwitchUI::bmpToTexture(std::string filename)
     return texture;
 }
 
-void SwitchUI::drawImage(uint32_t *image, int width, int height, int x, int y, int scaleWidth, int scaleHeight, bool filter, int rotation)
+void SwitchUI::drawImage(const uint32_t *image, int width, int height, int x, int y, int scaleWidth, int scaleHeight, bool filter, int rotation)
 {
     // Rotate the texture coordinates
     uint8_t texCoords;
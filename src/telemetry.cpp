@@ -0,0 +1,209 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstring>
+#include <string>
+
+#ifdef WINDOWS
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "telemetry.h"
+#include "core.h"
+
+// Records are sent or flushed in batches, which is about half a second at full speed
+#define BATCH_FRAMES 32
+
+Telemetry::Telemetry(Core *core): core(core)
+{
+    underruns.store(0);
+    wait3D.store(0);
+    wait2D.store(0);
+
+    // Open the output given in the settings, if any
+    const std::string &path = core->config.telemetry;
+    if (path.empty())
+        return;
+
+    if (path.compare(0, 4, "udp:") == 0)
+    {
+        openSocket(path.c_str() + 4);
+        return;
+    }
+
+    // Append to an existing file, only writing the header when it's new
+    file = fopen(path.c_str(), "a");
+    if (!file)
+    {
+        printf("Failed to open telemetry file: %s\n", path.c_str());
+        return;
+    }
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) == 0)
+        fprintf(file, "frame,frame_us,interval_us,speed,underruns,wait_3d_us,wait_2d_us\n");
+}
+
+Telemetry::~Telemetry()
+{
+    // Send or write anything left in the batch and close the output
+    flush();
+    if (file)
+        fclose(file);
+    if (sock == -1)
+        return;
+
+#ifdef WINDOWS
+    closesocket(sock);
+#else
+    close(sock);
+#endif
+}
+
+void Telemetry::openSocket(const char *peer)
+{
+#ifdef WINDOWS
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+        return;
+#endif
+
+    // Look up the address, which is given as "host:port"
+    std::string address = peer;
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos)
+    {
+        printf("Invalid telemetry address: %s\n", peer);
+        return;
+    }
+
+    addrinfo hints = {}, *info = nullptr;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    if (getaddrinfo(address.substr(0, colon).c_str(), address.substr(colon + 1).c_str(), &hints, &info) != 0)
+    {
+        printf("Failed to resolve telemetry address: %s\n", peer);
+        return;
+    }
+    memcpy(this->address, info->ai_addr, sizeof(sockaddr_in));
+    freeaddrinfo(info);
+
+    // Use a non-blocking socket, so a slow receiver drops records instead of stalling the core
+    sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock == -1)
+        return;
+
+#ifdef WINDOWS
+    u_long nonBlocking = 1;
+    ioctlsocket(sock, FIONBIO, &nonBlocking);
+#else
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+#endif
+}
+
+void Telemetry::startFrame()
+{
+    // Ignore frames run ahead, which are counted as part of the real frame before them
+    if (!isEnabled() || core->runAhead.isSpeculative())
+        return;
+
+    // Finish the record for the last real frame now that its interval is known
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (pending)
+    {
+        TelemetryFrame record;
+        record.frame = frames++;
+        record.frameTime = std::chrono::duration_cast<std::chrono::microseconds>(frameEnd - frameStart).count();
+        record.interval = std::chrono::duration_cast<std::chrono::microseconds>(now - frameStart).count();
+        record.underruns = underruns.exchange(0);
+        record.wait3D = wait3D.exchange(0) / 1000;
+        record.wait2D = wait2D.exchange(0) / 1000;
+
+        // Compare the length of an emulated frame to the host time it took
+        double emulated = core->isGbaMode() ? (228.0 * 308 * 4 / 16777216) : (263.0 * 355 * 6 / 33513982);
+        if (record.interval > 0)
+            record.speed = (uint32_t)(emulated * 1000000000 / record.interval);
+        write(record);
+    }
+
+    pending = true;
+    frameStart = now;
+}
+
+void Telemetry::finishFrame()
+{
+    // Track when the last frame ended, including any run ahead of the real one
+    if (isEnabled())
+        frameEnd = std::chrono::steady_clock::now();
+}
+
+void Telemetry::write(const TelemetryFrame &record)
+{
+    if (file)
+    {
+        // Write the record as a line of CSV
+        fprintf(file, "%u,%u,%u,%u.%03u,%u,%u,%u\n", record.frame, record.frameTime, record.interval,
+            record.speed / 1000, record.speed % 1000, record.underruns, record.wait3D, record.wait2D);
+    }
+    else
+    {
+        // Pack the record as little-endian words
+        const uint32_t words[] = { record.frame, record.frameTime, record.interval,
+            record.speed, record.underruns, record.wait3D, record.wait2D };
+        for (int i = 0; i < 7; i++)
+            for (int j = 0; j < 4; j++)
+                batch.push_back(words[i] >> (j * 8));
+    }
+
+    if (++batchFrames == BATCH_FRAMES)
+        flush();
+}
+
+void Telemetry::flush()
+{
+    // Write out the batched records
+    batchFrames = 0;
+    if (file)
+    {
+        fflush(file);
+    }
+    else if (!batch.empty())
+    {
+        sendto(sock, (const char*)&batch[0], batch.size(), 0, (sockaddr*)address, sizeof(sockaddr_in));
+        batch.clear();
+    }
+}
+
+TelemetryWait::~TelemetryWait()
+{
+    // Add the time since the scope started to the wait
+    if (!telemetry) return;
+    uint64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    if (is3D)
+        telemetry->addWait3D(duration);
+    else
+        telemetry->addWait2D(duration);
+}
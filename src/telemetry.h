@@ -0,0 +1,100 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+class Core;
+
+struct TelemetryFrame
+{
+    uint32_t frame = 0;
+    uint32_t frameTime = 0;
+    uint32_t interval = 0;
+    uint32_t speed = 0;
+    uint32_t underruns = 0;
+    uint32_t wait3D = 0;
+    uint32_t wait2D = 0;
+};
+
+// Telemetry records how each displayed frame performed, for tracking performance on devices without a profiler
+// Each record has the frame's host time, the time since the last one, the emulated speed in thousandths, the audio
+// underruns, and the time spent waiting for the 3D and 2D threads, with times in microseconds
+// Records go to a file as CSV, or to a UDP address given as "udp:host:port" as packed little-endian words
+// Frames run ahead count towards the real frame before them, so a record is written when the next real frame starts
+class Telemetry
+{
+    public:
+        Telemetry(Core *core);
+        ~Telemetry();
+
+        bool isEnabled() { return file || sock != -1; }
+
+        void startFrame();
+        void finishFrame();
+
+        void addUnderrun()                { underruns.fetch_add(1);      }
+        void addWait3D(uint64_t duration) { wait3D.fetch_add(duration); }
+        void addWait2D(uint64_t duration) { wait2D.fetch_add(duration); }
+
+    private:
+        Core *core;
+
+        FILE *file = nullptr;
+        int sock = -1;
+        uint8_t address[16] = {};
+        std::vector<uint8_t> batch;
+        int batchFrames = 0;
+
+        uint32_t frames = 0;
+        bool pending = false;
+        std::chrono::steady_clock::time_point frameStart, frameEnd;
+
+        // The waits and underruns are counted from other threads, and taken whenever a record is written
+        std::atomic<uint32_t> underruns;
+        std::atomic<uint64_t> wait3D;
+        std::atomic<uint64_t> wait2D;
+
+        void openSocket(const char *peer);
+        void write(const TelemetryFrame &record);
+        void flush();
+};
+
+// Adds the time until the end of a scope to a telemetry wait, if telemetry is enabled
+class TelemetryWait
+{
+    public:
+        TelemetryWait(Telemetry *telemetry, bool is3D): telemetry(telemetry->isEnabled() ? telemetry : nullptr),
+            is3D(is3D) { if (this->telemetry) start = std::chrono::steady_clock::now(); }
+        ~TelemetryWait();
+
+    private:
+        Telemetry *telemetry;
+        bool is3D;
+        std::chrono::steady_clock::time_point start;
+};
+
+#endif // TELEMETRY_H
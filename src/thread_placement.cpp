@@ -0,0 +1,196 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define PLACE_LINUX
+#elif defined(_WIN32)
+#include <windows.h>
+#elif defined(__SWITCH__)
+#include <switch.h>
+#endif
+
+#include "thread_placement.h"
+
+const CpuTopology &ThreadPlacement::getTopology()
+{
+    // Detect the topology once, the first time it's needed
+    static const CpuTopology topology = detect();
+    return topology;
+}
+
+CpuTopology ThreadPlacement::detect()
+{
+    CpuTopology topology;
+
+#if defined(__SWITCH__)
+    // Applications get cores 0 to 2, since core 3 is reserved for the system
+    for (int i = 0; i < 3; i++)
+        topology.fast.push_back(i);
+
+#elif defined(PLACE_LINUX)
+    // Find the CPUs the process is allowed to run on, along with their maximum clocks
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool masked = (sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+    int count = sysconf(_SC_NPROCESSORS_CONF);
+    std::vector<std::pair<int, long>> cpus;
+
+    for (int i = 0; i < count && i < CPU_SETSIZE; i++)
+    {
+        if (masked && !CPU_ISSET(i, &allowed)) continue;
+
+        long freq = 0;
+        char path[80];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", i);
+        if (FILE *file = fopen(path, "r"))
+        {
+            if (fscanf(file, "%ld", &freq) != 1) freq = 0;
+            fclose(file);
+        }
+        cpus.push_back(std::make_pair(i, freq));
+    }
+
+    // Split the CPUs into the ones with the highest clock and the rest
+    // If clocks can't be read, they're all 0 and count as fast
+    long maxFreq = 0;
+    for (unsigned int i = 0; i < cpus.size(); i++)
+        maxFreq = std::max(maxFreq, cpus[i].second);
+    for (unsigned int i = 0; i < cpus.size(); i++)
+        (cpus[i].second == maxFreq ? topology.fast : topology.slow).push_back(cpus[i].first);
+
+#else
+    // Other platforms don't report clusters, so treat every CPU as fast
+    int count = std::max<int>(std::thread::hardware_concurrency(), 1);
+    for (int i = 0; i < count; i++)
+        topology.fast.push_back(i);
+#endif
+
+    return topology;
+}
+
+std::string ThreadPlacement::describe()
+{
+    // Describe the topology, like "4 fast + 4 slow CPUs"
+    const CpuTopology &topology = getTopology();
+    char text[64];
+    if (topology.slow.empty())
+        snprintf(text, sizeof(text), "%d CPUs", (int)topology.fast.size());
+    else
+        snprintf(text, sizeof(text), "%d fast + %d slow CPUs", (int)topology.fast.size(), (int)topology.slow.size());
+    return text;
+}
+
+void ThreadPlacement::place(ThreadRole role)
+{
+    // Reserve the fastest cores from the end, since the first core tends to handle the most interrupts
+    // The ARM7 gets the next fast core, or a slow one if there isn't another, since it does less work
+    const CpuTopology &topology = getTopology();
+    int coreCpu = topology.fast.empty() ? -1 : topology.fast.back();
+    int arm7Cpu = (topology.fast.size() >= 2) ? topology.fast[topology.fast.size() - 2] :
+        (topology.slow.empty() ? -1 : topology.slow.back());
+
+    switch (role)
+    {
+        case THREAD_CORE:
+        {
+            if (coreCpu >= 0) setAffinity(std::vector<int>(1, coreCpu));
+            break;
+        }
+
+        case THREAD_ARM7:
+        {
+            if (arm7Cpu >= 0) setAffinity(std::vector<int>(1, arm7Cpu));
+            break;
+        }
+
+        case THREAD_WORKER:
+        {
+            // Put render workers on every CPU that isn't reserved, or on all of them if nothing is left
+            std::vector<int> cpus;
+            for (unsigned int i = 0; i < topology.fast.size(); i++)
+                if (topology.fast[i] != coreCpu && topology.fast[i] != arm7Cpu) cpus.push_back(topology.fast[i]);
+            for (unsigned int i = 0; i < topology.slow.size(); i++)
+                if (topology.slow[i] != arm7Cpu) cpus.push_back(topology.slow[i]);
+            if (cpus.empty())
+            {
+                cpus = topology.fast;
+                cpus.insert(cpus.end(), topology.slow.begin(), topology.slow.end());
+            }
+            setAffinity(cpus);
+            break;
+        }
+
+        case THREAD_AUDIO:
+        {
+            break;
+        }
+    }
+
+    setPriority(role);
+}
+
+void ThreadPlacement::setAffinity(const std::vector<int> &cpus)
+{
+    // Restrict the calling thread to a set of CPUs
+    // Failures are ignored, since placement is only a hint
+#if defined(PLACE_LINUX)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (unsigned int i = 0; i < cpus.size(); i++)
+        CPU_SET(cpus[i], &set);
+    sched_setaffinity(syscall(SYS_gettid), sizeof(set), &set);
+
+#elif defined(_WIN32)
+    DWORD_PTR mask = 0;
+    for (unsigned int i = 0; i < cpus.size(); i++)
+        if (cpus[i] < (int)sizeof(DWORD_PTR) * 8) mask |= (DWORD_PTR)1 << cpus[i];
+    if (mask) SetThreadAffinityMask(GetCurrentThread(), mask);
+
+#elif defined(__SWITCH__)
+    uint32_t mask = 0;
+    for (unsigned int i = 0; i < cpus.size(); i++)
+        mask |= BIT(cpus[i]);
+    if (mask) svcSetThreadCoreMask(CUR_THREAD_HANDLE, cpus[0], mask);
+#endif
+}
+
+void ThreadPlacement::setPriority(ThreadRole role)
+{
+    // Raise the priority of the core thread slightly and of audio more, leaving workers at the default
+    // Raising priority needs permission on desktop Linux, so it usually only takes effect on Android there
+    if (role == THREAD_WORKER) return;
+    bool audio = (role == THREAD_AUDIO);
+
+#if defined(PLACE_LINUX)
+    setpriority(PRIO_PROCESS, syscall(SYS_gettid), audio ? -16 : -4);
+#elif defined(_WIN32)
+    SetThreadPriority(GetCurrentThread(), audio ? THREAD_PRIORITY_HIGHEST : THREAD_PRIORITY_ABOVE_NORMAL);
+#elif defined(__SWITCH__)
+    svcSetThreadPriority(CUR_THREAD_HANDLE, audio ? 0x2A : 0x2B);
+#endif
+}
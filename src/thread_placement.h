@@ -0,0 +1,60 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef THREAD_PLACEMENT_H
+#define THREAD_PLACEMENT_H
+
+#include <string>
+#include <vector>
+
+enum ThreadRole
+{
+    THREAD_CORE = 0,
+    THREAD_ARM7,
+    THREAD_WORKER,
+    THREAD_AUDIO
+};
+
+struct CpuTopology
+{
+    std::vector<int> fast;
+    std::vector<int> slow;
+};
+
+// Threads can be placed on specific CPUs when the pinThreads setting is enabled, so frame times are more consistent
+// The core thread gets a fast core to itself, followed by the ARM7 thread, and render workers share whatever is left
+// Audio isn't pinned, but gets a higher priority along with the core thread
+// Fast cores are the ones with the highest maximum clock, so big.LITTLE systems keep emulation off the little cores
+class ThreadPlacement
+{
+    public:
+        static void place(ThreadRole role);
+        static std::string describe();
+
+    private:
+        ThreadPlacement() {} // Private to prevent instantiation
+
+        static const CpuTopology &getTopology();
+        static CpuTopology detect();
+        static void setAffinity(const std::vector<int> &cpus);
+        static void setPriority(ThreadRole role);
+};
+
+#endif // THREAD_PLACEMENT_H
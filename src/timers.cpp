@@ -27,34 +27,63 @@ Timers::Timers(Core *core, bool cpu): core(core), cpu(cpu)
         overflowTask[i] = std::bind(&Timers::overflow, this, i);
 }
 
+void Timers::syncState(Savestate *state)
+{
+    // Register the tasks so they can be referenced by ID
+    for (int i = 0; i < 4; i++)
+        state->addTask(&overflowTask[i]);
+
+    // Sync the timer state and registers
+    state->sync(timers);
+    state->sync(shifts);
+    state->sync(endCycles);
+    state->sync(scheduled);
+    state->sync(tmCntL);
+    state->sync(tmCntH);
+}
+
 void Timers::resetCycles()
 {
     // Adjust timer end cycles for a global cycle reset
+    // Timers without events catch up first, so their end cycles never fall too far behind
     for (int i = 0; i < 4; i++)
+    {
+        if (isRunning(i) && !scheduled[i])
+            catchUp(i, core->getGlobalCycles());
         endCycles[i] -= core->getGlobalCycles();
+    }
+}
+
+bool Timers::needsOverflow(int timer)
+{
+    // Overflow events are needed for IRQs, and for count-up timers that tick off them
+    // The GBA sound FIFOs count overflows on their own, and only schedule events for when they need a refill
+    return (tmCntH[timer] & BIT(6)) || (timer < 3 && (tmCntH[timer + 1] & BIT(2)));
 }
 
 void Timers::overflow(int timer)
 {
     // Ensure the timer is enabled and the end cycle is correct if not in count-up mode
     // The end cycle check ensures that if a timer was changed while running, outdated events are ignored
-    if (!(tmCntH[timer] & BIT(7)) || ((timer == 0 || !(tmCntH[timer] & BIT(2))) && endCycles[timer] != core->getGlobalCycles()))
+    if (!(tmCntH[timer] & BIT(7)) || (isRunning(timer) && endCycles[timer] != core->getGlobalCycles()))
         return;
 
-    // Reload the timer and schedule another overflow if not in count-up mode
+    // Reload the timer and schedule another overflow if not in count-up mode and something depends on it
     timers[timer] = tmCntL[timer];
-    if (timer == 0 || !(tmCntH[timer] & BIT(2)))
+    if (isRunning(timer))
     {
-        core->schedule(Task(&overflowTask[timer], (0x10000 - timers[timer]) << shifts[timer]));
         endCycles[timer] = core->getGlobalCycles() + ((0x10000 - timers[timer]) << shifts[timer]);
+        scheduled[timer] = needsOverflow(timer);
+        if (scheduled[timer])
+            core->schedule(Task(&overflowTask[timer], (0x10000 - timers[timer]) << shifts[timer], cpu));
     }
 
     // Trigger a timer overflow IRQ if enabled
     if (tmCntH[timer] & BIT(6))
         core->interpreter[cpu].sendInterrupt(3 + timer);
 
-    // Trigger a GBA sound FIFO event
-    if (core->isGbaMode() && timer < 2)
+    // Trigger a GBA sound FIFO event if the timer is in count-up mode, since the FIFOs can't count its overflows
+    if (core->isGbaMode() && timer < 2 && !isRunning(timer))
         core->spu.gbaFifoTimer(timer);
 
     // If the next timer has count-up timing enabled, tick it now
@@ -63,20 +92,76 @@ void Timers::overflow(int timer)
         overflow(timer + 1);
 }
 
+void Timers::catchUp(int timer, uint32_t now)
+{
+    // Apply any overflows that passed without an event up to the given cycle, which each reload the timer
+    uint32_t cycles = now - endCycles[timer];
+    if ((int32_t)cycles < 0) return;
+    uint32_t period = (0x10000 - tmCntL[timer]) << shifts[timer];
+    endCycles[timer] += (cycles / period + 1) * period;
+    timers[timer] = tmCntL[timer];
+}
+
+void Timers::updateTask(int timer)
+{
+    // Schedule the next overflow if something started depending on it, or drop it if nothing does anymore
+    bool needed = isRunning(timer) && needsOverflow(timer);
+    if (needed && !scheduled[timer])
+    {
+        catchUp(timer, core->getGlobalCycles());
+        core->schedule(Task(&overflowTask[timer], endCycles[timer] - core->getGlobalCycles(), cpu));
+    }
+    else if (!needed && scheduled[timer])
+    {
+        core->cancel(&overflowTask[timer]);
+    }
+    scheduled[timer] = needed;
+}
+
+bool Timers::getOverflow(int timer, uint32_t *cycles, uint32_t *period)
+{
+    // Get the cycle of a timer's next overflow and the period after that, if it's running on the scheduler
+    if (!isRunning(timer)) return false;
+    if (!scheduled[timer]) catchUp(timer, core->getGlobalCycles());
+    *cycles = endCycles[timer];
+    *period = (0x10000 - tmCntL[timer]) << shifts[timer];
+    return true;
+}
+
 void Timers::writeTmCntL(int timer, uint16_t mask, uint16_t value)
 {
+    // Let the GBA sound FIFOs catch up on overflows under the old settings
+    bool fifo = (core->isGbaMode() && timer < 2);
+    if (fifo) core->spu.runGbaSamples();
+
+    // Apply any overflows that used the old reload value
+    if (isRunning(timer) && !scheduled[timer])
+        catchUp(timer, core->getCpuCycles(cpu));
+
     // Write to one of the TMCNT_L registers
     // This value doesn't affect the current counter, and is instead used as the reload value
     tmCntL[timer] = (tmCntL[timer] & ~mask) | (value & mask);
+    if (fifo) core->spu.updateGbaFifos();
 }
 
 void Timers::writeTmCntH(int timer, uint16_t mask, uint16_t value)
 {
     bool dirty = false;
 
+    // Let the GBA sound FIFOs catch up on overflows under the old settings
+    bool fifo = (core->isGbaMode() && timer < 2);
+    if (fifo) core->spu.runGbaSamples();
+
+    // Changes take effect at the writing CPU's cycle, which can be ahead of the global count in slices or blocks
+    uint32_t now = core->getCpuCycles(cpu);
+
     // Update the current timer value if it's running on the scheduler
     if ((tmCntH[timer] & BIT(7)) && (timer == 0 || !(value & BIT(2))))
-        timers[timer] = 0x10000 - ((endCycles[timer] - core->getGlobalCycles()) >> shifts[timer]);
+    {
+        if (isRunning(timer) && !scheduled[timer])
+            catchUp(timer, now);
+        timers[timer] = 0x10000 - ((endCycles[timer] - now) >> shifts[timer]);
+    }
 
     // Update the timer shift if the prescaler setting was changed
     // The prescaler allows timers to tick at frequencies of f/1, f/64, f/256, or f/1024 (when not in count-up mode)
@@ -101,18 +186,40 @@ void Timers::writeTmCntH(int timer, uint16_t mask, uint16_t value)
     mask &= 0x00C7;
     tmCntH[timer] = (tmCntH[timer] & ~mask) | (value & mask);
 
-    // Schedule a timer overflow if the timer changed and isn't in count-up mode
-    if (dirty && (tmCntH[timer] & BIT(7)) && (timer == 0 || !(tmCntH[timer] & BIT(2))))
+    // Move the next overflow if the timer changed and isn't in count-up mode
+    // This replaces any overflow that was scheduled before the change
+    if (dirty && isRunning(timer))
     {
-        core->schedule(Task(&overflowTask[timer], (0x10000 - timers[timer]) << shifts[timer]));
-        endCycles[timer] = core->getGlobalCycles() + ((0x10000 - timers[timer]) << shifts[timer]);
+        endCycles[timer] = now + ((0x10000 - timers[timer]) << shifts[timer]);
+        if (scheduled[timer])
+            core->reschedule(Task(&overflowTask[timer], endCycles[timer] - core->getGlobalCycles(), cpu));
     }
+
+    // Update whether overflow events are needed for this timer, and for the previous one in case it now has a count-up timer
+    updateTask(timer);
+    if (timer > 0)
+        updateTask(timer - 1);
+
+    // Let the GBA sound FIFOs follow the new settings
+    if (fifo) core->spu.updateGbaFifos();
 }
 
 uint16_t Timers::readTmCntL(int timer)
 {
     // Read the current timer value, updating it if it's running on the scheduler
-    if ((tmCntH[timer] & BIT(7)) && (timer == 0 || !(tmCntH[timer] & BIT(2))))
-        timers[timer] = 0x10000 - ((endCycles[timer] - core->getGlobalCycles()) >> shifts[timer]);
+    // The CPU can be ahead of the global cycle count when it runs in slices or blocks, so the value is based on its own count
+    // A timer with an overflow event stays at the overflow until the event runs
+    if (isRunning(timer))
+    {
+        uint32_t now = core->getCpuCycles(cpu);
+        if (!scheduled[timer])
+            catchUp(timer, now);
+        else if ((int32_t)(endCycles[timer] - now) < 0)
+            now = endCycles[timer];
+        timers[timer] = 0x10000 - ((endCycles[timer] - now) >> shifts[timer]);
+
+        // The value changes without a task to wake the CPU, so a loop polling it shouldn't be treated as idle
+        core->interpreter[cpu].wakeIdle();
+    }
     return timers[timer];
 }
@@ -23,15 +23,22 @@
 #include <cstdint>
 #include <functional>
 
+#include "defines.h"
+
 class Core;
+class Savestate;
 
 class Timers
 {
     public:
         Timers(Core *core, bool cpu);
 
+        void syncState(Savestate *state);
+
         void resetCycles();
 
+        bool getOverflow(int timer, uint32_t *cycles, uint32_t *period);
+
         uint16_t readTmCntH(int timer) { return tmCntH[timer]; }
         uint16_t readTmCntL(int timer);
 
@@ -42,16 +49,24 @@ class Timers
         Core *core;
         bool cpu;
 
+        // Timers that run on the scheduler always track the cycle of their next overflow
+        // Overflow events are only scheduled when something depends on them, and other timers catch up when accessed
         uint16_t timers[4] = {};
         uint8_t shifts[4] = {};
         uint32_t endCycles[4] = {};
+        bool scheduled[4] = {};
 
         uint16_t tmCntL[4] = {};
         uint16_t tmCntH[4] = {};
 
         std::function<void()> overflowTask[4];
 
+        bool isRunning(int timer) { return (tmCntH[timer] & BIT(7)) && (timer == 0 || !(tmCntH[timer] & BIT(2))); }
+        bool needsOverflow(int timer);
+
         void overflow(int timer);
+        void catchUp(int timer, uint32_t now);
+        void updateTask(int timer);
 };
 
 #endif // TIMERS_H
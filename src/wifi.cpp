@@ -17,15 +17,312 @@
     along with NooDS. If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <cstring>
+
 #include "wifi.h"
 #include "core.h"
 
+// Incoming packets are checked every 2 scanlines, and held for at most a quarter of a frame
+#define POLL_CYCLES (355 * 6 * 2)
+#define MAX_LATENCY (263 * 355 * 6 / 4)
+
 Wifi::Wifi(Core *core): core(core)
 {
+    // Prepare tasks to be used with the scheduler
+    pollTask = std::bind(&Wifi::poll, this);
+    finishTransferTask = std::bind(&Wifi::finishTransfer, this);
+
     // Set some default BB register values
     bbRegisters[0x00] = 0x6D;
     bbRegisters[0x5D] = 0x01;
     bbRegisters[0x64] = 0xFF;
+
+    // Link to a remote host over UDP if a local port is set
+    // The poll task is scheduled by the core once its scheduler is ready
+    if (core->config.wifiPort)
+    {
+        udpBridge = new WifiBridge(core->config.wifiPort, core->config.wifiPeer);
+        if (udpBridge->isOpen() && (bridgePort = udpBridge->attach()) != -1)
+            bridge = udpBridge;
+    }
+}
+
+Wifi::~Wifi()
+{
+    // Clean up the bridge
+    detach();
+    delete udpBridge;
+}
+
+void Wifi::syncState(Savestate *state)
+{
+    // Register the tasks so they can be referenced by ID
+    state->addTask(&pollTask);
+    state->addTask(&finishTransferTask);
+
+    // Sync the cycle count that packets are timestamped with
+    state->sync(cycleBase);
+
+    // Sync the baseband registers
+    state->sync(bbRegisters);
+
+    // Sync the registers
+    state->sync(wModeWep);
+    state->sync(wIrf);
+    state->sync(wIe);
+    state->sync(wMacaddr);
+    state->sync(wBssid);
+    state->sync(wAidFull);
+    state->sync(wRxcnt);
+    state->sync(wPowerstate);
+    state->sync(wPowerforce);
+    state->sync(wRxbufBegin);
+    state->sync(wRxbufEnd);
+    state->sync(wRxbufWrcsr);
+    state->sync(wRxbufWrAddr);
+    state->sync(wRxbufRdAddr);
+    state->sync(wRxbufReadcsr);
+    state->sync(wRxbufGap);
+    state->sync(wRxbufGapdisp);
+    state->sync(wRxbufCount);
+    state->sync(wTxbufWrAddr);
+    state->sync(wTxbufCount);
+    state->sync(wTxbufGap);
+    state->sync(wTxbufGapdisp);
+    state->sync(wTxbufLoc);
+    state->sync(wTxreq);
+    state->sync(wTxbusy);
+    state->sync(wTxstat);
+    state->sync(wBeaconcount2);
+    state->sync(wBbWrite);
+    state->sync(wBbRead);
+    state->sync(wConfig);
+}
+
+void Wifi::resetCycles()
+{
+    // Keep the packet timestamps counting up when the global cycles are reset
+    cycleBase += core->getGlobalCycles();
+}
+
+uint64_t Wifi::getCycles()
+{
+    // Get the cycles since boot, which don't reset like the global ones
+    return cycleBase + core->getGlobalCycles();
+}
+
+void Wifi::attach(WifiBridge *bridge)
+{
+    // Connect to a bridge shared with other cores, replacing any current one
+    // This should only be called while the core isn't running
+    detach();
+    if ((bridgePort = bridge->attach()) == -1)
+        return;
+
+    this->bridge = bridge;
+    memset(offsetsValid, 0, sizeof(offsetsValid));
+    schedulePoll();
+}
+
+void Wifi::detach()
+{
+    // Disconnect from the current bridge, and drop any packets still waiting
+    if (!bridge)
+        return;
+
+    bridge->detach(bridgePort);
+    bridge = nullptr;
+    bridgePort = -1;
+    pending.clear();
+    core->cancel(&pollTask);
+}
+
+void Wifi::schedulePoll()
+{
+    // Check for packets only while connected and powered up, so most games never have a WiFi task scheduled
+    // This is also used after loading a state, since connections aren't part of it
+    core->cancel(&pollTask);
+    if (bridge && !core->isGbaMode() && !(wPowerstate & BIT(9)))
+        core->schedule(Task(&pollTask, POLL_CYCLES, true));
+}
+
+void Wifi::updatePower(uint16_t oldState)
+{
+    // Check if the power state changed between sleeping and awake
+    if (!((oldState ^ wPowerstate) & BIT(9)))
+        return;
+
+    // Drop the packets that arrived while asleep, which the hardware would have missed
+    pending.clear();
+    if (bridge && !(wPowerstate & BIT(9)))
+    {
+        WifiPacket packet;
+        while (bridge->receive(bridgePort, &packet));
+        memset(offsetsValid, 0, sizeof(offsetsValid));
+    }
+
+    // Start or stop checking for packets
+    schedulePoll();
+}
+
+void Wifi::poll()
+{
+    // Don't touch the bridge in frames that will be rolled back, so packets are only sent and received once
+    if (!core->runAhead.isSpeculative())
+    {
+        // Send any packets that were batched, and collect the ones that have arrived
+        bridge->flush();
+        uint64_t cycles = getCycles();
+        WifiPacket packet;
+
+        while (bridge->receive(bridgePort, &packet))
+        {
+            // Map the sender's timestamp to this core's clock, which keeps the spacing between its packets
+            // If the sender is too far ahead or this is its first packet, the mapping restarts with it due now
+            int id = packet.sender;
+            uint64_t due = packet.timestamp + clockOffsets[id];
+            if (!offsetsValid[id] || (int64_t)(due - cycles) > MAX_LATENCY)
+            {
+                clockOffsets[id] = cycles - packet.timestamp;
+                offsetsValid[id] = true;
+                due = cycles;
+            }
+
+            packet.timestamp = due;
+            pending.push_back(packet);
+        }
+
+        // Receive the packets that are due
+        while (!pending.empty() && (int64_t)(pending.front().timestamp - cycles) <= 0)
+        {
+            receivePacket(&pending.front());
+            pending.pop_front();
+        }
+    }
+
+    core->schedule(Task(&pollTask, POLL_CYCLES, true));
+}
+
+void Wifi::startTransfer()
+{
+    // Only one packet is sent at a time, with the rest waiting until it finishes
+    if (wTxbusy)
+        return;
+
+    // Send a packet from the highest priority location that's requested and enabled
+    for (int i = 3; i >= 0; i--)
+    {
+        if (!(wTxreq & BIT(i)) || !(wTxbufLoc[i] & BIT(15)))
+            continue;
+
+        // Read the packet from WiFi RAM, which starts with a TX header that holds its rate and length
+        // The length includes the 4-byte FCS, which isn't stored and is left off the packet
+        uint16_t address = (wTxbufLoc[i] & 0x0FFF) << 1;
+        uint8_t rate = core->memory.read<uint8_t>(1, 0x4804000 + address + 0x8);
+        uint16_t length = core->memory.read<uint16_t>(1, 0x4804000 + address + 0xA);
+
+        WifiPacket packet;
+        packet.rate = rate;
+        packet.size = std::min<int>(std::max<int>(length - 4, 0), sizeof(packet.data));
+        for (int j = 0; j < packet.size; j++)
+            packet.data[j] = core->memory.read<uint8_t>(1, 0x4804000 + ((address + 12 + j) & 0x1FFF));
+
+        // Transfers take 192us for the preamble and then 1 or 2 Mbit/s for the data, at about 33.5 cycles per us
+        uint32_t cycles = (192 + length * ((rate == 0x14) ? 4 : 8)) * 67 / 2;
+
+        // Pass the packet to the bridge, timestamped with when it will finish arriving
+        if (bridge && !core->runAhead.isSpeculative())
+        {
+            packet.timestamp = getCycles() + cycles;
+            bridge->send(bridgePort, &packet);
+        }
+
+        wTxbusy = BIT(i);
+        sendInterrupt(7);
+        core->schedule(Task(&finishTransferTask, cycles, true));
+        return;
+    }
+}
+
+void Wifi::finishTransfer()
+{
+    // Find the location that was being sent
+    int i = 0;
+    while (!(wTxbusy & BIT(i)))
+        i++;
+
+    // Mark the packet as sent in its TX header, and disable its location
+    uint16_t address = (wTxbufLoc[i] & 0x0FFF) << 1;
+    core->memory.write<uint16_t>(1, 0x4804000 + address, 0x0001);
+    wTxbufLoc[i] &= ~BIT(15);
+
+    // Report the transfer as done, with the location it came from
+    wTxstat = 0x0001 | (i << 8);
+    wTxbusy = 0;
+    sendInterrupt(1);
+
+    // Start the next transfer, if any are waiting
+    startTransfer();
+}
+
+void Wifi::receivePacket(const WifiPacket *packet)
+{
+    // Only receive packets while receiving is enabled and the hardware is powered
+    // Packets without both addresses, like ACKs, aren't passed on since replies aren't emulated
+    if (!(wRxcnt & BIT(15)) || (wPowerstate & BIT(9)) || packet->size < 16)
+        return;
+
+    // Drop packets sent from this MAC address, which can come back from a broadcast
+    // Otherwise, only accept packets sent to this MAC address or to a group
+    if (!memcmp(&packet->data[10], wMacaddr, 6))
+        return;
+    if (!(packet->data[4] & BIT(0)) && memcmp(&packet->data[4], wMacaddr, 6))
+        return;
+
+    // Drop the packet if it doesn't fit in the space left in the RX buffer
+    uint16_t begin = wRxbufBegin & 0x1FFE, end = wRxbufEnd & 0x1FFE;
+    if (begin >= end)
+        return;
+    int write = wRxbufWrcsr << 1, read = wRxbufReadcsr << 1;
+    int used = (write >= read) ? (write - read) : (write + (end - begin) - read);
+    int size = 12 + ((packet->size + 3) & ~3);
+    if (used + size >= end - begin)
+        return;
+
+    // Get the packet type from its frame control
+    uint16_t type;
+    switch ((packet->data[0] >> 2) & 0x3)
+    {
+        case 0:  type = (packet->data[0] == 0x80) ? 1 : 0; break; // Beacon or other management
+        case 1:  type = 5; break; // Control
+        default: type = 8; break; // Data
+    }
+
+    // Write an RX header, followed by the packet data
+    writeRxbuf(type);
+    writeRxbuf(0x0040);
+    writeRxbuf(0x0000);
+    writeRxbuf(packet->rate ? packet->rate : 0x14);
+    writeRxbuf(packet->size);
+    writeRxbuf(0x0010); // Signal strength
+    for (int i = 0; i < packet->size; i += 2)
+        writeRxbuf(packet->data[i] | ((i + 1 < packet->size) ? (packet->data[i + 1] << 8) : 0));
+
+    // Align the write cursor to a word for the next packet
+    if (wRxbufWrcsr & 0x1)
+        writeRxbuf(0x0000);
+
+    // Trigger the receive start and complete interrupts
+    sendInterrupt(6);
+    sendInterrupt(0);
+}
+
+void Wifi::writeRxbuf(uint16_t value)
+{
+    // Write a value to the RX buffer, and wrap the cursor around at the end
+    core->memory.write<uint16_t>(1, 0x4804000 + (wRxbufWrcsr << 1), value);
+    if (++wRxbufWrcsr << 1 >= (wRxbufEnd & 0x1FFE))
+        wRxbufWrcsr = (wRxbufBegin & 0x1FFE) >> 1;
 }
 
 void Wifi::sendInterrupt(int bit)
@@ -80,15 +377,28 @@ void Wifi::writeWAidFull(uint16_t mask, uint16_t value)
     wAidFull = (wAidFull & ~mask) | (value & mask);
 }
 
+void Wifi::writeWRxcnt(uint16_t mask, uint16_t value)
+{
+    // Copy the W_RXBUF_WR_ADDR register to the write cursor if requested
+    if (value & mask & BIT(0))
+        wRxbufWrcsr = wRxbufWrAddr;
+
+    // Write to the W_RXCNT register
+    mask &= 0xFF0E;
+    wRxcnt = (wRxcnt & ~mask) | (value & mask);
+}
+
 void Wifi::writeWPowerstate(uint16_t mask, uint16_t value)
 {
     // Write to the W_POWERSTATE register
+    uint16_t oldState = wPowerstate;
     mask &= 0x0003;
     wPowerstate = (wPowerstate & ~mask) | (value & mask);
 
     // Set the power state to enabled if requested
     if (wPowerstate & BIT(1))
         wPowerstate &= ~BIT(9);
+    updatePower(oldState);
 }
 
 void Wifi::writeWPowerforce(uint16_t mask, uint16_t value)
@@ -99,7 +409,11 @@ void Wifi::writeWPowerforce(uint16_t mask, uint16_t value)
 
     // Force set the power state if requested
     if (wPowerforce & BIT(15))
+    {
+        uint16_t oldState = wPowerstate;
         wPowerstate = (wPowerstate & ~BIT(9)) | ((wPowerforce & BIT(0)) << 9);
+        updatePower(oldState);
+    }
 }
 
 void Wifi::writeWRxbufBegin(uint16_t mask, uint16_t value)
@@ -200,6 +514,25 @@ void Wifi::writeWTxbufGapdisp(uint16_t mask, uint16_t value)
     wTxbufGapdisp = (wTxbufGapdisp & ~mask) | (value & mask);
 }
 
+void Wifi::writeWTxbufLoc(int index, uint16_t mask, uint16_t value)
+{
+    // Write to one of the W_TXBUF_LOC registers
+    wTxbufLoc[index] = (wTxbufLoc[index] & ~mask) | (value & mask);
+}
+
+void Wifi::writeWTxreqReset(uint16_t mask, uint16_t value)
+{
+    // Clear bits in the W_TXREQ register
+    wTxreq &= ~(value & mask & 0x000F);
+}
+
+void Wifi::writeWTxreqSet(uint16_t mask, uint16_t value)
+{
+    // Set bits in the W_TXREQ register, and start sending if idle
+    wTxreq |= (value & mask & 0x000F);
+    startTransfer();
+}
+
 void Wifi::writeWConfig(int index, uint16_t mask, uint16_t value)
 {
     const uint16_t masks[] =
@@ -21,13 +21,26 @@
 #define WIFI_H
 
 #include <cstdint>
+#include <deque>
+#include <functional>
+
+#include "wifi_bridge.h"
 
 class Core;
+class Savestate;
 
 class Wifi
 {
     public:
         Wifi(Core *core);
+        ~Wifi();
+
+        void syncState(Savestate *state);
+        void resetCycles();
+
+        void attach(WifiBridge *bridge);
+        void detach();
+        void schedulePoll();
 
         uint16_t readWModeWep()          { return wModeWep;        }
         uint16_t readWIrf()              { return wIrf;            }
@@ -35,10 +48,12 @@ class Wifi
         uint16_t readWMacaddr(int index) { return wMacaddr[index]; }
         uint16_t readWBssid(int index)   { return wBssid[index];   }
         uint16_t readWAidFull()          { return wAidFull;        }
+        uint16_t readWRxcnt()            { return wRxcnt;          }
         uint16_t readWPowerstate()       { return wPowerstate;     }
         uint16_t readWPowerforce()       { return wPowerforce;     }
         uint16_t readWRxbufBegin()       { return wRxbufBegin;     }
         uint16_t readWRxbufEnd()         { return wRxbufEnd;       }
+        uint16_t readWRxbufWrcsr()       { return wRxbufWrcsr;     }
         uint16_t readWRxbufWrAddr()      { return wRxbufWrAddr;    }
         uint16_t readWRxbufRdAddr()      { return wRxbufRdAddr;    }
         uint16_t readWRxbufReadcsr()     { return wRxbufReadcsr;   }
@@ -49,6 +64,10 @@ class Wifi
         uint16_t readWTxbufCount()       { return wTxbufCount;     }
         uint16_t readWTxbufGap()         { return wTxbufGap;       }
         uint16_t readWTxbufGapdisp()     { return wTxbufGapdisp;   }
+        uint16_t readWTxbufLoc(int loc)  { return wTxbufLoc[loc];  }
+        uint16_t readWTxreqRead()        { return wTxreq;          }
+        uint16_t readWTxbusy()           { return wTxbusy;         }
+        uint16_t readWTxstat()           { return wTxstat;         }
         uint16_t readWConfig(int index)  { return wConfig[index];  }
         uint16_t readWBeaconcount2()     { return wBeaconcount2;   }
         uint16_t readWBbRead()           { return wBbRead;         }
@@ -60,6 +79,7 @@ class Wifi
         void writeWMacaddr(int index, uint16_t mask, uint16_t value);
         void writeWBssid(int index, uint16_t mask, uint16_t value);
         void writeWAidFull(uint16_t mask, uint16_t value);
+        void writeWRxcnt(uint16_t mask, uint16_t value);
         void writeWPowerstate(uint16_t mask, uint16_t value);
         void writeWPowerforce(uint16_t mask, uint16_t value);
         void writeWRxbufBegin(uint16_t mask, uint16_t value);
@@ -75,6 +95,9 @@ class Wifi
         void writeWTxbufWrData(uint16_t mask, uint16_t value);
         void writeWTxbufGap(uint16_t mask, uint16_t value);
         void writeWTxbufGapdisp(uint16_t mask, uint16_t value);
+        void writeWTxbufLoc(int index, uint16_t mask, uint16_t value);
+        void writeWTxreqReset(uint16_t mask, uint16_t value);
+        void writeWTxreqSet(uint16_t mask, uint16_t value);
         void writeWConfig(int index, uint16_t mask, uint16_t value);
         void writeWBeaconcount2(uint16_t mask, uint16_t value);
         void writeWBbCnt(uint16_t mask, uint16_t value);
@@ -84,6 +107,17 @@ class Wifi
     private:
         Core *core;
 
+        // Packets go through a bridge, which is either shared with other cores in-process or owned for UDP
+        // Incoming packets wait until this core reaches their timestamp, mapped from the sender's clock to this one
+        // Polling is the only periodic WiFi work, and it's left unscheduled until the hardware is powered up
+        WifiBridge *bridge = nullptr;
+        WifiBridge *udpBridge = nullptr;
+        int bridgePort = -1;
+        uint64_t cycleBase = 0;
+        uint64_t clockOffsets[BRIDGE_PORTS + 1] = {};
+        bool offsetsValid[BRIDGE_PORTS + 1] = {};
+        std::deque<WifiPacket> pending;
+
         uint8_t bbRegisters[0x100] = {};
 
         uint16_t wModeWep = 0;
@@ -92,10 +126,12 @@ class Wifi
         uint16_t wMacaddr[3] = {};
         uint16_t wBssid[3] = {};
         uint16_t wAidFull = 0;
+        uint16_t wRxcnt = 0;
         uint16_t wPowerstate = 0x0200;
         uint16_t wPowerforce = 0;
         uint16_t wRxbufBegin = 0;
         uint16_t wRxbufEnd = 0;
+        uint16_t wRxbufWrcsr = 0;
         uint16_t wRxbufWrAddr = 0;
         uint16_t wRxbufRdAddr = 0;
         uint16_t wRxbufReadcsr = 0;
@@ -106,6 +142,10 @@ class Wifi
         uint16_t wTxbufCount = 0;
         uint16_t wTxbufGap = 0;
         uint16_t wTxbufGapdisp = 0;
+        uint16_t wTxbufLoc[4] = {};
+        uint16_t wTxreq = 0;
+        uint16_t wTxbusy = 0;
+        uint16_t wTxstat = 0;
         uint16_t wBeaconcount2 = 0;
         uint16_t wBbWrite = 0;
         uint16_t wBbRead = 0;
@@ -117,7 +157,18 @@ class Wifi
             0x0016, 0x0016, 0x162C, 0x0204, 0x0058
         };
 
+        std::function<void()> pollTask;
+        std::function<void()> finishTransferTask;
+
+        uint64_t getCycles();
         void sendInterrupt(int bit);
+
+        void updatePower(uint16_t oldState);
+        void poll();
+        void startTransfer();
+        void finishTransfer();
+        void receivePacket(const WifiPacket *packet);
+        void writeRxbuf(uint16_t value);
 };
 
 #endif // WIFI_H
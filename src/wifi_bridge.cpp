@@ -0,0 +1,273 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef WINDOWS
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "wifi_bridge.h"
+
+// Each packet in a datagram is its timestamp, rate, and size, followed by its data
+#define PACKET_HEADER 12
+
+WifiBridge::WifiBridge(int localPort, std::string peer)
+{
+    for (int i = 0; i < BRIDGE_PORTS; i++)
+        attached[i].store(false);
+
+    // Without UDP, set up the rings to pass packets between the ports in-process
+    if (localPort == 0)
+    {
+        rings = new Ring[BRIDGE_PORTS * BRIDGE_PORTS];
+        return;
+    }
+
+#ifdef WINDOWS
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+        return;
+#endif
+
+    // Look up the remote host, which is given as "host:port"
+    size_t colon = peer.rfind(':');
+    if (colon == std::string::npos)
+    {
+        printf("Invalid wireless peer address: %s\n", peer.c_str());
+        return;
+    }
+
+    addrinfo hints = {}, *info = nullptr;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    if (getaddrinfo(peer.substr(0, colon).c_str(), peer.substr(colon + 1).c_str(), &hints, &info) != 0)
+    {
+        printf("Failed to resolve wireless peer: %s\n", peer.c_str());
+        return;
+    }
+    memcpy(peerAddr, info->ai_addr, sizeof(sockaddr_in));
+    freeaddrinfo(info);
+
+    datagram.resize(0x10000);
+
+    // Open a non-blocking socket on the local port, allowing broadcasts to reach several hosts
+    sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock == -1)
+        return;
+
+    int enable = 1;
+    setsockopt(sock, SOL_SOCKET, SO_BROADCAST, (const char*)&enable, sizeof(enable));
+
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_port = htons(localPort);
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(sock, (sockaddr*)&local, sizeof(local)) != 0)
+    {
+        printf("Failed to bind wireless port %d\n", localPort);
+#ifdef WINDOWS
+        closesocket(sock);
+#else
+        close(sock);
+#endif
+        sock = -1;
+        return;
+    }
+
+#ifdef WINDOWS
+    u_long nonBlocking = 1;
+    ioctlsocket(sock, FIONBIO, &nonBlocking);
+#else
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+#endif
+}
+
+WifiBridge::~WifiBridge()
+{
+    // Clean up the rings or the socket
+    delete[] rings;
+    if (sock == -1)
+        return;
+
+#ifdef WINDOWS
+    closesocket(sock);
+    WSACleanup();
+#else
+    close(sock);
+#endif
+}
+
+int WifiBridge::attach()
+{
+    // Claim a free port, with only one available over UDP
+    for (int i = 0; i < (rings ? BRIDGE_PORTS : 1); i++)
+    {
+        bool expected = false;
+        if (attached[i].compare_exchange_strong(expected, true))
+            return i;
+    }
+    return -1;
+}
+
+void WifiBridge::detach(int port)
+{
+    // Drop anything left in the port's incoming rings, and free it for another core
+    if (rings)
+    {
+        for (int i = 0; i < BRIDGE_PORTS; i++)
+        {
+            Ring *ring = &rings[i * BRIDGE_PORTS + port];
+            ring->head.store(ring->tail.load());
+        }
+    }
+    attached[port].store(false);
+}
+
+void WifiBridge::send(int port, const WifiPacket *packet)
+{
+    if (!rings)
+    {
+        // Queue the packet to be sent with the rest of the batch
+        size_t offset = batch.size();
+        batch.resize(offset + PACKET_HEADER + packet->size);
+        memcpy(&batch[offset + 0], &packet->timestamp, 8);
+        batch[offset + 8] = packet->rate;
+        batch[offset + 9] = 0;
+        memcpy(&batch[offset + 10], &packet->size, 2);
+        memcpy(&batch[offset + 12], packet->data, packet->size);
+
+        // Send early if the batch is close to the size limit of a datagram
+        if (batch.size() >= 0x8000)
+            flush();
+        return;
+    }
+
+    // Copy the packet to the ring of each other attached port, dropping it for any that are full
+    for (int i = 0; i < BRIDGE_PORTS; i++)
+    {
+        if (i == port || !attached[i].load())
+            continue;
+
+        Ring *ring = &rings[port * BRIDGE_PORTS + i];
+        uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+        if (tail - ring->head.load(std::memory_order_acquire) == BRIDGE_SLOTS)
+            continue;
+
+        WifiPacket *slot = &ring->packets[tail % BRIDGE_SLOTS];
+        slot->timestamp = packet->timestamp;
+        slot->sender = port;
+        slot->rate = packet->rate;
+        slot->size = packet->size;
+        memcpy(slot->data, packet->data, packet->size);
+        ring->tail.store(tail + 1, std::memory_order_release);
+    }
+}
+
+bool WifiBridge::receive(int port, WifiPacket *packet)
+{
+    if (!rings)
+    {
+        // Take the next packet from the remote host, reading new datagrams once the last ones run out
+        if (received.empty())
+            receiveUdp();
+        if (received.empty())
+            return false;
+
+        *packet = received.front();
+        received.pop_front();
+        return true;
+    }
+
+    // Take the oldest packet waiting in the port's incoming rings
+    Ring *oldest = nullptr;
+    for (int i = 0; i < BRIDGE_PORTS; i++)
+    {
+        Ring *ring = &rings[i * BRIDGE_PORTS + port];
+        uint32_t head = ring->head.load(std::memory_order_relaxed);
+        if (head == ring->tail.load(std::memory_order_acquire))
+            continue;
+
+        if (!oldest || ring->packets[head % BRIDGE_SLOTS].timestamp <
+            oldest->packets[oldest->head.load(std::memory_order_relaxed) % BRIDGE_SLOTS].timestamp)
+            oldest = ring;
+    }
+
+    if (!oldest)
+        return false;
+
+    uint32_t head = oldest->head.load(std::memory_order_relaxed);
+    const WifiPacket *slot = &oldest->packets[head % BRIDGE_SLOTS];
+    packet->timestamp = slot->timestamp;
+    packet->sender = slot->sender;
+    packet->rate = slot->rate;
+    packet->size = slot->size;
+    memcpy(packet->data, slot->data, slot->size);
+    oldest->head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+void WifiBridge::flush()
+{
+    // Send the queued packets to the remote host in a single datagram
+    if (batch.empty() || sock == -1)
+        return;
+
+    sendto(sock, (const char*)&batch[0], batch.size(), 0, (const sockaddr*)peerAddr, sizeof(sockaddr_in));
+    batch.clear();
+}
+
+void WifiBridge::receiveUdp()
+{
+    if (sock == -1)
+        return;
+
+    // Read every datagram that's waiting, and split them into packets
+    // Packets from the remote host are all given the sender ID after the local ports
+    uint8_t *buffer = &datagram[0];
+    int size;
+    while ((size = recvfrom(sock, (char*)buffer, datagram.size(), 0, nullptr, nullptr)) > 0)
+    {
+        int offset = 0;
+        while (offset + PACKET_HEADER <= size)
+        {
+            WifiPacket packet;
+            memcpy(&packet.timestamp, &buffer[offset + 0], 8);
+            packet.sender = BRIDGE_PORTS;
+            packet.rate = buffer[offset + 8];
+            memcpy(&packet.size, &buffer[offset + 10], 2);
+            if (packet.size > sizeof(packet.data) || offset + PACKET_HEADER + packet.size > size)
+                break;
+
+            memcpy(packet.data, &buffer[offset + PACKET_HEADER], packet.size);
+            received.push_back(packet);
+            offset += PACKET_HEADER + packet.size;
+        }
+    }
+}
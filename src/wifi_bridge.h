@@ -0,0 +1,82 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef WIFI_BRIDGE_H
+#define WIFI_BRIDGE_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#define BRIDGE_PORTS 4
+#define BRIDGE_SLOTS 16
+
+struct WifiPacket
+{
+    uint64_t timestamp = 0;
+    uint8_t sender = 0;
+    uint8_t rate = 0;
+    uint16_t size = 0;
+    uint8_t data[0x800];
+};
+
+// A bridge carries the wireless packets sent by one core to the others, either in-process or over UDP
+// In-process, each pair of ports has its own single-producer ring, so cores on different threads never take a lock
+// Over UDP, the bridge links a single port to a remote host, and the packets sent between polls go out in one datagram
+// Packets are timestamped in the sender's emulated cycles, which the receiver uses to keep their spacing
+class WifiBridge
+{
+    public:
+        WifiBridge(int localPort = 0, std::string peer = "");
+        ~WifiBridge();
+
+        bool isOpen() { return sock != -1; }
+
+        int attach();
+        void detach(int port);
+
+        void send(int port, const WifiPacket *packet);
+        bool receive(int port, WifiPacket *packet);
+        void flush();
+
+    private:
+        struct Ring
+        {
+            WifiPacket packets[BRIDGE_SLOTS];
+            std::atomic<uint32_t> head { 0 };
+            std::atomic<uint32_t> tail { 0 };
+        };
+
+        // Rings are indexed by sender and then receiver
+        Ring *rings = nullptr;
+        std::atomic<bool> attached[BRIDGE_PORTS];
+
+        int sock = -1;
+        uint8_t peerAddr[16] = {};
+        std::vector<uint8_t> batch;
+        std::vector<uint8_t> datagram;
+        std::deque<WifiPacket> received;
+
+        void receiveUdp();
+};
+
+#endif // WIFI_BRIDGE_H
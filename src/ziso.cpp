@@ -0,0 +1,169 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstring>
+
+#include "ziso.h"
+#include "defines.h"
+
+// ZISO files start with a 24-byte header, followed by an index with an entry for each block plus one for the end
+// Each index entry holds a file offset shifted right by the header's shift value
+// The high bit of an entry is set when its block is stored uncompressed rather than as a raw LZ4 block
+// The ROM size is taken from the header, so the file name can stay the same as the uncompressed ROM's
+
+Ziso::Ziso(FILE *file): file(file)
+{
+    // Read and verify the header
+    uint8_t header[0x18];
+    fseek(file, 0, SEEK_SET);
+    if (fread(header, sizeof(uint8_t), 0x18, file) != 0x18 || U8TO32(header, 0xC) != 0)
+    {
+        fclose(file);
+        throw 2;
+    }
+
+    size = U8TO32(header, 0x8);
+    blockSize = U8TO32(header, 0x10);
+    indexShift = header[0x15];
+    if (blockSize == 0 || (blockSize & (blockSize - 1)) || indexShift > 31)
+    {
+        fclose(file);
+        throw 2;
+    }
+
+    // Read the block index
+    uint32_t count = (size + blockSize - 1) / blockSize;
+    std::vector<uint8_t> data((count + 1) * 4);
+    fseek(file, U8TO32(header, 0x4), SEEK_SET);
+    if (fread(data.data(), sizeof(uint8_t), data.size(), file) != data.size())
+    {
+        fclose(file);
+        throw 2;
+    }
+
+    index.resize(count + 1);
+    for (uint32_t i = 0; i <= count; i++)
+        index[i] = U8TO32(data.data(), i * 4);
+
+    loaded.resize(count, false);
+    buffer.resize(blockSize + 0x800);
+}
+
+Ziso::~Ziso()
+{
+    fclose(file);
+}
+
+bool Ziso::detect(FILE *file)
+{
+    // Check for the 'ZISO' magic, leaving the file at the start
+    uint8_t magic[4] = {};
+    fseek(file, 0, SEEK_SET);
+    fread(magic, sizeof(uint8_t), 4, file);
+    fseek(file, 0, SEEK_SET);
+    return memcmp(magic, "ZISO", 4) == 0;
+}
+
+void Ziso::fetch(uint8_t *data, uint32_t address, uint32_t length)
+{
+    // Decompress any blocks in the range that haven't been loaded yet
+    if (address >= size || length == 0) return;
+    uint32_t end = (length > size - address) ? size : (address + length);
+    for (uint32_t i = address / blockSize; i <= (end - 1) / blockSize; i++)
+    {
+        if (!loaded[i])
+            loadBlock(data, i);
+    }
+}
+
+void Ziso::loadBlock(uint8_t *data, uint32_t block)
+{
+    // Get the location and sizes of the block
+    uint64_t start = (uint64_t)(index[block] & 0x7FFFFFFF) << indexShift;
+    uint64_t end = (uint64_t)(index[block + 1] & 0x7FFFFFFF) << indexShift;
+    uint32_t address = block * blockSize;
+    int dstSize = (size - address < blockSize) ? (size - address) : blockSize;
+    int srcSize = (end > start) ? (end - start) : 0;
+    if (srcSize > (int)buffer.size()) srcSize = buffer.size();
+    loaded[block] = true;
+
+    // Read the block, filling anything missing with 0xFF like open bus
+    memset(&buffer[0], 0xFF, buffer.size());
+    fseek(file, start, SEEK_SET);
+    fread(&buffer[0], sizeof(uint8_t), srcSize, file);
+
+    // Copy an uncompressed block directly, or decompress it
+    // Blocks that don't shrink are also stored uncompressed, for files written without the flag
+    if ((index[block] & BIT(31)) || srcSize >= (int)blockSize)
+        memcpy(&data[address], &buffer[0], dstSize);
+    else
+        decompress(&buffer[0], srcSize, &data[address], dstSize);
+}
+
+void Ziso::decompress(const uint8_t *src, int srcSize, uint8_t *dst, int dstSize)
+{
+    // Decode an LZ4 block, stopping once the output is full since blocks can be padded for alignment
+    int s = 0, d = 0;
+    while (s < srcSize && d < dstSize)
+    {
+        // Copy the literals, with extra length bytes following a maximum nibble
+        uint8_t token = src[s++];
+        int length = token >> 4;
+        if (length == 15)
+        {
+            while (s < srcSize)
+            {
+                uint8_t value = src[s++];
+                length += value;
+                if (value != 255) break;
+            }
+        }
+        if (length > srcSize - s) length = srcSize - s;
+        if (length > dstSize - d) length = dstSize - d;
+        memcpy(&dst[d], &src[s], length);
+        s += length;
+        d += length;
+
+        // The last sequence only has literals
+        if (s + 2 > srcSize || d >= dstSize) break;
+
+        // Copy the match from earlier output, byte by byte since it can overlap with itself
+        int offset = U8TO16(src, s);
+        s += 2;
+        if (offset == 0 || offset > d) break;
+        length = (token & 0xF) + 4;
+        if ((token & 0xF) == 15)
+        {
+            while (s < srcSize)
+            {
+                uint8_t value = src[s++];
+                length += value;
+                if (value != 255) break;
+            }
+        }
+        if (length > dstSize - d) length = dstSize - d;
+        for (int i = 0; i < length; i++, d++)
+            dst[d] = dst[d - offset];
+    }
+
+    // Fill anything that couldn't be decoded
+    if (d < dstSize)
+        memset(&dst[d], 0xFF, dstSize - d);
+}
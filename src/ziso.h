@@ -0,0 +1,55 @@
+/*
+    Copyright 2019-2021 Hydr8gon
+
+    This file is part of NooDS.
+
+    NooDS is free software: you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    NooDS is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with NooDS. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef ZISO_H
+#define ZISO_H
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Reader for ZISO files, a block-compressed container with a seekable index of LZ4 blocks
+// Blocks are decompressed on demand, so only the parts of a ROM that are accessed get read from disk
+class Ziso
+{
+    public:
+        Ziso(FILE *file);
+        ~Ziso();
+
+        static bool detect(FILE *file);
+
+        uint32_t getSize() { return size; }
+        void fetch(uint8_t *data, uint32_t address, uint32_t length);
+
+    private:
+        FILE *file;
+        uint32_t size = 0;
+        uint32_t blockSize = 0;
+        int indexShift = 0;
+
+        std::vector<uint32_t> index;
+        std::vector<bool> loaded;
+        std::vector<uint8_t> buffer;
+
+        void loadBlock(uint8_t *data, uint32_t block);
+        static void decompress(const uint8_t *src, int srcSize, uint8_t *dst, int dstSize);
+};
+
+#endif // ZISO_H